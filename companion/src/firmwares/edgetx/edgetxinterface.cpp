@@ -27,6 +27,7 @@
 #include "yaml_generalsettings.h"
 #include "yaml_modeldata.h"
 #include "labelvalidator.h"
+#include "version.h"
 
 #include <QMessageBox>
 
@@ -137,6 +138,26 @@ bool loadModelFromYaml(ModelData& model, const QByteArray& data)
   return true;
 }
 
+bool loadModelFromYamlUnattended(ModelData& model, const QByteArray& data,
+                                 bool& confirm)
+{
+  YAML::Node node = loadYamlFromByteArray(data);
+
+  // see convert<ModelData>::decode()
+  confirm = false;
+  if (node.IsMap() && node["semver"] && node["semver"].IsScalar()) {
+    QString semver = QString::fromStdString(node["semver"].as<std::string>());
+    if (SemanticVersion().isValid(semver) &&
+        SemanticVersion(semver) > SemanticVersion(VERSION)) {
+      confirm = true;
+      return true;
+    }
+  }
+
+  node >> model;
+  return true;
+}
+
 bool loadRadioSettingsFromYaml(GeneralSettings& settings, const QByteArray& data)
 {
     if(data.indexOf("checksum:") == 0) {
@@ -43,6 +43,12 @@ bool loadLabelsListFromYaml(RadioData::ModelLabels& labels,
                             const QByteArray& data);
 
 bool loadModelFromYaml(ModelData& model, const QByteArray& data);
+// Same as loadModelFromYaml() without any user interaction, may be called
+// from worker threads: models with a settings version newer than Companion
+// are not decoded and 'confirm' is set, they have to be loaded again with
+// loadModelFromYaml() which asks the user first
+bool loadModelFromYamlUnattended(ModelData& model, const QByteArray& data,
+                                 bool& confirm);
 bool loadRadioSettingsFromYaml(GeneralSettings& settings, const QByteArray& data);
 
 bool writeLabelsListToYaml(const RadioData &radioData, QByteArray& data);
@@ -239,6 +239,7 @@ Node convert<GeneralSettings>::encode(const GeneralSettings& rhs)
   node["bluetoothMode"] = bluetoothModeLut << rhs.bluetoothMode;
   node["countryCode"] = rhs.countryCode;
   node["noJitterFilter"] = (int)rhs.noJitterFilter;
+  node["adcFilter"] = rhs.adcFilter;
   node["disableRtcWarning"] = (int)rhs.rtcCheckDisable;  // TODO: verify
   node["audioMuteEnable"] = (int)rhs.muteIfNoSound;
   node["keysBacklight"] = (int)rhs.keysBacklight;
@@ -494,6 +495,7 @@ bool convert<GeneralSettings>::decode(const Node& node, GeneralSettings& rhs)
   node["countryCode"] >> rhs.countryCode;
   node["jitterFilter"] >> rhs.noJitterFilter;   // PR1363 : read old name and
   node["noJitterFilter"] >> rhs.noJitterFilter; // new, but don't write old
+  node["adcFilter"] >> rhs.adcFilter;
   node["disableRtcWarning"] >> rhs.rtcCheckDisable;  // TODO: verify
   node["audioMuteEnable"] >> rhs.muteIfNoSound;
   node["keysBacklight"] >> rhs.keysBacklight;
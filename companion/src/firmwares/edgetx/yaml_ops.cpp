@@ -23,7 +23,8 @@
 #include "namevalidator.h"
 
 SemanticVersion radioSettingsVersion;
-SemanticVersion modelSettingsVersion;
+// per thread: models can be decoded in parallel (see LabelsStorageFormat)
+thread_local SemanticVersion modelSettingsVersion;
 
 YAML::Node operator >> (const YAML::Node& node, const YamlLookupTable& lut)
 {
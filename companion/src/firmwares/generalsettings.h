@@ -265,6 +265,7 @@ class GeneralSettings {
     unsigned int rotarySteps;
     unsigned int countryCode;
     bool noJitterFilter;
+    unsigned int adcFilter;
     bool rtcCheckDisable;
     bool muteIfNoSound;
     bool keysBacklight;
@@ -29,16 +29,41 @@
 #include <unistd.h>
 #endif
 
+int LogTableModel::rowCount(const QModelIndex & parent) const
+{
+  return parent.isValid() ? 0 : log.rowCount();
+}
+
+int LogTableModel::columnCount(const QModelIndex & parent) const
+{
+  return parent.isValid() ? 0 : log.columnCount();
+}
+
+QVariant LogTableModel::data(const QModelIndex & index, int role) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole)
+    return QVariant();
+
+  return log.text(index.row(), index.column());
+}
+
+QVariant LogTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section < log.columnCount())
+    return log.headers().at(section);
+
+  return QAbstractTableModel::headerData(section, orientation, role);
+}
+
 LogsDialog::LogsDialog(QWidget *parent) :
   QDialog(parent, Qt::WindowTitleHint | Qt::WindowSystemMenuHint),
   ui(new Ui::LogsDialog),
   tracerMaxAlt(0),
   cursorA(0),
   cursorB(0),
-  cursorLine(0)
+  cursorLine(0),
+  tracerSeries(-1)
 {
-  csvlog.clear();
-
   ui->setupUi(this);
   setWindowIcon(CompanionIcon("logs.png"));
 
@@ -109,6 +134,10 @@ LogsDialog::LogsDialog(QWidget *parent) :
 
   ui->SaveSession_PB->setEnabled(false);
 
+  logModel = new LogTableModel(log, this);
+  ui->logTable->setModel(logModel);
+  ui->logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+
   // connect slot that ties some axis selections together (especially opposite axes):
   connect(ui->customPlot, &QCustomPlot::selectionChangedByUser, this, &LogsDialog::selectionChanged);
   // connect slots that takes care that when an axis is selected, only that direction can be dragged and zoomed:
@@ -117,12 +146,14 @@ LogsDialog::LogsDialog(QWidget *parent) :
 
   // make left axes transfer its range to right axes:
   connect(axisRect->axis(QCPAxis::atLeft), static_cast<void(QCPAxis::*)(const QCPRange&)>(&QCPAxis::rangeChanged), this, &LogsDialog::yAxisChangeRanges);
+  // level of detail of the graphs follows the time range:
+  connect(axisRect->axis(QCPAxis::atBottom), static_cast<void(QCPAxis::*)(const QCPRange&)>(&QCPAxis::rangeChanged), this, &LogsDialog::xAxisChangeRange);
   // connect some interaction slots:
   connect(title, &QCPTextElement::doubleClicked, this, &LogsDialog::titleDoubleClicked);
   connect(ui->customPlot, &QCustomPlot::axisDoubleClick, this, &LogsDialog::axisLabelDoubleClick);
   connect(ui->customPlot, &QCustomPlot::legendDoubleClick, this, &LogsDialog::legendDoubleClick);
   connect(ui->FieldsTW, &QTableWidget::itemSelectionChanged, this, &LogsDialog::plotLogs);
-  connect(ui->logTable, &QTableWidget::itemSelectionChanged, this, &LogsDialog::plotLogs);
+  connect(ui->logTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, &LogsDialog::plotLogs);
   connect(ui->Reset_PB, &QPushButton::clicked, this, &LogsDialog::plotLogs);
   connect(ui->SaveSession_PB, &QPushButton::clicked, this, &LogsDialog::saveSession);
   connect(ui->fileOpen_PB, &QPushButton::clicked, this, &LogsDialog::fileOpen);
@@ -248,18 +279,33 @@ void LogsDialog::selectionChanged()
   }
 }
 
-QList<QStringList> LogsDialog::filterGePoints(const QList<QStringList> & input)
+std::vector<int> LogsDialog::selectedRows() const
+{
+  std::vector<int> rows;
+
+  // ranges rather than selectedRows(): sessions may select millions of rows
+  for (const QItemSelectionRange & range: ui->logTable->selectionModel()->selection()) {
+    for (int row = range.top(); row <= range.bottom(); row++) {
+      rows.push_back(row);
+    }
+  }
+
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  return rows;
+}
+
+QList<QStringList> LogsDialog::filterGePoints()
 {
   QList<QStringList> result;
 
-  int n = input.count();
-  if (n == 0) {
+  if (log.rowCount() == 0) {
     return result;
   }
 
   int gpscol = 0;
-  for (int i=1; i<input.at(0).count(); i++) {
-    if (input.at(0).at(i) == "GPS") {
+  for (int i=1; i<log.columnCount(); i++) {
+    if (log.headers().at(i) == "GPS") {
       gpscol=i;
     }
   }
@@ -270,42 +316,46 @@ The columns for altitude \"GAlt\" and for speed \"GSpd\" are optional"));
     return result;
   }
 
-  result.append(input.at(0));
-  bool rangeSelected = ui->logTable->selectionModel()->selectedRows().length() > 0;
+  result.append(log.headers());
+
+  std::vector<int> rows = selectedRows();
+  if (rows.empty()) {
+    rows.resize(log.rowCount());
+    for (int i = 0; i < log.rowCount(); i++) {
+      rows[i] = i;
+    }
+  }
 
   GpsGlitchFilter glitchFilter;
   GpsLatLonFilter latLonFilter;
 
-  for (int i = 1; i < n; i++) {
-    if ((ui->logTable->item(i-1, 1)->isSelected() && rangeSelected) || !rangeSelected) {
-
-      GpsCoord coord = extractGpsCoordinates(input.at(i).at(gpscol));
+  for (int i: rows) {
+    GpsCoord coord = extractGpsCoordinates(log.text(i, gpscol));
 
-      // glitch filter
-      if ( glitchFilter.isGlitch(coord) ) {
-        // qDebug() << "filterGePoints(): GPS glitch detected at" << i << coord.latitude << coord.longitude;
-        continue;
-      }
-
-      // lat long pair filter
-      if ( !latLonFilter.isValid(coord) ) {
-        // qDebug() << "filterGePoints(): Lat-Lon pair wrong, skipping at" << i << coord.latitude << coord.longitude;
-        continue;
-      }
+    // glitch filter
+    if ( glitchFilter.isGlitch(coord) ) {
+      // qDebug() << "filterGePoints(): GPS glitch detected at" << i << coord.latitude << coord.longitude;
+      continue;
+    }
 
-      // qDebug() << "point " << latitude << longitude;
-      result.append(input.at(i));
+    // lat long pair filter
+    if ( !latLonFilter.isValid(coord) ) {
+      // qDebug() << "filterGePoints(): Lat-Lon pair wrong, skipping at" << i << coord.latitude << coord.longitude;
+      continue;
     }
+
+    // qDebug() << "point " << latitude << longitude;
+    result.append(log.fields(i));
   }
 
-  // qDebug() << "filterGePoints(): filtered from" << input.count() << "to " << result.count() << "points";
+  // qDebug() << "filterGePoints(): filtered from" << log.rowCount() << "to " << result.count() << "points";
   return result;
 }
 
 void LogsDialog::exportToGoogleEarth()
 {
   // filter data points
-  QList<QStringList> dataPoints = filterGePoints(csvlog);
+  QList<QStringList> dataPoints = filterGePoints();
   int n = dataPoints.count(); // number of points to export
   if (n==0) return;
 
@@ -476,9 +526,11 @@ void LogsDialog::placeCursor(double x, bool second)
 {
   QCPItemTracer * cursor = second ? cursorB : cursorA;
 
-  if (cursor) {
-    cursor->setGraphKey(x);
-    cursor->updatePosition();
+  // the graph only holds decimated data: use the full resolution samples
+  double key, value;
+  if (cursor && tracerSeries >= 0 &&
+      series.at(tracerSeries).valueAt(x, false, key, value)) {
+    cursor->position->setCoords(key, value);
     cursor->setVisible(true);
   }
 
@@ -555,6 +607,7 @@ void LogsDialog::mouseWheel()
 
 void LogsDialog::removeAllGraphs()
 {
+  series.clear();
   ui->customPlot->clearGraphs();
   ui->customPlot->clearItems();
   ui->customPlot->legend->setVisible(false);
@@ -574,6 +627,7 @@ void LogsDialog::removeAllGraphs()
   cursorA = 0;
   cursorB = 0;
   cursorLine = 0;
+  tracerSeries = -1;
   ui->labelCursors->setText("");
 }
 
@@ -585,36 +639,25 @@ void LogsDialog::fileOpen()
     ui->FileName_LE->setText(fileName);
     if (cvsFileParse()) {
       ui->FieldsTW->clear();
-      ui->logTable->clear();
       ui->FieldsTW->setShowGrid(false);
       ui->FieldsTW->setContentsMargins(0,0,0,0);
-      ui->FieldsTW->setRowCount(csvlog.at(0).count()-2);
+      ui->FieldsTW->setRowCount(log.columnCount()-2);
       ui->FieldsTW->setColumnCount(1);
       ui->FieldsTW->setHorizontalHeaderLabels(QStringList(tr("Available fields")));
-      ui->logTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-      for (int i=2; i<csvlog.at(0).count(); i++) {
-        QTableWidgetItem* item= new QTableWidgetItem(csvlog.at(0).at(i));
+      for (int i=2; i<log.columnCount(); i++) {
+        QTableWidgetItem* item= new QTableWidgetItem(log.headers().at(i));
         ui->FieldsTW->setItem(i-2, 0, item);
       }
       ui->FieldsTW->resizeRowsToContents();
-      ui->logTable->setColumnCount(csvlog.at(0).count());
-      ui->logTable->setRowCount(csvlog.count()-1);
-      ui->logTable->setHorizontalHeaderLabels(csvlog.at(0));
-
-      QAbstractItemModel *model = ui->logTable->model();
-      for (int i=1; i<csvlog.count(); i++) {
-        for (int j=0; j<csvlog.at(0).count(); j++) {
-          model->setData(model->index(i - 1, j, QModelIndex()), csvlog.at(i).at(j));
-        }
-      }
 
+      // only the first rows are measured (resizeContentsPrecision)
       ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
       QVarLengthArray<int> sizes;
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
+      for (int i = 0; i < logModel->columnCount(); i++) {
         sizes.append(ui->logTable->columnWidth(i));
       }
       ui->logTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-      for (int i = 0; i < ui->logTable->columnCount(); i++) {
+      for (int i = 0; i < logModel->columnCount(); i++) {
         ui->logTable->setColumnWidth(i, sizes.at(i));
       }
     }
@@ -626,26 +669,11 @@ void LogsDialog::saveSession()
   int index = ui->sessions_CB->currentIndex();
   // ignore index 0 is its all sessions combined
   if(index > 0) {
-    int n = csvlog.count();
-    QList<QStringList> sessionCsvLog;
-    // add CSV headers from first row of source file
-    sessionCsvLog.push_back(csvlog[0]);
-    // find session breaks
-    int currentSession = 0;
-    QDateTime lastvalue;
-    for (int i = 1; i < n; i++) {
-      QDateTime tmp = getRecordTimeStamp(i);
-      if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-        currentSession++;
-      }
-      lastvalue = tmp;
-      if(currentSession == index) {
-        // add records to filtered list
-        sessionCsvLog.push_back(csvlog[i]);
-      }
-      else if (currentSession > index) {
-        break;
-      }
+    // session records (see setFlightSessions())
+    int first = ui->sessions_CB->itemData(index, Qt::UserRole).toInt();
+    int last = log.rowCount();
+    if (index < ui->sessions_CB->count() - 1) {
+      last = ui->sessions_CB->itemData(index + 1, Qt::UserRole).toInt();
     }
     // save the filtered records to a new file
     QString newFilename = logFilename;
@@ -653,68 +681,39 @@ void LogsDialog::saveSession()
     QString filename = QFileDialog::getSaveFileName(this, "Save log", newFilename, "CSV files (.csv);"); // getting the filename (full path)
     QFile data(filename);
     if(data.open(QFile::WriteOnly |QFile::Truncate)) {
-      QTextStream output(&data);
-      int numRecords = sessionCsvLog.count();
-      for(int i = 0; i < numRecords; i++){
-        output << sessionCsvLog[i].join(",") << '\n';
+      // add CSV headers from first row of source file
+      data.write(log.headers().join(",").toUtf8() + '\n');
+      for (int i = first; i < last; i++) {
+        data.write(log.line(i) + '\n');
       }
     }
-    sessionCsvLog.clear();
   }
 }
 
 bool LogsDialog::cvsFileParse()
 {
-  QFile file(ui->FileName_LE->text());
-  int errors=0;
-  int lines=-1;
+  QString filename = ui->FileName_LE->text();
 
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) { // reading HEX TEXT file
-    return false;
-  }
-  else {
-    csvlog.clear();
-    logFilename.clear();
-    QTextStream inputStream(&file);
-    QString buffer = file.readLine();
-
-    if (buffer.startsWith("Date,Time")) {
-      file.reset();
-    }
-    else {
-      return false;
-    }
-
-    int numfields=-1;
-    while (!file.atEnd()) {
-      QString line = file.readLine().trimmed();
-      QStringList columns = line.split(',');
-      if (numfields==-1) {
-        numfields=columns.count();
-      }
-      if (columns.count()==numfields) {
-        csvlog.append(columns);
-      }
-      else {
-        errors++;
-      }
-      lines++;
-    }
+  removeAllGraphs();
+  logFilename.clear();
 
-    logFilename = QFileInfo(file.fileName()).baseName();
-  }
+  logModel->beginReset();
+  bool loaded = log.load(filename);
+  logModel->endReset();
 
-  file.close();
+  int errors = log.invalidLineCount();
   if (errors > 1) {
-    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(errors).arg(lines));
+    QMessageBox::warning(this, CPN_STR_APP_NAME, tr("The selected logfile contains %1 invalid lines out of  %2 total lines").arg(errors).arg(log.lineCount()));
   }
 
-  int n = csvlog.count();
-  if (n == 1) {
-    csvlog.clear();
+  if (!loaded) {
+    ui->FieldsTW->clear();
+    ui->FieldsTW->setRowCount(0);
     return false;
   }
 
+  logFilename = QFileInfo(filename).baseName();
+
   plotLock = true;
   setFlightSessions();
   plotLock = false;
@@ -722,19 +721,6 @@ bool LogsDialog::cvsFileParse()
   return true;
 }
 
-struct FlightSession {
-  QDateTime start;
-  QDateTime end;
-};
-
-QDateTime LogsDialog::getRecordTimeStamp(int index)
-{
-  QString tstamp = csvlog.at(index).at(0) + " " + csvlog.at(index).at(1);
-  if (csvlog.at(index).at(1).contains("."))
-    return QDateTime::fromString(tstamp, "yyyy-MM-dd HH:mm:ss.zzz");
-  return QDateTime::fromString(tstamp, "yyyy-MM-dd HH:mm:ss");
-}
-
 QString LogsDialog::generateDuration(const QDateTime & start, const QDateTime & end)
 {
   int secs = start.secsTo(end);
@@ -752,35 +738,32 @@ void LogsDialog::setFlightSessions()
   ui->sessions_CB->clear();
   ui->SaveSession_PB->setEnabled(false);
 
-  int n = csvlog.count();
+  int n = log.rowCount();
   // qDebug() << "records" << n;
 
-  // find session breaks
+  // find session breaks (more than 60s between records)
   QList<int> sessions;
-  QDateTime lastvalue;
-  for (int i = 1; i < n; i++) {
-    QDateTime tmp = getRecordTimeStamp(i);
-    if (!lastvalue.isValid() || lastvalue.secsTo(tmp) > 60) {
-      sessions.push_back(i-1);
-      // qDebug() << "session index" << i-1;
+  for (int i = 0; i < n; i++) {
+    if (i == 0 || log.time(i) - log.time(i-1) >= 61) {
+      sessions.push_back(i);
+      // qDebug() << "session index" << i;
     }
-    lastvalue = tmp;
   }
-  sessions.push_back(n-1);
+  sessions.push_back(n);
 
   //now construct a list of sessions with their times
   //total time
   int noSesions = sessions.size()-1;
   QString label = QString("%1 ").arg(noSesions);
   label += tr(noSesions > 1 ? "sessions" : "session");
-  label += " <" + tr("time span") + generateDuration(getRecordTimeStamp(1), getRecordTimeStamp(n-1)) + ">";
+  label += " <" + tr("time span") + generateDuration(log.timeStamp(0), log.timeStamp(n-1)) + ">";
   ui->sessions_CB->addItem(label);
 
   // add individual sessions
   if (sessions.size() > 2) {
     for (int i = 1; i < sessions.size(); i++) {
-      QDateTime sessionStart = getRecordTimeStamp(sessions.at(i-1)+1);
-      QDateTime sessionEnd = getRecordTimeStamp(sessions.at(i));
+      QDateTime sessionStart = log.timeStamp(sessions.at(i-1));
+      QDateTime sessionEnd = log.timeStamp(sessions.at(i)-1);
       QString label = sessionStart.toString("HH:mm:ss") + " <" + tr("duration ") + generateDuration(sessionStart, sessionEnd) + ">";
       ui->sessions_CB->addItem(label, sessions.at(i-1));
       // qDebug() << "added label" << label << sessions.at(i-1);
@@ -800,13 +783,13 @@ void LogsDialog::sessionsCurrentIndexChanged(int index)
     if (index < ui->sessions_CB->count() - 1) {
       bottom = ui->sessions_CB->itemData(index + 1, Qt::UserRole).toInt();
     } else {
-      bottom = ui->logTable->rowCount();
+      bottom = logModel->rowCount();
     }
 
     QModelIndex topLeft = ui->logTable->model()->index(
       ui->sessions_CB->itemData(index, Qt::UserRole).toInt(), 0 , QModelIndex());
     QModelIndex bottomRight = ui->logTable->model()->index(
-      bottom - 1, ui->logTable->columnCount() - 1, QModelIndex());
+      bottom - 1, logModel->columnCount() - 1, QModelIndex());
 
     QItemSelection selection(topLeft, bottomRight);
     ui->logTable->selectionModel()->select(selection, QItemSelectionModel::Select);
@@ -832,25 +815,27 @@ void LogsDialog::plotLogs()
 
   plotsCollection plots;
 
-  QModelIndexList selection = ui->logTable->selectionModel()->selectedRows();
-  int rowCount = selection.length();
-  bool hasLogSelection;
-  QVarLengthArray<int> selectedRows;
-
-  if (rowCount) {
-    hasLogSelection = true;
-    foreach (QModelIndex index, selection) {
-      selectedRows.append(index.row());
-    }
-    std::sort(selectedRows.begin(), selectedRows.end());
-  } else {
-    hasLogSelection = false;
-    rowCount = ui->logTable->rowCount();
-  }
+  std::vector<int> selectedRows = this->selectedRows();
+  bool hasLogSelection = !selectedRows.empty();
+  int rowCount = hasLogSelection ? (int)selectedRows.size() : log.rowCount();
 
   plots.min_x = INVALID_MIN;
   plots.max_x = 0;
 
+  // times are shared by all the plots
+  QVector<double> times(rowCount);
+  for (int row = 0; row < rowCount; row++) {
+    double time = log.time(hasLogSelection ? selectedRows[row] : row);
+    times[row] = time;
+
+    if(plots.min_x == INVALID_MIN)
+      plots.min_x = time;
+    else
+      if (plots.min_x > time) plots.min_x = time;
+
+    if (plots.max_x < time) plots.max_x = time;
+  }
+
   foreach (QTableWidgetItem *plot, ui->FieldsTW->selectedItems()) {
     coords_t plotCoords;
     int plotColumn = plot->row() + 2; // Date and Time first
@@ -859,45 +844,15 @@ void LogsDialog::plotLogs()
     plotCoords.max_y = INVALID_MAX;
     plotCoords.yaxis = firstLeft;
     plotCoords.name = plot->text();
+    plotCoords.x = times;
+    plotCoords.y.resize(rowCount);
 
     for (int row = 0; row < rowCount; row++) {
-      QTableWidgetItem *logValue;
-      double y;
-      double time;
-      QString time_str;
-
-      if (hasLogSelection) {
-        logValue = ui->logTable->item(selectedRows.at(row), plotColumn);
-        time_str = ui->logTable->item(selectedRows.at(row), 0)->text() +
-          QString(" ") + ui->logTable->item(selectedRows.at(row), 1)->text();
-      } else {
-        logValue = ui->logTable->item(row, plotColumn);
-        time_str = ui->logTable->item(row, 0)->text() + QString(" ") +
-          ui->logTable->item(row, 1)->text();
-      }
-
-      y = logValue->text().toDouble();
-      plotCoords.y.push_back(y);
+      double y = log.value(hasLogSelection ? selectedRows[row] : row, plotColumn);
+      plotCoords.y[row] = y;
 
       if (plotCoords.min_y > y) plotCoords.min_y = y;
       if (plotCoords.max_y < y) plotCoords.max_y = y;
-
-      if (time_str.contains('.')) {
-        time = QDateTime::fromString(time_str, "yyyy-MM-dd HH:mm:ss.zzz")
-          .toTime_t();
-        time += time_str.mid(time_str.indexOf('.')).toDouble();
-      } else {
-        time = QDateTime::fromString(time_str, "yyyy-MM-dd HH:mm:ss")
-          .toTime_t();
-      }
-      plotCoords.x.push_back(time);
-
-      if(plots.min_x == INVALID_MIN)
-        plots.min_x = time;
-      else
-        if (plots.min_x > time) plots.min_x = time;
-
-      if (plots.max_x < time) plots.max_x = time;
     }
 
     double range_inc = (plotCoords.max_y - plotCoords.min_y) / 100;
@@ -989,6 +944,11 @@ void LogsDialog::plotLogs()
 
   removeAllGraphs();
 
+  series.resize(plots.coords.size());
+  for (int i = 0; i < plots.coords.size(); i++) {
+    series[i].set(plots.coords.at(i).x, plots.coords.at(i).y);
+  }
+
   axisRect->axis(QCPAxis::atBottom)->setRange(plots.min_x, plots.max_x);
 
   axisRect->axis(QCPAxis::atLeft)->setRange(yAxesRanges[firstLeft].min,
@@ -1061,14 +1021,13 @@ void LogsDialog::plotLogs()
         break;
     }
 
-    ui->customPlot->graph(i)->setData(plots.coords.at(i).x,
-      plots.coords.at(i).y);
     pen.setColor(colors.at(i % colors.size()));
     ui->customPlot->graph(i)->setPen(pen);
 
     if (!tracerMaxAlt && (plots.coords.at(i).name.endsWith("(m)") ||
         plots.coords.at(i).name.endsWith(" Alt") ||
         plots.coords.at(i).name.endsWith("(ft)"))) {
+      tracerSeries = i;
       addMaxAltitudeMarker(plots.coords.at(i), ui->customPlot->graph(i));
       countNumberOfThrows(plots.coords.at(i), ui->customPlot->graph(i));
       addCursor(&cursorA, ui->customPlot->graph(i), Qt::blue);
@@ -1078,6 +1037,9 @@ void LogsDialog::plotLogs()
     }
   }
 
+  // graphs data for the current time range
+  xAxisChangeRange(axisRect->axis(QCPAxis::atBottom)->range());
+
   ui->customPlot->legend->setVisible(true);
   ui->customPlot->replot();
 }
@@ -1124,6 +1086,21 @@ void LogsDialog::yAxisChangeRanges(QCPRange range)
   }
 }
 
+void LogsDialog::xAxisChangeRange(QCPRange range)
+{
+  // a few points per pixel: min/max of the samples when zoomed out
+  int buckets = axisRect->width();
+  QVector<double> keys, values;
+
+  for (int i = 0; i < series.size() && i < ui->customPlot->graphCount(); i++) {
+    QCPGraph * graph = ui->customPlot->graph(i);
+    series.at(i).getRange(range.lower, range.upper, buckets, keys, values);
+    graph->setData(keys, values, true);
+    if (graph->selected()) {
+      graph->setSelection(QCPDataSelection(graph->data()->dataRange()));
+    }
+  }
+}
 
 void LogsDialog::addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph) {
   // find max altitude
@@ -1142,14 +1119,21 @@ void LogsDialog::addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph) {
 
   // add max altitude marker
   tracerMaxAlt = new QCPItemTracer(ui->customPlot);
-  tracerMaxAlt->setGraph(graph);
-  tracerMaxAlt->setInterpolating(true);
+  setTracerAxes(tracerMaxAlt, graph);
   tracerMaxAlt->setStyle(QCPItemTracer::tsSquare);
   tracerMaxAlt->setPen(QPen(Qt::blue));
   tracerMaxAlt->setBrush(Qt::NoBrush);
   tracerMaxAlt->setSize(7);
-  tracerMaxAlt->setGraphKey(c.x.at(positionIndex));
-  tracerMaxAlt->updatePosition();
+  tracerMaxAlt->position->setCoords(c.x.at(positionIndex), maxAlt);
+}
+
+// Tracers are not attached to their graph, which only holds decimated
+// data when zoomed out: their position is set from the full resolution
+// series
+void LogsDialog::setTracerAxes(QCPItemTracer * tracer, QCPGraph * graph)
+{
+  tracer->position->setType(QCPItemPosition::ptPlotCoords);
+  tracer->position->setAxes(graph->keyAxis(), graph->valueAxis());
 }
 
 void LogsDialog::countNumberOfThrows(const coords_t & c, QCPGraph * graph)
@@ -1168,8 +1152,7 @@ void LogsDialog::countNumberOfThrows(const coords_t & c, QCPGraph * graph)
 
 void LogsDialog::addCursor(QCPItemTracer ** cursor, QCPGraph * graph, const QColor & color) {
   QCPItemTracer * c = new QCPItemTracer(ui->customPlot);
-  c->setGraph(graph);
-  c->setInterpolating(false);
+  setTracerAxes(c, graph);
   c->setStyle(QCPItemTracer::tsCrosshair);
   QPen pen(color);
   pen.setStyle(Qt::DashLine);
@@ -23,6 +23,7 @@
 #include <QtCore>
 #include <QDialog>
 #include "qcustomplot.h"
+#include "storage/logdata.h"
 
 #define INVALID_MIN 999999
 #define INVALID_MAX -999999
@@ -31,6 +32,29 @@ namespace Ui {
   class LogsDialog;
 }
 
+// Log table content, read from the log file when displayed
+class LogTableModel : public QAbstractTableModel
+{
+  public:
+    explicit LogTableModel(const LogData & log, QObject * parent = nullptr) :
+      QAbstractTableModel(parent),
+      log(log)
+    {
+    }
+
+    int rowCount(const QModelIndex & parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex & parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex & index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // to be called around log changes
+    void beginReset() { beginResetModel(); }
+    void endReset() { endResetModel(); }
+
+  protected:
+    const LogData & log;
+};
+
 class LogsDialog : public QDialog
 {
   Q_OBJECT
@@ -81,9 +105,12 @@ private slots:
   void sessionsCurrentIndexChanged(int index);
   void mapsButtonClicked();
   void yAxisChangeRanges(QCPRange range);
+  void xAxisChangeRange(QCPRange range);
 
 private:
-  QList<QStringList> csvlog;
+  LogData log;
+  LogTableModel * logModel;
+  QVector<LogSeries> series;  // one per graph
   Ui::LogsDialog *ui;
   QCPAxisRect *axisRect;
   QCPLegend *rightLegend;
@@ -100,16 +127,18 @@ private:
   QCPItemTracer * cursorA;
   QCPItemTracer * cursorB;
   QCPItemStraightLine * cursorLine;
+  int tracerSeries;  // series of the tracers, -1 if none
 
   bool cvsFileParse();
-  QList<QStringList> filterGePoints(const QList<QStringList> & input);
+  std::vector<int> selectedRows() const;
+  QList<QStringList> filterGePoints();
   void exportToGoogleEarth();
-  QDateTime getRecordTimeStamp(int index);
   QString generateDuration(const QDateTime & start, const QDateTime & end);
   void setFlightSessions();
 
   void addMaxAltitudeMarker(const coords_t & c, QCPGraph * graph);
   void countNumberOfThrows(const coords_t & c, QCPGraph * graph);
+  void setTracerAxes(QCPItemTracer * tracer, QCPGraph * graph);
   void addCursor(QCPItemTracer ** cursor, QCPGraph * graph, const QColor & color);
   void addCursorLine(QCPItemStraightLine ** line, QCPGraph * graph, const QColor & color);
   void placeCursor(double x, bool second);
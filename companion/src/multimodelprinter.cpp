@@ -22,7 +22,32 @@
 #include "helpers_html.h"
 #include "multimodelprinter.h"
 #include "appdata.h"
+#include <QCache>
+#include <QCryptographicHash>
+#include <QMutex>
 #include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Rendered sections, shared by all the printers and keyed by a hash of
+// the data they are printed from: only the sections whose data changed
+// are rendered again (e.g. after editing a mix in the compare dialog)
+#define MODEL_PRINT_CACHE_SIZE (32 * 1024 * 1024)  // characters
+
+static QMutex sectionCacheMutex;
+static QCache<QByteArray, QString> sectionCache(MODEL_PRINT_CACHE_SIZE);
+static int sectionThreads = 0;
+
+void MultiModelPrinter::setThreadCount(int count)
+{
+  sectionThreads = count;
+}
+
+void MultiModelPrinter::clearCache()
+{
+  QMutexLocker locker(&sectionCacheMutex);
+  sectionCache.clear();
+}
 
 MultiModelPrinter::MultiColumns::MultiColumns(int count):
   count(count),
@@ -265,45 +290,158 @@ void MultiModelPrinter::clearModels()
   modelPrinterMap.clear();
 }
 
+// Model and settings are hashed as raw bytes (both are copied with
+// memcpy), except the arrays only read by some of the sections
+static void modelHashes(const ModelData & model, const GeneralSettings & generalSettings, QVector<QByteArray> & hashes)
+{
+  const char * base = (const char *)&model;
+  const char * mixes = (const char *)model.mixData;
+  const char * functions = (const char *)model.customFn;
+  QPair<const char *, int> skipped[] = {
+    { mixes, (int)sizeof(model.mixData) },
+    { functions, (int)sizeof(model.customFn) },
+  };
+  std::sort(std::begin(skipped), std::end(skipped));
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData((const char *)&generalSettings, sizeof(GeneralSettings));
+  const char * pos = base;
+  for (const auto & range : skipped) {
+    hash.addData(pos, range.first - pos);
+    pos = range.first + range.second;
+  }
+  hash.addData(pos, base + sizeof(ModelData) - pos);
+
+  hashes.append(hash.result());
+  hashes.append(QCryptographicHash::hash(QByteArray::fromRawData(mixes, sizeof(model.mixData)), QCryptographicHash::Md5));
+  hashes.append(QCryptographicHash::hash(QByteArray::fromRawData(functions, sizeof(model.customFn)), QCryptographicHash::Md5));
+}
+
+QByteArray MultiModelPrinter::sectionKey(const Section & section, const QVector<QByteArray> & hashes) const
+{
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(QByteArray(section.name));
+  hash.addData(firmware->getId().toUtf8());
+  for (int i = 0; i < hashes.size(); i += 3) {
+    hash.addData(hashes[i]);
+    if (section.dependencies & DEP_MIXES)
+      hash.addData(hashes[i + 1]);
+    if (section.dependencies & DEP_SPECIAL_FUNCTIONS)
+      hash.addData(hashes[i + 2]);
+  }
+  return hash.result();
+}
+
+// Sections not found in the cache are rendered by a pool of threads,
+// each one taking the next section to render
+void MultiModelPrinter::renderSections(QVector<Section> & sections)
+{
+  QVector<int> pending;
+  {
+    QMutexLocker locker(&sectionCacheMutex);
+    for (int i = 0; i < sections.size(); i++) {
+      Section & section = sections[i];
+      if (!section.print)
+        continue;
+      QString * html = sectionCache.object(section.key);
+      if (html)
+        section.html = *html;
+      else
+        pending.append(i);
+    }
+  }
+
+  int threads = sectionThreads > 0 ? sectionThreads : std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, pending.size());
+
+  std::atomic<int> next(0);
+  auto render = [&]() {
+    int i;
+    while ((i = next++) < pending.size()) {
+      Section & section = sections[pending[i]];
+      section.html = (this->*section.print)();
+    }
+  };
+
+  if (threads > 1) {
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; i++)
+      pool.emplace_back(render);
+    for (auto & thread : pool)
+      thread.join();
+  }
+  else {
+    render();
+  }
+
+  QMutexLocker locker(&sectionCacheMutex);
+  for (int i : pending) {
+    const Section & section = sections[i];
+    sectionCache.insert(section.key, new QString(section.html), std::max(1, section.html.size()));
+  }
+}
+
 QString MultiModelPrinter::print(QTextDocument * document)
 {
   if (document) document->clear();
   Stylesheet css(MODEL_PRINT_CSS);
-  if (css.load(Stylesheet::StyleType::STYLE_TYPE_EFFECTIVE))
+  if (document && css.load(Stylesheet::StyleType::STYLE_TYPE_EFFECTIVE))
     document->setDefaultStyleSheet(css.text());
-  QString str = "<table cellspacing='0' cellpadding='3' width='100%'>";   // attributes not settable via QT stylesheet
-  str.append(printSetup());
+
+  QVector<Section> sections;
+  auto addSection = [&](const char * name, QString (MultiModelPrinter::*print)(), unsigned int dependencies = 0) {
+    sections.append({ name, print, dependencies, QByteArray(), QString() });
+  };
+
+  addSection("setup", &MultiModelPrinter::printSetup);
   if (firmware->getCapability(HasDisplayText))
-    str.append(printChecklist());
+    addSection("checklist", &MultiModelPrinter::printChecklist);
   if (firmware->getCapability(Timers)) {
-    str.append(printTimers());
+    addSection("timers", &MultiModelPrinter::printTimers);
   }
   if (Boards::getCapability(firmware->getBoard(), Board::FunctionSwitches)) {
-    str.append(printFunctionSwitches());
+    addSection("functionswitches", &MultiModelPrinter::printFunctionSwitches);
   }
 
-  str.append(printModules());
+  addSection("modules", &MultiModelPrinter::printModules);
   if (firmware->getCapability(Heli))
-    str.append(printHeliSetup());
+    addSection("heli", &MultiModelPrinter::printHeliSetup);
   if (firmware->getCapability(FlightModes))
-    str.append(printFlightModes());
-  str.append(printInputs());
-  str.append(printMixers());
-  str.append(printOutputs());
-  str.append(printCurves(document));
+    addSection("flightmodes", &MultiModelPrinter::printFlightModes);
+  addSection("inputs", &MultiModelPrinter::printInputs);
+  addSection("mixers", &MultiModelPrinter::printMixers, DEP_MIXES);
+  addSection("outputs", &MultiModelPrinter::printOutputs, DEP_MIXES);
+  // curves images are added to the document: rendered here, not cached
+  addSection("curves", NULL);
   if (firmware->getCapability(Gvars) && !firmware->getCapability(GvarsFlightModes))
-    str.append(printGvars());
-  str.append(printLogicalSwitches());
+    addSection("gvars", &MultiModelPrinter::printGvars);
+  addSection("logicalswitches", &MultiModelPrinter::printLogicalSwitches);
   if (firmware->getCapability(GlobalFunctions))
-    str.append(printGlobalFunctions());
-  str.append(printSpecialFunctions());
+    addSection("globalfunctions", &MultiModelPrinter::printGlobalFunctions);
+  addSection("specialfunctions", &MultiModelPrinter::printSpecialFunctions, DEP_SPECIAL_FUNCTIONS);
   if (firmware->getCapability(Telemetry)) {
-    str.append(printTelemetry());
-    str.append(printSensors());
+    addSection("telemetry", &MultiModelPrinter::printTelemetry);
+    addSection("sensors", &MultiModelPrinter::printSensors);
     if (firmware->getCapability(TelemetryCustomScreens)) {
-      str.append(printTelemetryScreens());
+      addSection("telemetryscreens", &MultiModelPrinter::printTelemetryScreens);
     }
   }
+
+  QVector<QByteArray> hashes;
+  for (int cc = 0; cc < modelPrinterMap.size(); cc++) {
+    modelHashes(*modelPrinterMap.value(cc).first, *modelPrinterMap.value(cc).second->gs(), hashes);
+  }
+  for (auto & section : sections) {
+    if (section.print)
+      section.key = sectionKey(section, hashes);
+  }
+
+  renderSections(sections);
+
+  QString str = "<table cellspacing='0' cellpadding='3' width='100%'>";   // attributes not settable via QT stylesheet
+  for (const auto & section : sections) {
+    str.append(section.print ? section.html : printCurves(document));
+  }
   str.append("</table>");
   return str;
 }
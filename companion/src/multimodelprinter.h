@@ -23,6 +23,7 @@
 
 #include <QObject>
 #include <QTextDocument>
+#include <QVector>
 #include "eeprominterface.h"
 #include "modelprinter.h"
 
@@ -39,6 +40,10 @@ class MultiModelPrinter: public QObject
     void clearModels();
     QString print(QTextDocument * document);
 
+    // Number of threads rendering the sections, 0 = one per core
+    static void setThreadCount(int count);
+    static void clearCache();
+
   protected:
     class MultiColumns {
       public:
@@ -73,10 +78,28 @@ class MultiModelPrinter: public QObject
         QString * compareColumns;
     };
 
+    // Model data only read by some of the sections, left out of the
+    // cache key of the other ones
+    enum SectionDependency {
+      DEP_MIXES = 1 << 0,
+      DEP_SPECIAL_FUNCTIONS = 1 << 1,
+    };
+
+    struct Section {
+      const char * name;
+      QString (MultiModelPrinter::*print)();   // NULL for the curves
+      unsigned int dependencies;
+      QByteArray key;
+      QString html;
+    };
+
     Firmware * firmware;
     GeneralSettings defaultSettings;
     QMap<int, QPair<const ModelData *, ModelPrinter *> > modelPrinterMap;
 
+    QByteArray sectionKey(const Section & section, const QVector<QByteArray> & hashes) const;
+    void renderSections(QVector<Section> & sections);
+
     QString printTitle(const QString & label);
     QString printSetup();
     QString printModules();
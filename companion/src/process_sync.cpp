@@ -24,9 +24,23 @@
 #include <QCryptographicHash>
 #include <QElapsedTimer>
 #include <QMutexLocker>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+
+#include <atomic>
+#include <thread>
+#include <vector>
 
 #define SYNC_MAX_ERRORS       50  // give up after this many errors per destination
 
+#define SYNC_MANIFEST_HEADER  "EdgeTX Companion sync manifest 1"
+#define SYNC_HASH_THREADS     4   // files hashed in parallel
+#define SYNC_COPY_THREADS     4   // files copied in parallel
+#define SYNC_COPY_BATCH       64  // copies queued before being run...
+#define SYNC_COPY_BATCH_SIZE  (64 * 1024 * 1024)  // ...or bytes
+#define SYNC_COPY_BUFFER_SIZE (256 * 1024)
+
 // a flood of log messages can make the UI unresponsive so we'll introduce a dynamic sleep period based on log frequency (values in [us])
 #define PAUSE_FACTOR          60UL
 #define PAUSE_RECOVERY        (PAUSE_FACTOR / 3 * 2)
@@ -52,8 +66,97 @@
   #define FILTER_RE_SYNTX     QRegExp::WildcardUnix
 #endif
 
+bool SyncManifest::load(const QString & folder)
+{
+  m_folder.setPath(folder);
+  m_entries.clear();
+  m_changed = false;
+
+  QFile file(path());
+  if (!file.open(QFile::ReadOnly | QFile::Text))
+    return false;
+
+  QTextStream in(&file);
+  in.setCodec("UTF-8");
+  if (in.readLine() != SYNC_MANIFEST_HEADER)
+    return false;
+
+  // size, modification time, hash, path (tab separated)
+  while (!in.atEnd()) {
+    const QStringList fields = in.readLine().split('\t');
+    if (fields.size() < 4)
+      continue;
+    m_entries.insert(fields.mid(3).join('\t'), { fields[0].toLongLong(), fields[1].toLongLong(), QByteArray::fromHex(fields[2].toLatin1()) });
+  }
+  return true;
+}
+
+QString SyncManifest::path() const
+{
+  return m_folder.absoluteFilePath(SYNC_MANIFEST_NAME);
+}
+
+bool SyncManifest::save(QString * error)
+{
+  if (!m_changed || !m_folder.exists())
+    return true;
+
+  QSaveFile file(path());
+  if (!file.open(QFile::WriteOnly | QFile::Text)) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+
+  QTextStream out(&file);
+  out.setCodec("UTF-8");
+  out << SYNC_MANIFEST_HEADER << "\n";
+  for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+    if (m_folder.exists(it.key()))  // forget deleted files
+      out << it->size << '\t' << it->modified << '\t' << it->hash.toHex() << '\t' << it.key() << '\n';
+  }
+  out.flush();
+  if (!file.commit()) {
+    if (error)
+      *error = file.errorString();
+    return false;
+  }
+
+  m_changed = false;
+  return true;
+}
+
+QByteArray SyncManifest::hash(const QFileInfo & fileInfo) const
+{
+  const auto it = m_entries.constFind(m_folder.relativeFilePath(fileInfo.absoluteFilePath()));
+  if (it == m_entries.constEnd() || it->size != fileInfo.size() || it->modified != fileInfo.lastModified().toMSecsSinceEpoch())
+    return QByteArray();
+  return it->hash;
+}
+
+void SyncManifest::setHash(const QFileInfo & fileInfo, const QByteArray & hash)
+{
+  m_entries.insert(m_folder.relativeFilePath(fileInfo.absoluteFilePath()), { fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch(), hash });
+  m_changed = true;
+}
+
+QByteArray SyncManifest::fileHash(const QString & path, QString * error)
+{
+  QFile file(path);
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  if (!file.open(QFile::ReadOnly) || !hash.addData(&file)) {
+    if (error)
+      *error = file.errorString();
+    return QByteArray();
+  }
+  return hash.result();
+}
+
 SyncProcess::SyncProcess(const SyncProcess::SyncOptions & options) :
   m_options(options),
+  m_srcManifest(nullptr),
+  m_dstManifest(nullptr),
+  m_copyQueueSize(0),
   m_pauseTime(PAUSE_MINTM),
   stopping(false)
 {
@@ -113,6 +216,8 @@ void SyncProcess::run()
 
   m_stat.clear();
   m_startTime = QDateTime::currentDateTime();
+  m_manifestA.load(folderA);
+  m_manifestB.load(folderB);
 
   emit started();
   emit fileCountChanged(0);
@@ -130,6 +235,8 @@ void SyncProcess::run()
       if (m_options.direction == SYNC_A2B_B2A)
         count *= 2;  // assume this direction is only 50% of total, exact will be calculated later
       emit fileCountChanged(count);
+      m_srcManifest = &m_manifestA;
+      m_dstManifest = &m_manifestB;
       updateDir(folderA, folderB);
       if (isStopRequsted())
         goto endrun;
@@ -151,6 +258,8 @@ void SyncProcess::run()
     emit fileCountChanged(m_stat.count);
 
     if (count) {
+      m_srcManifest = &m_manifestB;
+      m_dstManifest = &m_manifestA;
       updateDir(folderB, folderA);
     }
     else {
@@ -173,6 +282,15 @@ void SyncProcess::finish()
 {
   const lldiv_t elapsed = lldiv(m_startTime.secsTo(QDateTime::currentDateTime()), 60);
   QString endStr = testRunStr;
+
+  // a source only folder is left untouched
+  if (!(m_options.flags & OPT_DRY_RUN)) {
+    if (m_options.direction != SYNC_B2A)
+      saveManifest(m_manifestB);
+    if (m_options.direction != SYNC_A2B)
+      saveManifest(m_manifestA);
+  }
+
   if (m_stat.index < m_stat.count)
     endStr.append(tr("Synchronization aborted at %1 of %2 files.").arg(m_stat.index).arg(m_stat.count));
   else
@@ -181,8 +299,21 @@ void SyncProcess::finish()
   emit finished();
 }
 
+void SyncProcess::saveManifest(SyncManifest & manifest)
+{
+  QString error;
+  if (!manifest.save(&error)) {
+    PRINT_ERROR(tr("Could not save the synchronization manifest %1: %2").arg(manifest.path(), error));
+    ++m_stat.errored;
+    emit statusUpdate(m_stat);
+  }
+}
+
 SyncProcess::FileFilterResult SyncProcess::fileFilter(const QFileInfo & fileInfo)
 {
+  if (fileInfo.fileName() == SYNC_MANIFEST_NAME)
+    return FILE_EXCLUDE;
+
   // Windows Junctions (mount points) are not detected as links (QTBUG-45344), but that's OK since they're really "hard links."
   const bool chkDirLnk = ((m_dirFilters & QDir::NoSymLinks) && !(m_dirFilters & QDir::AllDirs)) || ((m_options.flags & OPT_SKIP_DIR_LINKS) && fileInfo.isDir());
   if ((chkDirLnk || ((m_dirFilters & QDir::NoSymLinks) && fileInfo.isFile())) && QFileInfo(fileInfo.absoluteFilePath()).isSymLink())  // MUST create a new QFileInfo here (QTBUG-69001)
@@ -248,6 +379,8 @@ void SyncProcess::updateDir(const QString & source, const QString & destination)
   emit statusMessage(testRunStr % tr("Synchronizing: %1\n    To: %2").arg(source, destination));
   PRINT_INFO(testRunStr % tr("Starting synchronization:\n  %1 -> %2\n").arg(source, destination));
 
+  hashFiles(source, destination);
+
   QFileInfoList infoList = dirInfoList(source);
   QMutableListIterator<QFileInfo> it(infoList);
   it.toBack();
@@ -288,6 +421,8 @@ void SyncProcess::updateDir(const QString & source, const QString & destination)
     pause();
   }
 
+  flushCopies();
+
   QString endStr = "\n" % testRunStr;
   if (isStopRequsted())
     endStr.append(tr("Aborted synchronization of:"));
@@ -336,8 +471,6 @@ bool SyncProcess::updateEntry(const QString & entry, const QDir & source, const
   }
 
   //qDebug() << destPath;
-  QFile sourceFile(srcPath);
-  QFile destinationFile(destPath);
   const bool destExists = destInfo.exists();
   bool checkDate = (m_options.compareType == OVERWR_NEWER_IF_DIFF || m_options.compareType == OVERWR_NEWER_ALWAYS);
   bool checkContent = (m_options.compareType == OVERWR_NEWER_IF_DIFF || m_options.compareType == OVERWR_IF_DIFF);
@@ -359,20 +492,24 @@ bool SyncProcess::updateEntry(const QString & entry, const QDir & source, const
   }
 
   if (destExists && checkContent) {
-    if (!sourceFile.open(QFile::ReadOnly)) {
-      PRINT_ERROR(tr("Could not open source file '%1': %2").arg(srcPath, sourceFile.errorString()));
-      ++m_stat.errored;
-      return false;
-    }
-    if (!destinationFile.open(QFile::ReadOnly)) {
-      PRINT_ERROR(tr("Could not open destination file '%1': %2").arg(destPath, destinationFile.errorString()));
-      ++m_stat.errored;
-      return false;
+    bool skip = false;
+    // files of different sizes don't need to be read
+    if (sourceInfo.size() == destInfo.size()) {
+      QString error;
+      const QByteArray srcHash = fileHash(*m_srcManifest, sourceInfo, error);
+      if (srcHash.isEmpty()) {
+        PRINT_ERROR(tr("Could not open source file '%1': %2").arg(srcPath, error));
+        ++m_stat.errored;
+        return false;
+      }
+      const QByteArray destHash = fileHash(*m_dstManifest, destInfo, error);
+      if (destHash.isEmpty()) {
+        PRINT_ERROR(tr("Could not open destination file '%1': %2").arg(destPath, error));
+        ++m_stat.errored;
+        return false;
+      }
+      skip = (srcHash == destHash);
     }
-
-    const bool skip = QCryptographicHash::hash(sourceFile.readAll(), QCryptographicHash::Md5) == QCryptographicHash::hash(destinationFile.readAll(), QCryptographicHash::Md5);
-    sourceFile.close();
-    destinationFile.close();
     if (skip) {
       PRINT_SKIP(tr("Skipping identical file: %1").arg(srcPath));
       ++m_stat.skipped;
@@ -385,28 +522,180 @@ bool SyncProcess::updateEntry(const QString & entry, const QDir & source, const
     if (destInfo.exists()) {
       existed = true;
       PRINT_REPLACE(tr("Replacing file: %1").arg(destPath));
-      if (!(m_options.flags & OPT_DRY_RUN) && !destinationFile.remove()) {
-        PRINT_ERROR(tr("Could not delete destination file '%1': %2").arg(destPath, destinationFile.errorString()));
-        ++m_stat.errored;
-        return false;
-      }
     }
     else {
       PRINT_CREATE(tr("Creating file: %1").arg(destPath));
     }
-    if (!(m_options.flags & OPT_DRY_RUN) && !sourceFile.copy(destPath)) {
-      PRINT_ERROR(tr("Copy failed: '%1' to '%2': %3").arg(srcPath, destPath, sourceFile.errorString()));
-      ++m_stat.errored;
-      return false;
+    if (!(m_options.flags & OPT_DRY_RUN)) {
+      queueCopy(srcPath, destPath, existed, sourceInfo.size());  // counted by flushCopies()
+    }
+    else if (existed) {
+      ++m_stat.updated;
+    }
+    else {
+      ++m_stat.created;
     }
+  }
+
+  return true;
+}
+
+// Hashes in parallel the files updateEntry() will have to compare and
+// which are not (or no longer) known by the manifests
+void SyncProcess::hashFiles(const QString & source, const QString & destination)
+{
+  struct HashJob {
+    SyncManifest * manifest;
+    QFileInfo fileInfo;
+    QByteArray hash;
+  };
+
+  const bool checkDate = (m_options.compareType == OVERWR_NEWER_IF_DIFF);
+  if (!checkDate && m_options.compareType != OVERWR_IF_DIFF)
+    return;
+
+  const QDir srcDir(source), dstDir(destination);
+  QVector<HashJob> jobs;
+
+  QFileInfoList infoList = dirInfoList(source);
+  QMutableListIterator<QFileInfo> it(infoList);
+  it.toBack();
+  while (it.hasPrevious() && !isStopRequsted()) {
+    const QFileInfo fi(it.previous());
+    it.remove();
+    if (fileFilter(fi) == FILE_ALLOW) {
+      pushDirEntries(fi, it);
+      const QFileInfo destInfo(dstDir.absoluteFilePath(srcDir.relativeFilePath(fi.filePath())));
+      if (fi.isFile() && destInfo.isFile() && fi.size() == destInfo.size() && (!checkDate || fi.lastModified() > destInfo.lastModified())) {
+        if (m_srcManifest->hash(fi).isEmpty())
+          jobs.append({ m_srcManifest, fi, QByteArray() });
+        if (m_dstManifest->hash(destInfo).isEmpty())
+          jobs.append({ m_dstManifest, destInfo, QByteArray() });
+      }
+    }
+    QApplication::processEvents();
+  }
+
+  HashJob * data = jobs.data();
+  runParallel(jobs.size(), SYNC_HASH_THREADS, [data](int i) {
+    data[i].hash = SyncManifest::fileHash(data[i].fileInfo.absoluteFilePath());
+  });
+
+  // errors are reported by updateEntry()
+  for (const HashJob & job : qAsConst(jobs)) {
+    if (!job.hash.isEmpty())
+      job.manifest->setHash(job.fileInfo, job.hash);
+  }
+}
+
+QByteArray SyncProcess::fileHash(SyncManifest & manifest, const QFileInfo & fileInfo, QString & error)
+{
+  QByteArray hash = manifest.hash(fileInfo);
+  if (hash.isEmpty()) {
+    hash = SyncManifest::fileHash(fileInfo.absoluteFilePath(), &error);
+    if (!hash.isEmpty())
+      manifest.setHash(fileInfo, hash);
+  }
+  return hash;
+}
 
-    if (existed)
+void SyncProcess::queueCopy(const QString & srcPath, const QString & destPath, bool existed, qint64 size)
+{
+  m_copyQueue.append({ srcPath, destPath, existed, false, QByteArray(), QString() });
+  m_copyQueueSize += size;
+  if (m_copyQueue.size() >= SYNC_COPY_BATCH || m_copyQueueSize >= SYNC_COPY_BATCH_SIZE)
+    flushCopies();
+}
+
+// Runs the queued copies, then reports them in the queue order
+void SyncProcess::flushCopies()
+{
+  CopyJob * jobs = m_copyQueue.data();
+  runParallel(m_copyQueue.size(), SYNC_COPY_THREADS, [jobs](int i) {
+    copyFile(jobs[i]);
+  });
+
+  for (const CopyJob & job : qAsConst(m_copyQueue)) {
+    if (!job.done)  // stopped
+      continue;
+    if (!job.error.isEmpty()) {
+      PRINT_ERROR(job.error);
+      ++m_stat.errored;
+      continue;
+    }
+    if (job.existed)
       ++m_stat.updated;
     else
       ++m_stat.created;
+    m_srcManifest->setHash(QFileInfo(job.srcPath), job.hash);
+    m_dstManifest->setHash(QFileInfo(job.destPath), job.hash);
   }
 
-  return true;
+  m_copyQueue.clear();
+  m_copyQueueSize = 0;
+  emit statusUpdate(m_stat);
+}
+
+// Copies a file and hashes its content on the way
+void SyncProcess::copyFile(CopyJob & job)
+{
+  QFile sourceFile(job.srcPath);
+  QFile destinationFile(job.destPath);
+  job.done = true;
+
+  if (job.existed && !destinationFile.remove()) {
+    job.error = tr("Could not delete destination file '%1': %2").arg(job.destPath, destinationFile.errorString());
+    return;
+  }
+  if (!sourceFile.open(QFile::ReadOnly) || !destinationFile.open(QFile::WriteOnly)) {
+    job.error = tr("Copy failed: '%1' to '%2': %3").arg(job.srcPath, job.destPath, sourceFile.isOpen() ? destinationFile.errorString() : sourceFile.errorString());
+    return;
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  QByteArray buffer(SYNC_COPY_BUFFER_SIZE, Qt::Uninitialized);
+  qint64 len;
+  while ((len = sourceFile.read(buffer.data(), buffer.size())) > 0) {
+    hash.addData(buffer.constData(), len);
+    if (destinationFile.write(buffer.constData(), len) != len)
+      break;
+  }
+  if (len != 0 || !destinationFile.flush()) {
+    job.error = tr("Copy failed: '%1' to '%2': %3").arg(job.srcPath, job.destPath, len < 0 ? sourceFile.errorString() : destinationFile.errorString());
+    destinationFile.close();
+    destinationFile.remove();
+    return;
+  }
+
+  destinationFile.close();
+  destinationFile.setPermissions(sourceFile.permissions());
+  job.hash = hash.result();
+}
+
+// Runs job(0) to job(count - 1) on up to 'threads' threads
+void SyncProcess::runParallel(int count, int threads, const std::function<void(int)> & job)
+{
+  std::atomic<int> next(0);
+  std::atomic<int> running(qMin(count, threads));
+  std::vector<std::thread> workers;
+
+  for (int t = running; t > 0; t--) {
+    workers.emplace_back([&]() {
+      int i;
+      while (!isStopRequsted() && (i = next++) < count)
+        job(i);
+      --running;
+    });
+  }
+
+  // keep the UI responsive meanwhile
+  while (running > 0) {
+    QApplication::processEvents();
+    QThread::msleep(5);
+  }
+
+  for (std::thread & worker : workers)
+    worker.join();
 }
 
 void SyncProcess::pause()
@@ -26,10 +26,45 @@
 #include <QDebug>
 #include <QDir>
 #include <QDirIterator>
+#include <QHash>
 #include <QReadWriteLock>
 #include <QRegExp>
 #include <QVector>
 
+#include <functional>
+
+#define SYNC_MANIFEST_NAME    ".companion-sync"
+
+// Size, modification time and content hash of the files of a synchronized
+// folder, saved in the folder between runs: a file whose size and time did
+// not change is not read again to be compared. Only the folders written to
+// by a synchronization get a manifest.
+class SyncManifest
+{
+  public:
+    bool load(const QString & folder);
+    bool save(QString * error = nullptr);
+    QString path() const;
+
+    // cached hash, empty if unknown or if the file changed since
+    QByteArray hash(const QFileInfo & fileInfo) const;
+    void setHash(const QFileInfo & fileInfo, const QByteArray & hash);
+
+    // streaming hash of a file, empty on error
+    static QByteArray fileHash(const QString & path, QString * error = nullptr);
+
+  protected:
+    struct Entry {
+      qint64 size;
+      qint64 modified;
+      QByteArray hash;
+    };
+
+    QDir m_folder;
+    QHash<QString, Entry> m_entries;
+    bool m_changed = false;
+};
+
 class SyncProcess : public QObject
 {
     Q_OBJECT
@@ -123,14 +158,30 @@ class SyncProcess : public QObject
   protected:
     enum FileFilterResult { FILE_ALLOW, FILE_OVERSIZE, FILE_EXCLUDE, FILE_LINK_IGNORE };
 
+    struct CopyJob {
+      QString srcPath;
+      QString destPath;
+      bool existed;
+      bool done;
+      QByteArray hash;
+      QString error;
+    };
+
     bool isStopRequsted();
     void finish();
+    void saveManifest(SyncManifest & manifest);
     FileFilterResult fileFilter(const QFileInfo & fileInfo);
     QFileInfoList dirInfoList(const QString & directory);
     int getFilesCount(const QString & directory);
     void updateDir(const QString & source, const QString & destination);
     void pushDirEntries(const QFileInfo & fi, QMutableListIterator<QFileInfo> &it);
     bool updateEntry(const QString & entry, const QDir & source, const QDir & destination);
+    void hashFiles(const QString & source, const QString & destination);
+    QByteArray fileHash(SyncManifest & manifest, const QFileInfo & fileInfo, QString & error);
+    void queueCopy(const QString & srcPath, const QString & destPath, bool existed, qint64 size);
+    void flushCopies();
+    static void copyFile(CopyJob & job);
+    void runParallel(int count, int threads, const std::function<void(int)> & job);
     void pause();
     void emitProgressMessage(const QString &text, int type);
 
@@ -142,6 +193,12 @@ class SyncProcess : public QObject
     QStringList m_dirIteratorFilters;
     QDir::Filters m_dirFilters;
     QDateTime m_startTime;
+    SyncManifest m_manifestA;
+    SyncManifest m_manifestB;
+    SyncManifest * m_srcManifest;
+    SyncManifest * m_dstManifest;
+    QVector<CopyJob> m_copyQueue;
+    qint64 m_copyQueueSize;
     unsigned long m_pauseTime;
     bool stopping;
 };
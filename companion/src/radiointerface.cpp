@@ -210,6 +210,7 @@ bool readSettingsSDCard(const QString & filename, ProgressWidget * progress)
 
   RadioData radioData;
   Storage inputStorage(radioPath);
+  inputStorage.setProgress(progress);
   if (!inputStorage.load(radioData)) {
     QString errorMsg = inputStorage.error();
     if (errorMsg.isEmpty()) {
@@ -41,7 +41,8 @@ SimulatedUIWidget::SimulatedUIWidget(SimulatorInterface * simulator, QWidget * p
   m_board(getCurrentBoard()),
   m_backLight(0),
   m_beepShow(0),
-  m_beepVal(0)
+  m_beepVal(0),
+  m_lcdStale(true)
 {
   m_screenshotAction = new RadioUiAction(-1, Qt::Key_Print);
   connect(m_screenshotAction, static_cast<void (RadioUiAction::*)(void)>(&RadioUiAction::pushed), this, &SimulatedUIWidget::captureScreenshot);
@@ -129,11 +130,23 @@ void SimulatedUIWidget::updateUi()
 
 void SimulatedUIWidget::onLcdChange(bool backlightEnable)
 {
-  if (!m_lcd || !m_lcd->isVisible())
+  // always read the changed areas, the simulator waits for it before
+  // signaling the next changes
+  QVector<QRect> rects = m_simulator->getLcdDirtyRects();
+
+  if (!m_lcd || !m_lcd->isVisible()) {
+    m_lcdStale = true;
     return;
+  }
+
+  // areas changed while hidden are unknown: whole screen
+  if (m_lcdStale) {
+    rects.clear();
+    m_lcdStale = false;
+  }
 
   uint8_t* lcdBuf = m_simulator->getLcd();
-  m_lcd->onLcdChanged(lcdBuf, backlightEnable);
+  m_lcd->onLcdChanged(lcdBuf, backlightEnable, rects);
   m_simulator->lcdFlushed();
 
   setLightOn(backlightEnable);
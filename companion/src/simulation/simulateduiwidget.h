@@ -97,6 +97,7 @@ class SimulatedUIWidget : public QWidget
     unsigned int m_backLight;
     int m_beepShow;
     int m_beepVal;
+    bool m_lcdStale;
 };
 
 
@@ -33,6 +33,8 @@
 #include <QDir>
 #include <QLibrary>
 #include <QMap>
+#include <QRect>
+#include <QVector>
 
 #define SIMULATOR_INTERFACE_HEARTBEAT_PERIOD    1000  // ms
 
@@ -124,6 +126,9 @@ class SimulatorInterface : public QObject
     virtual bool isRunning() = 0;
     virtual void readRadioData(QByteArray & dest) = 0;
     virtual uint8_t * getLcd() = 0;
+    // LCD areas changed since the previous call, lcdChange() is not
+    // emitted again until they have been read
+    virtual QVector<QRect> getLcdDirtyRects() = 0;
     virtual uint8_t getSensorInstance(uint16_t id, uint8_t defaultValue = 0) = 0;
     virtual uint16_t getSensorRatio(uint16_t id) = 0;
     virtual const int getCapability(Capability cap) = 0;
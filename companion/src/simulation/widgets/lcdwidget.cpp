@@ -33,6 +33,14 @@ void LcdWidget::setData(int width, int height, int depth)
 
   localBuf = (unsigned char *)malloc(lcdSize);
   memset(localBuf, 0, lcdSize);
+
+  // both formats have the same layout as the radio frame buffer
+  if (depth == 16)
+    image = QImage(localBuf, width, height, width * 2, QImage::Format_RGB16);
+  else if (depth == 12)
+    image = QImage(localBuf, width, height, width * 2, QImage::Format_RGB444);
+  else
+    image = QImage();
 }
 
 void LcdWidget::setBgDefaultColor(const QColor &color)
@@ -69,18 +77,64 @@ void LcdWidget::makeScreenshot(const QString &fileName)
   }
 }
 
-void LcdWidget::onLcdChanged(uint8_t* lcdBuf, bool light)
+void LcdWidget::onLcdChanged(uint8_t* lcdBuf, bool light,
+                             const QVector<QRect>& rects)
 {
   QMutexLocker locker(&lcdMtx);
-  lightEnable = light;
-  if (lcdBuf) memcpy(localBuf, lcdBuf, lcdSize);
+  const QRect screen(0, 0, lcdWidth, lcdHeight);
+
+  if (light != lightEnable) {
+    lightEnable = light;
+    dirtyRegion += rect();
+  }
+
+  if (lcdBuf) {
+    if (image.isNull() || rects.isEmpty()) {
+      memcpy(localBuf, lcdBuf, lcdSize);
+      dirtyRegion += rect();
+    } else {
+      // only the changed lines of each area
+      for (const QRect& area : rects) {
+        QRect r = area.intersected(screen);
+        if (r.isEmpty()) continue;
+        for (int y = r.top(); y <= r.bottom(); y++) {
+          int offset = (y * lcdWidth + r.left()) * 2;
+          memcpy(localBuf + offset, lcdBuf + offset, r.width() * 2);
+        }
+        dirtyRegion += r;
+      }
+    }
+  }
+
   if (!redrawTimer.isValid() ||
       redrawTimer.hasExpired(LCD_WIDGET_REFRESH_PERIOD)) {
-    update();
-    redrawTimer.start();
+    flushDirtyRegion();
+  } else if (!flushPending) {
+    // changes are not dropped, only delayed to the next refresh period
+    flushPending = true;
+    QTimer::singleShot(
+        LCD_WIDGET_REFRESH_PERIOD - redrawTimer.elapsed(), this, [this]() {
+          QMutexLocker locker(&lcdMtx);
+          flushPending = false;
+          flushDirtyRegion();
+        });
   }
 }
 
+void LcdWidget::flushDirtyRegion()
+{
+  if (dirtyRegion.isEmpty()) return;
+
+  // 1 and 4 bits displays are painted twice as large
+  if (image.isNull())
+    update();
+  else
+    update(dirtyRegion);
+
+  dirtyRegion = QRegion();
+  redrawTimer.start();
+}
+
 void LcdWidget::doPaint(QPainter &p)
 {
   QRgb rgb;
@@ -88,28 +142,8 @@ void LcdWidget::doPaint(QPainter &p)
 
   if (!localBuf) return;
 
-  if (lcdDepth == 16) {
-    for (int x = 0; x < lcdWidth; x++) {
-      for (int y = 0; y < lcdHeight; y++) {
-        z = ((uint16_t *)localBuf)[y * lcdWidth + x];
-        rgb = qRgb(255 * ((z & 0xF800) >> 11) / 0x1F,
-                   255 * ((z & 0x07E0) >> 5) / 0x3F, 255 * (z & 0x001F) / 0x1F);
-        p.setPen(rgb);
-        p.drawPoint(x, y);
-      }
-    }
-    return;
-  }
-  if (lcdDepth == 12) {
-    for (int x = 0; x < lcdWidth; x++) {
-      for (int y = 0; y < lcdHeight; y++) {
-        z = ((uint16_t *)localBuf)[y * lcdWidth + x];
-        rgb = qRgb(255 * ((z & 0xF00) >> 8) / 0x0F,
-                   255 * ((z & 0x0F0) >> 4) / 0x0F, 255 * (z & 0x00F) / 0x0F);
-        p.setPen(rgb);
-        p.drawPoint(x, y);
-      }
-    }
+  if (!image.isNull()) {
+    p.drawImage(0, 0, image);
     return;
   }
 
@@ -155,9 +189,15 @@ void LcdWidget::doPaint(QPainter &p)
   }
 }
 
-void LcdWidget::paintEvent(QPaintEvent *)
+void LcdWidget::paintEvent(QPaintEvent *event)
 {
   QPainter p(this);
+  if (!image.isNull()) {
+    // only the areas which changed
+    const QRect area = event->rect();
+    p.drawImage(area, image, area);
+    return;
+  }
   doPaint(p);
 }
 
@@ -26,9 +26,12 @@
 #include <QClipboard>
 #include <QDir>
 #include <QElapsedTimer>
+#include <QImage>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QMouseEvent>
+#include <QRegion>
+#include <QTimer>
 #include <AppDebugMessageHandler>
 
 #include "appdata.h"
@@ -46,6 +49,7 @@ class LcdWidget : public QWidget
       QWidget(parent),
       localBuf(NULL),
       lightEnable(false),
+      flushPending(false),
       bgDefaultColor(QColor(198, 208, 199)),
       fgDefaultColor(QColor(0, 0, 0))
   {
@@ -65,7 +69,9 @@ class LcdWidget : public QWidget
 
   void makeScreenshot(const QString &fileName);
 
-  void onLcdChanged(uint8_t* lcdBuf, bool light);
+  // 'rects': areas of 'lcdBuf' which changed, the whole screen if empty
+  void onLcdChanged(uint8_t* lcdBuf, bool light,
+                    const QVector<QRect>& rects = QVector<QRect>());
 
  signals:
   void touchEvent(int type, int x, int y);
@@ -77,8 +83,11 @@ class LcdWidget : public QWidget
   int lcdSize;
 
   unsigned char *localBuf;
+  QImage image;  // localBuf, for 12 and 16 bits displays
 
   bool lightEnable;
+  bool flushPending;
+  QRegion dirtyRegion;
   QColor bgColor;
   QColor bgDefaultColor;
   QColor fgDefaultColor;
@@ -86,6 +95,7 @@ class LcdWidget : public QWidget
   QElapsedTimer redrawTimer;
 
   void doPaint(QPainter &p);
+  void flushDirtyRegion();
 
   void paintEvent(QPaintEvent *) override;
 
@@ -19,9 +19,10 @@
  */
 
 #include "etx.h"
-#include <QFile>
+#include "firmwares/edgetx/edgetxinterface.h"
 
-#define MZ_ALLOCATION_SIZE    (32*1024)
+#include <QFile>
+#include <QSaveFile>
 
 bool EtxFormat::load(RadioData & radioData)
 {
@@ -32,13 +33,10 @@ bool EtxFormat::load(RadioData & radioData)
     return false;
   }
 
-  QByteArray archiveContents = file.readAll();
-
-  qDebug() << "File" << filename << "read, size:" << archiveContents.size();
+  qDebug() << "File" << filename << "opened, size:" << file.size();
 
-  // open zip file
-  memset(&zip_archive, 0, sizeof(zip_archive));
-  if (!mz_zip_reader_init_mem(&zip_archive, archiveContents.data(), archiveContents.size(), 0)) {
+  // open zip file, the entries are extracted when needed
+  if (!MinizInterface::initReader(&zip_archive, &file)) {
     qDebug() << tr("Error opening EdgeTX archive %1").arg(filename);
     return false;
   }
@@ -48,51 +46,95 @@ bool EtxFormat::load(RadioData & radioData)
   return result;
 }
 
+bool EtxFormat::loadModel(ModelData & model, const QString & modelFile)
+{
+  QFile file(filename);
+
+  if (!file.open(QFile::ReadOnly)) {
+    setError(tr("Error opening file %1:\n%2.").arg(filename).arg(file.errorString()));
+    return false;
+  }
+
+  if (!MinizInterface::initReader(&zip_archive, &file)) {
+    setError(tr("Error opening EdgeTX archive %1").arg(filename));
+    return false;
+  }
+
+  QByteArray modelBuffer;
+  bool result = loadFile(modelBuffer, "MODELS/" + modelFile);
+  mz_zip_reader_end(&zip_archive);
+
+  if (!result) {
+    setError(tr("Cannot extract ") + modelFile);
+    return false;
+  }
+
+  try {
+    result = loadModelFromYaml(model, modelBuffer);
+  } catch(const std::runtime_error& e) {
+    setError(tr("Cannot load ") + modelFile + ":\n" + QString(e.what()));
+    return false;
+  }
+
+  if (!result) {
+    setError(tr("Cannot load ") + modelFile);
+    return false;
+  }
+
+  strncpy(model.filename, qPrintable(modelFile), sizeof(model.filename) - 1);
+  model.used = true;
+  return true;
+}
+
 bool EtxFormat::write(const RadioData & radioData)
 {
   qDebug() << "Saving to archive" << filename;
 
-  memset(&zip_archive, 0, sizeof(zip_archive));
-  if (!mz_zip_writer_init_heap(&zip_archive, 0, MZ_ALLOCATION_SIZE)) {
+  // the file is only replaced once the archive is complete
+  QSaveFile file(filename);
+  if (!file.open(QIODevice::WriteOnly)) {
+    setError(tr("Error creating EdgeTX file %1:\n%2.").arg(filename).arg(file.errorString()));
+    return false;
+  }
+
+  if (!MinizInterface::initWriter(&zip_archive, &file)) {
     setError(tr("Error initializing EdgeTX archive writer"));
     return false;
   }
 
+  entries.clear();
   bool result = LabelsStorageFormat::write(radioData);
   if (result) {
-    // finalize archive and get contents
-    char * archiveContents;
-    size_t archiveSize;
-    if (mz_zip_writer_finalize_heap_archive(&zip_archive, (void **)&archiveContents, &archiveSize)) {
-      qDebug() << "Archive size" << archiveSize;
-      // write contents to file
-      QFile file(filename);
-      if (file.open(QIODevice::WriteOnly)) {
-        qint64 len = file.write(archiveContents, archiveSize);
-        if (len != (qint64)archiveSize) {
-          setError(tr("Error writing file %1:\n%2.").arg(filename).arg(file.errorString()));
-          result = false;
-        }
-      }
-      else {
-        setError(tr("Error creating EdgeTX file %1:\n%2.").arg(filename).arg(file.errorString()));
+    MinizInterface::compressEntries(entries);
+    for (const MinizInterface::ZipEntry & entry : qAsConst(entries)) {
+      if (!MinizInterface::addEntry(&zip_archive, entry)) {
+        setError(tr("Error adding %1 to EdgeTX archive").arg(entry.name));
         result = false;
+        break;
       }
     }
-    else {
-      setError(tr("Error creating EdgeTX archive"));
-      result = false;
-    }
+  }
+
+  if (result && !mz_zip_writer_finalize_archive(&zip_archive)) {
+    setError(tr("Error creating EdgeTX archive"));
+    result = false;
   }
 
   mz_zip_writer_end(&zip_archive);
+  entries.clear();
+
+  if (result && !file.commit()) {
+    setError(tr("Error writing file %1:\n%2.").arg(filename).arg(file.errorString()));
+    result = false;
+  }
+
   return result;
 }
 
 bool EtxFormat::loadFile(QByteArray & filedata, const QString & filename)
 {
   size_t size;
-  void * data = mz_zip_reader_extract_file_to_heap(&zip_archive, qPrintable(filename), &size, 0);
+  void * data = mz_zip_reader_extract_file_to_heap(&zip_archive, filename.toUtf8().constData(), &size, 0);
   if (!data) {
     return false;
   }
@@ -106,16 +148,21 @@ bool EtxFormat::loadFile(QByteArray & filedata, const QString & filename)
 
 bool EtxFormat::writeFile(const QByteArray & filedata, const QString & filename)
 {
-  if (!mz_zip_writer_add_mem(&zip_archive, filename.toStdString().c_str(), filedata.data(), filedata.size(), MZ_DEFAULT_LEVEL)) {
-    setError(tr("Error adding %1 to EdgeTX archive").arg(filename));
-    return false;
-  }
-
+  MinizInterface::ZipEntry entry;
+  entry.name = filename;
+  entry.data = filedata;
+  entries.append(entry);
   return true;
 }
 
 bool EtxFormat::getFileList(std::list<std::string>& filelist)
 {
+  if (zip_archive.m_zip_mode == MZ_ZIP_MODE_WRITING) {
+    for (const MinizInterface::ZipEntry & entry : qAsConst(entries))
+      filelist.push_back(entry.name.toStdString());
+    return !entries.isEmpty();
+  }
+
   int count = (int)mz_zip_reader_get_num_files(&zip_archive);
   if (count == 0) return false;
 
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "labeled.h"
+#include "minizinterface.h"
 
 #include <QtCore>
 
@@ -38,6 +39,10 @@ class EtxFormat : public LabelsStorageFormat
     virtual bool load(RadioData & radioData);
     virtual bool write(const RadioData & radioData);
 
+    // Reads a single model (e.g. "model05.yml") without extracting the
+    // other files of the archive
+    bool loadModel(ModelData & model, const QString & modelFile);
+
   protected:
     virtual bool loadFile(QByteArray & fileData, const QString & fileName);
     virtual bool writeFile(const QByteArray & fileData, const QString & fileName);
@@ -45,4 +50,6 @@ class EtxFormat : public LabelsStorageFormat
     virtual bool deleteFile(const QString & fileName) { return false; }
 
     mz_zip_archive zip_archive;
+    // written files, compressed in parallel and added by write()
+    QVector<MinizInterface::ZipEntry> entries;
 };
@@ -21,8 +21,89 @@
 #include "labeled.h"
 #include "firmwares/opentx/opentxinterface.h"
 #include "firmwares/edgetx/edgetxinterface.h"
+#include "progresswidget.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <regex>
+#include <thread>
+
+// A model file to be decoded by the YAML loading threads
+struct YamlModelJob {
+  std::string filename;
+  QString path;
+  QByteArray buffer;
+  int modelIdx;
+  bool loaded;
+  bool confirm;     // newer settings version, to be loaded from this thread
+  QString error;
+};
+
+// Decodes the models in parallel, in any order: each job has its own
+// ModelData. Returns when all the jobs are done, updating the progress
+// from the calling thread meanwhile.
+static void decodeYamlModels(std::vector<YamlModelJob> & jobs,
+                             RadioData & radioData, int threadCount,
+                             ProgressWidget * progress)
+{
+  std::atomic<int> next(0);
+  std::atomic<int> done(0);
+  std::mutex mutex;
+  std::condition_variable finished;
+
+  auto worker = [&]() {
+    int i;
+    while ((i = next++) < (int)jobs.size()) {
+      YamlModelJob & job = jobs[i];
+      try {
+        job.loaded = loadModelFromYamlUnattended(radioData.models[job.modelIdx],
+                                                 job.buffer, job.confirm);
+      } catch(const std::runtime_error& e) {
+        job.loaded = false;
+        job.error = QString(e.what());
+      }
+      if (!job.confirm) {
+        job.buffer.clear();
+      }
+      if (++done == (int)jobs.size()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.notify_one();
+      }
+    }
+  };
+
+  if (threadCount <= 0) {
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threadCount = std::min(threadCount, (int)jobs.size());
+
+  if (threadCount <= 1) {
+    worker();
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threadCount; i++) {
+    threads.emplace_back(worker);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (done < (int)jobs.size()) {
+      finished.wait_for(lock, std::chrono::milliseconds(50));
+      if (progress) {
+        progress->setValue(done);
+      }
+    }
+  }
+
+  for (auto & thread: threads) {
+    thread.join();
+  }
+}
 
 bool LabelsStorageFormat::load(RadioData & radioData)
 {
@@ -259,13 +340,18 @@ bool LabelsStorageFormat::loadYaml(RadioData & radioData)
   if (hasLabels)
     radioData.models.resize(modelFiles.size());
 
+  // Files are read from this thread (the archive can't be shared) and the
+  // models decoded in parallel, then set in the files order
+  std::vector<YamlModelJob> jobs;
+  std::vector<bool> slotUsed(radioData.models.size(), false);
+
   for (const auto& mc : modelFiles) {
     qDebug() << "Filename: " << mc.filename.c_str();
 
     if (!hasLabels) {
       if (mc.modelIdx >= 0 && mc.modelIdx < (int)radioData.models.size()) {
         modelIdx = mc.modelIdx;
-        if (!radioData.models[modelIdx].isEmpty()) {
+        if (slotUsed[modelIdx] || !radioData.models[modelIdx].isEmpty()) {
           qDebug() << QString("Warning: file %1 skipped as slot %2 already used").arg(mc.filename.c_str()).arg(mc.modelIdx + 1);
           continue;
         }
@@ -276,38 +362,62 @@ bool LabelsStorageFormat::loadYaml(RadioData & radioData)
       }
     }
 
-    QByteArray modelBuffer;
-    QString filename = "MODELS/" + QString::fromStdString(mc.filename);
-    if (!loadFile(modelBuffer, filename)) {
-      setError(tr("Cannot extract ") + filename);
+    YamlModelJob job = { mc.filename, "MODELS/" + QString::fromStdString(mc.filename), QByteArray(), modelIdx, false, false, QString() };
+    if (!loadFile(job.buffer, job.path)) {
+      setError(tr("Cannot extract ") + job.path);
       return false;
     }
 
-    // Please note:
-    //  ModelData() use memset to clear everything to 0
-    //
-    auto& model = radioData.models[modelIdx];
+    jobs.push_back(std::move(job));
+    slotUsed[modelIdx] = true;
+    modelIdx++;
+  }
+
+  if (progress) {
+    progress->setInfo(tr("Loading models"));
+    progress->setMaximum(jobs.size());
+    progress->setValue(0);
+  }
 
-    try {
-      if (!loadModelFromYaml(model,modelBuffer)) {
-        setError(tr("Cannot load ") + filename);
-        return false;
+  // Please note:
+  //  ModelData() use memset to clear everything to 0
+  //
+  decodeYamlModels(jobs, radioData, threadCount, progress);
+
+  if (progress) {
+    progress->setValue(jobs.size());
+  }
+
+  for (auto& job : jobs) {
+    auto& model = radioData.models[job.modelIdx];
+
+    if (job.confirm) {
+      // newer settings version: the user is asked first
+      try {
+        job.loaded = loadModelFromYaml(model, job.buffer);
+      } catch(const std::runtime_error& e) {
+        job.loaded = false;
+        job.error = QString(e.what());
       }
-    } catch(const std::runtime_error& e) {
-      setError(tr("Cannot load ") + filename + ":\n" + QString(e.what()));
+    }
+
+    if (!job.loaded) {
+      if (job.error.isEmpty())
+        setError(tr("Cannot load ") + job.path);
+      else
+        setError(tr("Cannot load ") + job.path + ":\n" + job.error);
       return false;
     }
 
-    model.modelIndex = modelIdx;
-    strncpy(model.filename, mc.filename.c_str(), sizeof(model.filename)-1);
+    model.modelIndex = job.modelIdx;
+    strncpy(model.filename, job.filename.c_str(), sizeof(model.filename)-1);
 
     if (hasLabels && !strncmp(radioData.generalSettings.currModelFilename,
                                   model.filename, sizeof(model.filename))) {
-      radioData.generalSettings.currModelIndex = modelIdx;
+      radioData.generalSettings.currModelIndex = job.modelIdx;
     }
 
     model.used = true;
-    modelIdx++;
   }
 
   // Add the labels in the models
@@ -40,7 +40,15 @@ class LabelsStorageFormat : public StorageFormat
     virtual bool load(RadioData & radioData);
     virtual bool write(const RadioData & radioData);
 
+    // Threads decoding the YAML models, 0 = one per CPU core
+    void setThreadCount(int count)
+    {
+      threadCount = count;
+    }
+
   protected:
+    int threadCount = 0;
+
     virtual bool loadFile(QByteArray & fileData, const QString & fileName) = 0;
     virtual bool writeFile(const QByteArray & fileData, const QString & fileName) = 0;
     virtual bool getFileList(std::list<std::string>& filelist) = 0;
@@ -0,0 +1,489 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "logdata.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+// Smaller files are parsed by a single thread (threads = 0)
+#define LOG_PARALLEL_MIN_SIZE (4 * 1024 * 1024)
+
+struct LogData::Chunk {
+  qint64 begin;
+  qint64 end;
+  std::vector<Row> rows;
+  std::vector<std::vector<double>> columns;
+  std::vector<double> times;
+  int lines = 0;
+  int errors = 0;
+};
+
+static inline bool isSpace(char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline void trim(const char *& begin, const char *& end)
+{
+  while (begin < end && isSpace(*begin)) begin++;
+  while (end > begin && isSpace(end[-1])) end--;
+}
+
+// Same result as QString::toDouble() (0 if not a number). Plain decimal
+// numbers which can be converted exactly (mantissa < 2^53, at most 22
+// decimals) are converted here, the other ones by Qt.
+static double toDouble(const char * begin, const char * end)
+{
+  static const double powers[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+
+  trim(begin, end);
+
+  const char * p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  quint64 mantissa = 0;
+  int digits = 0;
+  int decimals = -1;
+  for (; p < end; p++) {
+    if (*p >= '0' && *p <= '9') {
+      mantissa = mantissa * 10 + (*p - '0');
+      if (decimals >= 0) decimals++;
+      if (++digits > 18) break;
+    }
+    else if (*p == '.' && decimals < 0) {
+      decimals = 0;
+    }
+    else {
+      break;
+    }
+  }
+
+  if (p == end && digits > 0 && mantissa < (1ull << 53) && decimals <= 22) {
+    double value = (double)mantissa;
+    if (decimals > 0) value /= powers[decimals];
+    return negative ? -value : value;
+  }
+
+  bool ok;
+  double value = QByteArray::fromRawData(begin, end - begin).toDouble(&ok);
+  return ok ? value : 0;
+}
+
+static inline bool parseDigits(const char * p, int count, int & value)
+{
+  value = 0;
+  for (int i = 0; i < count; i++) {
+    if (p[i] < '0' || p[i] > '9') return false;
+    value = value * 10 + (p[i] - '0');
+  }
+  return true;
+}
+
+// Record time as the previous implementation computed it:
+//   QDateTime::fromString(date + " " + time).toTime_t() + decimals
+// The local time of the beginning of each hour is converted by Qt, and
+// kept in 'hourKey' / 'hourTime' for the next records.
+static double parseTime(const char * date, int dateLen, const char * time,
+                        int timeLen, int & hourKey, double & hourTime)
+{
+  int year, month, day, hour, minute, second;
+  if (dateLen == 10 && date[4] == '-' && date[7] == '-' &&
+      parseDigits(date, 4, year) && parseDigits(date + 5, 2, month) &&
+      parseDigits(date + 8, 2, day) && timeLen >= 8 && time[2] == ':' &&
+      time[5] == ':' && (timeLen == 8 || time[8] == '.') &&
+      parseDigits(time, 2, hour) && parseDigits(time + 3, 2, minute) &&
+      parseDigits(time + 6, 2, second) && hour < 24 && minute < 60 &&
+      second < 60 && QDate::isValid(year, month, day)) {
+    int key = ((year * 13 + month) * 32 + day) * 24 + hour;
+    if (key != hourKey) {
+      hourKey = key;
+      hourTime = QDateTime(QDate(year, month, day), QTime(hour, 0)).toTime_t();
+    }
+    double result = hourTime + minute * 60 + second;
+    if (timeLen > 8) result += toDouble(time + 8, time + timeLen);
+    return result;
+  }
+
+  QString timeStr = QString::fromUtf8(time, timeLen);
+  QString str = QString::fromUtf8(date, dateLen) + " " + timeStr;
+  double result;
+  if (timeStr.contains('.')) {
+    result = QDateTime::fromString(str, "yyyy-MM-dd HH:mm:ss.zzz").toTime_t();
+    result += timeStr.mid(timeStr.indexOf('.')).toDouble();
+  }
+  else {
+    result = QDateTime::fromString(str, "yyyy-MM-dd HH:mm:ss").toTime_t();
+  }
+  return result;
+}
+
+void LogData::parse(Chunk & chunk) const
+{
+  const int numFields = header.size();
+  std::vector<const char *> fieldBegin(numFields + 1);
+  int hourKey = -1;
+  double hourTime = 0;
+
+  chunk.columns.resize(numFields);
+
+  qint64 pos = chunk.begin;
+  while (pos < chunk.end) {
+    const char * begin = data + pos;
+    const char * nl = (const char *)memchr(begin, '\n', chunk.end - pos);
+    const char * end = nl ? nl : data + chunk.end;
+    pos = (nl ? nl + 1 : end) - data;
+
+    chunk.lines++;
+    trim(begin, end);
+
+    // split
+    int count = 0;
+    fieldBegin[count++] = begin;
+    for (const char * p = begin; p < end; p++) {
+      if (*p == ',') {
+        if (count == numFields) {
+          count++;
+          break;
+        }
+        fieldBegin[count++] = p + 1;
+      }
+    }
+    if (count != numFields) {
+      chunk.errors++;
+      continue;
+    }
+    fieldBegin[numFields] = end + 1;
+
+    chunk.rows.push_back({begin - data, (int)(end - begin)});
+    chunk.times.push_back(parseTime(fieldBegin[0],
+                                    fieldBegin[1] - fieldBegin[0] - 1,
+                                    fieldBegin[1],
+                                    fieldBegin[2] - fieldBegin[1] - 1,
+                                    hourKey, hourTime));
+    for (int i = 2; i < numFields; i++) {
+      chunk.columns[i].push_back(toDouble(fieldBegin[i], fieldBegin[i + 1] - 1));
+    }
+  }
+}
+
+bool LogData::load(const QString & filename, int threads)
+{
+  clear();
+
+  file.setFileName(filename);
+  if (!file.open(QIODevice::ReadOnly)) {
+    error = file.errorString();
+    return false;
+  }
+
+  size = file.size();
+  if (size > 0) {
+    data = (const char *)file.map(0, size);
+  }
+  if (!data) {
+    buffer = file.readAll();
+    data = buffer.constData();
+    size = buffer.size();
+  }
+
+  const char * nl = (const char *)memchr(data, '\n', size);
+  qint64 dataBegin = nl ? nl - data + 1 : size;
+  QByteArray headerLine = QByteArray::fromRawData(data, dataBegin).trimmed();
+  if (!headerLine.startsWith("Date,Time")) {
+    clear();
+    error = tr("Not a telemetry log");
+    return false;
+  }
+  header = QString::fromUtf8(headerLine).split(',');
+
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+    if (size - dataBegin < LOG_PARALLEL_MIN_SIZE) {
+      threads = 1;
+    }
+  }
+
+  // chunks start at the beginning of a line
+  std::vector<Chunk> chunks(threads);
+  qint64 begin = dataBegin;
+  for (int i = 0; i < threads; i++) {
+    qint64 end = dataBegin + (size - dataBegin) * (i + 1) / threads;
+    if (end < begin) end = begin;
+    if (end < size) {
+      nl = (const char *)memchr(data + end, '\n', size - end);
+      end = nl ? nl - data + 1 : size;
+    }
+    chunks[i].begin = begin;
+    chunks[i].end = end;
+    begin = end;
+  }
+
+  if (threads > 1) {
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+      workers.emplace_back(&LogData::parse, this, std::ref(chunks[i]));
+    }
+    parse(chunks[0]);
+    for (auto & worker: workers) {
+      worker.join();
+    }
+  }
+  else {
+    parse(chunks[0]);
+  }
+
+  // merge
+  size_t count = 0;
+  for (const auto & chunk: chunks) {
+    count += chunk.rows.size();
+    lines += chunk.lines;
+    errors += chunk.errors;
+  }
+
+  rows.reserve(count);
+  times.reserve(count);
+  columns.resize(header.size());
+  for (int i = 2; i < header.size(); i++) {
+    columns[i].reserve(count);
+  }
+
+  for (auto & chunk: chunks) {
+    rows.insert(rows.end(), chunk.rows.begin(), chunk.rows.end());
+    times.insert(times.end(), chunk.times.begin(), chunk.times.end());
+    for (int i = 2; i < header.size(); i++) {
+      columns[i].insert(columns[i].end(), chunk.columns[i].begin(),
+                        chunk.columns[i].end());
+    }
+    chunk = Chunk();
+  }
+
+  if (rows.empty()) {
+    int invalid = errors;
+    clear();
+    errors = invalid;
+    error = tr("No data");
+    return false;
+  }
+
+  return true;
+}
+
+void LogData::clear()
+{
+  if (data && data != buffer.constData()) {
+    file.unmap((uchar *)data);
+  }
+  file.close();
+  buffer.clear();
+  data = nullptr;
+  size = 0;
+  header.clear();
+  rows.clear();
+  rows.shrink_to_fit();
+  columns.clear();
+  times.clear();
+  times.shrink_to_fit();
+  lines = 0;
+  errors = 0;
+  error.clear();
+}
+
+QDateTime LogData::timeStamp(int row) const
+{
+  return QDateTime::fromMSecsSinceEpoch(llround(times[row] * 1000));
+}
+
+QByteArray LogData::line(int row) const
+{
+  return QByteArray(data + rows[row].offset, rows[row].length);
+}
+
+QString LogData::text(int row, int column) const
+{
+  const char * p = data + rows[row].offset;
+  const char * end = p + rows[row].length;
+
+  for (int i = 0; i < column; i++) {
+    p = (const char *)memchr(p, ',', end - p);
+    if (!p) return QString();
+    p++;
+  }
+
+  const char * comma = (const char *)memchr(p, ',', end - p);
+  return QString::fromUtf8(p, (comma ? comma : end) - p);
+}
+
+QStringList LogData::fields(int row) const
+{
+  return QString::fromUtf8(data + rows[row].offset, rows[row].length).split(',');
+}
+
+void LogSeries::clear()
+{
+  keys.clear();
+  values.clear();
+  levels.clear();
+}
+
+void LogSeries::set(const QVector<double> & x, const QVector<double> & y)
+{
+  clear();
+
+  const int n = x.size();
+  if (n == 0) return;
+
+  if (std::is_sorted(x.begin(), x.end())) {
+    keys = x;
+    values = y;
+  }
+  else {
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](int a, int b) { return x[a] < x[b]; });
+    keys.resize(n);
+    values.resize(n);
+    for (int i = 0; i < n; i++) {
+      keys[i] = x[order[i]];
+      values[i] = y[order[i]];
+    }
+  }
+
+  // level 0: buckets of 2 samples, then each level merges 2 buckets
+  for (int bucketSize = 2;; bucketSize *= 2) {
+    Level level;
+    level.bucketSize = bucketSize;
+    int count = (n + bucketSize - 1) / bucketSize;
+    level.minIndex.resize(count);
+    level.maxIndex.resize(count);
+
+    const Level * prev = levels.empty() ? nullptr : &levels.back();
+    for (int b = 0; b < count; b++) {
+      int min, max;
+      if (!prev) {
+        int i = 2 * b;
+        int j = std::min(i + 1, n - 1);
+        min = values[j] < values[i] ? j : i;
+        max = values[j] > values[i] ? j : i;
+      }
+      else {
+        int i = 2 * b;
+        int j = std::min(i + 1, (int)prev->minIndex.size() - 1);
+        min = prev->minIndex[i];
+        max = prev->maxIndex[i];
+        if (values[prev->minIndex[j]] < values[min]) min = prev->minIndex[j];
+        if (values[prev->maxIndex[j]] > values[max]) max = prev->maxIndex[j];
+      }
+      level.minIndex[b] = min;
+      level.maxIndex[b] = max;
+    }
+
+    levels.push_back(std::move(level));
+    if (count <= 1) break;
+  }
+}
+
+void LogSeries::getRange(double lower, double upper, int buckets,
+                         QVector<double> & keysOut,
+                         QVector<double> & valuesOut) const
+{
+  keysOut.clear();
+  valuesOut.clear();
+
+  const int n = keys.size();
+  if (n == 0) return;
+
+  int first = std::lower_bound(keys.begin(), keys.end(), lower) - keys.begin();
+  int last = std::upper_bound(keys.begin(), keys.end(), upper) - keys.begin();
+  first = std::max(first - 1, 0);
+  last = std::min(last, n - 1);
+  int count = last - first + 1;
+
+  if (buckets < 1) buckets = 1;
+
+  const Level * level = nullptr;
+  if (count > 2 * buckets) {
+    for (const auto & l: levels) {
+      level = &l;
+      if ((qint64)l.bucketSize * buckets >= count) break;
+    }
+  }
+
+  if (!level) {
+    keysOut = keys.mid(first, count);
+    valuesOut = values.mid(first, count);
+    return;
+  }
+
+  int b0 = first / level->bucketSize;
+  int b1 = last / level->bucketSize;
+  keysOut.reserve(2 * (b1 - b0 + 1));
+  valuesOut.reserve(2 * (b1 - b0 + 1));
+
+  for (int b = b0; b <= b1; b++) {
+    int i = std::min(level->minIndex[b], level->maxIndex[b]);
+    int j = std::max(level->minIndex[b], level->maxIndex[b]);
+    keysOut.append(keys[i]);
+    valuesOut.append(values[i]);
+    if (j != i) {
+      keysOut.append(keys[j]);
+      valuesOut.append(values[j]);
+    }
+  }
+}
+
+bool LogSeries::valueAt(double key, bool interpolate, double & keyOut,
+                        double & valueOut) const
+{
+  const int n = keys.size();
+  if (n == 0) return false;
+
+  int i = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+  if (i == 0 || i == n) {
+    i = std::min(i, n - 1);
+    keyOut = keys[i];
+    valueOut = values[i];
+    return true;
+  }
+
+  // keys[i - 1] < key <= keys[i]
+  double k0 = keys[i - 1], k1 = keys[i];
+  if (interpolate) {
+    keyOut = key;
+    valueOut = values[i - 1] + (values[i] - values[i - 1]) * (key - k0) / (k1 - k0);
+  }
+  else {
+    if (key - k0 < k1 - key) i -= 1;
+    keyOut = keys[i];
+    valueOut = values[i];
+  }
+  return true;
+}
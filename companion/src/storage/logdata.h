@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <QtCore>
+#include <vector>
+
+//
+// Telemetry log written by the radio (CSV: Date,Time,field1,...)
+//
+// The file is memory mapped and parsed once, in parallel, into one
+// array of values per column (and one of record times), so that
+// plotting does not parse strings again. The text of the fields is
+// read from the mapped file when needed (log table, exports).
+//
+
+class LogData
+{
+  Q_DECLARE_TR_FUNCTIONS(LogData)
+
+  public:
+    LogData() = default;
+    ~LogData() { clear(); }
+
+    // 'threads' = 0: one per CPU core
+    bool load(const QString & filename, int threads = 0);
+    void clear();
+
+    QString errorString() const { return error; }
+    // lines (header excluded) and lines with a wrong number of fields
+    int lineCount() const { return lines; }
+    int invalidLineCount() const { return errors; }
+
+    int rowCount() const { return (int)rows.size(); }
+    int columnCount() const { return header.size(); }
+    const QStringList & headers() const { return header; }
+
+    // Field value as QString::toDouble() would return it (0 if not a number)
+    double value(int row, int column) const { return columns[column][row]; }
+    // Record time in seconds since epoch (ms resolution)
+    double time(int row) const { return times[row]; }
+    QDateTime timeStamp(int row) const;
+
+    QString text(int row, int column) const;
+    QStringList fields(int row) const;
+    // Line as in the file, without end of line
+    QByteArray line(int row) const;
+
+  protected:
+    struct Row {
+      qint64 offset;
+      int length;
+    };
+
+    struct Chunk;
+
+    QFile file;
+    QByteArray buffer;  // file content if it can't be mapped
+    const char * data = nullptr;
+    qint64 size = 0;
+
+    QStringList header;
+    std::vector<Row> rows;
+    std::vector<std::vector<double>> columns;  // Date and Time are empty
+    std::vector<double> times;
+    int lines = 0;
+    int errors = 0;
+    QString error;
+
+    void parse(Chunk & chunk) const;
+};
+
+//
+// Min/max decimation of a log series, for plotting
+//
+// For each level of detail, the samples are grouped by buckets of 2^n
+// samples and only the minimum and maximum of each bucket are kept: the
+// series can be displayed with a few points per pixel at any zoom level
+// without losing the peaks.
+//
+
+class LogSeries
+{
+  public:
+    // Keys are sorted if needed (radio clock changes)
+    void set(const QVector<double> & x, const QVector<double> & y);
+    void clear();
+
+    int count() const { return keys.size(); }
+
+    // Points of [lower, upper] (and one point on each side), with at
+    // most 'buckets' buckets of min/max
+    void getRange(double lower, double upper, int buckets,
+                  QVector<double> & keysOut,
+                  QVector<double> & valuesOut) const;
+
+    // Full resolution sample for the plot tracers: the nearest sample, or
+    // the value interpolated between the two samples around 'key'.
+    // Returns false if the series is empty
+    bool valueAt(double key, bool interpolate, double & keyOut,
+                 double & valueOut) const;
+
+  protected:
+    struct Level {
+      int bucketSize;
+      std::vector<int> minIndex;
+      std::vector<int> maxIndex;
+    };
+
+    QVector<double> keys;
+    QVector<double> values;
+    std::vector<Level> levels;
+};
@@ -28,6 +28,61 @@
 #include <QDebug>
 #include <QWidget>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#define ZIP_BATCH_SIZE        (32 * 1024 * 1024)  // files read and compressed at once
+#define ZIP_STREAM_MIN_SIZE   (8 * 1024 * 1024)   // larger files are streamed
+
+static size_t zipRead(void * opaque, mz_uint64 offset, void * buffer, size_t size)
+{
+  QIODevice * device = static_cast<QIODevice *>(opaque);
+  if ((qint64)offset != device->pos() && !device->seek(offset))
+    return 0;
+  const qint64 len = device->read((char *)buffer, size);
+  return len < 0 ? 0 : len;
+}
+
+static size_t zipWrite(void * opaque, mz_uint64 offset, const void * buffer, size_t size)
+{
+  QIODevice * device = static_cast<QIODevice *>(opaque);
+  if ((qint64)offset != device->pos() && !device->seek(offset))
+    return 0;
+  const qint64 len = device->write((const char *)buffer, size);
+  return len < 0 ? 0 : len;
+}
+
+// Runs job(0) to job(count - 1) on up to one thread per core, calling
+// poll() from this thread meanwhile
+static void runParallel(int count, const std::function<void(int)> & job,
+                        const std::function<void()> & poll = nullptr)
+{
+  std::atomic<int> next(0);
+  std::atomic<int> running(std::min<int>(std::max(1u, std::thread::hardware_concurrency()), count));
+  std::vector<std::thread> workers;
+
+  for (int i = running; i > 0; i--) {
+    workers.emplace_back([&]() {
+      int index;
+      while ((index = next++) < count)
+        job(index);
+      --running;
+    });
+  }
+
+  while (poll && running > 0) {
+    poll();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  for (auto & worker : workers)
+    worker.join();
+}
+
 MinizInterface::MinizInterface(ProgressWidget * progress, const ProgressCalcMethod progressMethod, const int & logLevel) :
   progress(progress),
   progressMethod(progressMethod),
@@ -59,19 +114,21 @@ bool MinizInterface::zipPathToFile(const QString & sourcePath, const QString & a
   mz_zip_zero_struct(&zip_archive);
 
   QFileInfo afi(archiveFile);
+  QFile file(archiveFile);
 
   if (afi.exists() && !append)
     reportProgress(tr("Existing archive will be overwritten"), QtCriticalMsg);
 
   if (afi.exists() && append) {
-    if (!mz_zip_reader_init_file(&zip_archive, qPrintable(archiveFile), 0)) {
+    if (!file.open(QIODevice::ReadWrite) || !initReader(&zip_archive, &file)) {
       reportProgress(tr("Unable to open existing archive"), QtFatalMsg);
       return false;
     }
     else
       reportProgress(tr("Existing archive opened"), QtDebugMsg);
 
-    if (!mz_zip_writer_init_from_reader(&zip_archive, qPrintable(archiveFile))) {
+    if (!mz_zip_writer_init_from_reader_v2(&zip_archive, nullptr, 0)) {
+      mz_zip_reader_end(&zip_archive);
       reportProgress(tr("Unable to write to existing archive"), QtFatalMsg);
       return false;
     }
@@ -79,7 +136,7 @@ bool MinizInterface::zipPathToFile(const QString & sourcePath, const QString & a
       reportProgress(tr("Existing archive initialised"), QtDebugMsg);
   }
   else {
-    if (!mz_zip_writer_init_file(&zip_archive, qPrintable(archiveFile), 0)) {
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || !initWriter(&zip_archive, &file)) {
       reportProgress(tr("Failure to initialise archive"), QtFatalMsg);
       return false;
     }
@@ -88,50 +145,37 @@ bool MinizInterface::zipPathToFile(const QString & sourcePath, const QString & a
   }
 
   QFileInfo pfi(path);
-
-  int fileCount = 0;
+  QDir root;
+  QStringList files;
+  qint64 totalSize = 0;
 
   if (pfi.isDir()) {
-    if (progressMethod == PCM_COUNT) {
-      reportProgress(tr("Calculating number of items to archive"), QtDebugMsg);
-
-      QDirIterator itcnt(path, QDirIterator::Subdirectories);
-
-      while (itcnt.hasNext()) {
-        fileCount++;
-      }
-    }
+    reportProgress(tr("Calculating number of items to archive"), QtDebugMsg);
 
-    if (progress) {
-      if (progressMethod == PCM_COUNT)
-        progress->setMaximum(fileCount);
-      else
-        progress->setMaximum(pfi.size());
-    }
-
-    fileCount = 0;
-    QDirIterator it(path, QDirIterator::Subdirectories);
+    root.setPath(path);
+    QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
 
     while (it.hasNext()) {
-      it.next();
-      if (!addFileToArchive(it.filePath()))
-        return false;
+      files.append(it.next());
+      totalSize += it.fileInfo().size();
     }
   }
   else {
-    fileCount = 1;
-
-    if (progress) {
-      if (progressMethod == PCM_COUNT)
-        progress->setMaximum(fileCount);
-      else
-        progress->setMaximum(pfi.size());
-    }
+    root = pfi.absoluteDir();
+    files.append(pfi.absoluteFilePath());
+    totalSize = pfi.size();
+  }
 
-    if (!addFileToArchive(path))
-      return false;
+  if (progress) {
+    if (progressMethod == PCM_COUNT)
+      progress->setMaximum(files.size());
+    else
+      progress->setMaximum(totalSize);
   }
 
+  if (!addFilesToArchive(files, root))
+    return false;
+
   if (!mz_zip_writer_finalize_archive(&zip_archive)) {
     mz_zip_writer_end(&zip_archive);
     reportProgress(tr("Failure to finalise archive"), QtFatalMsg);
@@ -148,23 +192,110 @@ bool MinizInterface::zipPathToFile(const QString & sourcePath, const QString & a
   return true;
 }
 
-bool MinizInterface::addFileToArchive(const QString & path)
+// Files up to ZIP_STREAM_MIN_SIZE are read and compressed in parallel, by
+// batches of ZIP_BATCH_SIZE bytes, then added in order. Larger files are
+// streamed into the archive.
+bool MinizInterface::addFilesToArchive(const QStringList & files, const QDir & root)
+{
+  QVector<ZipEntry> batch;
+  QStringList sources;
+  qint64 batchSize = 0;
+
+  for (const QString & file : files) {
+    const QFileInfo fi(file);
+
+    if (fi.size() > ZIP_STREAM_MIN_SIZE) {
+      if (!addBatch(batch, sources) || !streamFile(fi, root.relativeFilePath(fi.absoluteFilePath())))
+        return false;
+      batchSize = 0;
+      continue;
+    }
+
+    ZipEntry entry;
+    entry.name = root.relativeFilePath(fi.absoluteFilePath());
+    entry.modified = fi.lastModified().toSecsSinceEpoch();
+    batch.append(entry);
+    sources.append(fi.absoluteFilePath());
+    batchSize += fi.size();
+
+    if (batchSize >= ZIP_BATCH_SIZE) {
+      if (!addBatch(batch, sources))
+        return false;
+      batchSize = 0;
+    }
+  }
+
+  return addBatch(batch, sources);
+}
+
+bool MinizInterface::addBatch(QVector<ZipEntry> & entries, QStringList & sources)
+{
+  std::vector<char> loaded(entries.size(), false);
+  std::atomic<int> doneCount(0);
+  std::atomic<qint64> doneSize(0);
+  ZipEntry * data = entries.data();
+
+  runParallel(entries.size(), [&](int i) {
+    QFile file(sources.at(i));
+    if (file.open(QIODevice::ReadOnly)) {
+      data[i].data = file.readAll();
+      loaded[i] = (file.error() == QFileDevice::NoError);
+      compressEntry(data[i], MZ_DEFAULT_LEVEL);
+    }
+    doneSize += data[i].size;
+    ++doneCount;
+  }, [&]() {
+    if (progress)
+      progress->setValue(progressValue + (progressMethod == PCM_COUNT ? (qint64)doneCount : (qint64)doneSize));
+  });
+
+  for (int i = 0; i < entries.size(); i++) {
+    if (!loaded[i] || !addEntry(&zip_archive, entries[i])) {
+      mz_zip_writer_end(&zip_archive);
+      reportProgress(tr("Failure to add %1").arg(sources[i]), QtFatalMsg);
+      return false;
+    }
+
+    if (progressMethod == PCM_COUNT)
+      ++progressValue;
+    else
+      progressValue += entries[i].size;
+
+    entries[i].data.clear();
+
+    reportProgress(tr("Added file: %1").arg(sources[i]), QtDebugMsg);
+  }
+
+  if (progress)
+    progress->setValue(progressValue);
+
+  entries.clear();
+  sources.clear();
+  return true;
+}
+
+bool MinizInterface::streamFile(const QFileInfo & fileInfo, const QString & name)
 {
-  if (!mz_zip_writer_add_file(&zip_archive, qPrintable(archiveFile), qPrintable(path), NULL, 0, MZ_DEFAULT_COMPRESSION)) {
+  QFile file(fileInfo.absoluteFilePath());
+  MZ_TIME_T modified = fileInfo.lastModified().toSecsSinceEpoch();
+
+  if (!file.open(QIODevice::ReadOnly) ||
+      !mz_zip_writer_add_read_buf_callback(&zip_archive, name.toUtf8().constData(), zipRead, &file, file.size(),
+                                           &modified, nullptr, 0, MZ_DEFAULT_LEVEL, nullptr, 0, nullptr, 0)) {
     mz_zip_writer_end(&zip_archive);
-    reportProgress(tr("Failure to add %1").arg(path), QtFatalMsg);
+    reportProgress(tr("Failure to add %1").arg(fileInfo.absoluteFilePath()), QtFatalMsg);
     return false;
   }
 
   if (progressMethod == PCM_COUNT)
     ++progressValue;
   else
-    progressValue += QFileInfo(path).size();
+    progressValue += fileInfo.size();
 
   if (progress)
     progress->setValue(progressValue);
 
-  reportProgress(tr("Added file: %1").arg(path), QtDebugMsg);
+  reportProgress(tr("Added file: %1").arg(fileInfo.absoluteFilePath()), QtDebugMsg);
 
   return true;
 }
@@ -183,7 +314,8 @@ bool MinizInterface::unzipArchiveToPath(const QString & archiveFile, const QStri
   this->archiveFile = archiveFile;
   mz_zip_zero_struct(&zip_archive);
 
-  if (!mz_zip_reader_init_file(&zip_archive, qPrintable(archiveFile), 0)) {
+  QFile file(archiveFile);
+  if (!file.open(QIODevice::ReadOnly) || !initReader(&zip_archive, &file)) {
     reportProgress(tr("File does not appear to be a compressed archive"), QtFatalMsg);
     return false;
   }
@@ -211,6 +343,9 @@ bool MinizInterface::unzipArchiveToPath(const QString & archiveFile, const QStri
     return false;
   }
 
+  // directories are created first, then the files are extracted in parallel
+  QVector<mz_uint> files;
+
   for (int i = 0; i < fileCount; i++) {
     if (!mz_zip_reader_file_stat(&zip_archive, i, &file_stat)) {
       mz_zip_reader_end(&zip_archive);
@@ -227,38 +362,19 @@ bool MinizInterface::unzipArchiveToPath(const QString & archiveFile, const QStri
       }
     }
     else {
-      QFileInfo dfi(destPath);
-      if (!createDirectory(dfi.absolutePath())) {
-        mz_zip_reader_end(&zip_archive);
-        return false;
-      }
-
-      if (!mz_zip_reader_extract_to_file(&zip_archive, i, qPrintable(destPath), 0)) {
+      if (!createDirectory(QFileInfo(destPath).absolutePath())) {
         mz_zip_reader_end(&zip_archive);
-        reportProgress(tr("Failed to extract %1 to %2").arg(dfi.fileName(), dfi.absolutePath()), QtFatalMsg);
         return false;
       }
-      else {
-        if (dfi.size() != (qint64)file_stat.m_uncomp_size) {
-          reportProgress(tr("File %1 extracted size %2 does not match original %3").arg(file_stat.m_filename).arg(dfi.size()).arg((qint64)file_stat.m_uncomp_size), QtFatalMsg);
-            // return false;  disable until testing complete as there maybe some adjustment factor or even OS strangeness
-        }
-      }
-
-      if (progressMethod == PCM_COUNT)
-        ++progressValue;
-      else
-        progressValue += file_stat.m_comp_size;
-
-      if (progress)
-        progress->setValue(progressValue);
-
-      reportProgress(tr("Extracted file: %1").arg(file_stat.m_filename), QtDebugMsg);
+      files.append(i);
     }
   }
 
   mz_zip_reader_end(&zip_archive);
 
+  if (!extractFiles(files))
+    return false;
+
   if (progress)
     progress->setValue(progress->maximum());
 
@@ -267,6 +383,132 @@ bool MinizInterface::unzipArchiveToPath(const QString & archiveFile, const QStri
   return true;
 }
 
+// The archive reader can't be shared: each thread has its own one
+bool MinizInterface::extractFiles(const QVector<mz_uint> & files)
+{
+  struct Extracted {
+    QString name;
+    qint64 size = 0;
+    qint64 compSize = 0;
+    qint64 written = 0;
+    bool ok = false;
+  };
+
+  std::vector<Extracted> results(files.size());
+  std::atomic<int> next(0);
+  std::atomic<int> doneCount(0);
+  std::atomic<qint64> doneSize(0);
+  const int threads = std::min<int>(std::max(1u, std::thread::hardware_concurrency()), files.size());
+
+  runParallel(threads, [&](int) {
+    QFile file(archiveFile);
+    mz_zip_archive zip;
+    const bool opened = file.open(QIODevice::ReadOnly) && initReader(&zip, &file);
+    int i;
+
+    while ((i = next++) < files.size()) {
+      Extracted & result = results[i];
+      mz_zip_archive_file_stat stat;
+      if (opened && mz_zip_reader_file_stat(&zip, files[i], &stat)) {
+        result.name = QString(stat.m_filename);
+        result.size = stat.m_uncomp_size;
+        result.compSize = stat.m_comp_size;
+        QFile destination(path % "/" % result.name);
+        result.ok = destination.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+                    mz_zip_reader_extract_to_callback(&zip, files[i], zipWrite, &destination, 0);
+        result.written = destination.size();
+      }
+      doneSize += result.compSize;
+      ++doneCount;
+    }
+
+    if (opened)
+      mz_zip_reader_end(&zip);
+  }, [&]() {
+    if (progress)
+      progress->setValue(progressMethod == PCM_COUNT ? (qint64)doneCount : (qint64)doneSize);
+  });
+
+  for (const Extracted & result : results) {
+    QFileInfo dfi(path % "/" % result.name);
+
+    if (!result.ok) {
+      reportProgress(tr("Failed to extract %1 to %2").arg(dfi.fileName(), dfi.absolutePath()), QtFatalMsg);
+      return false;
+    }
+
+    if (result.written != result.size) {
+      reportProgress(tr("File %1 extracted size %2 does not match original %3").arg(result.name).arg(result.written).arg(result.size), QtFatalMsg);
+        // return false;  disable until testing complete as there maybe some adjustment factor or even OS strangeness
+    }
+
+    reportProgress(tr("Extracted file: %1").arg(result.name), QtDebugMsg);
+  }
+
+  return true;
+}
+
+bool MinizInterface::initReader(mz_zip_archive * zip, QIODevice * device)
+{
+  mz_zip_zero_struct(zip);
+  zip->m_pRead = zipRead;
+  zip->m_pWrite = zipWrite;
+  zip->m_pIO_opaque = device;
+  return mz_zip_reader_init(zip, device->size(), 0);
+}
+
+bool MinizInterface::initWriter(mz_zip_archive * zip, QIODevice * device)
+{
+  mz_zip_zero_struct(zip);
+  zip->m_pRead = zipRead;
+  zip->m_pWrite = zipWrite;
+  zip->m_pIO_opaque = device;
+  return mz_zip_writer_init_v2(zip, 0, 0);
+}
+
+void MinizInterface::compressEntry(ZipEntry & entry, int level)
+{
+  entry.size = entry.data.size();
+  entry.crc = (mz_uint32)mz_crc32(MZ_CRC32_INIT, (const unsigned char *)entry.data.constData(), entry.data.size());
+  entry.deflated = false;
+
+  // same as miniz: tiny entries are stored
+  if (level == MZ_NO_COMPRESSION || entry.data.size() <= 3)
+    return;
+
+  size_t len = 0;
+  void * deflated = tdefl_compress_mem_to_heap(entry.data.constData(), entry.data.size(), &len,
+                                               tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+  // incompressible entries are stored too
+  if (deflated && len < (size_t)entry.data.size()) {
+    entry.data = QByteArray((const char *)deflated, len);
+    entry.deflated = true;
+  }
+  mz_free(deflated);
+}
+
+void MinizInterface::compressEntries(QVector<ZipEntry> & entries, int level)
+{
+  ZipEntry * data = entries.data();
+  runParallel(entries.size(), [data, level](int i) {
+    compressEntry(data[i], level);
+  });
+}
+
+bool MinizInterface::addEntry(mz_zip_archive * zip, const ZipEntry & entry)
+{
+  MZ_TIME_T modified = entry.modified ? entry.modified : time(nullptr);
+  const QByteArray name = entry.name.toUtf8();
+
+  if (entry.deflated)
+    return mz_zip_writer_add_mem_ex_v2(zip, name.constData(), entry.data.constData(), entry.data.size(), nullptr, 0,
+                                       MZ_DEFAULT_LEVEL | MZ_ZIP_FLAG_COMPRESSED_DATA, entry.size, entry.crc,
+                                       &modified, nullptr, 0, nullptr, 0);
+
+  return mz_zip_writer_add_mem_ex_v2(zip, name.constData(), entry.data.constData(), entry.data.size(), nullptr, 0,
+                                     MZ_NO_COMPRESSION, 0, 0, &modified, nullptr, 0, nullptr, 0);
+}
+
 bool MinizInterface::createDirectory(const QString & path)
 {
   if (!QDir(path).exists()) {
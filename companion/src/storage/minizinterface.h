@@ -26,6 +26,8 @@
 #include <QtCore>
 #include <QString>
 
+#include <ctime>
+
 class ProgressWidget;
 
 class MinizInterface
@@ -38,12 +40,32 @@ class MinizInterface
       PCM_SIZE
     };
 
+    // An archive entry compressed apart from the archive, so that
+    // independent entries can be compressed in parallel
+    struct ZipEntry {
+      QString name;
+      QByteArray data;      // raw deflate data once compressed
+      time_t modified = 0;  // 0: now
+      mz_uint64 size = 0;   // uncompressed size
+      mz_uint32 crc = 0;
+      bool deflated = false;
+    };
+
     MinizInterface(ProgressWidget * progress = nullptr, const ProgressCalcMethod progressMethod = PCM_COUNT, const int & logLevel = QtWarningMsg);
     ~MinizInterface();
 
     bool zipPathToFile(const QString & sourcePath, const QString & archiveFile, bool append = true);
     bool unzipArchiveToPath(const QString & archiveFile, const QString & destinationPath);
 
+    // Archives read from and written to a QIODevice, which must stay open
+    // until the archive is closed. Entries are streamed, not buffered.
+    static bool initReader(mz_zip_archive * zip, QIODevice * device);
+    static bool initWriter(mz_zip_archive * zip, QIODevice * device);
+
+    // Compresses the entries on up to one thread per core
+    static void compressEntries(QVector<ZipEntry> & entries, int level = MZ_DEFAULT_LEVEL);
+    static bool addEntry(mz_zip_archive * zip, const ZipEntry & entry);
+
   private:
     ProgressWidget *progress;
     ProgressCalcMethod progressMethod;
@@ -54,7 +76,11 @@ class MinizInterface
 
     mz_zip_archive zip_archive;
 
-    bool addFileToArchive(const QString & path);
+    bool addFilesToArchive(const QStringList & files, const QDir & root);
+    bool addBatch(QVector<ZipEntry> & entries, QStringList & sources);
+    bool streamFile(const QFileInfo & fileInfo, const QString & name);
+    bool extractFiles(const QVector<mz_uint> & files);
+    static void compressEntry(ZipEntry & entry, int level);
     bool createDirectory(const QString & path);
     void reportProgress(const QString & text, const int & type = QtInfoMsg, bool richText = false);
 };
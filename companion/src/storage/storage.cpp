@@ -90,6 +90,7 @@ bool Storage::load(RadioData & radioData)
   foreach(StorageFactory * factory, registeredStorageFactories) {
     if (factory->probe(filename)) {
       StorageFormat * format = factory->instance(filename);
+      format->setProgress(progress);
       if (format->load(radioData)) {
         board = format->getBoard();
         setWarning(format->warning());
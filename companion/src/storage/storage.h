@@ -27,6 +27,8 @@
 #include <QString>
 #include <QDebug>
 
+class ProgressWidget;
+
 enum StorageType
 {
   STORAGE_TYPE_UNKNOWN,
@@ -51,7 +53,8 @@ class StorageFormat
     StorageFormat(const QString & filename, uint8_t version=0):
       filename(filename),
       version(version),
-      board(Board::BOARD_UNKNOWN)
+      board(Board::BOARD_UNKNOWN),
+      progress(nullptr)
     {
     }
     virtual ~StorageFormat() {}
@@ -74,6 +77,12 @@ class StorageFormat
       return board;
     }
 
+    // Optional, used by the formats which can take some time to load
+    void setProgress(ProgressWidget * progress)
+    {
+      this->progress = progress;
+    }
+
   protected:
     void setError(const QString & error)
     {
@@ -92,6 +101,7 @@ class StorageFormat
     QString _error;
     QString _warning;
     Board::Type board;
+    ProgressWidget * progress;
 };
 
 class StorageFactory
@@ -0,0 +1,122 @@
+#include "gtests.h"
+#include "location.h"
+#include "storage/etx.h"
+#include "storage/minizinterface.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#define SDCARD_FILES      400
+#define SDCARD_FILE_SIZE  (64 * 1024)
+#define SDCARD_LARGE_SIZE (12 * 1024 * 1024)  // streamed
+
+// Peak resident memory (KB), Linux only
+static long peakMemory()
+{
+#if defined(__linux__)
+  QFile status("/proc/self/status");
+  if (status.open(QFile::ReadOnly | QFile::Text)) {
+    for (const QByteArray & line : status.readAll().split('\n')) {
+      if (line.startsWith("VmHWM:"))
+        return line.mid(6).trimmed().split(' ').first().toLong();
+    }
+  }
+#endif
+  return 0;
+}
+
+static QByteArray fileContents(int index, int size)
+{
+  QByteArray data;
+  data.reserve(size);
+  while (data.size() < size)
+    data.append(QString("file %1 line %2\n").arg(index).arg(data.size()).toLatin1());
+  data.truncate(size);
+  return data;
+}
+
+static void writeFile(const QString & path, const QByteArray & data)
+{
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  QFile file(path);
+  ASSERT_TRUE(file.open(QFile::WriteOnly));
+  ASSERT_EQ(data.size(), file.write(data));
+}
+
+TEST(Archive, etxRoundTrip)
+{
+  RadioData radio;
+  EtxFormat etx(RADIO_TESTS_PATH "/model_22_x12s.etx");
+  ASSERT_TRUE(etx.load(radio));
+
+  QTemporaryDir dir;
+  const QString filename = dir.filePath("radio.etx");
+  EtxFormat output(filename);
+  ASSERT_TRUE(output.write(radio));
+
+  RadioData loaded;
+  EtxFormat input(filename);
+  ASSERT_TRUE(input.load(loaded));
+  ASSERT_EQ(radio.models.size(), loaded.models.size());
+  for (unsigned i = 0; i < radio.models.size(); i++) {
+    EXPECT_STREQ(radio.models[i].name, loaded.models[i].name);
+    EXPECT_EQ(radio.models[i].used, loaded.models[i].used);
+  }
+
+  // single model, nothing else extracted
+  const ModelData & first = radio.models[0];
+  ModelData model;
+  ASSERT_TRUE(input.loadModel(model, first.filename));
+  EXPECT_STREQ(first.name, model.name);
+  EXPECT_STREQ(first.filename, model.filename);
+  EXPECT_FALSE(input.loadModel(model, "missing.yml"));
+}
+
+// Backup and restore of a SD card tree, large files included
+TEST(Archive, sdcardBackupRestore)
+{
+  QTemporaryDir dir;
+  const QString sdcard = dir.filePath("sdcard");
+  const QString restored = dir.filePath("restored");
+  const QString archive = dir.filePath("backup.zip");
+  qint64 totalSize = 0;
+
+  for (int i = 0; i < SDCARD_FILES; i++) {
+    writeFile(QString("%1/DIR%2/file%3.txt").arg(sdcard).arg(i % 10).arg(i), fileContents(i, SDCARD_FILE_SIZE));
+    totalSize += SDCARD_FILE_SIZE;
+  }
+  for (int i = 0; i < 2; i++) {
+    writeFile(QString("%1/LARGE/large%2.bin").arg(sdcard).arg(i), fileContents(i, SDCARD_LARGE_SIZE));
+    totalSize += SDCARD_LARGE_SIZE;
+  }
+
+  const long startMemory = peakMemory();
+  QElapsedTimer timer;
+  timer.start();
+
+  MinizInterface backup(nullptr, MinizInterface::PCM_SIZE, QtCriticalMsg);
+  ASSERT_TRUE(backup.zipPathToFile(sdcard, archive, false));
+  const qint64 backupTime = timer.restart();
+  const long backupMemory = peakMemory();
+
+  MinizInterface restore(nullptr, MinizInterface::PCM_SIZE, QtCriticalMsg);
+  ASSERT_TRUE(restore.unzipArchiveToPath(archive, restored));
+  const qint64 restoreTime = timer.elapsed();
+  const long restoreMemory = peakMemory();
+
+  QDirIterator it(sdcard, QDir::Files, QDirIterator::Subdirectories);
+  int count = 0;
+  while (it.hasNext()) {
+    const QString path = it.next();
+    QFile source(path), copy(restored + "/" + QDir(sdcard).relativeFilePath(path));
+    ASSERT_TRUE(source.open(QFile::ReadOnly));
+    ASSERT_TRUE(copy.open(QFile::ReadOnly)) << copy.fileName().toStdString();
+    EXPECT_EQ(source.readAll(), copy.readAll()) << path.toStdString();
+    count++;
+  }
+  EXPECT_EQ(SDCARD_FILES + 2, count);
+
+  printf("%d files, %lld MB, archive %lld MB: backup %lld ms (+%ld KB peak), restore %lld ms (+%ld KB peak)\n",
+         count, totalSize / (1024 * 1024), QFileInfo(archive).size() / (1024 * 1024),
+         backupTime, backupMemory - startMemory, restoreTime, restoreMemory - backupMemory);
+}
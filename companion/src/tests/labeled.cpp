@@ -0,0 +1,59 @@
+#include "gtests.h"
+#include "location.h"
+#include "storage/etx.h"
+#include "storage/sdcard.h"
+
+#include <chrono>
+#include <thread>
+
+#define SDCARD_MODELS 500
+
+// Synthetic SD card with SDCARD_MODELS models, loaded by one thread and
+// by one thread per core: same models, in the same slots
+TEST(LabeledStorage, parallelYamlLoad)
+{
+  RadioData radio;
+  EtxFormat etx(RADIO_TESTS_PATH "/model_22_x12s.etx");
+  ASSERT_TRUE(etx.load(radio));
+
+  ModelData model = radio.models[0];
+  radio.models.resize(SDCARD_MODELS);
+  for (int i = 0; i < SDCARD_MODELS; i++) {
+    radio.models[i] = model;
+    radio.models[i].modelIndex = i;
+    snprintf(radio.models[i].name, sizeof(radio.models[i].name), "Model %d", i);
+    snprintf(radio.models[i].filename, sizeof(radio.models[i].filename), "model%03d.yml", i);
+    radio.models[i].used = true;
+  }
+
+  QTemporaryDir dir;
+  SdcardFormat sdcard(dir.path());
+  ASSERT_TRUE(sdcard.write(radio));
+
+  RadioData serial, parallel;
+  SdcardFormat serialFormat(dir.path());
+  SdcardFormat parallelFormat(dir.path());
+  serialFormat.setThreadCount(1);
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(serialFormat.load(serial));
+  auto serialEnd = std::chrono::steady_clock::now();
+  ASSERT_TRUE(parallelFormat.load(parallel));
+  auto parallelEnd = std::chrono::steady_clock::now();
+
+  ASSERT_EQ(serial.models.size(), parallel.models.size());
+  int count = 0;
+  for (unsigned i = 0; i < serial.models.size(); i++) {
+    EXPECT_EQ(serial.models[i].used, parallel.models[i].used);
+    EXPECT_STREQ(serial.models[i].name, parallel.models[i].name);
+    EXPECT_EQ(0, memcmp(&serial.models[i], &parallel.models[i], sizeof(ModelData))) << "model " << i;
+    if (parallel.models[i].used) count++;
+  }
+  EXPECT_GT(count, 0);
+  EXPECT_EQ(serial.generalSettings.currModelIndex, parallel.generalSettings.currModelIndex);
+
+  printf("%d models: 1 thread %lld ms, %u threads %lld ms\n", count,
+         (long long)std::chrono::duration_cast<std::chrono::milliseconds>(serialEnd - start).count(),
+         std::thread::hardware_concurrency(),
+         (long long)std::chrono::duration_cast<std::chrono::milliseconds>(parallelEnd - serialEnd).count());
+}
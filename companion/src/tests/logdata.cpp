@@ -0,0 +1,158 @@
+#include "gtests.h"
+#include "storage/logdata.h"
+
+#include <algorithm>
+#include <chrono>
+
+static QString writeLog(const QTemporaryDir & dir, const QByteArray & content)
+{
+  QString filename = dir.filePath("log.csv");
+  QFile file(filename);
+  file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+  file.write(content);
+  file.close();
+  return filename;
+}
+
+TEST(LogData, parse)
+{
+  QTemporaryDir dir;
+  QString filename = writeLog(dir,
+    "Date,Time,RSSI(dB),Alt(m),GPS\r\n"
+    "2022-05-01,10:00:00.100,45,12.5,45.123456 6.654321\r\n"
+    "2022-05-01,10:00:00.300,44,-1.25,45.123457 6.654322\r\n"
+    "2022-05-01,10:00:01\r\n"
+    "2022-05-01,10:01:01.000,,abc,\r\n");
+
+  LogData log;
+  ASSERT_TRUE(log.load(filename));
+
+  EXPECT_EQ(4, log.lineCount());
+  EXPECT_EQ(1, log.invalidLineCount());
+  EXPECT_EQ(3, log.rowCount());
+  EXPECT_EQ(5, log.columnCount());
+  EXPECT_EQ(QString("Alt(m)"), log.headers().at(3));
+
+  EXPECT_EQ(45, log.value(0, 2));
+  EXPECT_EQ(12.5, log.value(0, 3));
+  EXPECT_EQ(-1.25, log.value(1, 3));
+  EXPECT_EQ(0, log.value(2, 2));
+  EXPECT_EQ(0, log.value(2, 3));
+
+  double time = QDateTime::fromString("2022-05-01 10:00:00", "yyyy-MM-dd HH:mm:ss").toTime_t();
+  EXPECT_DOUBLE_EQ(time + 0.1, log.time(0));
+  EXPECT_DOUBLE_EQ(time + 61, log.time(2));
+  EXPECT_EQ(QDateTime::fromString("2022-05-01 10:00:00.300", "yyyy-MM-dd HH:mm:ss.zzz"), log.timeStamp(1));
+
+  EXPECT_EQ(QString("45.123457 6.654322"), log.text(1, 4));
+  EXPECT_EQ(QString(""), log.text(2, 4));
+  EXPECT_EQ(5, log.fields(2).count());
+  EXPECT_EQ(QByteArray("2022-05-01,10:01:01.000,,abc,"), log.line(2));
+
+  // same result with several threads
+  LogData parallel;
+  ASSERT_TRUE(parallel.load(filename, 4));
+  EXPECT_EQ(log.rowCount(), parallel.rowCount());
+  EXPECT_EQ(log.value(1, 3), parallel.value(1, 3));
+
+  EXPECT_FALSE(log.load(writeLog(dir, "Not,a,log\n1,2,3\n")));
+  EXPECT_EQ(0, log.rowCount());
+}
+
+TEST(LogData, decimation)
+{
+  QVector<double> keys, values;
+  for (int i = 0; i < 100000; i++) {
+    keys.append(i);
+    values.append(sin(i * 0.01) * 100);
+  }
+  values[12345] = 1000;
+  values[54321] = -1000;
+
+  LogSeries series;
+  series.set(keys, values);
+
+  QVector<double> k, v;
+  series.getRange(keys.first(), keys.last(), 500, k, v);
+  EXPECT_LE(k.count(), 2 * 500 + 2);
+  EXPECT_TRUE(std::is_sorted(k.begin(), k.end()));
+  EXPECT_EQ(1000, *std::max_element(v.begin(), v.end()));
+  EXPECT_EQ(-1000, *std::min_element(v.begin(), v.end()));
+  EXPECT_TRUE(k.contains(keys[12345]));
+
+  // zoomed in: raw samples, one more on each side
+  series.getRange(10000, 10100, 500, k, v);
+  EXPECT_EQ(103, k.count());
+  EXPECT_EQ(keys[9999], k.first());
+  EXPECT_EQ(values[10000], v.at(1));
+
+  // tracers read the full resolution samples
+  double key, value;
+  EXPECT_TRUE(series.valueAt(12345.2, false, key, value));
+  EXPECT_EQ(12345, key);
+  EXPECT_EQ(1000, value);
+  EXPECT_TRUE(series.valueAt(54320.6, false, key, value));
+  EXPECT_EQ(54321, key);
+  EXPECT_EQ(-1000, value);
+  EXPECT_TRUE(series.valueAt(12345.5, true, key, value));
+  EXPECT_EQ(12345.5, key);
+  EXPECT_DOUBLE_EQ((1000 + values[12346]) / 2, value);
+  EXPECT_TRUE(series.valueAt(-10, true, key, value));
+  EXPECT_EQ(keys.first(), key);
+}
+
+// Loads a generated log of LOGDATA_BENCHMARK_MB (default 1024) MB
+// gtests-companion --gtest_also_run_disabled_tests --gtest_filter=LogData.*
+TEST(LogData, DISABLED_benchmark)
+{
+  int megabytes = qEnvironmentVariableIsSet("LOGDATA_BENCHMARK_MB") ? qEnvironmentVariableIntValue("LOGDATA_BENCHMARK_MB") : 1024;
+
+  QTemporaryDir dir;
+  QString filename = dir.filePath("log.csv");
+  {
+    QFile file(filename);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("Date,Time,1RSS(dB),RQly(%),RSNR(dB),RxBt(V),Curr(A),Capa(mAh),Alt(m),GPS,GSpd(kmh),Rud,Ele,Thr,Ail,TxBat(V)\n");
+    QByteArray block;
+    int ms = 0;
+    while (file.size() < (qint64)megabytes * 1024 * 1024) {
+      block.clear();
+      for (int i = 0; i < 10000; i++, ms += 5) {
+        QTime time = QTime(0, 0).addMSecs(ms % (24 * 3600 * 1000));
+        block += QString("2022-05-01,%1,-%2,100,%3,%4,%5,%6,%7,45.%8 6.%9,%10,%11,%12,%13,%14,7.9\n")
+          .arg(time.toString("HH:mm:ss.zzz")).arg(40 + i % 30).arg(i % 20).arg(7.4 + (i % 10) * 0.01, 0, 'f', 2)
+          .arg((i % 500) * 0.1, 0, 'f', 1).arg(ms / 1000).arg(sin(ms * 0.0001) * 100, 0, 'f', 1)
+          .arg(123456 + i % 1000).arg(654321 + i % 1000).arg(i % 120).arg(i % 2048 - 1024)
+          .arg(-(i % 2048) + 1024).arg(i % 1024).arg(i % 512).toUtf8();
+      }
+      file.write(block);
+    }
+  }
+
+  for (int threads: {1, 0}) {
+    LogData log;
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(log.load(filename, threads));
+    auto loaded = std::chrono::steady_clock::now();
+
+    QVector<double> keys(log.rowCount()), values(log.rowCount());
+    for (int i = 0; i < log.rowCount(); i++) {
+      keys[i] = log.time(i);
+      values[i] = log.value(i, 8);
+    }
+    LogSeries series;
+    series.set(keys, values);
+    auto built = std::chrono::steady_clock::now();
+
+    QVector<double> k, v;
+    series.getRange(keys.first(), keys.last(), 1920, k, v);
+    auto ranged = std::chrono::steady_clock::now();
+
+    printf("%d MB, %d rows, %s: load %lld ms, series %lld ms, full range %lld us (%d points)\n",
+           megabytes, log.rowCount(), threads ? "1 thread" : "all threads",
+           (long long)std::chrono::duration_cast<std::chrono::milliseconds>(loaded - start).count(),
+           (long long)std::chrono::duration_cast<std::chrono::milliseconds>(built - loaded).count(),
+           (long long)std::chrono::duration_cast<std::chrono::microseconds>(ranged - built).count(),
+           k.count());
+  }
+}
@@ -0,0 +1,170 @@
+#include "gtests.h"
+#include "location.h"
+#include "storage/etx.h"
+#include "multimodelprinter.h"
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <functional>
+
+#define PRINTED_MODELS 100
+
+class ModelPrinterTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+      previous = Firmware::getCurrentVariant();
+      firmware = Firmware::getFirmwareForFlavour("x12s");
+      ASSERT_NE(nullptr, firmware);
+      Firmware::setCurrentVariant(firmware);
+
+      EtxFormat etx(RADIO_TESTS_PATH "/model_22_x12s.etx");
+      ASSERT_TRUE(etx.load(radio));
+
+      QVector<const ModelData *> used;
+      for (const auto & model : radio.models) {
+        if (model.used)
+          used.append(&model);
+      }
+      ASSERT_FALSE(used.isEmpty());
+
+      models.resize(PRINTED_MODELS);
+      for (int i = 0; i < PRINTED_MODELS; i++) {
+        models[i] = *used[i % used.size()];
+        snprintf(models[i].name, sizeof(models[i].name), "Model %d", i);
+      }
+    }
+
+    void TearDown() override
+    {
+      Firmware::setCurrentVariant(previous);
+      MultiModelPrinter::setThreadCount(0);
+      MultiModelPrinter::clearCache();
+    }
+
+    // The curve image names contain the address of their ModelPrinter:
+    // removed to compare the output of different printers
+    static QString normalized(QString html)
+    {
+      static const QRegularExpression curveImage("mydata://curve-\\d+-");
+      return html.replace(curveImage, "mydata://curve-");
+    }
+
+    QString printModel(const ModelData & model)
+    {
+      MultiModelPrinter printer(firmware);
+      printer.setModel(0, &model, &radio.generalSettings);
+      return normalized(printer.print(nullptr));
+    }
+
+    // Each model printed on its own, as a batch print does
+    QStringList printModels()
+    {
+      QStringList result;
+      for (const auto & model : models)
+        result.append(printModel(model));
+      return result;
+    }
+
+    qint64 timedPrint(QStringList & result)
+    {
+      QElapsedTimer timer;
+      timer.start();
+      result = printModels();
+      return timer.elapsed();
+    }
+
+    Firmware * previous = nullptr;
+    Firmware * firmware = nullptr;
+    RadioData radio;
+    std::vector<ModelData> models;
+};
+
+TEST_F(ModelPrinterTest, cachedSections)
+{
+  QStringList serial, parallel, cached;
+
+  MultiModelPrinter::clearCache();
+  MultiModelPrinter::setThreadCount(1);
+  qint64 serialTime = timedPrint(serial);
+
+  MultiModelPrinter::clearCache();
+  MultiModelPrinter::setThreadCount(0);
+  qint64 parallelTime = timedPrint(parallel);
+  qint64 cachedTime = timedPrint(cached);
+
+  EXPECT_EQ(serial, parallel);
+  EXPECT_EQ(serial, cached);
+
+  // one mix edited: the cached sections of the other models and the
+  // other sections of this model must give the same output as a full
+  // render
+  ModelData & edited = models[PRINTED_MODELS / 2];
+  int mix = 0;
+  while (mix < CPN_MAX_MIXERS && edited.mixData[mix].isEmpty())
+    mix++;
+  ASSERT_LT(mix, CPN_MAX_MIXERS);
+  edited.mixData[mix].weight = edited.mixData[mix].weight == 42 ? 43 : 42;
+
+  QStringList updated;
+  qint64 updatedTime = timedPrint(updated);
+  EXPECT_NE(cached[PRINTED_MODELS / 2], updated[PRINTED_MODELS / 2]);
+
+  MultiModelPrinter::clearCache();
+  EXPECT_EQ(printModels(), updated);
+
+  printf("%d models printed: serial %lld ms, parallel %lld ms, cached %lld ms, one mix edited %lld ms\n",
+         PRINTED_MODELS, serialTime, parallelTime, cachedTime, updatedTime);
+}
+
+// Each edit must be printed as a full render would: a section reading the
+// edited data without the matching SectionDependency would come from the
+// cache unchanged
+TEST_F(ModelPrinterTest, sectionDependencies)
+{
+  ModelData & model = models[0];
+  int mix = 0;
+  while (mix < CPN_MAX_MIXERS && model.mixData[mix].isEmpty())
+    mix++;
+  ASSERT_LT(mix, CPN_MAX_MIXERS);
+  MixData & mixData = model.mixData[mix];
+  CustomFunctionData & fn = model.customFn[0];
+
+  const std::vector<std::pair<const char *, std::function<void()>>> edits = {
+    { "model name", [&]() { strcpy(model.name, "Edited"); } },
+    { "mix weight", [&]() { mixData.weight = mixData.weight == 42 ? 43 : 42; } },
+    { "mix source", [&]() { mixData.srcRaw = RawSource(SOURCE_TYPE_MAX); } },
+    { "mix channel", [&]() { mixData.destCh = mixData.destCh == 1 ? 2 : 1; } },
+    { "mix name", [&]() { strcpy(mixData.name, "edited"); } },
+    { "special function switch", [&]() { fn.swtch = RawSwitch(fn.swtch.type == SWITCH_TYPE_ON ? SWITCH_TYPE_OFF : SWITCH_TYPE_ON); } },
+    { "special function", [&]() { fn.func = fn.func == FuncBacklight ? FuncPlaySound : FuncBacklight; } },
+    { "special function enabled", [&]() { fn.enabled = !fn.enabled; } },
+  };
+
+  MultiModelPrinter::clearCache();
+  for (const auto & edit : edits) {
+    QString before = printModel(model);
+    edit.second();
+    QString cached = printModel(model);
+    EXPECT_NE(before, cached) << edit.first;
+    MultiModelPrinter::clearCache();
+    EXPECT_EQ(printModel(model), cached) << edit.first;
+  }
+}
+
+// Models side by side, as the compare dialog does
+TEST_F(ModelPrinterTest, compareColumns)
+{
+  MultiModelPrinter printer(firmware);
+  printer.setModel(0, &models[0], &radio.generalSettings);
+  printer.setModel(1, &models[1], &radio.generalSettings);
+  QString before = printer.print(nullptr);
+
+  models[1].customFn[0].enabled = !models[1].customFn[0].enabled;
+  QString after = printer.print(nullptr);
+
+  MultiModelPrinter::clearCache();
+  EXPECT_EQ(after, printer.print(nullptr));
+  EXPECT_EQ(before.contains("mpc-diff"), true);
+}
@@ -0,0 +1,123 @@
+#include "gtests.h"
+#include "process_sync.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+static void writeFile(const QString & path, qint64 size, char fill)
+{
+  QDir().mkpath(QFileInfo(path).absolutePath());
+  QFile file(path);
+  ASSERT_TRUE(file.open(QFile::WriteOnly));
+  ASSERT_EQ(size, file.write(QByteArray(size, fill)));
+}
+
+static QByteArray readFile(const QString & path)
+{
+  QFile file(path);
+  return file.open(QFile::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+static SyncProcess::SyncStatus syncFolders(const QString & folderA, const QString & folderB)
+{
+  SyncProcess::SyncOptions options;
+  options.folderA = folderA;
+  options.folderB = folderB;
+  options.direction = SyncProcess::SYNC_A2B;
+  options.compareType = SyncProcess::OVERWR_IF_DIFF;
+  options.maxFileSize = 0;
+
+  SyncProcess::SyncStatus status;
+  status.clear();
+  SyncProcess sync(options);
+  QObject::connect(&sync, &SyncProcess::statusUpdate, [&status](const SyncProcess::SyncStatus & s) { status = s; });
+  sync.run();
+  return status;
+}
+
+TEST(SyncProcess, manifest)
+{
+  QTemporaryDir dir;
+  const QString folderA = dir.filePath("A");
+  const QString folderB = dir.filePath("B");
+
+  for (int i = 0; i < 20; i++)
+    writeFile(QString("%1/SOUNDS/%2/file%3.wav").arg(folderA).arg(i % 2 ? "en" : "fr").arg(i), 4096, 'a' + i);
+
+  SyncProcess::SyncStatus status = syncFolders(folderA, folderB);
+  EXPECT_EQ(20, status.created);
+  EXPECT_EQ(0, status.errored);
+  // only the destination gets a manifest
+  EXPECT_FALSE(QFile::exists(folderA + "/" SYNC_MANIFEST_NAME));
+  EXPECT_TRUE(QFile::exists(folderB + "/" SYNC_MANIFEST_NAME));
+
+  // same size, other content
+  writeFile(folderA + "/SOUNDS/fr/file0.wav", 4096, 'z');
+  writeFile(folderA + "/SOUNDS/en/file1.wav", 4096, 'z');
+  // other size
+  writeFile(folderA + "/SOUNDS/fr/file2.wav", 1024, 'z');
+
+  status = syncFolders(folderA, folderB);
+  EXPECT_EQ(0, status.created);
+  EXPECT_EQ(3, status.updated);
+  EXPECT_EQ(17, status.skipped);
+  EXPECT_EQ(0, status.errored);
+  EXPECT_EQ(QByteArray(4096, 'z'), readFile(folderB + "/SOUNDS/en/file1.wav"));
+  EXPECT_EQ(QByteArray(1024, 'z'), readFile(folderB + "/SOUNDS/fr/file2.wav"));
+
+  status = syncFolders(folderA, folderB);
+  EXPECT_EQ(20, status.skipped);
+  EXPECT_EQ(0, status.updated);
+
+  // a manifest which can't be saved is reported
+  writeFile(folderA + "/SOUNDS/fr/file4.wav", 1024, 'z');
+  ASSERT_TRUE(QFile::remove(folderB + "/" SYNC_MANIFEST_NAME));
+  ASSERT_TRUE(QDir(folderB).mkdir(SYNC_MANIFEST_NAME));
+  status = syncFolders(folderA, folderB);
+  EXPECT_EQ(1, status.updated);
+  EXPECT_EQ(1, status.errored);
+}
+
+// Sync of a SD card like tree, then re-sync with a few files changed,
+// without and with the manifests
+// gtests-companion --gtest_also_run_disabled_tests --gtest_filter=SyncProcess.*
+TEST(SyncProcess, DISABLED_incrementalBenchmark)
+{
+  const int files = 512;
+  const qint64 fileSize = 128 * 1024;
+  QTemporaryDir dir;
+  const QString folderA = dir.filePath("A");
+  const QString folderB = dir.filePath("B");
+  QElapsedTimer timer;
+
+  for (int i = 0; i < files; i++)
+    writeFile(QString("%1/DIR%2/file%3.bin").arg(folderA).arg(i % 16).arg(i), fileSize, 'a' + i % 26);
+
+  timer.start();
+  SyncProcess::SyncStatus status = syncFolders(folderA, folderB);
+  const qint64 fullSync = timer.elapsed();
+  EXPECT_EQ(files, status.created);
+
+  for (int i = 0; i < 4; i++)
+    writeFile(QString("%1/DIR%2/file%3.bin").arg(folderA).arg(i % 16).arg(i), fileSize, 'Z');
+  QFile::remove(folderB + "/" SYNC_MANIFEST_NAME);
+
+  timer.start();
+  status = syncFolders(folderA, folderB);
+  const qint64 hashedSync = timer.elapsed();
+  EXPECT_EQ(4, status.updated);
+  EXPECT_EQ(files - 4, status.skipped);
+
+  for (int i = 4; i < 8; i++)
+    writeFile(QString("%1/DIR%2/file%3.bin").arg(folderA).arg(i % 16).arg(i), fileSize, 'Z');
+
+  timer.start();
+  status = syncFolders(folderA, folderB);
+  const qint64 manifestSync = timer.elapsed();
+  EXPECT_EQ(4, status.updated);
+  EXPECT_EQ(files - 4, status.skipped);
+  EXPECT_EQ(0, status.errored);
+
+  printf("%d files, %lldMB: full sync %lldms, re-sync %lldms, with manifests %lldms\n",
+         files, files * fileSize / (1024 * 1024), fullSync, hashedSync, manifestSync);
+}
@@ -38,6 +38,8 @@
 
 #include "tasks.h"
 #include "tasks/mixer_task.h"
+#include "mixer_outputs.h"
+#include "tasks/task_placement.h"
 
 #include "cli.h"
 
@@ -502,6 +504,7 @@ int cliTestNew()
 }
 
 #if defined(COLORLCD)
+#include "text_cache.h"
 
 extern bool perMainEnabled;
 typedef void (*timedTestFunc_t)(void);
@@ -552,6 +555,31 @@ void testDrawText()
               COLOR_THEME_SECONDARY1);
 }
 
+// short texts drawn on each frame by widgets
+void testDrawTextLabels()
+{
+  static const char* const labels[] = {"RSSI", "-67dB", "RxBt", "7.4V",
+                                       "Alt",  "123m",  "Curr", "12.5A"};
+  for (unsigned i = 0; i < DIM(labels); i++) {
+    lcdDrawText((i & 1) ? LCD_W / 2 : 0, (i / 2) * 30, labels[i],
+                COLOR_THEME_SECONDARY1 | ((i & 1) ? RIGHT : 0));
+  }
+}
+
+void testDrawTextUncached()
+{
+  textCache.setEnabled(false);
+  testDrawText();
+  textCache.setEnabled(true);
+}
+
+void testDrawTextLabelsUncached()
+{
+  textCache.setEnabled(false);
+  testDrawTextLabels();
+  textCache.setEnabled(true);
+}
+
 void testDrawTextVertical()
 {
   lcdDrawText(30, LCD_H, "The quick brown fox ",
@@ -610,8 +638,16 @@ int cliTestGraphics()
   result += RUN_GRAPHICS_TEST(testDrawBlackOverlay, 1000);
   result += RUN_GRAPHICS_TEST(testDrawText, 1000);
   result += RUN_GRAPHICS_TEST(testDrawTextVertical, 1000);
+  result += RUN_GRAPHICS_TEST(testDrawTextLabels, 1000);
   result += RUN_GRAPHICS_TEST(testClear, 1000);
 
+  // not in the total: same texts, drawn by LVGL
+  RUN_GRAPHICS_TEST(testDrawTextUncached, 1000);
+  RUN_GRAPHICS_TEST(testDrawTextLabelsUncached, 1000);
+  TextCacheStats stats = textCache.getStats();
+  cliSerialPrint("Text cache: %lu hits, %lu misses, %u entries, %lu bytes",
+                 stats.hits, stats.misses, stats.entries, stats.bytesUsed);
+
   cliSerialPrint("Total speed: %lu.%02u", uint32_t(result),
               uint16_t((result - uint32_t(result)) * 100.0f));
 
@@ -863,6 +899,31 @@ int cliStackInfo(const char ** argv)
   return 0;
 }
 
+// CPU usage is measured since the previous call
+int cliTasks(const char ** argv)
+{
+  TaskStats stats[MAX_TASKS_STATS];
+  uint8_t count = getTasksStats(stats, MAX_TASKS_STATS);
+
+  cliSerialPrint("task             core prio  stack free   cpu");
+  for (uint8_t i = 0; i < count; i++) {
+    const TaskStats & task = stats[i];
+    char core[4] = "any";
+    if (task.core != TASK_ANY_CORE) {
+      snprintf(core, sizeof(core), "%d", task.core);
+    }
+    if (task.load == TASK_LOAD_UNKNOWN) {
+      cliSerialPrint("%-16s %4s %4d %11d     -", task.name, core,
+                     task.priority, task.stackFree);
+    } else {
+      cliSerialPrint("%-16s %4s %4d %11d %3d.%d%%", task.name, core,
+                     task.priority, task.stackFree, task.load / 10,
+                     task.load % 10);
+    }
+  }
+  return 0;
+}
+
 extern int _heap_start;
 extern int _heap_end;
 extern unsigned char *heap;
@@ -908,11 +969,96 @@ int cliMemoryInfo(const char ** argv)
   cliSerialPrint("------------");
   cliSerialPrint("\tTotal   %u", s + w + e);
 #endif
+  cliSerialPrint("\nLua GC:");
+  cliSerialPrint("\tsteps %u (%u us), cycles %u, full %u", luaGcStats.steps,
+                 luaGcStats.stepTime / 16, luaGcStats.cycles,
+                 luaGcStats.fullCollections);
+  cliSerialPrint("\tpauses <0.5ms %u, <1ms %u, <2ms %u, <5ms %u, more %u",
+                 luaGcStats.pauses[0], luaGcStats.pauses[1],
+                 luaGcStats.pauses[2], luaGcStats.pauses[3],
+                 luaGcStats.pauses[4]);
+  cliSerialPrint("\tmax pause %u us", luaGcStats.maxPauseUs);
 #endif
   return 0;
 }
 #endif
 
+#if defined(LUA)
+static const char * const luaBudgetStates[] = {"ok", "throttled", "cpu", "mem"};
+
+static void cliLuaPrintStats(const char * name, LuaScriptStats & stats, void * ctx)
+{
+  cliSerialPrint("%-10s %6u %6u %6u %8u %7d %7u %8u %s/%u", name, stats.lastUs,
+                 stats.maxUs, stats.runs, stats.allocated, stats.memory,
+                 stats.timeBudgetUs, stats.memBudget,
+                 luaBudgetStates[stats.state], stats.throttle);
+}
+
+struct CliLuaBudget {
+  const char * name;
+  uint32_t timeBudgetUs;
+  uint32_t memBudget;
+  int count;
+};
+
+static void cliLuaSetBudget(const char * name, LuaScriptStats & stats, void * ctx)
+{
+  CliLuaBudget * budget = (CliLuaBudget *)ctx;
+  if (strcmp(name, budget->name) || stats.policy == LUA_POLICY_EXEMPT) return;
+  stats.timeBudgetUs = budget->timeBudgetUs;
+  stats.memBudget = budget->memBudget;
+  budget->count++;
+}
+
+int cliLua(const char ** argv)
+{
+  const char * cmd = argv[1] ? argv[1] : "";
+  if (!strcmp(cmd, "budget")) {
+    int us, bytes;
+    if (!argv[4] || toInt(argv, 3, &us) <= 0 || us < 0 || toInt(argv, 4, &bytes) <= 0 || bytes < 0) {
+      cliSerialPrint("%s: invalid budget", argv[0]);
+      return -1;
+    }
+    CliLuaBudget budget = {argv[2], (uint32_t)us, (uint32_t)bytes, 0};
+    luaForEachStats(cliLuaSetBudget, &budget);
+    cliSerialPrint("%d script(s) updated", budget.count);
+    return 0;
+  }
+
+  if (!strcmp(cmd, "limits")) {
+    // budgets of the scripts and widgets loaded from now on
+    int values[5];
+    int count = 0;
+    while (count < 5 && argv[2 + count] &&
+           toInt(argv, 2 + count, &values[count]) > 0 && values[count] >= 0) {
+      count++;
+    }
+    if (count == 5) {
+      luaBudgets.scriptTimeUs = values[0];
+      luaBudgets.widgetTimeUs = values[1];
+      luaBudgets.memory = values[2];
+      luaBudgets.maxOverruns = limit(1, values[3], 255);
+      luaBudgets.maxThrottle = limit(0, values[4], 7);
+    }
+    else if (count > 0 || (argv[2] && argv[2][0])) {
+      cliSerialPrint("%s: invalid limits", argv[0]);
+      return -1;
+    }
+    cliSerialPrint("script %uus, widget %uus, memory %u, overruns %u, throttle %u",
+                   luaBudgets.scriptTimeUs, luaBudgets.widgetTimeUs,
+                   luaBudgets.memory, luaBudgets.maxOverruns,
+                   luaBudgets.maxThrottle);
+    return 0;
+  }
+
+  // times in us, memory in bytes, budgets of 0 are unlimited
+  cliSerialPrint("%-10s %6s %6s %6s %8s %7s %7s %8s %s", "name", "last", "max",
+                 "runs", "alloc", "mem", "budget", "membudg", "state");
+  luaForEachStats(cliLuaPrintStats, nullptr);
+  return 0;
+}
+#endif
+
 int cliReboot(const char ** argv)
 {
 #if !defined(SIMU)
@@ -1307,8 +1453,10 @@ int cliDisplay(const char ** argv)
     }
   }
   else if (!strcmp(argv[1], "outputs")) {
+    MixerOutputs outputs;
+    mixerOutputsRead(outputs);
     for (int i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
-      cliSerialPrint("outputs[%d] = %04d", i, (int)channelOutputs[i]);
+      cliSerialPrint("outputs[%d] = %04d", i, (int)outputs.channels[i]);
     }
   }
   else if (!strcmp(argv[1], "rtc")) {
@@ -1375,6 +1523,17 @@ int cliDisplay(const char ** argv)
     printInterrupts();
   }
 #endif
+  else if (!strcmp(argv[1], "modelload")) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < getModelLoadStagesCount(); i++) {
+      uint32_t duration = getModelLoadStageDuration(i);
+      cliSerialPrint("[%s] %uus%s", getModelLoadStageName(i), duration,
+                     isModelLoadStageDeferred(i) ? " (deferred)" : "");
+      total += duration;
+    }
+    cliSerialPrint("total %uus%s", total,
+                   isModelLoadPending() ? " (pending)" : "");
+  }
 #if defined(DEBUG_TIMERS)
   else if (!strcmp(argv[1], "dt")) {
     printDebugTimers();
@@ -1628,6 +1787,7 @@ const CliCommand cliCommands[] = {
   { "print", cliDisplay, "<address> [<size>] | <what>" },
   { "p", cliDisplay, "<address> [<size>] | <what>" },
   { "stackinfo", cliStackInfo, "" },
+  { "tasks", cliTasks, "" },
   { "meminfo", cliMemoryInfo, "" },
   { "test", cliTest, "new | graphics | memspd" },
   { "trace", cliTrace, "on | off" },
@@ -1635,6 +1795,9 @@ const CliCommand cliCommands[] = {
   { "repeat", cliRepeat, "<interval> <command>" },
 #endif
   { "help", cliHelp, "[<command>]" },
+#if defined(LUA)
+  { "lua", cliLua, "[budget <name> <us> <bytes>] [limits [<script us> <widget us> <bytes> <overruns> <throttle>]]" },
+#endif
 #if defined(JITTER_MEASURE)
   { "jitter", cliShowJitter, "" },
 #endif
@@ -20,6 +20,7 @@
  */
 
 #include "opentx.h"
+#include "tasks/mixer_task.h"
 
 #if defined(LIBOPENUI)
   #include "libopenui.h"
@@ -31,12 +32,8 @@ constexpr int CUSTOM_CURVE_POINTS(int p) { return 2 * p + (2 * DEFAULT_POINTS -
 
 int8_t * curveEnd[MAX_CURVES];
 
-uint8_t getCurvePoints(uint8_t index)
+static uint8_t getCurvePoints(const CurveHeader & curve)
 {
-  if (index >= MAX_CURVES)
-    return 0;
-
-  const auto& curve = g_model.curves[index];
   if (curve.type == CURVE_TYPE_STANDARD)
     return STD_CURVE_POINTS(curve.points);
   else if (curve.type == CURVE_TYPE_CUSTOM)
@@ -45,6 +42,14 @@ uint8_t getCurvePoints(uint8_t index)
   return 0;
 }
 
+uint8_t getCurvePoints(uint8_t index)
+{
+  if (index >= MAX_CURVES)
+    return 0;
+
+  return getCurvePoints(g_model.curves[index]);
+}
+
 void loadCurves()
 {
   bool showWarning= false;
@@ -102,15 +107,41 @@ static void curveMove_unsafe(uint8_t index, int8_t shift)
   }
 }
 
-bool moveCurve(uint8_t index, int8_t shift)
+// New curve, committed between two mixer cycles
+struct CurveEdit {
+  uint8_t index;
+  int8_t shift;
+  CurveHeader header;
+  int8_t points[MAX_CURVE_DATA_POINTS];
+};
+
+static void applyCurveEdit(void * ctx)
 {
-  if (curveEnd[MAX_CURVES-1] + shift > g_model.points + sizeof(g_model.points)) {
+  const CurveEdit * edit = (const CurveEdit *)ctx;
+  if (edit->shift != 0) {
+    curveMove_unsafe(edit->index, edit->shift);
+  }
+  g_model.curves[edit->index] = edit->header;
+  memcpy(curveAddress(edit->index), edit->points, getCurvePoints(edit->header));
+}
+
+bool curveUpdate(uint8_t index, const CurveHeader & header, const int8_t * points)
+{
+  if (index >= MAX_CURVES)
+    return false;
+
+  CurveEdit edit;
+  edit.index = index;
+  edit.header = header;
+  edit.shift = getCurvePoints(header) - getCurvePoints(index);
+  if (curveEnd[MAX_CURVES-1] + edit.shift > g_model.points + sizeof(g_model.points)) {
     AUDIO_WARNING2();
     return false;
   }
+  memcpy(edit.points, points, getCurvePoints(header));
+
+  mixerTaskCommitEdit(applyCurveEdit, &edit);
 
-  curveMove_unsafe(index, shift);
-  
   storageDirty(EE_MODEL);
   return true;
 }
@@ -129,35 +160,29 @@ void resetCustomCurveX(int8_t * points, int noPoints)
 
 void curveClear(uint8_t index)
 {
-  if (index >= MAX_CURVES)
-    return;
-  
-  CurveHeader * curve = &g_model.curves[index];
-  int8_t * curvePoints = curveAddress(index);
-
-  uint8_t nPoints = getCurvePoints(index);
-  memclear(curvePoints, nPoints);
-
-  memclear(curve, sizeof(CurveHeader));
-  uint8_t newPoints = getCurvePoints(index);
-  
-  int8_t shift = newPoints - nPoints;
-  if (shift != 0) {
-    curveMove_unsafe(index, shift);
-  }
+  CurveHeader header;
+  memclear(&header, sizeof(CurveHeader));
+
+  int8_t points[MAX_CURVE_DATA_POINTS];
+  memclear(points, sizeof(points));
+
+  curveUpdate(index, header, points);
 }
 
 void curveMirror(uint8_t index)
 {
   if (index >= MAX_CURVES)
     return;
-  
-  CurveHeader & curve = g_model.curves[index];
-  int8_t * points = curveAddress(index);
+
+  const CurveHeader & curve = g_model.curves[index];
+  int8_t points[MAX_CURVE_DATA_POINTS];
+  memcpy(points, curveAddress(index), getCurvePoints(index));
 
   // we only mirror Y axis: X axis does not change
   for (int i = 0; i < STD_CURVE_POINTS(curve.points); i++)
     points[i] = -points[i];
+
+  curveUpdate(index, curve, points);
 }
 
 bool isCurveUsed(uint8_t index)
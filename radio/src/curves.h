@@ -33,12 +33,17 @@ enum BaseCurves {
   CURVE_BASE
 };
 
+// Y then X points of the largest (custom) curve
+#define MAX_CURVE_DATA_POINTS  (2 * MAX_POINTS_PER_CURVE - 2)
+
 void curveClear(uint8_t index);
 void curveMirror(uint8_t index);
 bool isCurveUsed(uint8_t index);
 void loadCurves();
 int8_t * curveAddress(uint8_t idx);
-bool moveCurve(uint8_t index, int8_t shift);
+// Replaces the curve header and its points (Y then X for custom curves)
+// between two mixer cycles. Returns false if the points do not fit.
+bool curveUpdate(uint8_t index, const CurveHeader & header, const int8_t * points);
 int8_t getCurveX(int noPoints, int point);
 void resetCustomCurveX(int8_t * points, int noPoints);
 point_t getPoint(uint8_t i);
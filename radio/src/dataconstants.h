@@ -284,7 +284,8 @@ enum TelemetryProtocol
   PROTOCOL_TELEMETRY_GHOST,
   PROTOCOL_TELEMETRY_FLYSKY_NV14,
   PROTOCOL_TELEMETRY_DSMP,
-  PROTOCOL_TELEMETRY_LAST=PROTOCOL_TELEMETRY_DSMP,
+  PROTOCOL_TELEMETRY_ESPNOW,
+  PROTOCOL_TELEMETRY_LAST=PROTOCOL_TELEMETRY_ESPNOW,
   PROTOCOL_TELEMETRY_LUA
 };
 
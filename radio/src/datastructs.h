@@ -152,7 +152,7 @@ static inline void check_struct()
   CHKSIZE(RadioData, 869);
   CHKSIZE(ModelData, 6265);
 #elif defined(PCB_MUFFIN)
-  CHKSIZE(RadioData, 1048);
+  CHKSIZE(RadioData, 1049);
   CHKSIZE(ModelData, 11475);
 #elif defined(PCBX7)
   CHKSIZE(RadioData, 869);
@@ -165,17 +165,17 @@ static inline void check_struct()
   CHKSIZE(ModelData, 6706);
 #elif defined(PCBHORUS)
   #if defined(RADIO_T15)
-    CHKSIZE(RadioData, 836);
+    CHKSIZE(RadioData, 837);
     CHKSIZE(ModelData, 15632);
   #elif defined(PCBX10)
-    CHKSIZE(RadioData, 836);
+    CHKSIZE(RadioData, 837);
     CHKSIZE(ModelData, 15607);
   #else
-    CHKSIZE(RadioData, 836);
+    CHKSIZE(RadioData, 837);
     CHKSIZE(ModelData, 15607);
   #endif
 #elif defined(PCBNV14)
-  CHKSIZE(RadioData, 836);
+  CHKSIZE(RadioData, 837);
   CHKSIZE(ModelData, 15463);
 #endif
 
@@ -990,6 +990,8 @@ PACK(struct RadioData {
   uint8_t favMultiMode:1;       // 0 = match all (AND), 1 = match any (OR)
 #endif
 
+  NOBACKUP(uint8_t adcFilter:2);  // AdcFilterType of the main controls
+
   NOBACKUP(uint8_t getBrightness() const
   {
 #if defined(OLED_SCREEN)
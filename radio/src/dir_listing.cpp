@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dir_listing.h"
+#include "libopenui/src/libopenui_file.h"
+
+#define DIR_LISTING_FILE        0x80000000u
+#define DIR_LISTING_OFFSET(e)   ((e) & ~DIR_LISTING_FILE)
+#define DIR_LISTING_MAX_PAGE    64
+#define DIR_LISTING_MAX_ENTRIES 0xFFFF
+
+int strnatcasecmp(const char * s1, const char * s2)
+{
+  int i1, i2;
+  char c1, c2;
+
+  i1 = i2 = 0;
+  while (true) {
+    c1 = s1[i1]; c2 = s2[i2];
+
+    if (c1 == 0 && c2 == 0) {
+      return 0;
+    }
+
+    if (isdigit(c1) && isdigit(c2)) {
+      int num_cmp = 0;
+      while (true) {
+        if (!num_cmp) {
+          if (c1 < c2) {
+            num_cmp = -1;
+          } else if (c1 > c2) {
+            num_cmp = 1;
+          }
+        }
+        i1 += 1; i2 += 1;
+        c1 = s1[i1]; c2 = s2[i2];
+        if (!isdigit(c1) && !isdigit(c2))
+          break;
+        if (!isdigit(c1)) {
+          num_cmp = -1;
+          break;
+        }
+        if (!isdigit(c2)) {
+          num_cmp = 1;
+          break;
+        }
+      }
+      if (num_cmp)
+        return num_cmp;
+    }
+
+    c1 = toupper(c1);
+    c2 = toupper(c2);
+
+    if (c1 < c2)
+      return -1;
+
+    if (c1 > c2)
+      return +1;
+
+    i1 += 1; i2 += 1;
+  }
+}
+
+DirListing::~DirListing()
+{
+  clear();
+}
+
+void DirListing::clear()
+{
+  close();
+  free(arena);
+  free(entries);
+  arena = nullptr;
+  entries = nullptr;
+  arenaSize = arenaUsed = 0;
+  count = capacity = 0;
+}
+
+bool DirListing::open(Filter filter)
+{
+  clear();
+  if (f_opendir(&dir, ".") != FR_OK) return false;
+  opened = true;
+  firstTime = true;
+  this->filter = filter;
+  return true;
+}
+
+void DirListing::close()
+{
+  if (opened) {
+    f_closedir(&dir);
+    opened = false;
+  }
+}
+
+const char * DirListing::getName(uint16_t idx) const
+{
+  if (idx >= count) return nullptr;
+  return &arena[DIR_LISTING_OFFSET(entries[idx])];
+}
+
+bool DirListing::isDirectory(uint16_t idx) const
+{
+  return idx < count && !(entries[idx] & DIR_LISTING_FILE);
+}
+
+static bool isParentDirectory(const char * name)
+{
+  return name[0] == '.' && name[1] == '.' && name[2] == '\0';
+}
+
+// "..", then directories, then files
+static int compareEntries(bool isDir1, const char * name1, bool isDir2,
+                          const char * name2)
+{
+  if (isDir1 != isDir2) return isDir1 ? -1 : 1;
+  bool parent1 = isParentDirectory(name1);
+  bool parent2 = isParentDirectory(name2);
+  if (parent1 || parent2) return (int)parent2 - (int)parent1;
+  return strnatcasecmp(name1, name2);
+}
+
+int DirListing::find(const char * name, bool isDirectory) const
+{
+  // binary search, same order as isBefore()
+  int lo = 0, hi = count - 1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    int cmp = compareEntries(!(entries[mid] & DIR_LISTING_FILE),
+                             &arena[DIR_LISTING_OFFSET(entries[mid])],
+                             isDirectory, name);
+    if (cmp == 0) return mid;
+    if (cmp < 0)
+      lo = mid + 1;
+    else
+      hi = mid - 1;
+  }
+  return -1;
+}
+
+uint32_t DirListing::getAllocatedSize() const
+{
+  return arenaSize + capacity * sizeof(uint32_t);
+}
+
+bool DirListing::isBefore(uint32_t a, uint32_t b) const
+{
+  return compareEntries(!(a & DIR_LISTING_FILE), &arena[DIR_LISTING_OFFSET(a)],
+                        !(b & DIR_LISTING_FILE), &arena[DIR_LISTING_OFFSET(b)]) < 0;
+}
+
+bool DirListing::addName(const char * name, uint32_t & offset)
+{
+  uint32_t len = strlen(name) + 1;
+  if (arenaUsed + len > arenaSize) {
+    // grow by half (names are short, avoid many small reallocs)
+    uint32_t size = arenaSize + arenaSize / 2;
+    if (size < arenaUsed + len) size = arenaUsed + len + 256;
+    char * p = (char *)realloc(arena, size);
+    if (!p) return false;
+    arena = p;
+    arenaSize = size;
+  }
+  offset = arenaUsed;
+  memcpy(&arena[arenaUsed], name, len);
+  arenaUsed += len;
+  return true;
+}
+
+bool DirListing::reserve(uint16_t entriesCount)
+{
+  if (entriesCount <= capacity) return true;
+  uint32_t size = capacity + capacity / 2;
+  if (size < entriesCount) size = entriesCount + DIR_LISTING_MAX_PAGE;
+  if (size > DIR_LISTING_MAX_ENTRIES) size = DIR_LISTING_MAX_ENTRIES;
+  uint32_t * p = (uint32_t *)realloc(entries, size * sizeof(uint32_t));
+  if (!p) return false;
+  entries = p;
+  capacity = size;
+  return true;
+}
+
+bool DirListing::readPage(uint16_t pageSize)
+{
+  if (!opened) return true;
+  if (pageSize > DIR_LISTING_MAX_PAGE) pageSize = DIR_LISTING_MAX_PAGE;
+
+  // room for the whole page first, names are only added once it fits
+  uint32_t needed = (uint32_t)count + pageSize;
+  if (needed > DIR_LISTING_MAX_ENTRIES) needed = DIR_LISTING_MAX_ENTRIES;
+  if (!reserve(needed)) {
+    close();
+    return true;
+  }
+
+  // read and sort the page (insertion sort, small)
+  uint32_t page[DIR_LISTING_MAX_PAGE];
+  uint16_t pageCount = 0;
+  bool complete = false;
+
+  while (pageCount < pageSize) {
+    FILINFO fno;
+    FRESULT res = sdReadDir(&dir, &fno, firstTime);
+    if (res != FR_OK || fno.fname[0] == 0) {
+      complete = true;
+      break;
+    }
+    if (filter && !filter(fno)) continue;
+    if (count + pageCount >= DIR_LISTING_MAX_ENTRIES) {
+      complete = true;
+      break;
+    }
+
+    uint32_t entry;
+    if (!addName(fno.fname, entry)) {
+      complete = true;
+      break;
+    }
+    if (!(fno.fattrib & AM_DIR)) entry |= DIR_LISTING_FILE;
+
+    uint16_t i = pageCount++;
+    while (i > 0 && isBefore(entry, page[i - 1])) {
+      page[i] = page[i - 1];
+      i--;
+    }
+    page[i] = entry;
+  }
+
+  // merge the page into the listing, from the end
+  if (pageCount > 0) {
+    int i = count - 1, j = pageCount - 1, k = count + pageCount - 1;
+    while (j >= 0) {
+      if (i >= 0 && isBefore(page[j], entries[i]))
+        entries[k--] = entries[i--];
+      else
+        entries[k--] = page[j--];
+    }
+    count += pageCount;
+  }
+
+  if (complete) close();
+  return complete;
+}
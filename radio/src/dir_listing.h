@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include "ff.h"
+
+//
+// Sorted directory listing, read a page of entries at a time
+//
+// Names are stored one after the other in a single buffer (arena), the
+// listing itself is an array of offsets in the arena, kept sorted as the
+// pages are read: directories first, then files, each in natural order
+// ("file2" before "file10"), not case sensitive. Entries indexes change
+// until the listing is complete.
+//
+
+// natural comparison, not case sensitive
+int strnatcasecmp(const char * s1, const char * s2);
+
+class DirListing
+{
+ public:
+  // returns false for entries to skip
+  typedef bool (*Filter)(const FILINFO & fno);
+
+  DirListing() = default;
+  ~DirListing();
+
+  // lists the current directory ("..", if not at the root, included)
+  bool open(Filter filter = nullptr);
+  void close();
+
+  // reads up to 'count' entries, returns true once the listing is complete
+  bool readPage(uint16_t count);
+  bool isComplete() const { return !opened; }
+
+  uint16_t size() const { return count; }
+  const char * getName(uint16_t idx) const;
+  bool isDirectory(uint16_t idx) const;
+
+  // index of an entry, or -1 (for the selection while the listing grows)
+  int find(const char * name, bool isDirectory) const;
+
+  // heap used by the listing (bytes)
+  uint32_t getAllocatedSize() const;
+
+ protected:
+  DIR dir;
+  bool opened = false;
+  bool firstTime = false;
+  Filter filter = nullptr;
+
+  char * arena = nullptr;
+  uint32_t arenaSize = 0;
+  uint32_t arenaUsed = 0;
+
+  uint32_t * entries = nullptr;  // arena offset | DIR_LISTING_FILE
+  uint16_t count = 0;
+  uint16_t capacity = 0;
+
+  bool addName(const char * name, uint32_t & offset);
+  bool reserve(uint16_t entriesCount);
+  void clear();
+  bool isBefore(uint32_t a, uint32_t b) const;
+};
@@ -23,7 +23,16 @@
 #define _FIFO_H_
 
 #include <inttypes.h>
-
+#include <atomic>
+
+// Single producer / single consumer ring buffer, usable between an ISR
+// and a task, or between tasks running on different cores: the producer
+// publishes 'widx' with release semantics after writing the elements,
+// the consumer publishes 'ridx' the same way after reading them.
+//
+// Producer side: push(), pushSpan() / pushCommit(), isFull(), hasSpace()
+// Consumer side: pop(), popSpan() / popCommit(), probe(), skip()
+// clear() must not race with any of them.
 template <class T, int N>
 class Fifo
 {
@@ -38,49 +47,135 @@ class Fifo
 
     void clear()
     {
-      widx = ridx = 0;
+      widx.store(0, std::memory_order_relaxed);
+      ridx.store(0, std::memory_order_release);
     }
 
-    void push(T element)
+    bool push(T element)
     {
-      uint32_t next = nextIndex(widx);
-      if (next != ridx) {
-        fifo[widx] = element;
-        widx = next;
+      uint32_t w = widx.load(std::memory_order_relaxed);
+      uint32_t next = nextIndex(w);
+      if (next == ridx.load(std::memory_order_acquire)) {
+        overflows.store(overflows.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+        return false;
       }
+      fifo[w] = element;
+      widx.store(next, std::memory_order_release);
+      updateHighWaterMark(next);
+      return true;
+    }
+
+    // Pushes up to 'count' elements, returns the number pushed
+    uint32_t push(const T * elements, uint32_t count)
+    {
+      uint32_t pushed = 0;
+      while (pushed < count) {
+        uint32_t len;
+        T * span = pushSpan(len);
+        if (len == 0) {
+          overflows.store(overflows.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+          break;
+        }
+        if (len > count - pushed) len = count - pushed;
+        for (uint32_t i = 0; i < len; i++) {
+          span[i] = elements[pushed + i];
+        }
+        pushCommit(len);
+        pushed += len;
+      }
+      return pushed;
+    }
+
+    // Contiguous free region starting at the write index ('len' elements,
+    // 0 if full), to be filled (memcpy, DMA) then published by pushCommit()
+    T * pushSpan(uint32_t & len)
+    {
+      uint32_t w = widx.load(std::memory_order_relaxed);
+      uint32_t r = ridx.load(std::memory_order_acquire);
+      if (r > w)
+        len = r - w - 1;
+      else
+        len = N - w - (r == 0 ? 1 : 0);
+      return &fifo[w];
+    }
+
+    void pushCommit(uint32_t count)
+    {
+      uint32_t next = (widx.load(std::memory_order_relaxed) + count) & (N - 1);
+      widx.store(next, std::memory_order_release);
+      updateHighWaterMark(next);
     }
 
     void skip()
     {
-      ridx = nextIndex(ridx);
+      popCommit(1);
     }
 
     bool pop(T & element)
     {
-      if (isEmpty()) {
+      uint32_t r = ridx.load(std::memory_order_relaxed);
+      if (r == widx.load(std::memory_order_acquire)) {
         return false;
       }
       else {
-        element = fifo[ridx];
-        ridx = nextIndex(ridx);
+        element = fifo[r];
+        ridx.store(nextIndex(r), std::memory_order_release);
         return true;
       }
     }
 
+    // Pops up to 'count' elements, returns the number popped
+    uint32_t pop(T * elements, uint32_t count)
+    {
+      uint32_t popped = 0;
+      while (popped < count) {
+        uint32_t len;
+        const T * span = popSpan(len);
+        if (len == 0) break;
+        if (len > count - popped) len = count - popped;
+        for (uint32_t i = 0; i < len; i++) {
+          elements[popped + i] = span[i];
+        }
+        popCommit(len);
+        popped += len;
+      }
+      return popped;
+    }
+
+    // Contiguous filled region starting at the read index ('len' elements,
+    // 0 if empty), to be released by popCommit() once consumed
+    const T * popSpan(uint32_t & len) const
+    {
+      uint32_t r = ridx.load(std::memory_order_relaxed);
+      uint32_t w = widx.load(std::memory_order_acquire);
+      len = (w >= r) ? w - r : N - r;
+      return &fifo[r];
+    }
+
+    void popCommit(uint32_t count)
+    {
+      uint32_t r = ridx.load(std::memory_order_relaxed);
+      ridx.store((r + count) & (N - 1), std::memory_order_release);
+    }
+
     bool isEmpty() const
     {
-      return (ridx == widx);
+      return (ridx.load(std::memory_order_acquire) ==
+              widx.load(std::memory_order_acquire));
     }
 
     bool isFull() const
     {
-      uint32_t next = nextIndex(widx);
-      return (next == ridx);
+      uint32_t next = nextIndex(widx.load(std::memory_order_relaxed));
+      return (next == ridx.load(std::memory_order_acquire));
     }
 
     uint32_t size() const
     {
-      return (N + widx - ridx) & (N - 1);
+      return (N + widx.load(std::memory_order_acquire) -
+              ridx.load(std::memory_order_acquire)) & (N - 1);
     }
 
     bool hasSpace(uint32_t n) const
@@ -90,11 +185,12 @@ class Fifo
 
     bool probe(T & element) const
     {
-      if (isEmpty()) {
+      uint32_t r = ridx.load(std::memory_order_relaxed);
+      if (r == widx.load(std::memory_order_acquire)) {
         return false;
       }
       else {
-        element = fifo[ridx];
+        element = fifo[r];
         return true;
       }
     }
@@ -104,15 +200,44 @@ class Fifo
       return fifo;
     }
 
+    // Highest number of elements seen in the fifo since the last resetStats()
+    uint32_t getHighWaterMark() const
+    {
+      return highWaterMark.load(std::memory_order_relaxed);
+    }
+
+    // Number of push calls which dropped elements because the fifo was full
+    uint32_t getOverflows() const
+    {
+      return overflows.load(std::memory_order_relaxed);
+    }
+
+    void resetStats()
+    {
+      highWaterMark.store(0, std::memory_order_relaxed);
+      overflows.store(0, std::memory_order_relaxed);
+    }
+
   protected:
     T fifo[N];
-    volatile uint32_t widx;
-    volatile uint32_t ridx;
+    std::atomic<uint32_t> widx;
+    std::atomic<uint32_t> ridx;
+    std::atomic<uint32_t> highWaterMark = {0};
+    std::atomic<uint32_t> overflows = {0};
 
     static inline uint32_t nextIndex(uint32_t idx)
     {
       return (idx + 1) & (N - 1);
     }
+
+    // producer side only
+    void updateHighWaterMark(uint32_t w)
+    {
+      uint32_t used = (N + w - ridx.load(std::memory_order_relaxed)) & (N - 1);
+      if (used > highWaterMark.load(std::memory_order_relaxed)) {
+        highWaterMark.store(used, std::memory_order_relaxed);
+      }
+    }
 };
 
 #endif // _FIFO_H_
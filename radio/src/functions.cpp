@@ -134,6 +134,66 @@ bool isRepeatDelayElapsed(const CustomFunctionData * functions, CustomFunctionsC
   }
 }
 
+// Functions doing their work only when their switch changes
+static bool isEdgeFunction(const CustomFunctionData * cfn)
+{
+  switch (CFN_FUNC(cfn)) {
+    case FUNC_RESET:
+      return CFN_PARAM(cfn) == FUNC_RESET_FLIGHT;
+#if defined(GVARS)
+    case FUNC_ADJUST_GVAR:
+      return CFN_GVAR_MODE(cfn) == FUNC_ADJUST_GVAR_INCDEC;
+#endif
+    case FUNC_SCREENSHOT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Lists the functions with a switch, and their distinct triggers
+static void buildFunctionsIndex(const CustomFunctionData * functions, CustomFunctionsContext & functionsContext)
+{
+  CustomFunctionsIndex & index = functionsContext.index;
+
+  // an edit during the build bumps the generation again and the index
+  // is rebuilt on the next pass
+  uint16_t generation = functionsContext.generation;
+
+  index.count = 0;
+  index.switchesCount = 0;
+  index.edgeFunctions = 0;
+
+  for (uint8_t i=0; i<MAX_SPECIAL_FUNCTIONS; i++) {
+    const CustomFunctionData * cfn = &functions[i];
+    swsrc_t swtch = CFN_SWITCH(cfn);
+    if (!swtch)
+      continue;
+
+    uint8_t flags = IS_PLAY_FUNC(CFN_FUNC(cfn)) ? GETSWITCH_MIDPOS_DELAY : 0;
+    uint8_t s = 0;
+    while (s < index.switchesCount &&
+           (index.switches[s] != swtch || index.switchFlags[s] != flags)) {
+      s++;
+    }
+    if (s == index.switchesCount) {
+      index.switches[s] = swtch;
+      index.switchFlags[s] = flags;
+      index.switchesCount++;
+    }
+
+    index.functions[index.count] = i;
+    index.switchIndex[index.count] = s;
+    index.count++;
+
+    if (isEdgeFunction(cfn))
+      index.edgeFunctions |= ((MASK_CFN_TYPE)1 << i);
+  }
+
+  index.generation = generation;
+  index.valid = true;
+}
+
 #define VOLUME_HYSTERESIS 10            // how much must a input value change to actually be considered for new volume setting
 getvalue_t requiredSpeakerVolumeRawLast = 1024 + 1; //initial value must be outside normal range
 
@@ -157,17 +217,38 @@ void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext
   }
 #endif
 
+  CustomFunctionsIndex & index = functionsContext.index;
+  if (!index.valid || index.generation != functionsContext.generation) {
+    buildFunctionsIndex(functions, functionsContext);
+  }
+
+  // each trigger is evaluated once
+  MASK_CFN_TYPE switchesState = 0;
+  for (uint8_t s=0; s<index.switchesCount; s++) {
+    if (getSwitch(index.switches[s], index.switchFlags[s]))
+      switchesState |= ((MASK_CFN_TYPE)1 << s);
+  }
+
   bool videoEnabled = false;
-  for (uint8_t i=0; i<MAX_SPECIAL_FUNCTIONS; i++) {
+  for (uint8_t n=0; n<index.count; n++) {
+    uint8_t i = index.functions[n];
     const CustomFunctionData * cfn = &functions[i];
-    swsrc_t swtch = CFN_SWITCH(cfn);
-    if (swtch) {
+    // the functions may have been edited since the index was built
+    if (CFN_SWITCH(cfn)) {
       MASK_CFN_TYPE switch_mask = ((MASK_CFN_TYPE)1 << i);
+      bool wasActive = functionsContext.activeSwitches & switch_mask;
 
-      bool active = getSwitch(swtch, IS_PLAY_FUNC(CFN_FUNC(cfn)) ? GETSWITCH_MIDPOS_DELAY : 0);
+      bool active = switchesState & ((MASK_CFN_TYPE)1 << index.switchIndex[n]);
       if (CFN_ACTIVE(cfn) == 0)
         active = false;
 
+      // edge functions have nothing to do until their switch changes
+      if (active == wasActive && (index.edgeFunctions & switch_mask)) {
+        if (active)
+          newActiveSwitches |= switch_mask;
+        continue;
+      }
+
       if (active) {
         switch (CFN_FUNC(cfn)) {
 #if defined(OVERRIDE_CHANNEL_FUNCTION)
@@ -204,7 +285,7 @@ void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext
                 timerReset(CFN_PARAM(cfn));
                 break;
               case FUNC_RESET_FLIGHT:
-                if (!(functionsContext.activeSwitches & switch_mask)) {
+                if (!wasActive) {
                   mainRequestFlags |=
                       (1 << REQUEST_FLIGHT_RESET);  // on systems with threads
                                                     // flightReset() must not be
@@ -256,7 +337,7 @@ void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext
                                                     CFN_PARAM(cfn))),
                        mixerCurrentFlightMode);
             } else if (CFN_GVAR_MODE(cfn) == FUNC_ADJUST_GVAR_INCDEC) {
-              if (!(functionsContext.activeSwitches & switch_mask)) {
+              if (!wasActive) {
                 SET_GVAR(CFN_GVAR_INDEX(cfn),
                          limit<int16_t>(MODEL_GVAR_MIN(CFN_GVAR_INDEX(cfn)),
                                         GVAR_VALUE(CFN_GVAR_INDEX(cfn),
@@ -343,8 +424,7 @@ void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext
             uint8_t repeatParam = CFN_PLAY_REPEAT(cfn);
             if (!functionsContext.lastFunctionTime[i] ||
                 (CFN_FUNC(cfn) == FUNC_PLAY_BOTH &&
-                 active !=
-                     (bool)(functionsContext.activeSwitches & switch_mask)) ||
+                 active != wasActive) ||
                 (repeatParam &&
                  (signed)(tmr10ms - functionsContext.lastFunctionTime[i]) >=
                      1000 * repeatParam)) {
@@ -410,7 +490,7 @@ void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext
           }
 
           case FUNC_SCREENSHOT:
-            if (!(functionsContext.activeSwitches & switch_mask)) {
+            if (!wasActive) {
               mainRequestFlags |= (1u << REQUEST_SCREENSHOT);
             }
             break;
@@ -459,7 +539,7 @@ void evalFunctions(const CustomFunctionData * functions, CustomFunctionsContext
       } else {
         functionsContext.lastFunctionTime[i] = 0;
 #if defined(DANGEROUS_MODULE_FUNCTIONS)
-        if (functionsContext.activeSwitches & switch_mask) {
+        if (wasActive) {
           switch (CFN_FUNC(cfn)) {
             case FUNC_RANGECHECK:
             case FUNC_BIND:
@@ -44,14 +44,17 @@ void onCustomFunctionsFileSelectionMenu(const char * result)
   int  sub = menuVerticalPosition - HEADER_LINE;
   CustomFunctionData * cfn;
   uint8_t eeFlags;
+  CustomFunctionsContext * functionsContext;
 
   if (menuHandlers[menuLevel] == menuModelSpecialFunctions) {
     cfn = &g_model.customFn[sub];
     eeFlags = EE_MODEL;
+    functionsContext = &modelFunctionsContext;
   }
   else {
     cfn = &g_eeGeneral.customFn[sub];
     eeFlags = EE_GENERAL;
+    functionsContext = &globalFunctionsContext;
   }
 
   uint8_t func = CFN_FUNC(cfn);
@@ -75,6 +78,7 @@ void onCustomFunctionsFileSelectionMenu(const char * result)
   else if (result != STR_EXIT) {
     // The user choosed a file in the list
     memcpy(cfn->play.name, result, sizeof(cfn->play.name));
+    functionsContext->invalidateIndex();
     storageDirty(eeFlags);
     if (CFN_ACTIVE(cfn)  && (func == FUNC_PLAY_SCRIPT || func == FUNC_RGB_LED)) {
       LUA_LOAD_MODEL_SCRIPTS();
@@ -111,6 +115,10 @@ void onAdjustGvarSourceLongEnterPress(const char * result)
   else if (result != STR_EXIT) {
     onSourceLongEnterPress(result);
   }
+
+  if (result != STR_EXIT) {
+    modelFunctionsContext.invalidateIndex();
+  }
 }
 
 void onCustomFunctionsMenu(const char * result)
@@ -118,14 +126,17 @@ void onCustomFunctionsMenu(const char * result)
   int sub = menuVerticalPosition - HEADER_LINE;
   CustomFunctionData * cfn;
   uint8_t eeFlags;
+  CustomFunctionsContext * functionsContext;
 
   if (menuHandlers[menuLevel] == menuModelSpecialFunctions) {
     cfn = &g_model.customFn[sub];
     eeFlags = EE_MODEL;
+    functionsContext = &modelFunctionsContext;
   }
   else {
     cfn = &g_eeGeneral.customFn[sub];
     eeFlags = EE_GENERAL;
+    functionsContext = &globalFunctionsContext;
   }
 
   if (result == STR_COPY) {
@@ -150,6 +161,10 @@ void onCustomFunctionsMenu(const char * result)
     memset(&g_model.customFn[MAX_SPECIAL_FUNCTIONS-1], 0, sizeof(CustomFunctionData));
     storageDirty(eeFlags);
   }
+
+  if (result != STR_COPY && result != STR_EXIT) {
+    functionsContext->invalidateIndex();
+  }
 }
 #endif // PCBTARANIS
 
@@ -494,6 +509,11 @@ void menuSpecialFunctions(event_t event, CustomFunctionData * functions, CustomF
     }
 #endif
   }
+
+  // the event may have edited a function: the mixer rebuilds its index
+  if (event) {
+    functionsContext->invalidateIndex();
+  }
 }
 
 void menuModelSpecialFunctions(event_t event)
@@ -111,15 +111,18 @@ void menuModelCurveOne(event_t event)
   if (attr) {
     uint8_t newType = checkIncDecModelZero(event, crv.type, CURVE_TYPE_LAST);
     if (newType != crv.type) {
+      CurveHeader newCurve = crv;
+      newCurve.type = newType;
+      int8_t newPoints[MAX_CURVE_DATA_POINTS];
+      newPoints[0] = points[0];
+      newPoints[4 + crv.points] = points[4 + crv.points];
       for (int i = 1; i < 4 + crv.points; i++) {
-        points[i] = calcRESXto100(applyCustomCurve(calc100toRESX(getCurveX(5 + crv.points, i)), s_currIdxSubMenu));
+        newPoints[i] = calcRESXto100(applyCustomCurve(calc100toRESX(getCurveX(5 + crv.points, i)), s_currIdxSubMenu));
       }
-      if (moveCurve(s_currIdxSubMenu, checkIncDec_Ret > 0 ? 3 + crv.points : -3 - crv.points)) {
-        if (newType == CURVE_TYPE_CUSTOM) {
-          resetCustomCurveX(points, 5 + crv.points);
-        }
-        crv.type = newType;
+      if (newType == CURVE_TYPE_CUSTOM) {
+        resetCustomCurveX(newPoints, 5 + crv.points);
       }
+      curveUpdate(s_currIdxSubMenu, newCurve, newPoints);
     }
   }
 
@@ -132,19 +135,16 @@ void menuModelCurveOne(event_t event)
     rotaryEncoderResetAccel();
     int8_t count = checkIncDecModel(event, crv.points, -3, 12); // 2pts - 17pts
     if (checkIncDec_Ret) {
-      int8_t newPoints[MAX_POINTS_PER_CURVE];
+      CurveHeader newCurve = crv;
+      newCurve.points = count;
+      int8_t newPoints[MAX_CURVE_DATA_POINTS];
       newPoints[0] = points[0];
       newPoints[4 + count] = points[4 + crv.points];
       for (int i = 1; i < 4 + count; i++)
         newPoints[i] = calcRESXto100(applyCustomCurve(calc100toRESX(getCurveX(5 + count, i)), s_currIdxSubMenu));
-      if (moveCurve(s_currIdxSubMenu, checkIncDec_Ret * (crv.type == CURVE_TYPE_CUSTOM ? 2 : 1))) {
-        for (int i = 0; i < 5 + count; i++) {
-          points[i] = newPoints[i];
-          if (crv.type == CURVE_TYPE_CUSTOM && i != 0 && i != 4 + count)
-            points[5 + count + i - 1] = getCurveX(5 + count, i);
-        }
-        crv.points = count;
-      }
+      if (crv.type == CURVE_TYPE_CUSTOM)
+        resetCustomCurveX(newPoints, 5 + count);
+      curveUpdate(s_currIdxSubMenu, newCurve, newPoints);
     }
   }
 
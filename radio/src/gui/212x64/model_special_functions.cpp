@@ -36,14 +36,17 @@ void onCustomFunctionsFileSelectionMenu(const char * result)
   int  sub = menuVerticalPosition;
   CustomFunctionData * cfn;
   uint8_t eeFlags;
+  CustomFunctionsContext * functionsContext;
 
   if (menuHandlers[menuLevel] == menuModelSpecialFunctions) {
     cfn = &g_model.customFn[sub];
     eeFlags = EE_MODEL;
+    functionsContext = &modelFunctionsContext;
   }
   else {
     cfn = &g_eeGeneral.customFn[sub];
     eeFlags = EE_GENERAL;
+    functionsContext = &globalFunctionsContext;
   }
 
   uint8_t func = CFN_FUNC(cfn);
@@ -64,6 +67,7 @@ void onCustomFunctionsFileSelectionMenu(const char * result)
   else if (result != STR_EXIT) {
     // The user choosed a file in the list
     memcpy(cfn->play.name, result, sizeof(cfn->play.name));
+    functionsContext->invalidateIndex();
     storageDirty(eeFlags);
     if (func == FUNC_PLAY_SCRIPT) {
       LUA_LOAD_MODEL_SCRIPTS();
@@ -76,14 +80,17 @@ void onCustomFunctionsMenu(const char * result)
   int sub = menuVerticalPosition;
   CustomFunctionData * cfn;
   uint8_t eeFlags;
+  CustomFunctionsContext * functionsContext;
 
   if (menuHandlers[menuLevel] == menuModelSpecialFunctions) {
     cfn = &g_model.customFn[sub];
     eeFlags = EE_MODEL;
+    functionsContext = &modelFunctionsContext;
   }
   else {
     cfn = &g_eeGeneral.customFn[sub];
     eeFlags = EE_GENERAL;
+    functionsContext = &globalFunctionsContext;
   }
 
   if (result == STR_COPY) {
@@ -108,6 +115,10 @@ void onCustomFunctionsMenu(const char * result)
     memset(&g_model.customFn[MAX_SPECIAL_FUNCTIONS-1], 0, sizeof(CustomFunctionData));
     storageDirty(eeFlags);
   }
+
+  if (result != STR_COPY && result != STR_EXIT) {
+    functionsContext->invalidateIndex();
+  }
 }
 
 void onAdjustGvarSourceLongEnterPress(const char * result)
@@ -137,6 +148,10 @@ void onAdjustGvarSourceLongEnterPress(const char * result)
   else if (result != STR_EXIT) {
     onSourceLongEnterPress(result);
   }
+
+  if (result != STR_EXIT) {
+    modelFunctionsContext.invalidateIndex();
+  }
 }
 
 enum CustomFunctionsItems {
@@ -450,6 +465,11 @@ void menuSpecialFunctions(event_t event, CustomFunctionData * functions, CustomF
       }
     }
   }
+
+  // the event may have edited a function: the mixer rebuilds its index
+  if (event) {
+    functionsContext->invalidateIndex();
+  }
 }
 
 void menuModelSpecialFunctions(event_t event)
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include "bitmap_cache.h"
+#include "debug.h"
+#include "ff.h"
+
+BitmapCache bitmapCache;
+
+std::list<BitmapCache::Entry>::iterator BitmapCache::find(
+    const BitmapBuffer* bitmap)
+{
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->bitmap == bitmap) return it;
+  }
+  return entries.end();
+}
+
+std::list<BitmapCache::Entry>::iterator BitmapCache::find(
+    const char* path, uint32_t fileDate, uint32_t fileSize, int8_t format,
+    uint16_t w, uint16_t h)
+{
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->fileDate == fileDate && it->fileSize == fileSize &&
+        it->format == format && it->w == w && it->h == h && it->path == path)
+      return it;
+  }
+  return entries.end();
+}
+
+const BitmapBuffer* BitmapCache::hit(std::list<Entry>::iterator it)
+{
+  hits += 1;
+  bytesSaved += it->bitmap->getDataSize();
+  it->refs += 1;
+  entries.splice(entries.begin(), entries, it);
+  return it->bitmap;
+}
+
+const BitmapBuffer* BitmapCache::insert(Entry&& entry)
+{
+  misses += 1;
+  bytesUsed += entry.bitmap->getDataSize();
+  entries.push_front(std::move(entry));
+  evict(budget);
+  return entries.front().bitmap;
+}
+
+const BitmapBuffer* BitmapCache::acquire(const char* path, BitmapFormats fmt,
+                                         uint16_t w, uint16_t h)
+{
+  if (!path || !path[0]) return nullptr;
+
+  FILINFO info;
+  if (f_stat(path, &info) != FR_OK) return nullptr;
+  uint32_t fileDate = ((uint32_t)info.fdate << 16) | info.ftime;
+
+  auto it = find(path, fileDate, info.fsize, fmt, w, h);
+  if (it != entries.end()) return hit(it);
+
+  if (w || h) {
+    // scaled copy of the image at its own size
+    const BitmapBuffer* bitmap = acquire(path, fmt);
+    if (!bitmap) return nullptr;
+    const BitmapBuffer* scaled = acquireScaled(bitmap, w, h);
+    release(bitmap);
+    return scaled;
+  }
+
+  BitmapBuffer* bitmap = BitmapBuffer::loadBitmap(path, fmt);
+  if (!bitmap) {
+    // low on memory? free unused bitmaps and try again
+    flush();
+    bitmap = BitmapBuffer::loadBitmap(path, fmt);
+    if (!bitmap) return nullptr;
+  }
+
+  TRACE("BitmapCache: load '%s' (%u)", path, bitmap->getDataSize());
+  return insert(
+      Entry{path, fileDate, (uint32_t)info.fsize, fmt, 0, 0, bitmap, 1, 0});
+}
+
+const BitmapBuffer* BitmapCache::acquireScaled(const BitmapBuffer* bitmap,
+                                               uint16_t w, uint16_t h)
+{
+  auto src = find(bitmap);
+  if (src == entries.end()) return nullptr;
+
+  if (w == bitmap->width() && h == bitmap->height()) return hit(src);
+
+  auto it = find(src->path.c_str(), src->fileDate, src->fileSize, src->format,
+                 w, h);
+  if (it != entries.end()) return hit(it);
+
+  BitmapBuffer* scaled = new BitmapBuffer(BMP_ARGB4444, w, h);
+  if (!scaled || !scaled->getData()) {
+    delete scaled;
+    return nullptr;
+  }
+  scaled->clear();
+  scaled->drawScaledBitmap(bitmap, 0, 0, w, h);
+
+  // 'src' may be evicted by insert() if it is not referenced
+  return insert(Entry{src->path, src->fileDate, src->fileSize, src->format, w,
+                      h, scaled, 1, 0});
+}
+
+const BitmapBuffer* BitmapCache::addRef(const BitmapBuffer* bitmap)
+{
+  auto it = find(bitmap);
+  if (it == entries.end()) return nullptr;
+  it->refs += 1;
+  return bitmap;
+}
+
+void BitmapCache::release(const BitmapBuffer* bitmap)
+{
+  if (!bitmap) return;
+
+  auto it = find(bitmap);
+  if (it == entries.end()) {
+    TRACE("BitmapCache: release of unknown bitmap %p", bitmap);
+    return;
+  }
+
+  if (it->refs > 0 && --it->refs == 0) {
+    evict(budget);
+  }
+}
+
+uint16_t BitmapCache::getRefCount(const BitmapBuffer* bitmap) const
+{
+  for (const auto& entry : entries) {
+    if (entry.bitmap == bitmap) return entry.refs;
+  }
+  return 0;
+}
+
+uint32_t BitmapCache::charge(const BitmapBuffer* bitmap)
+{
+  auto it = find(bitmap);
+  if (it == entries.end()) return 0;
+  return it->chargedRefs++ == 0 ? bitmap->getDataSize() : 0;
+}
+
+uint32_t BitmapCache::uncharge(const BitmapBuffer* bitmap)
+{
+  auto it = find(bitmap);
+  if (it == entries.end() || it->chargedRefs == 0) return 0;
+  return --it->chargedRefs == 0 ? bitmap->getDataSize() : 0;
+}
+
+void BitmapCache::evict(uint32_t size)
+{
+  auto it = entries.end();
+  while (bytesUsed > size && it != entries.begin()) {
+    --it;
+    if (it->refs == 0) {
+      bytesUsed -= it->bitmap->getDataSize();
+      delete it->bitmap;
+      it = entries.erase(it);
+    }
+  }
+}
+
+void BitmapCache::clear()
+{
+  for (auto& entry : entries) {
+    delete entry.bitmap;
+  }
+  entries.clear();
+  bytesUsed = 0;
+}
+
+BitmapCacheStats BitmapCache::getStats() const
+{
+  BitmapCacheStats stats = {hits, misses, bytesSaved, bytesUsed, 0, 0};
+  for (const auto& entry : entries) {
+    stats.entries += 1;
+    if (entry.refs > 0) stats.used += 1;
+  }
+  return stats;
+}
+
+void BitmapCache::resetStats()
+{
+  hits = 0;
+  misses = 0;
+  bytesSaved = 0;
+}
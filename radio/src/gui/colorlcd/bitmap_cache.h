@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#pragma once
+
+#include <list>
+#include <string>
+
+#include "bitmapbuffer.h"
+
+//
+// Shared cache of decoded bitmaps
+//
+// Bitmaps are keyed by (path, file date & size, format, size) and
+// refcounted: all users of the same image get the same buffer from
+// acquire() and give it back with release(). Released bitmaps stay in
+// the cache until its size exceeds the budget, least recently used
+// first, so that reopening an image does not decode it again.
+//
+// Cached bitmaps are shared: they must never be drawn into. A scaled
+// copy (Bitmap.resize) is another cache entry, created on first use.
+//
+// Only used from the UI task (no locking).
+//
+
+#if !defined(BITMAP_CACHE_SIZE)
+  #define BITMAP_CACHE_SIZE (256 * 1024)
+#endif
+
+struct BitmapCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t bytesSaved;  // decoded bytes not allocated thanks to hits
+  uint32_t bytesUsed;
+  uint16_t entries;
+  uint16_t used;        // entries currently referenced
+};
+
+class BitmapCache
+{
+ public:
+  explicit BitmapCache(uint32_t budget = BITMAP_CACHE_SIZE) : budget(budget) {}
+  ~BitmapCache() { clear(); }
+
+  // Returns the bitmap of an image file, scaled to w x h if not 0,
+  // or nullptr if it cannot be loaded
+  const BitmapBuffer* acquire(const char* path, BitmapFormats fmt = BMP_INVALID,
+                              uint16_t w = 0, uint16_t h = 0);
+
+  // Returns a w x h copy of a cached bitmap (or the bitmap itself
+  // if the size does not change)
+  const BitmapBuffer* acquireScaled(const BitmapBuffer* bitmap, uint16_t w,
+                                    uint16_t h);
+
+  // Adds a reference to a cached bitmap
+  const BitmapBuffer* addRef(const BitmapBuffer* bitmap);
+
+  void release(const BitmapBuffer* bitmap);
+
+  // Number of references of a cached bitmap (0 if not cached)
+  uint16_t getRefCount(const BitmapBuffer* bitmap) const;
+
+  // References charged to a memory account (Lua scripts): each bitmap
+  // is charged once, whoever else uses it. Return the size to add to
+  // the account on the first reference, and to remove from it on the
+  // last one, 0 otherwise.
+  uint32_t charge(const BitmapBuffer* bitmap);
+  uint32_t uncharge(const BitmapBuffer* bitmap);
+
+  // Frees all unreferenced bitmaps
+  void flush() { evict(0); }
+
+  void setBudget(uint32_t size)
+  {
+    budget = size;
+    evict(budget);
+  }
+
+  BitmapCacheStats getStats() const;
+  void resetStats();
+
+ protected:
+  struct Entry {
+    std::string path;
+    uint32_t fileDate;
+    uint32_t fileSize;
+    int8_t format;
+    uint16_t w;
+    uint16_t h;
+    BitmapBuffer* bitmap;
+    uint16_t refs;
+    uint16_t chargedRefs;
+  };
+
+  // most recently used first
+  std::list<Entry> entries;
+  uint32_t budget;
+  uint32_t bytesUsed = 0;
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t bytesSaved = 0;
+
+  std::list<Entry>::iterator find(const BitmapBuffer* bitmap);
+  std::list<Entry>::iterator find(const char* path, uint32_t fileDate,
+                                  uint32_t fileSize, int8_t format,
+                                  uint16_t w, uint16_t h);
+  const BitmapBuffer* hit(std::list<Entry>::iterator it);
+  const BitmapBuffer* insert(Entry&& entry);
+  void evict(uint32_t size);
+  void clear();
+};
+
+extern BitmapCache bitmapCache;
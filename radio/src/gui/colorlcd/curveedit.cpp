@@ -310,15 +310,18 @@ void CurveEditWindow::buildBody(FormWindow * window)
              [=](int32_t newValue) {
                  CurveHeader &curve = g_model.curves[index];
                  if (newValue != curve.type) {
+                   CurveHeader newCurve = curve;
+                   newCurve.type = newValue;
+                   int8_t newPoints[MAX_CURVE_DATA_POINTS];
+                   newPoints[0] = points[0];
+                   newPoints[4 + curve.points] = points[4 + curve.points];
                    for (int i = 1; i < 4 + curve.points; i++) {
-                     points[i] = calcRESXto100(applyCustomCurve(calc100toRESX(-100 + i * 200 / (4 + curve.points)), index));
+                     newPoints[i] = calcRESXto100(applyCustomCurve(calc100toRESX(-100 + i * 200 / (4 + curve.points)), index));
                    }
-                   if (moveCurve(index, newValue == CURVE_TYPE_CUSTOM ? 3 + curve.points : -3 - curve.points)) {
-                     if (newValue == CURVE_TYPE_CUSTOM) {
-                       resetCustomCurveX(points, 5 + curve.points);
-                     }
-                     curve.type = newValue;
+                   if (newValue == CURVE_TYPE_CUSTOM) {
+                     resetCustomCurveX(newPoints, 5 + curve.points);
                    }
+                   curveUpdate(index, newCurve, newPoints);
                    SET_DIRTY();
                    curveEdit->updatePreview();
                    if (curveDataEdit) {
@@ -332,18 +335,18 @@ void CurveEditWindow::buildBody(FormWindow * window)
                              [=](int32_t newValue) {
                                  newValue -= 5;
                                  CurveHeader &curve = g_model.curves[index];
-                                 int newPoints[MAX_POINTS_PER_CURVE];
+                                 CurveHeader newCurve = curve;
+                                 newCurve.points = newValue;
+                                 int8_t newPoints[MAX_CURVE_DATA_POINTS];
                                  newPoints[0] = points[0];
                                  newPoints[4 + newValue] = points[4 + curve.points];
                                  for (int i = 1; i < 4 + newValue; i++)
                                    newPoints[i] = calcRESXto100(applyCustomCurve(-RESX + (i * 2 * RESX) / (4 + newValue), index));
-                                 if (moveCurve(index, (newValue - curve.points) * (curve.type == CURVE_TYPE_CUSTOM ? 2 : 1))) {
-                                   for (int i = 0; i < 5 + newValue; i++) {
-                                     points[i] = newPoints[i];
-                                     if (curve.type == CURVE_TYPE_CUSTOM && i != 0 && i != 4 + newValue)
-                                       points[5 + newValue + i - 1] = -100 + (i * 200) / (4 + newValue);
-                                   }
-                                   curve.points = newValue;
+                                 if (curve.type == CURVE_TYPE_CUSTOM) {
+                                   for (int i = 1; i < 4 + newValue; i++)
+                                     newPoints[5 + newValue + i - 1] = -100 + (i * 200) / (4 + newValue);
+                                 }
+                                 if (curveUpdate(index, newCurve, newPoints)) {
                                    SET_DIRTY();
                                    curveEdit->updatePreview();
                                    if (curveDataEdit) {
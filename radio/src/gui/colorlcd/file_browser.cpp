@@ -21,13 +21,15 @@
 
 #include "file_browser.h"
 #include "libopenui_file.h"
+#include "bitmapbuffer.h"
 #include "font.h"
 
-#include <list>
-#include <string>
+// entries read per page: the first one is shown right away,
+// the next ones from checkEvents()
+#define FB_PAGE_SIZE     32
 
-#define CELL_CTRL_DIR  LV_TABLE_CELL_CTRL_CUSTOM_1
-#define CELL_CTRL_FILE LV_TABLE_CELL_CTRL_CUSTOM_2
+// rows filled above and below the visible ones
+#define FB_ROWS_MARGIN   4
 
 static void fb_event(lv_event_t* e)
 {
@@ -68,103 +70,21 @@ static const char* getCurrentPath()
   return path;
 }
 
-static int strnatcasecmp(char const *s1, char const *s2)
+// hidden and system files, decoded images are not listed
+static bool fb_filter(const FILINFO& fno)
 {
-  int i1, i2;
-  char c1, c2;
-
-  i1 = i2 = 0;
-  while (true) {
-    c1 = s1[i1]; c2 = s2[i2];
-
-    if (c1 == 0 && c2 == 0) {
-      return 0;
-    }
-
-    if (isdigit(c1) && isdigit(c2)) {
-      int num_cmp = 0;
-      while (true) {
-        if (!num_cmp) {
-          if (c1 < c2) {
-            num_cmp = -1;
-          } else if (c1 > c2) {
-            num_cmp = 1;
-          }
-        }
-        i1 += 1; i2 += 1;
-        c1 = s1[i1]; c2 = s2[i2];
-        if (!isdigit(c1) && !isdigit(c2))
-          break;
-        if (!isdigit(c1)) {
-          num_cmp = -1;
-          break;
-        }
-        if (!isdigit(c2)) {
-          num_cmp = 1;
-          break;
-        }
-      }
-      if (num_cmp)
-        return num_cmp;
-    }
-
-    c1 = toupper(c1);
-    c2 = toupper(c2);
-
-    if (c1 < c2)
-      return -1;
-
-    if (c1 > c2)
-      return +1;
-
-    i1 += 1; i2 += 1;
-  }
-}
-
-// natural comparison, not case sensitive.
-static bool natural_compare_nocase(const std::string & first, const std::string & second)
-{
-  return strnatcasecmp(first.c_str(), second.c_str()) < 0;
-}
-
-static int scan_files(std::list<std::string>& files,
-                      std::list<std::string>& directories)
-{
-  FILINFO fno;
-  DIR dir;
-
-  FRESULT res = f_opendir(&dir, "."); // Open the directory
-  if (res != FR_OK) return -1;
-
-  // read all entries
-  bool firstTime = true;
-  for (;;) {
-    res = sdReadDir(&dir, &fno, firstTime);
-
-    if (res != FR_OK || fno.fname[0] == 0)
-      break; // Break on error or end of dir
-    // if (strlen((const char*)fno.fname) > SD_SCREEN_FILE_LENGTH)
-    //   continue;
-    if (fno.fattrib & (AM_HID|AM_SYS)) continue;     /* Ignore hidden and system files */
-    if (fno.fname[0] == '.' && fno.fname[1] != '.') continue; // Ignore hidden files under UNIX, but not ..
-
-    if (fno.fattrib & AM_DIR) {
-      directories.push_back((char*)fno.fname);
-    } else {
-      files.push_back((char*)fno.fname);
-    }
-  }
-
-  directories.sort(natural_compare_nocase);
-  files.sort(natural_compare_nocase);
-
-  return 0;
+  if (fno.fattrib & (AM_HID|AM_SYS)) return false;     /* Ignore hidden and system files */
+  if (fno.fname[0] == '.' && fno.fname[1] != '.') return false; // Ignore hidden files under UNIX, but not ..
+  const char* ext = getFileExtension(fno.fname);
+  if (ext && !strcasecmp(ext, BITMAP_SIDECAR_EXT)) return false; // Ignore decoded images
+  return true;
 }
 
 FileBrowser::FileBrowser(Window* parent, const rect_t& rect, const char* dir) :
     TableField(parent, rect)
 {
   lv_obj_add_event_cb(lvobj, fb_event, LV_EVENT_ALL, nullptr);
+  lv_obj_add_event_cb(lvobj, FileBrowser::scroll_cb, LV_EVENT_SCROLL, nullptr);
 
   setColumnCount(1);
 
@@ -181,29 +101,80 @@ void FileBrowser::setFileSelected(FileAction fct) { fileSelected = std::move(fct
 
 void FileBrowser::refresh()
 {
-  std::list<std::string> files;
-  std::list<std::string> directories;
-  if (scan_files(files, directories) < 0) return;
+  // drop the cells of the previous directory
+  setRowCount(0);
+  selected[0] = '\0';
 
-  setRowCount(files.size() + directories.size());
+  if (!listing.open(fb_filter)) return;
+  listing.readPage(FB_PAGE_SIZE);
+  updateRows();
 
-  uint16_t row = 0;
-  for (const auto& name: directories) {
+  select(0, 0);
+}
 
-    // LV_SYMBOL_DIRECTORY
-    lv_table_set_cell_value(lvobj, row, 0, name.c_str());
-    lv_table_add_cell_ctrl(lvobj, row, 0, CELL_CTRL_DIR);
-    row++;
+void FileBrowser::readPage()
+{
+  // the page is merged in the sorted listing: keep the cursor
+  // on the same entry
+  lv_table_t* table = (lv_table_t*)lvobj;
+  uint16_t row = table->row_act;
+
+  char name[FF_MAX_LFN + 1] = "";
+  bool is_dir = false;
+  if (row < listing.size()) {
+    strncpy(name, listing.getName(row), FF_MAX_LFN);
+    name[FF_MAX_LFN] = '\0';
+    is_dir = listing.isDirectory(row);
   }
 
-  for (const auto& name: files) {
-    // LV_SYMBOL_FILE
-    lv_table_set_cell_value(lvobj, row, 0, name.c_str());
-    lv_table_clear_cell_ctrl(lvobj, row, 0, CELL_CTRL_DIR);
-    row++;
+  listing.readPage(FB_PAGE_SIZE);
+  updateRows();
+
+  if (name[0]) {
+    int idx = listing.find(name, is_dir);
+    if (idx >= 0 && idx != row) select(idx, 0, true);
   }
+}
 
-  select(0, 0);
+void FileBrowser::updateRows()
+{
+  lv_table_t* table = (lv_table_t*)lvobj;
+  uint16_t rows = listing.size();
+  if (getRowCount() != rows) setRowCount(rows);
+  if (rows == 0) return;
+
+  // rows all have the same height: names are cropped to one line
+  lv_coord_t row_h = table->row_h[0];
+  if (row_h <= 0) row_h = 1;
+
+  lv_coord_t top = lv_obj_get_scroll_y(lvobj) - lv_obj_get_style_pad_top(lvobj, LV_PART_MAIN);
+  int first = top / row_h - FB_ROWS_MARGIN;
+  int last = (top + lv_obj_get_height(lvobj)) / row_h + FB_ROWS_MARGIN;
+  if (first < 0) first = 0;
+  if (last >= rows) last = rows - 1;
+
+  for (int row = first; row <= last; row++) {
+    const char* name = listing.getName(row);
+    const char* value = lv_table_get_cell_value(lvobj, row, 0);
+    if (!value || strcmp(value, name)) {
+      // set before the value, which computes the row height
+      lv_table_add_cell_ctrl(lvobj, row, 0, LV_TABLE_CELL_CTRL_TEXT_CROP);
+      lv_table_set_cell_value(lvobj, row, 0, name);
+    }
+  }
+}
+
+void FileBrowser::scroll_cb(lv_event_t* e)
+{
+  lv_obj_t* obj = lv_event_get_target(e);
+  auto fb = (FileBrowser*)lv_obj_get_user_data(obj);
+  if (fb) fb->updateRows();
+}
+
+void FileBrowser::checkEvents()
+{
+  TableField::checkEvents();
+  if (!listing.isComplete()) readPage();
 }
 
 void FileBrowser::adjustWidth()
@@ -214,14 +185,14 @@ void FileBrowser::adjustWidth()
 
 void FileBrowser::onSelected(uint16_t row, uint16_t col)
 {
-  bool is_dir = lv_table_has_cell_ctrl(lvobj, row, col, CELL_CTRL_DIR);
-  onSelected(lv_table_get_cell_value(lvobj, row, col), is_dir);
+  if (row >= listing.size()) return;
+  onSelected(listing.getName(row), listing.isDirectory(row));
 }
 
 void FileBrowser::onPress(uint16_t row, uint16_t col)
 {
-  bool is_dir = lv_table_has_cell_ctrl(lvobj, row, col, CELL_CTRL_DIR);
-  onPress(lv_table_get_cell_value(lvobj, row, col), is_dir);  
+  if (row >= listing.size()) return;
+  onPress(listing.getName(row), listing.isDirectory(row));
 }
 
 void FileBrowser::onDrawBegin(uint16_t row, uint16_t col, lv_obj_draw_part_dsc_t* dsc)
@@ -232,10 +203,12 @@ void FileBrowser::onDrawBegin(uint16_t row, uint16_t col, lv_obj_draw_part_dsc_t
 
 void FileBrowser::onDrawEnd(uint16_t row, uint16_t col, lv_obj_draw_part_dsc_t* dsc)
 {
+  if (row >= listing.size()) return;
+
   const char* sym = nullptr;
-  if (lv_table_has_cell_ctrl(lvobj, row, 0, CELL_CTRL_DIR)) {
+  if (listing.isDirectory(row)) {
     // dir
-    const char* dir = lv_table_get_cell_value(lvobj, row, 0);
+    const char* dir = listing.getName(row);
     if (dir[0] == '.')
       sym = LV_SYMBOL_LEFT;
     else
@@ -267,10 +240,13 @@ void FileBrowser::onSelected(const char* name, bool is_dir)
     return;
   }
 
+  // names move while the listing grows: keep a copy
+  strncpy(selected, name, FF_MAX_LFN);
+  selected[FF_MAX_LFN] = '\0';
+
   const char* path = getCurrentPath();
-  const char* fullpath = getFullPath(name);  
-  if (fileSelected) fileSelected(path, name, fullpath);
-  selected = name;
+  const char* fullpath = getFullPath(selected);
+  if (fileSelected) fileSelected(path, selected, fullpath);
 }
 
 void FileBrowser::onPress(const char* name, bool is_dir)
@@ -284,12 +260,12 @@ void FileBrowser::onPress(const char* name, bool is_dir)
     return;
   }
 
-  if (!selected || (selected != name)) {
+  if (strcmp(selected, name)) {
     onSelected(name, is_dir);
     return;
   }
   
   if (fileAction){
-    fileAction(path, name, fullpath);
+    fileAction(path, selected, fullpath);
   }
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "table.h"
+#include "dir_listing.h"
 
 class FileBrowser : public TableField
 {
@@ -36,7 +37,9 @@ class FileBrowser : public TableField
   void refresh();
 
   void adjustWidth();
-  
+
+  void checkEvents() override;
+
  protected:
   void onSelected(const char* name, bool is_dir);
   void onPress(const char* name, bool is_dir);
@@ -47,8 +50,15 @@ class FileBrowser : public TableField
   void onDrawBegin(uint16_t row, uint16_t col, lv_obj_draw_part_dsc_t* dsc) override;
   void onDrawEnd(uint16_t row, uint16_t col, lv_obj_draw_part_dsc_t* dsc) override;
 
+  // the listing is read a page at a time, and only the visible rows
+  // have their cell filled
+  void readPage();
+  void updateRows();
+  static void scroll_cb(lv_event_t* e);
+
  private:
-  const char* selected = nullptr;
+  DirListing listing;
+  char selected[FF_MAX_LFN + 1] = "";
   FileAction fileAction;
   FileAction fileSelected;
 };
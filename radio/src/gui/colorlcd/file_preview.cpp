@@ -20,6 +20,7 @@
  */
 
 #include "file_preview.h"
+#include "bitmap_cache.h"
 #include "sdcard.h"
 
 FilePreview::FilePreview(Window *parent, const rect_t &rect,
@@ -30,18 +31,18 @@ FilePreview::FilePreview(Window *parent, const rect_t &rect,
 
 FilePreview::~FilePreview()
 {
-  if (bitmap != nullptr) delete bitmap;
+  bitmapCache.release(bitmap);
 }
 
 void FilePreview::setFile(const char *filename)
 {
-  if (bitmap != nullptr) delete bitmap;
+  bitmapCache.release(bitmap);
   bitmap = nullptr;
 
   if (filename) {
     const char *ext = getFileExtension(filename);
     if (ext && isExtensionMatching(ext, BITMAPS_EXT)) {
-      bitmap = BitmapBuffer::loadBitmap(filename);
+      bitmap = bitmapCache.acquire(filename);
     } else {
       bitmap = nullptr;
     }
@@ -39,6 +39,6 @@ class FilePreview : public Window
   void paint(BitmapBuffer *dc) override;
 
  protected:
-  BitmapBuffer *bitmap = nullptr;
+  const BitmapBuffer *bitmap = nullptr;
   bool _drawCentered = true;
 };
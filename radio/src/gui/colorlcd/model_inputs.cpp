@@ -51,34 +51,50 @@ uint8_t getExposCount()
   return count;
 }
 
+// Input lines edit, prepared off the model and run by the mixer task
+struct ExpoEdit {
+  uint8_t idx;
+  ExpoData line;
+};
+
+static void insertExpoLine(void* ctx)
+{
+  auto edit = (const ExpoEdit*)ctx;
+  ExpoData* expo = expoAddress(edit->idx);
+  memmove(expo + 1, expo, (MAX_EXPOS - (edit->idx + 1)) * sizeof(ExpoData));
+  memcpy(expo, &edit->line, sizeof(ExpoData));
+}
+
+static void deleteExpoLine(void* ctx)
+{
+  auto edit = (const ExpoEdit*)ctx;
+  ExpoData* expo = expoAddress(edit->idx);
+  int input = expo->chn;
+  memmove(expo, expo + 1, (MAX_EXPOS - (edit->idx + 1)) * sizeof(ExpoData));
+  memclear(&g_model.expoData[MAX_EXPOS - 1], sizeof(ExpoData));
+  if (!isInputAvailable(input)) {
+    memclear(&g_model.inputNames[input], LEN_INPUT_NAME);
+  }
+}
+
 // TODO: these functions need to be added to the generic API
 //       used by all radios, and be removed from UI code
 //
 void copyExpo(uint8_t source, uint8_t dest, uint8_t input)
 {
-  mixerTaskStop();
-  ExpoData sourceExpo;
-  memcpy(&sourceExpo, expoAddress(source), sizeof(ExpoData));
-  ExpoData* expo = expoAddress(dest);
-  size_t trailingExpos = MAX_EXPOS - (dest + 1);
-  memmove(expo + 1, expo, trailingExpos * sizeof(ExpoData));
-  memcpy(expo, &sourceExpo, sizeof(ExpoData));
-  expo->chn = input;
-  mixerTaskStart();
+  ExpoEdit edit;
+  edit.idx = dest;
+  memcpy(&edit.line, expoAddress(source), sizeof(ExpoData));
+  edit.line.chn = input;
+  mixerTaskCommitEdit(insertExpoLine, &edit);
   storageDirty(EE_MODEL);
 }
 
 void deleteExpo(uint8_t idx)
 {
-  mixerTaskStop();
-  ExpoData* expo = expoAddress(idx);
-  int input = expo->chn;
-  memmove(expo, expo + 1, (MAX_EXPOS - (idx + 1)) * sizeof(ExpoData));
-  memclear(&g_model.expoData[MAX_EXPOS - 1], sizeof(ExpoData));
-  if (!isInputAvailable(input)) {
-    memclear(&g_model.inputNames[input], LEN_INPUT_NAME);
-  }
-  mixerTaskStart();
+  ExpoEdit edit;
+  edit.idx = idx;
+  mixerTaskCommitEdit(deleteExpoLine, &edit);
   storageDirty(EE_MODEL);
 }
 
@@ -89,9 +105,9 @@ int8_t s_copySrcRow;
 
 void insertExpo(uint8_t idx, uint8_t input)
 {
-  mixerTaskStop();
-  ExpoData* expo = expoAddress(idx);
-  memmove(expo + 1, expo, (MAX_EXPOS - (idx + 1)) * sizeof(ExpoData));
+  ExpoEdit edit;
+  edit.idx = idx;
+  ExpoData* expo = &edit.line;
   memclear(expo, sizeof(ExpoData));
   if (input >= adcGetMaxInputs(ADC_INPUT_MAIN)) {
     expo->srcRaw = MIXSRC_FIRST_STICK + input;
@@ -102,7 +118,7 @@ void insertExpo(uint8_t idx, uint8_t input)
   expo->mode = 3;  // pos+neg
   expo->chn = input;
   expo->weight = 100;
-  mixerTaskStart();
+  mixerTaskCommitEdit(insertExpoLine, &edit);
   storageDirty(EE_MODEL);
 }
 
@@ -233,7 +233,6 @@ class ScriptLineButton : public Button
       lv_obj_set_style_text_align(lbl, LV_TEXT_ALIGN_LEFT, 0);
       lv_obj_set_grid_cell(lbl, LV_GRID_ALIGN_START, 3, 1, LV_GRID_ALIGN_CENTER, 0, 1);
 
-      // TODO: runtimeData->instructions has no value 
       switch (runtimeData->state) {
         case SCRIPT_SYNTAX_ERROR:
           lv_label_set_text(lbl, STR_SCRIPT_ERROR);
@@ -241,6 +240,9 @@ class ScriptLineButton : public Button
         case SCRIPT_NOFILE:
           lv_label_set_text(lbl, STR_NEEDS_FILE);
           break;
+        case SCRIPT_KILLED:
+          lv_label_set_text(lbl, STR_SCRIPT_KILLED);
+          break;
         case SCRIPT_OK:
           lv_label_set_text(lbl, "-");
           break;
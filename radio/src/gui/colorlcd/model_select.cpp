@@ -20,6 +20,7 @@
  */
 
 #include "model_select.h"
+#include "bitmap_cache.h"
 
 #include "libopenui.h"
 #include "menu_model.h"
@@ -116,20 +117,20 @@ class ModelButton : public Button
 
     if (modelLayouts[layout].hsaImage) {
       GET_FILENAME(filename, BITMAPS_PATH, modelCell->modelBitmap, "");
-      const BitmapBuffer *bitmap = BitmapBuffer::loadBitmap(filename);
+      const BitmapBuffer *bitmap = bitmapCache.acquire(filename);
 
       if (bitmap) {
         buffer = new BitmapBuffer(BMP_RGB565, w, h);
         if (buffer) {
           buffer->clear(bg_color);
           buffer->drawScaledBitmap(bitmap, 0, 0, w, h);
-          delete bitmap;
 
           lv_obj_t *bm = lv_canvas_create(lvobj);
           lv_obj_center(bm);
           lv_canvas_set_buffer(bm, buffer->getData(), buffer->width(),
                                buffer->height(), LV_IMG_CF_TRUE_COLOR);
         }
+        bitmapCache.release(bitmap);
       }
 
       if (!buffer) {
@@ -27,6 +27,7 @@
 #include "opentx.h"
 #include "libopenui.h"
 #include "hal/adc_driver.h"
+#include "hal/adc_filter.h"
 
 #include "hw_intmodule.h"
 #include "hw_extmodule.h"
@@ -127,6 +128,11 @@ void RadioHardwarePage::build(FormWindow * window)
   new StaticText(line, rect_t{}, STR_JITTER_FILTER, 0, COLOR_THEME_PRIMARY1);
   new ToggleSwitch(line, rect_t{}, GET_SET_INVERTED(g_eeGeneral.noJitterFilter));
 
+  line = window->newLine(&grid);
+  new StaticText(line, rect_t{}, STR_TYPE, 0, COLOR_THEME_PRIMARY1);
+  new Choice(line, rect_t{}, STR_ADC_FILTER_TYPES, 0, ADC_FILTER_COUNT - 1,
+             GET_SET_DEFAULT(g_eeGeneral.adcFilter));
+
 #if defined(AUDIO_MUTE_GPIO)
   // Mute audio
   line = window->newLine(&grid);
@@ -27,7 +27,19 @@
 #include "hal/adc_driver.h"
 #include "strhelpers.h"
 
-#define SET_DIRTY()     storageDirty(functions == g_model.customFn ? EE_MODEL : EE_GENERAL)
+#define SET_DIRTY()     setFunctionsDirty(functions)
+
+static void setFunctionsDirty(const CustomFunctionData * functions)
+{
+  if (functions == g_model.customFn) {
+    modelFunctionsContext.invalidateIndex();
+    storageDirty(EE_MODEL);
+  }
+  else {
+    globalFunctionsContext.invalidateIndex();
+    storageDirty(EE_GENERAL);
+  }
+}
 
 static const lv_coord_t col_dsc[] = {LV_GRID_FR(2), LV_GRID_FR(3),
                                      LV_GRID_TEMPLATE_LAST};
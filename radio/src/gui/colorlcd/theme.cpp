@@ -22,6 +22,7 @@
 #include "opentx.h"
 #include "libopenui.h"
 #include "theme.h"
+#include "bitmap_cache.h"
 #include "theme_manager.h"
 
 const uint8_t _LBM_USB_PLUGGED[] = {
@@ -98,7 +99,7 @@ void EdgeTxTheme::update()
   createIcons();
   loadIcons();
   if (!backgroundBitmap) {
-    backgroundBitmap = BitmapBuffer::loadBitmap(getFilePath("background.png"));
+    backgroundBitmap = bitmapCache.acquire(getFilePath("background.png"));
   }
   initLvglTheme();
 }
@@ -153,15 +154,14 @@ void EdgeTxTheme::loadIcons() const
 
 void EdgeTxTheme::setBackgroundImageFileName(const char *fileName)
 {
-  // ensure you delete old bitmap
-  if (backgroundBitmap != nullptr)
-    delete backgroundBitmap;
+  // ensure you release old bitmap
+  bitmapCache.release(backgroundBitmap);
 
   strncpy(backgroundImageFileName, fileName, FF_MAX_LFN);
   backgroundImageFileName[FF_MAX_LFN] = '\0'; // ensure string termination
 
   // Try to load bitmap. If this fails backgroundBitmap will be NULL and default will be loaded in update() method
-  backgroundBitmap = BitmapBuffer::loadBitmap(backgroundImageFileName);
+  backgroundBitmap = bitmapCache.acquire(backgroundImageFileName);
 }
 
 const char * EdgeTxTheme::getFilePath(const char * filename) const
@@ -23,10 +23,29 @@
 
 #include "opentx.h"
 #include "draw_functions.h"
+#include "bitmap_cache.h"
 
 #include "tasks.h"
 #include "tasks/mixer_task.h"
 
+#if defined(LUA)
+struct LuaTopScript {
+  char name[LEN_SCRIPT_FILENAME + 1];
+  LuaScriptStats* stats;
+};
+
+static void luaFindTopScript(const char* name, LuaScriptStats& stats,
+                             void* ctx)
+{
+  auto top = (LuaTopScript*)ctx;
+  if (!top->stats || stats.maxUs > top->stats->maxUs) {
+    strncpy(top->name, name, LEN_SCRIPT_FILENAME);
+    top->name[LEN_SCRIPT_FILENAME] = '\0';
+    top->stats = &stats;
+  }
+}
+#endif
+
 static const lv_coord_t col_dsc[] = {LV_GRID_FR(1), LV_GRID_FR(1),
                                      LV_GRID_FR(1), LV_GRID_FR(1),
                                      LV_GRID_TEMPLATE_LAST};
@@ -317,11 +336,61 @@ void DebugViewPage::build(FormWindow* window)
       line, rect_t{0, 0, DBG_B_WIDTH, DBG_B_HEIGHT},
       [] { return luaExtraMemoryUsage; }, COLOR_THEME_PRIMARY1,
       STR_MEM_USED_EXTRA, nullptr);
+
+  line = form->newLine(&grid);
+  line->padAll(0);
+#if LCD_H > LCD_W
+  line->padLeft(10);
+#else
+  grid.nextCell();
+#endif
+
+  // slowest script or widget
+  new DynamicText(
+      line, rect_t{},
+      [] {
+        LuaTopScript top = {"-", nullptr};
+        luaForEachStats(luaFindTopScript, &top);
+        char msg[64];
+        if (top.stats)
+          snprintf(msg, sizeof(msg), "%s %u.%ums %ukB", top.name,
+                   (unsigned)(top.stats->maxUs / 1000),
+                   (unsigned)(top.stats->maxUs / 100 % 10),
+                   (unsigned)(max<int32_t>(top.stats->memory, 0) / 1024));
+        else
+          strcpy(msg, top.name);
+        return std::string(msg);
+      },
+      COLOR_THEME_PRIMARY1);
 #endif
 
   line = form->newLine(&grid);
   line->padAll(2);
 
+  // Bitmap cache data
+  new StaticText(line, rect_t{}, STR_BITMAP_CACHE_LABEL, 0,
+                 COLOR_THEME_PRIMARY1);
+#if LCD_H > LCD_W
+  line = form->newLine(&grid);
+  line->padAll(0);
+  line->padLeft(10);
+#endif
+  new DebugInfoNumber<uint32_t>(
+      line, rect_t{0, 0, DBG_B_WIDTH, DBG_B_HEIGHT},
+      [] {
+        BitmapCacheStats stats = bitmapCache.getStats();
+        uint32_t total = stats.hits + stats.misses;
+        return total ? stats.hits * 100 / total : 0;
+      },
+      COLOR_THEME_PRIMARY1, STR_CACHE_HITS, nullptr);
+  new DebugInfoNumber<uint32_t>(
+      line, rect_t{0, 0, DBG_B_WIDTH, DBG_B_HEIGHT},
+      [] { return bitmapCache.getStats().bytesSaved; }, COLOR_THEME_PRIMARY1,
+      STR_CACHE_SAVED, nullptr);
+
+  line = form->newLine(&grid);
+  line->padAll(2);
+
   // Stacks data
   new StaticText(line, rect_t{}, STR_FREE_STACK, 0, COLOR_THEME_PRIMARY1);
 #if LCD_H > LCD_W
@@ -387,6 +456,7 @@ void DebugViewPage::build(FormWindow* window)
   auto btn = new TextButton(line, rect_t{0, 0, 0, 24}, STR_MENUTORESET,
                             [=]() -> uint8_t {
                               maxMixerDuration = 0;
+                              bitmapCache.resetStats();
 #if defined(LUA)
                               maxLuaInterval = 0;
                               maxLuaDuration = 0;
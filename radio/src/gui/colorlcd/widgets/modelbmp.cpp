@@ -20,6 +20,7 @@
  */
 
 #include "opentx.h"
+#include "bitmap_cache.h"
 #include "widgets_container_impl.h"
 
 #include <memory>
@@ -111,17 +112,18 @@ class ModelBitmapWidget: public Widget
 
       buffer->clear();
       if (!filename.empty()) {
-        std::unique_ptr<BitmapBuffer> bitmap(BitmapBuffer::loadBitmap(fullpath.c_str()));
+        const BitmapBuffer * bitmap = bitmapCache.acquire(fullpath.c_str());
         if (!bitmap) {
           TRACE("could not load bitmap '%s'", filename.c_str());
           return;
         }
 
         if (rect.h >= 96 && rect.w >= 120) {
-          buffer->drawScaledBitmap(bitmap.get(), 0, 0, width(), height() - 38);
+          buffer->drawScaledBitmap(bitmap, 0, 0, width(), height() - 38);
         } else {
-          buffer->drawScaledBitmap(bitmap.get(), 0, 0, width(), height());
+          buffer->drawScaledBitmap(bitmap, 0, 0, width(), height());
         }
+        bitmapCache.release(bitmap);
       }
     }
 };
@@ -20,6 +20,7 @@
  */
 
 #include "opentx.h"
+#include "mixer_outputs.h"
 #include "widgets_container_impl.h"
 
 #define RECT_BORDER 1
@@ -65,9 +66,12 @@ class OutputsWidget : public Widget
     LcdFlags barColor = COLOR2FLAGS(bar_color);
     LcdFlags txtColor = COLOR2FLAGS(txt_color);
 
+    MixerOutputs outputs;
+    mixerOutputsRead(outputs);
+
     for (uint8_t curChan = firstChan;
          curChan < lastChan && curChan <= MAX_OUTPUT_CHANNELS; curChan++) {
-      const int16_t chanVal = calcRESXto100(channelOutputs[curChan - 1]);
+      const int16_t chanVal = calcRESXto100(outputs.channels[curChan - 1]);
       const uint16_t rowTop = y + (curChan - firstChan) * rowH;
       const uint16_t barTop = rowTop + RECT_BORDER;
       const uint16_t fillW = divRoundClosest(
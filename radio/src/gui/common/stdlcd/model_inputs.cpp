@@ -50,13 +50,46 @@ bool reachExposLimit()
   return false;
 }
 
+// Input lines edit, prepared off the model and run by the mixer task
+struct ExpoEdit {
+  uint8_t idx;
+  uint8_t dst;
+  ExpoData line;
+};
+
+static void insertExpoLine(void * ctx)
+{
+  auto edit = (const ExpoEdit *)ctx;
+  ExpoData * expo = expoAddress(edit->idx);
+  memmove(expo+1, expo, (MAX_EXPOS-(edit->idx+1))*sizeof(ExpoData));
+  memcpy(expo, &edit->line, sizeof(ExpoData));
+}
+
+static void deleteExpoLine(void * ctx)
+{
+  auto edit = (const ExpoEdit *)ctx;
+  ExpoData * expo = expoAddress(edit->idx);
+  int input = expo->chn;
+  memmove(expo, expo+1, (MAX_EXPOS-(edit->idx+1))*sizeof(ExpoData));
+  memclear(&g_model.expoData[MAX_EXPOS-1], sizeof(ExpoData));
+  if (!isInputAvailable(input)) {
+    memclear(&g_model.inputNames[input], LEN_INPUT_NAME);
+  }
+}
+
+static void swapExpoLines(void * ctx)
+{
+  auto edit = (const ExpoEdit *)ctx;
+  memswap(expoAddress(edit->idx), expoAddress(edit->dst), sizeof(ExpoData));
+}
+
 // TODO avoid this global s_currCh on ARM boards ...
 int8_t s_currCh;
 void insertExpo(uint8_t idx)
 {
-  mixerTaskStop();
-  ExpoData * expo = expoAddress(idx);
-  memmove(expo+1, expo, (MAX_EXPOS-(idx+1))*sizeof(ExpoData));
+  ExpoEdit edit;
+  edit.idx = idx;
+  ExpoData * expo = &edit.line;
   memclear(expo, sizeof(ExpoData));
   for (int i = s_currCh; i < INPUTSRC_LAST; i++) {
     if (i > adcGetMaxInputs(ADC_INPUT_MAIN)) {
@@ -72,16 +105,16 @@ void insertExpo(uint8_t idx)
   expo->mode = 3; // pos+neg
   expo->chn = s_currCh - 1;
   expo->weight = 100;
-  mixerTaskStart();
+  mixerTaskCommitEdit(insertExpoLine, &edit);
   storageDirty(EE_MODEL);
 }
 
 void copyExpo(uint8_t idx)
 {
-  mixerTaskStop();
-  ExpoData * expo = expoAddress(idx);
-  memmove(expo+1, expo, (MAX_EXPOS-(idx+1))*sizeof(ExpoData));
-  mixerTaskStart();
+  ExpoEdit edit;
+  edit.idx = idx;
+  memcpy(&edit.line, expoAddress(idx), sizeof(ExpoData));
+  mixerTaskCommitEdit(insertExpoLine, &edit);
   storageDirty(EE_MODEL);
 }
 
@@ -119,9 +152,10 @@ bool swapExpos(uint8_t & idx, uint8_t up)
     return true;
   }
   
-  mixerTaskStop();
-  memswap(x, y, sizeof(ExpoData));
-  mixerTaskStart();
+  ExpoEdit edit;
+  edit.idx = idx;
+  edit.dst = tgt_idx;
+  mixerTaskCommitEdit(swapExpoLines, &edit);
   
   idx = tgt_idx;
   return true;
@@ -129,15 +163,9 @@ bool swapExpos(uint8_t & idx, uint8_t up)
 
 void deleteExpo(uint8_t idx)
 {
-  mixerTaskStop();
-  ExpoData * expo = expoAddress(idx);
-  int input = expo->chn;
-  memmove(expo, expo+1, (MAX_EXPOS-(idx+1))*sizeof(ExpoData));
-  memclear(&g_model.expoData[MAX_EXPOS-1], sizeof(ExpoData));
-  if (!isInputAvailable(input)) {
-    memclear(&g_model.inputNames[input], LEN_INPUT_NAME);
-  }
-  mixerTaskStart();
+  ExpoEdit edit;
+  edit.idx = idx;
+  mixerTaskCommitEdit(deleteExpoLine, &edit);
   storageDirty(EE_MODEL);
 }
 
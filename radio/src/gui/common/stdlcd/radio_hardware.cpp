@@ -22,6 +22,7 @@
 #include "opentx.h"
 
 #include "hal/adc_driver.h"
+#include "hal/adc_filter.h"
 #include "hal/switch_driver.h"
 #include "hal/module_port.h"
 
@@ -78,6 +79,7 @@ enum {
   ITEM_RADIO_HARDWARE_SERIAL_PORT,
   ITEM_RADIO_HARDWARE_SERIAL_PORT_END = ITEM_RADIO_HARDWARE_SERIAL_PORT + MAX_SERIAL_PORTS - 1,
   ITEM_RADIO_HARDWARE_JITTER_FILTER,
+  ITEM_RADIO_HARDWARE_ADC_FILTER_TYPE,
   ITEM_RADIO_HARDWARE_RAS,
   ITEM_RADIO_HARDWARE_SPORT_UPDATE_POWER,
   ITEM_RADIO_HARDWARE_DEBUG,
@@ -202,6 +204,7 @@ static void _init_menu_tab_array(uint8_t* tab, size_t len)
   }
   tab[ITEM_RADIO_HARDWARE_SERIAL_PORT_LABEL] = has_serial ? READONLY_ROW : HIDDEN_ROW;
   tab[ITEM_RADIO_HARDWARE_JITTER_FILTER] = 0;
+  tab[ITEM_RADIO_HARDWARE_ADC_FILTER_TYPE] = 0;
   tab[ITEM_RADIO_HARDWARE_RAS] = READONLY_ROW;
 
   auto mod_desc = modulePortGetModuleDescription(SPORT_MODULE);
@@ -400,6 +403,13 @@ void menuRadioHardware(event_t event)
                              event);
         break;
 
+      case ITEM_RADIO_HARDWARE_ADC_FILTER_TYPE:
+        g_eeGeneral.adcFilter =
+            editChoice(HW_SETTINGS_COLUMN2, y, STR_TYPE, STR_ADC_FILTER_TYPES,
+                       g_eeGeneral.adcFilter, 0, ADC_FILTER_COUNT - 1, attr,
+                       event);
+        break;
+
       case ITEM_RADIO_HARDWARE_RAS:
 #if defined(HARDWARE_INTERNAL_RAS)
         lcdDrawTextAlignedLeft(y, "RAS");
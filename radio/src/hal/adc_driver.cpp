@@ -20,9 +20,11 @@
  */
 
 #include "adc_driver.h"
+#include "adc_filter.h"
 #include "board.h"
 
 #include "opentx.h"
+#include "mixer_scheduler.h"
 
 const etx_hal_adc_driver_t* _hal_adc_driver = nullptr;
 const etx_hal_adc_inputs_t* _hal_adc_inputs = nullptr;
@@ -260,7 +262,6 @@ uint16_t* getAnalogValues()
 // used by diaganas
 uint32_t s_anaFilt[MAX_ANALOG_INPUTS];
 
-#define ANALOG_MULTIPLIER (1 << ANALOG_SCALE)
 #define ANA_FILT(chan)    (s_anaFilt[chan] / (JITTER_ALPHA * ANALOG_MULTIPLIER))
 #if (JITTER_ALPHA * ANALOG_MULTIPLIER > 32)
   #error "JITTER_FILTER_STRENGTH and ANALOG_SCALE are too big, their summ should be <= 5 !!!"
@@ -287,6 +288,7 @@ void anaSetFiltered(uint8_t chan, uint16_t val)
 void anaResetFiltered()
 {
   memset(s_anaFilt, 0, sizeof(s_anaFilt));
+  adcFilters.initialized = 0;
 }
 
 #if defined(JITTER_MEASURE)
@@ -323,69 +325,19 @@ uint16_t getBatteryVoltage()
 #endif
 }
 
-static uint32_t apply_low_pass_filter(uint32_t v, uint32_t v_prev,
-                                      bool is_main_input)
-{
-  // Jitter filter:
-  //    * pass trough any big change directly
-  //    * for small change use Modified moving average (MMA) filter
-  //
-  // Explanation:
-  //
-  // Normal MMA filter has this formula:
-  //            <out> = ((ALPHA-1)*<out> + <in>)/ALPHA
-  //
-  // If calculation is done this way with integer arithmetics, then any small
-  // change in input signal is lost. One way to combat that, is to rearrange the
-  // formula somewhat, to store a more precise (larger) number between
-  // iterations. The basic idea is to store undivided value between iterations.
-  // Therefore an new variable <filtered> is used. The new formula becomes:
-  //           <filtered> = <filtered> - <filtered>/ALPHA + <in>
-  //           <out> = <filtered>/ALPHA  (use only when out is needed)
-  //
-  // The above formula with a maximum allowed ALPHA value (we are limited by
-  // the 16 bit s_anaFilt[]) was tested on the radio. The resulting signal still
-  // had some jitter (a value of 1 was observed). The jitter might be bigger on
-  // other radios.
-  //
-  // So another idea is to use larger input values for filtering. So instead of
-  // using input in a range from 0 to 2047, we use twice larger number (temp[x]
-  // is divided less)
-  //
-  // This also means that ALPHA must be lowered (remember 16 bit limit), but
-  // test results have proved that this kind of filtering gives better results.
-  // So the recommended values for filter are:
-  //     JITTER_FILTER_STRENGTH  4
-  //     ANALOG_SCALE            1
-  //
-  uint32_t previous = v_prev / JITTER_ALPHA;
-  uint32_t diff = (v > previous) ? (v - previous) : (previous - v);
-
-  // Combine ADC jitter filter setting form radio and model.
-  // Model can override (on or off) or use setting from radio setup.
-  // Model setting is active when 1, radio setting is active when 0
-  // Please note: these settings only apply to main controls.
-  bool useJitterFilter = true;
-  if (is_main_input) {
-    if (g_model.jitterFilter == OVERRIDE_GLOBAL) {
-      // Use radio setting - which is inverted
-      useJitterFilter = !g_eeGeneral.noJitterFilter;
-    } else {
-      // Enable if value is "On", disable if "Off"
-      useJitterFilter = (g_model.jitterFilter == OVERRIDE_ON);
-    }
-  }
-
-  uint32_t out;
-  if (useJitterFilter && diff < (10 * ANALOG_MULTIPLIER)) {
-    // apply jitter filter
-    out = (v_prev - previous) + v;
-  } else {
-    // use unfiltered value
-    out = v * JITTER_ALPHA;
+// Combine ADC jitter filter setting form radio and model.
+// Model can override (on or off) or use setting from radio setup.
+// Model setting is active when 1, radio setting is active when 0
+// Please note: these settings only apply to main controls.
+static bool useMainsJitterFilter()
+{
+  if (g_model.jitterFilter == OVERRIDE_GLOBAL) {
+    // Use radio setting - which is inverted
+    return !g_eeGeneral.noJitterFilter;
   }
 
-  return out;
+  // Enable if value is "On", disable if "Off"
+  return g_model.jitterFilter == OVERRIDE_ON;
 }
 
 static uint32_t apply_calibration(const CalibData* calib, uint32_t v)
@@ -454,27 +406,46 @@ void getADC()
   if (!adcRead()) TRACE("adcRead failed");
   DEBUG_TIMER_STOP(debugTimerAdcRead);
 
-  for (uint8_t x = 0; x < max_analogs; x++) {
+  uint32_t multipos = 0, inverted = 0;
+  for (uint8_t i = 0; i < max_pots; i++) {
+    uint32_t mask = 1u << (pot_offset + i);
+    if (IS_POT_MULTIPOS(i)) multipos |= mask;
+    if (getPotInversion(i)) inverted |= mask;
+  }
 
-    bool is_flex_input = (x >= pot_offset) && (x < pot_offset + max_pots);
-    bool is_multipos = is_flex_input && IS_POT_MULTIPOS(x - pot_offset);
+  uint32_t bypass = 0;
+  if (!useMainsJitterFilter()) {
+    bypass = (1u << max_mains) - 1;
+  }
+
+  for (uint8_t x = 0; x < max_mains; x++) {
+    adcSetInputFilter(x, g_eeGeneral.adcFilter);
+  }
 
-    // 1st: apply calibration
+  // 1st: apply calibration and inversion
+  uint16_t calibrated[MAX_ANALOG_INPUTS];
+  for (uint8_t x = 0; x < max_analogs; x++) {
+    uint32_t mask = 1u << x;
     uint32_t v = getAnalogValue(x);
 
-    if (x < max_calib_analogs && !is_multipos) {
+    if (x < max_calib_analogs && !(multipos & mask)) {
       v = apply_calibration(&g_eeGeneral.calib[x], v);
     }
 
-    // 2nd: apply inversion
-    if (is_flex_input && getPotInversion(x - pot_offset)) {
+    if (inverted & mask) {
       v = 4 * RESX - v;
     }
 
-    // 3rd: apply filtering
-    s_anaFilt[x] = apply_low_pass_filter(v, s_anaFilt[x], x < max_mains);
+    calibrated[x] = v;
+  }
+
+  // 2nd: apply filtering
+  adcFilterInputs(adcFilters, calibrated, s_anaFilt, max_analogs, bypass,
+                  getMixerSchedulerPeriod());
 
-    if (is_multipos) {
+  // 3rd: convert multipos switches into steps
+  for (uint8_t x = 0; x < max_analogs; x++) {
+    if (multipos & (1u << x)) {
       const auto* calib = (const StepsCalibData*)&g_eeGeneral.calib[x];
       if (IS_MULTIPOS_CALIBRATED(calib)) {
         s_anaFilt[x] = apply_multipos(calib, s_anaFilt[x]);
@@ -34,6 +34,7 @@
 // tune this value, bigger value - more filtering (range: 0-1) (see explanation below)
 #define ANALOG_SCALE            1
 #define JITTER_ALPHA            (1<<JITTER_FILTER_STRENGTH)
+#define ANALOG_MULTIPLIER       (1<<ANALOG_SCALE)
 
 enum {
   ADC_INPUT_MAIN=0, // gimbals / wheel + throttle
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "adc_filter.h"
+
+#define TWO_PI 6.2831853f
+
+AdcFilters adcFilters;
+
+void adcFilterReset(AdcFilters& filters)
+{
+  memset(&filters, 0, sizeof(filters));
+}
+
+// Jitter filter:
+//    * pass trough any big change directly
+//    * for small change use Modified moving average (MMA) filter
+//
+// Explanation:
+//
+// Normal MMA filter has this formula:
+//            <out> = ((ALPHA-1)*<out> + <in>)/ALPHA
+//
+// If calculation is done this way with integer arithmetics, then any small
+// change in input signal is lost. One way to combat that, is to rearrange the
+// formula somewhat, to store a more precise (larger) number between
+// iterations. The basic idea is to store undivided value between iterations.
+// Therefore an new variable <filtered> is used. The new formula becomes:
+//           <filtered> = <filtered> - <filtered>/ALPHA + <in>
+//           <out> = <filtered>/ALPHA  (use only when out is needed)
+//
+// The above formula with a maximum allowed ALPHA value (we are limited by
+// the 16 bit s_anaFilt[]) was tested on the radio. The resulting signal still
+// had some jitter (a value of 1 was observed). The jitter might be bigger on
+// other radios.
+//
+// So another idea is to use larger input values for filtering. So instead of
+// using input in a range from 0 to 2047, we use twice larger number (temp[x]
+// is divided less)
+//
+// This also means that ALPHA must be lowered (remember 16 bit limit), but
+// test results have proved that this kind of filtering gives better results.
+// So the recommended values for filter are:
+//     JITTER_FILTER_STRENGTH  4
+//     ANALOG_SCALE            1
+//
+static inline uint32_t jitterFilter(uint32_t v, uint32_t v_prev)
+{
+  uint32_t previous = v_prev / JITTER_ALPHA;
+  uint32_t diff = (v > previous) ? (v - previous) : (previous - v);
+
+  if (diff < (10 * ANALOG_MULTIPLIER)) {
+    return (v_prev - previous) + v;
+  }
+
+  return v * JITTER_ALPHA;
+}
+
+// 1€ filter (Casiez, Roussel, Vogel 2012): a first order low-pass,
+// which cutoff frequency rises with the (filtered) input speed
+static inline float oneEuroAlpha(float cutoff, float te)
+{
+  float tau = 1.0f / (TWO_PI * cutoff);
+  return te / (te + tau);
+}
+
+static inline uint32_t oneEuroFilter(AdcFilters& filters, uint8_t x,
+                                     uint32_t v, float te, float speedAlpha)
+{
+  float value = filters.value[x];
+  float speed = filters.speed[x];
+
+  speed += speedAlpha * (((float)v - value) / te - speed);
+  float cutoff = ADC_ONE_EURO_MIN_CUTOFF + ADC_ONE_EURO_BETA * fabsf(speed);
+  value += oneEuroAlpha(cutoff, te) * ((float)v - value);
+
+  filters.value[x] = value;
+  filters.speed[x] = speed;
+  return (uint32_t)(value * JITTER_ALPHA + 0.5f);
+}
+
+static inline uint32_t decimateFilter(AdcFilters& filters, uint8_t x,
+                                      uint32_t v)
+{
+  uint16_t& sample = filters.samples[filters.next][x];
+  filters.sum[x] += v - sample;
+  sample = v;
+  return filters.sum[x] * JITTER_ALPHA / ADC_DECIMATE_SAMPLES;
+}
+
+static void initFilter(AdcFilters& filters, uint8_t x, uint32_t v)
+{
+  filters.value[x] = v;
+  filters.speed[x] = 0;
+  for (uint8_t i = 0; i < ADC_DECIMATE_SAMPLES; i++) {
+    filters.samples[i][x] = v;
+  }
+  filters.sum[x] = v * ADC_DECIMATE_SAMPLES;
+  filters.initialized |= 1u << x;
+}
+
+void adcFilterInputs(AdcFilters& filters, const uint16_t* values,
+                     uint32_t* filtered, uint8_t count, uint32_t bypass,
+                     uint32_t periodUs)
+{
+  // only computed when a 1€ filter is used
+  float te = 0.0f;
+  float speedAlpha = 0.0f;
+
+  for (uint8_t x = 0; x < count; x++) {
+    uint32_t v = values[x];
+    uint32_t mask = 1u << x;
+
+    if (!(filters.initialized & mask)) {
+      initFilter(filters, x, v);
+    }
+
+    if (bypass & mask) {
+      // filters state restarts from the input when enabled again
+      filters.initialized &= ~mask;
+      filtered[x] = v * JITTER_ALPHA;
+      continue;
+    }
+
+    switch (filters.type[x]) {
+      case ADC_FILTER_ONE_EURO:
+        if (te == 0.0f) {
+          te = (float)periodUs / 1000000.0f;
+          speedAlpha = oneEuroAlpha(ADC_ONE_EURO_D_CUTOFF, te);
+        }
+        filtered[x] = oneEuroFilter(filters, x, v, te, speedAlpha);
+        break;
+      case ADC_FILTER_DECIMATE:
+        filtered[x] = decimateFilter(filters, x, v);
+        break;
+      default:
+        filtered[x] = jitterFilter(v, filtered[x]);
+        break;
+    }
+  }
+
+  filters.next = (filters.next + 1) % ADC_DECIMATE_SAMPLES;
+}
+
+uint32_t adcFilterLatency(uint8_t type, uint32_t periodUs)
+{
+  switch (type) {
+    case ADC_FILTER_ONE_EURO:
+      // time constant at rest, does not depend on the period
+      return (uint32_t)(1000000.0f / (TWO_PI * ADC_ONE_EURO_MIN_CUTOFF));
+    case ADC_FILTER_DECIMATE:
+      return (ADC_DECIMATE_SAMPLES - 1) * periodUs / 2;
+    default:
+      // moving average delay, big changes are not delayed
+      return (JITTER_ALPHA - 1) * periodUs;
+  }
+}
+
+void adcSetInputFilter(uint8_t input, uint8_t type)
+{
+  if (input >= MAX_ANALOG_INPUTS || type >= ADC_FILTER_COUNT) return;
+  if (adcFilters.type[input] == type) return;
+  adcFilters.type[input] = type;
+  adcFilters.initialized &= ~(1u << input);
+}
+
+uint8_t adcGetInputFilter(uint8_t input)
+{
+  if (input >= MAX_ANALOG_INPUTS) return ADC_FILTER_JITTER;
+  return adcFilters.type[input];
+}
+
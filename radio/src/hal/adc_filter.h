@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "dataconstants.h"
+#include "adc_driver.h"
+
+//
+// Analog inputs filters
+//
+// All the inputs are filtered in one pass by adcFilterInputs(), each
+// one with its own filter. Inputs are the calibrated values (0..4*RESX),
+// outputs are scaled by JITTER_ALPHA (see anaIn()).
+//
+
+enum AdcFilterType {
+  ADC_FILTER_JITTER = 0,  // moving average, big changes passed through
+  ADC_FILTER_ONE_EURO,    // 1€ filter: cutoff raised with the speed
+  ADC_FILTER_DECIMATE,    // average of the last ADC_DECIMATE_SAMPLES
+  ADC_FILTER_COUNT
+};
+
+#define ADC_DECIMATE_SAMPLES     4
+
+// 1€ filter parameters (speed in input steps per second)
+#define ADC_ONE_EURO_MIN_CUTOFF  5.0f    // Hz, at rest
+#define ADC_ONE_EURO_BETA        0.002f  // Hz per step/s
+#define ADC_ONE_EURO_D_CUTOFF    10.0f   // Hz, speed low-pass
+
+static_assert(MAX_ANALOG_INPUTS <= 32, "inputs masks are 32 bits");
+
+// Filters state (structure of arrays, indexed by analog input)
+struct AdcFilters {
+  uint8_t type[MAX_ANALOG_INPUTS];
+  uint32_t initialized;  // mask of the inputs with a valid state
+
+  // ADC_FILTER_ONE_EURO
+  float value[MAX_ANALOG_INPUTS];
+  float speed[MAX_ANALOG_INPUTS];
+
+  // ADC_FILTER_DECIMATE
+  uint16_t samples[ADC_DECIMATE_SAMPLES][MAX_ANALOG_INPUTS];
+  uint32_t sum[MAX_ANALOG_INPUTS];
+  uint8_t next;
+};
+
+extern AdcFilters adcFilters;
+
+void adcFilterReset(AdcFilters& filters);
+
+// Filters the first 'count' inputs, once per mixer cycle ('periodUs').
+// 'filtered' holds the previous outputs on entry. Inputs in 'bypass'
+// are not filtered (jitter filter disabled).
+void adcFilterInputs(AdcFilters& filters, const uint16_t* values,
+                     uint32_t* filtered, uint8_t count, uint32_t bypass,
+                     uint32_t periodUs);
+
+// Delay (us) added by a filter to slow input changes
+uint32_t adcFilterLatency(uint8_t type, uint32_t periodUs);
+
+// main controls use g_eeGeneral.adcFilter, other inputs the jitter filter
+void adcSetInputFilter(uint8_t input, uint8_t type);
+uint8_t adcGetInputFilter(uint8_t input);
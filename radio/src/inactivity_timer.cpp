@@ -64,13 +64,21 @@ bool inactivityCheckInputs()
       sum += getAnalogValue(i) >> INAC_STICKS_SHIFT;
   }
 
-  for (uint8_t i = 0; i < getSwitchCount(); i++)
-    sum += getValue(MIXSRC_FIRST_SWITCH + i) >> INAC_SWITCHES_SHIFT;
+  mixsrc_t sources[MAX_SWITCHES + 2];
+  getvalue_t values[MAX_SWITCHES + 2];
+  uint8_t switches = getSwitchCount();
+  uint8_t count = 0;
 
+  for (uint8_t i = 0; i < switches; i++)
+    sources[count++] = MIXSRC_FIRST_SWITCH + i;
 #if defined(IMU)
-  for (uint8_t i = 0; i < 2; i++)
-    sum += getValue(MIXSRC_TILT_X + i) >> INAC_STICKS_SHIFT;
+  sources[count++] = MIXSRC_TILT_X;
+  sources[count++] = MIXSRC_TILT_Y;
 #endif
+  getValues(sources, values, count);
+
+  for (uint8_t i = 0; i < count; i++)
+    sum += values[i] >> (i < switches ? INAC_SWITCHES_SHIFT : INAC_STICKS_SHIFT);
 
 #if defined(SPACEMOUSE)
   for (uint8_t i = 0; i < (MIXSRC_LAST_SPACEMOUSE - MIXSRC_FIRST_SPACEMOUSE + 1);
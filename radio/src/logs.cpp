@@ -27,6 +27,7 @@
 #include "hal/adc_driver.h"
 #include "hal/switch_driver.h"
 #include "hal/usb_driver.h"
+#include "mixer_outputs.h"
 
 #if defined(LIBOPENUI)
   #include "libopenui.h"
@@ -367,8 +368,11 @@ void logsWrite()
       f_printf(&g_oLogFile, "0x%08X%08X,", getLogicalSwitchesStates(32),
                getLogicalSwitchesStates(0));
 
+      // all the channels from the same mixer cycle
+      MixerOutputs outputs;
+      mixerOutputsRead(outputs);
       for (uint8_t channel = 0; channel < MAX_OUTPUT_CHANNELS; channel++) {
-        f_printf(&g_oLogFile, "%d,", PPM_CENTER+channelOutputs[channel]/2); // in us
+        f_printf(&g_oLogFile, "%d,", PPM_CENTER+outputs.channels[channel]/2); // in us
       }
 
       div_t qr = div(g_vbat100mV, 10);
@@ -28,8 +28,10 @@
 #include "libopenui.h"
 #include "widget.h"
 #include "theme.h"
+#include "bitmap_cache.h"
 
 #include "lua_api.h"
+#include "lua_display_list.h"
 #include "api_colorlcd.h"
 
 #define BITMAP_METATABLE "BITMAP*"
@@ -105,6 +107,8 @@ Clear the LCD screen
 */
 static int luaLcdClear(lua_State * L)
 {
+  LUA_LCD_RECORD(L, luaLcdClear);
+
   if (luaLcdAllowed && luaLcdBuffer) {
     LcdFlags flags = luaL_optunsigned(L, 1, COLOR2FLAGS(COLOR_THEME_SECONDARY3_INDEX));
     flags = flagsRGB(flags);
@@ -148,6 +152,8 @@ bottom line is 63. Drawing on an existing black pixel produces white pixel (TODO
 */
 static int luaLcdDrawPoint(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawPoint);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -182,6 +188,8 @@ whole line will not be drawn (starting from OpenTX 2.1.5)
 */
 static int luaLcdDrawLine(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawLine);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -277,6 +285,8 @@ Draw a text beginning at (x,y)
 */
 static int luaLcdDrawText(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawText);
+
   const char * s = luaL_checkstring(L, 3);
   LcdFlags flags = luaL_optunsigned(L, 4, 0);
   drawString(L, s, flags);
@@ -322,6 +332,8 @@ Draw text inside rectangle (x,y,w,h) with line breaks
 */
 static int luaLcdDrawTextLines(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawTextLines);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -378,6 +390,8 @@ Display a value formatted as time at (x,y)
 */
 static int luaLcdDrawTimer(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawTimer);
+
   char s[LEN_TIMER_STRING];
   int tme = luaL_checkinteger(L, 3);
   LcdFlags flags = luaL_optunsigned(L, 4, 0);
@@ -405,6 +419,8 @@ Display a number at (x,y)
 */
 static int luaLcdDrawNumber(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawNumber);
+
   char s[49];
   int val = luaL_checkinteger(L, 3);
   LcdFlags flags = luaL_optunsigned(L, 4, 0);
@@ -429,6 +445,8 @@ See getValue()
 */
 static int luaLcdDrawChannel(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawChannel);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -470,6 +488,8 @@ displays negated switch
 */
 static int luaLcdDrawSwitch(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawSwitch);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -498,6 +518,8 @@ Displays the name of the corresponding input as defined by the source at (x,y)
 */
 static int luaLcdDrawSource(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawSource);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -511,6 +533,29 @@ static int luaLcdDrawSource(lua_State *L)
   return 0;
 }
 
+// Bitmaps are shared through bitmapCache: each bitmap used by Lua is
+// charged once to luaExtraMemoryUsage, until its last Lua reference
+// is released
+struct LuaBitmap {
+  const BitmapBuffer * bitmap;
+};
+
+static LuaBitmap * newLuaBitmap(lua_State * L)
+{
+  LuaBitmap * b = (LuaBitmap *)lua_newuserdata(L, sizeof(LuaBitmap));
+  b->bitmap = nullptr;
+  return b;
+}
+
+static void chargeLuaBitmap(LuaBitmap * b, const char * what)
+{
+  if (b->bitmap) {
+    uint32_t charged = bitmapCache.charge(b->bitmap);
+    luaExtraMemoryUsage += charged;
+    TRACE("%s: %p (%u)", what, b->bitmap, charged);
+  }
+}
+
 /*luadoc
 @function Bitmap.open(name)
 
@@ -535,27 +580,21 @@ static int luaOpenBitmap(lua_State *L)
 {
   const char *filename = luaL_checkstring(L, 1);
 
-  BitmapBuffer **b =
-      (BitmapBuffer **)lua_newuserdata(L, sizeof(BitmapBuffer *));
+  LuaBitmap * b = newLuaBitmap(L);
 
   if (luaExtraMemoryUsage > LUA_MEM_EXTRA_MAX) {
     // already allocated more than max allowed, fail
     TRACE("luaOpenBitmap: Error, using too much memory %u/%u",
           luaExtraMemoryUsage, LUA_MEM_EXTRA_MAX);
-    *b = 0;
   } else {
-    *b = BitmapBuffer::loadBitmap(filename);
-    if (*b == NULL && G(L)->gcrunning) {
-      luaC_fullgc(L, 1);                       /* try to free some memory... */
-      *b = BitmapBuffer::loadBitmap(filename); /* try again */
+    b->bitmap = bitmapCache.acquire(filename);
+    if (b->bitmap == NULL && G(L)->gcrunning) {
+      luaC_fullgc(L, 1);                        /* try to free some memory... */
+      b->bitmap = bitmapCache.acquire(filename); /* try again */
     }
   }
 
-  if (*b) {
-    uint32_t size = (*b)->getDataSize();
-    luaExtraMemoryUsage += size;
-    TRACE("luaOpenBitmap: %p (%u)", *b, size);
-  }
+  chargeLuaBitmap(b, "luaOpenBitmap");
 
   luaL_getmetatable(L, BITMAP_METATABLE);
   lua_setmetatable(L, -2);
@@ -563,10 +602,10 @@ static int luaOpenBitmap(lua_State *L)
   return 1;
 }
 
-static BitmapBuffer * checkBitmap(lua_State * L, int index)
+static const BitmapBuffer * checkBitmap(lua_State * L, int index)
 {
-  BitmapBuffer ** b = (BitmapBuffer **)luaL_checkudata(L, index, BITMAP_METATABLE);
-  return *b;
+  LuaBitmap * b = (LuaBitmap *)luaL_checkudata(L, index, BITMAP_METATABLE);
+  return b->bitmap;
 }
 
 /*luadoc
@@ -624,24 +663,18 @@ static int luaBitmapResize(lua_State * L)
     return 1;
   }
 
-  BitmapBuffer **n = (BitmapBuffer**)lua_newuserdata(L, sizeof(BitmapBuffer*));
+  LuaBitmap * n = newLuaBitmap(L);
 
   if (luaExtraMemoryUsage > LUA_MEM_EXTRA_MAX) {
     // already allocated more than max allowed, fail
     TRACE("luaOpenBitmap: Error, using too much memory %u/%u",
           luaExtraMemoryUsage, LUA_MEM_EXTRA_MAX);
-    *n = 0;
   } else {
-    *n = new BitmapBuffer(BMP_ARGB4444, w, h);
-    (*n)->clear();
-    (*n)->drawScaledBitmap(b, 0, 0, w, h);
+    // same size: shared with the source bitmap
+    n->bitmap = bitmapCache.acquireScaled(b, w, h);
   }
 
-  if (*n) {
-    uint32_t size = (*n)->getDataSize();
-    luaExtraMemoryUsage += size;
-    TRACE("luaResizeBitmap: %p (%u)", *n, size);
-  }
+  chargeLuaBitmap(n, "luaResizeBitmap");
 
   luaL_getmetatable(L, BITMAP_METATABLE);
   lua_setmetatable(L, -2);
@@ -678,17 +711,18 @@ static int luaBitmapTo8bitMask(lua_State * L)
 
 static int luaDestroyBitmap(lua_State * L)
 {
-  BitmapBuffer * b = checkBitmap(L, 1);
-  if (b) {
-    uint32_t size = b->getDataSize();
-    TRACE("luaDestroyBitmap: %p (%u)", b, size);
-    if (luaExtraMemoryUsage >= size) {
-      luaExtraMemoryUsage -= size;
+  LuaBitmap * b = (LuaBitmap *)luaL_checkudata(L, 1, BITMAP_METATABLE);
+  if (b->bitmap) {
+    uint32_t charged = bitmapCache.uncharge(b->bitmap);
+    TRACE("luaDestroyBitmap: %p (%u)", b->bitmap, charged);
+    if (luaExtraMemoryUsage >= charged) {
+      luaExtraMemoryUsage -= charged;
     }
     else {
       luaExtraMemoryUsage = 0;
     }
-    delete b;
+    bitmapCache.release(b->bitmap);
+    b->bitmap = nullptr;
   }
   return 0;
 }
@@ -712,6 +746,8 @@ Omitting scale draws image in 1:1 scale and is faster than specifying 100 for sc
 */
 static int luaLcdDrawBitmap(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawBitmap);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -750,6 +786,8 @@ Displays a bitmap pattern at (x,y)
 */
 static int luaLcdDrawBitmapPattern(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawBitmapPattern);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -787,6 +825,8 @@ Displays a bitmap pattern pie at (x,y)
 */
 static int luaLcdDrawBitmapPatternPie(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawBitmapPatternPie);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -826,6 +866,8 @@ Draw a rectangle from top left corner (x,y) of specified width and height
 */
 static int luaLcdDrawRectangle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawRectangle);
+
   if (!luaLcdAllowed || !luaLcdBuffer) return 0;
 
   int x = luaL_checkinteger(L, 1);
@@ -862,6 +904,8 @@ Draw a solid rectangle from top left corner (x,y) of specified width and height
 */
 static int luaLcdDrawFilledRectangle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawFilledRectangle);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -897,6 +941,8 @@ Invert a rectangle zone from top left corner (x,y) of specified width and height
 */
 static int luaLcdInvertRect(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdInvertRect);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -934,6 +980,8 @@ Draw a simple gauge that is filled based upon fill value
 */
 static int luaLcdDrawGauge(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawGauge);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -966,6 +1014,8 @@ Please notice that changing theme colors affects not only other Lua widgets, but
 */
 static int luaLcdSetColor(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdSetColor);
+
   unsigned int index = COLOR_VAL(luaL_checkunsigned(L, 1));
   uint16_t color = COLOR_VAL(flagsRGB(luaL_checkunsigned(L, 2)));
 
@@ -1052,6 +1102,8 @@ Draw a circle at (x, y) of specified radius
 */
 static int luaLcdDrawCircle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawCircle);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1081,6 +1133,8 @@ Draw a filled circle at (x, y) of specified radius
 */
 static int luaLcdDrawFilledCircle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawFilledCircle);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1108,6 +1162,8 @@ Draw a triangle
 */
 static int luaLcdDrawTriangle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawTriangle);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1140,6 +1196,8 @@ Draw a filled triangle
 */
 static int luaLcdDrawFilledTriangle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawFilledTriangle);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1174,6 +1232,8 @@ Draw an arc
 */
 static int luaLcdDrawArc(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawArc);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1208,6 +1268,8 @@ Draw a pie slice
 */
 static int luaLcdDrawPie(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawPie);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1242,6 +1304,8 @@ Draw an arc
 */
 static int luaLcdDrawAnnulus(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawAnnulus);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1276,6 +1340,8 @@ Draw a line only inside a rectangle
 */
 static int luaLcdDrawLineWithClipping(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawLineWithClipping);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -1384,6 +1450,8 @@ Draw a rectangle in perspective
 */
 static int luaLcdDrawHudRectangle(lua_State *L)
 {
+  LUA_LCD_RECORD(L, luaLcdDrawHudRectangle);
+
   if (!luaLcdAllowed || !luaLcdBuffer)
     return 0;
 
@@ -32,6 +32,7 @@
 #include "hal/rotary_encoder.h"
 #include "switches.h"
 #include "input_mapping.h"
+#include "mixer_outputs.h"
 #if defined(LED_STRIP_GPIO)
 #include "boards/generic_stm32/rgb_leds.h"
 #endif
@@ -2838,7 +2839,9 @@ static int luaGetOutputValue(lua_State * L)
 {
   mixsrc_t idx = luaL_checkinteger(L, 1);
   if (idx < MAX_OUTPUT_CHANNELS) {           // mixsrc_t is unsigned, no need to check for <0
-    lua_pushinteger(L, channelOutputs[idx]);
+    int16_t channels[MAX_OUTPUT_CHANNELS];
+    mixerOutputsReadChannels(channels);
+    lua_pushinteger(L, channels[idx]);
   } else {
     lua_pushinteger(L, 0);
   }
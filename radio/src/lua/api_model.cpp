@@ -1205,7 +1205,6 @@ static int luaModelSetCurve(lua_State *L)
   memset(yPoints, -127, sizeof(yPoints));
 
 
-  CurveHeader &destCurveHeader = g_model.curves[curveIdx];
   CurveHeader newCurveHeader;
   memclear(&newCurveHeader, sizeof(CurveHeader));
 
@@ -1299,46 +1298,24 @@ static int luaModelSetCurve(lua_State *L)
     }
   }
 
-  // Calculate size of curve we replace
-  int oldCurveMemSize;
-  if (destCurveHeader.type == CURVE_TYPE_STANDARD) {
-    oldCurveMemSize = 5 + destCurveHeader.points;
-  }
-  else {
-    oldCurveMemSize = 8 + 2 * destCurveHeader.points;
+  int8_t points[MAX_CURVE_DATA_POINTS];
+  int8_t *point = points;
+  for (int i = 0; i < newCurveHeader.points + 5; i++) {
+    *point++ = yPoints[i];
   }
 
-  // Calculate own size
-  int newCurveMemSize;
-  if (newCurveHeader.type == CURVE_TYPE_STANDARD)
-    newCurveMemSize = 5 + newCurveHeader.points;
-  else
-    newCurveMemSize = 8 + 2 * newCurveHeader.points;
-
-  int shift = newCurveMemSize - oldCurveMemSize;
+  if (newCurveHeader.type == CURVE_TYPE_CUSTOM) {
+    for (int i = 1; i < newCurveHeader.points + 4; i++) {
+      *point++ = xPoints[i];
+    }
+  }
 
   // Also checks if new curve size would fit
-  if (!moveCurve(curveIdx, shift)) {
+  if (!curveUpdate(curveIdx, newCurveHeader, points)) {
     lua_pushinteger(L, 3);
-    TRACE("curve shift is  %d", shift);
     return 1;
   }
 
-  // Curve fits into mem, fill new curve
-  destCurveHeader = newCurveHeader;
-
-  int8_t *point = curveAddress(curveIdx);
-  for (int i = 0; i < destCurveHeader.points + 5; i++) {
-    *point++ = yPoints[i];
-  }
-
-  if (destCurveHeader.type == CURVE_TYPE_CUSTOM) {
-    for (int i = 1; i < destCurveHeader.points + 4; i++) {
-      *point++ = xPoints[i];
-    }
-  }
-  storageDirty(EE_MODEL);
-
   lua_pushinteger(L, 0);
   return 1;
 }
@@ -1439,6 +1416,7 @@ static int luaModelSetCustomFunction(lua_State *L)
         cfn->repeat = luaL_checkinteger(L, -1);
       }
     }
+    modelFunctionsContext.invalidateIndex();
     storageDirty(EE_MODEL);
   }
 
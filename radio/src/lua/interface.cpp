@@ -34,6 +34,7 @@
 #include "sdcard.h"
 #include "api_filesystem.h"
 #include "switches.h"
+#include "timers_driver.h"
 
 #if defined(LIBOPENUI)
   #include "libopenui.h"
@@ -53,6 +54,20 @@ extern "C" {
 #define PERMANENT_SCRIPTS_MAX_INSTRUCTIONS 100
 #define LUA_TASK_PERIOD_TICKS                5   // 50 ms
 
+// Lua task time (scripts + GC) for each call, the GC gets what the
+// scripts left, within these limits
+#define LUA_GC_FRAME_US                  10000
+#define LUA_GC_MIN_SLICE_US                500
+#define LUA_GC_MAX_SLICE_US               2000
+
+// heap growth since the last cycle below which no slice is done (the
+// allocator's own steps are enough), the full slice is given once the
+// heap doubled
+#define LUA_GC_MIN_GROWTH              (4*1024)
+
+// memory used above which checkLuaMemoryUsage() does full collections
+#define LUA_MEM_GC_PRESSURE     (LUA_MEM_MAX / 4 * 3)
+
 // #if defined(HARDWARE_TOUCH)
 // #include "touch.h"
 // #endif
@@ -75,6 +90,7 @@ tmr10ms_t luaCycleStart;
 char lua_warning_info[LUA_WARNING_INFO_LEN+1];
 uint8_t errorState;
 struct our_longjmp * global_lj = 0;
+LuaGcStats luaGcStats;
 #if defined(COLORLCD)
 uint32_t luaExtraMemoryUsage = 0;
 #endif
@@ -119,6 +135,204 @@ void *tracer_alloc(void * ud, void * ptr, size_t osize, size_t nsize)
 
 #endif // #if defined(LUA_ALLOCATOR_TRACER)
 
+LuaBudgets luaBudgets = {
+  LUA_SCRIPT_TIME_BUDGET_US,
+  LUA_WIDGET_TIME_BUDGET_US,
+  LUA_SCRIPT_MEM_BUDGET,
+  LUA_MAX_OVERRUNS,
+  LUA_MAX_THROTTLE
+};
+
+// script or widget running, charged with the allocations
+static LuaScriptStats * luaRunningStats = nullptr;
+
+#if defined(LUA_SCRIPT_MEMORY)
+// scripts and widgets charged by the allocator, slot 0 is nobody
+#define LUA_MEM_OWNERS    (MAX_SCRIPTS + 64)
+
+struct LuaMemOwner {
+  LuaScriptStats * stats;
+  uint16_t generation;   // incremented when released
+};
+
+static LuaMemOwner luaMemOwners[LUA_MEM_OWNERS];
+
+// prefix of each block, the slot it is charged to; the size keeps the
+// blocks aligned for any Lua object
+struct LuaBlockHeader {
+  uint16_t owner;
+  uint16_t generation;
+};
+
+#define LUA_BLOCK_HEADER  8
+
+static void luaMemCharge(const LuaBlockHeader & header, int32_t size)
+{
+  const LuaMemOwner & owner = luaMemOwners[header.owner];
+  if (header.owner && owner.stats && owner.generation == header.generation)
+    owner.stats->memory += size;
+}
+
+static void luaMemAcquire(LuaScriptStats & stats)
+{
+  stats.memOwner = 0;
+  for (uint16_t slot = 1; slot < LUA_MEM_OWNERS; slot++) {
+    LuaMemOwner & owner = luaMemOwners[slot];
+    if (owner.stats == &stats) {
+      // initialized again without being released
+      owner.stats = nullptr;
+      owner.generation++;
+    }
+    if (!owner.stats && !stats.memOwner) {
+      owner.stats = &stats;
+      stats.memOwner = slot;
+    }
+  }
+}
+
+void luaStatsRelease(LuaScriptStats & stats)
+{
+  LuaMemOwner & owner = luaMemOwners[stats.memOwner];
+  if (stats.memOwner && owner.stats == &stats) {
+    owner.stats = nullptr;
+    owner.generation++;
+  }
+  stats.memOwner = 0;
+}
+#else
+void luaStatsRelease(LuaScriptStats &)
+{
+}
+#endif
+
+static void * luaRealloc(void * ud, void * ptr, size_t osize, size_t nsize)
+{
+#if defined(USE_BIN_ALLOCATOR)
+  return bin_l_alloc(ud, ptr, osize, nsize);
+#elif defined(LUA_ALLOCATOR_TRACER)
+  return tracer_alloc(ud, ptr, osize, nsize);
+#else
+  return l_alloc(ud, ptr, osize, nsize);
+#endif
+}
+
+void * luaAlloc(void * ud, void * ptr, size_t osize, size_t nsize)
+{
+  LuaScriptStats * stats = luaRunningStats;
+  // for new blocks, osize is the object type
+  size_t size = ptr ? osize : 0;
+
+#if defined(LUA_SCRIPT_MEMORY)
+  LuaBlockHeader header = {0, 0};
+  if (ptr) {
+    ptr = (uint8_t *)ptr - LUA_BLOCK_HEADER;
+    header = *(LuaBlockHeader *)ptr;
+    osize += LUA_BLOCK_HEADER;
+  }
+  else if (stats) {
+    header.owner = stats->memOwner;
+    header.generation = luaMemOwners[header.owner].generation;
+  }
+
+  void * res = luaRealloc(ud, ptr, osize, nsize ? nsize + LUA_BLOCK_HEADER : 0);
+  if (!res) {
+    if (nsize == 0) luaMemCharge(header, -(int32_t)size);
+    return nullptr;
+  }
+  *(LuaBlockHeader *)res = header;
+  luaMemCharge(header, (int32_t)nsize - (int32_t)size);
+  res = (uint8_t *)res + LUA_BLOCK_HEADER;
+#else
+  void * res = luaRealloc(ud, ptr, osize, nsize);
+#endif
+
+  if (stats && res && nsize > size) stats->allocated += nsize - size;
+  return res;
+}
+
+void luaStatsInit(LuaScriptStats & stats, uint8_t policy)
+{
+  memclear(&stats, sizeof(stats));
+  stats.policy = policy;
+  if (policy != LUA_POLICY_EXEMPT) {
+    stats.timeBudgetUs = policy == LUA_POLICY_WIDGET ? luaBudgets.widgetTimeUs
+                                                     : luaBudgets.scriptTimeUs;
+    stats.memBudget = luaBudgets.memory;
+  }
+#if defined(LUA_SCRIPT_MEMORY)
+  luaMemAcquire(stats);
+#endif
+}
+
+bool luaStatsRun(LuaScriptStats & stats)
+{
+  if (stats.state >= LUA_BUDGET_CPU_EXCEEDED) return false;
+  if (!stats.throttle) return true;
+  return (++stats.calls & ((1 << stats.throttle) - 1)) == 0;
+}
+
+// time spent in the mixer task, which preempts the Lua one
+static uint32_t luaPreemptedUs()
+{
+#if defined(SIMU)
+  // the tasks are threads running in parallel
+  return 0;
+#else
+  return totalMixerDuration;
+#endif
+}
+
+void luaStatsStart(LuaScriptStats & stats)
+{
+  stats.runUs = 0;
+  stats.startUs = timersGetUsTick();
+  stats.preemptUs = luaPreemptedUs();
+  luaRunningStats = &stats;
+}
+
+void luaStatsPause(LuaScriptStats & stats)
+{
+  if (luaRunningStats != &stats) return;
+  uint32_t us = timersGetUsTick() - stats.startUs;
+  uint32_t preempted = luaPreemptedUs() - stats.preemptUs;
+  // a mixer cycle started before this segment is counted whole
+  stats.runUs += us > preempted ? us - preempted : 0;
+  luaRunningStats = nullptr;
+}
+
+uint8_t luaStatsStop(LuaScriptStats & stats)
+{
+  luaStatsPause(stats);
+
+  stats.runs++;
+  stats.lastUs = stats.runUs;
+  if (stats.lastUs > stats.maxUs) stats.maxUs = stats.lastUs;
+
+  if (stats.state >= LUA_BUDGET_CPU_EXCEEDED) return stats.state;
+
+  if (stats.timeBudgetUs && stats.runUs > stats.timeBudgetUs) {
+    stats.underruns = 0;
+    if (++stats.overruns >= luaBudgets.maxOverruns) {
+      stats.overruns = 0;
+      if (stats.throttle < luaBudgets.maxThrottle) {
+        stats.throttle++;
+        stats.state = LUA_BUDGET_THROTTLED;
+      }
+      else if (stats.policy == LUA_POLICY_SCRIPT) {
+        stats.state = LUA_BUDGET_CPU_EXCEEDED;
+      }
+    }
+  }
+  else {
+    stats.overruns = 0;
+    if (stats.throttle && ++stats.underruns >= luaBudgets.maxOverruns) {
+      stats.underruns = 0;
+      if (--stats.throttle == 0) stats.state = LUA_BUDGET_OK;
+    }
+  }
+  return stats.state;
+}
+
 /* custom panic handler */
 int custom_lua_atpanic(lua_State * L)
 {
@@ -292,15 +506,47 @@ void luaRegisterLibraries(lua_State * L)
 
 #define GC_REPORT_TRESHOLD    (2*1024)
 
-void luaDoGc(lua_State * L, bool full)
+static void luaGcPause(uint32_t us)
+{
+  static const uint16_t limits[LUA_GC_PAUSES_BUCKETS - 1] = { 500, 1000, 2000, 5000 };
+  uint8_t i = 0;
+  while (i < DIM(limits) && us >= limits[i]) i++;
+  luaGcStats.pauses[i]++;
+  if (us > luaGcStats.maxPauseUs) luaGcStats.maxPauseUs = min<uint32_t>(us, 0xFFFF);
+}
+
+// incremental steps, as long as one more fits in the budget,
+// stops at the end of a cycle
+static void luaGcSteps(lua_State * L, uint32_t budgetUs)
+{
+  uint32_t start = timersGetUsTick();
+  uint32_t elapsed;
+  do {
+    uint32_t t0 = timersGetUsTick();
+    int cycleDone = lua_gc(L, LUA_GCSTEP, 0);
+    int32_t us = timersGetUsTick() - t0;
+    luaGcStats.steps++;
+    // running average, in 1/16 us so that short steps count
+    luaGcStats.stepTime += (us * 16 - (int32_t)luaGcStats.stepTime) / 8;
+    if (cycleDone) {
+      luaGcStats.cycles++;
+      break;
+    }
+    elapsed = timersGetUsTick() - start;
+  } while (elapsed + luaGcStats.stepTime / 16 < budgetUs);
+}
+
+void luaDoGc(lua_State * L, bool full, uint32_t budgetUs)
 {
   if (L) {
+    uint32_t start = timersGetUsTick();
     PROTECT_LUA() {
       if (full) {
         lua_gc(L, LUA_GCCOLLECT, 0);
+        luaGcStats.fullCollections++;
       }
       else {
-        lua_gc(L, LUA_GCSTEP, 10);
+        luaGcSteps(L, budgetUs ? budgetUs : LUA_GC_MIN_SLICE_US);
       }
 #if defined(DEBUG)
       if (L == lsScripts) {
@@ -331,6 +577,7 @@ void luaDoGc(lua_State * L, bool full)
 #endif
     }
     UNPROTECT_LUA();
+    luaGcPause(timersGetUsTick() - start);
   }
 }
 
@@ -586,9 +833,29 @@ static const char * getScriptName(uint8_t idx)
   }
 }
 
+void luaForEachStats(LuaStatsVisitor visitor, void * ctx)
+{
+  char name[LEN_SCRIPT_FILENAME + 1];
+  for (uint8_t idx = 0; idx < luaScriptsCount; idx++) {
+    ScriptInternalData & sid = scriptInternalData[idx];
+    if (sid.state != SCRIPT_OK && sid.state != SCRIPT_KILLED) continue;
+    strncpy(name, getScriptName(idx), LEN_SCRIPT_FILENAME);
+    name[LEN_SCRIPT_FILENAME] = '\0';
+    visitor(name, sid.stats, ctx);
+  }
+#if defined(COLORLCD)
+  luaForEachWidgetStats(visitor, ctx);
+#endif
+}
+
 static bool luaLoad(const char * pathname, ScriptInternalData & sid)
 {
+  luaStatsInit(sid.stats, sid.reference == SCRIPT_STANDALONE
+                              ? LUA_POLICY_EXEMPT
+                              : LUA_POLICY_SCRIPT);
+  luaStatsStart(sid.stats);
   sid.state = luaLoadScriptFileToState(lsScripts, pathname, LUA_SCRIPT_LOAD_MODE);
+  luaStatsPause(sid.stats);
 
   if (sid.state != SCRIPT_OK) {
     luaFree(lsScripts, sid);
@@ -720,6 +987,9 @@ void displayLuaError(bool firstCall = false)
     case SCRIPT_PANIC:
       title = STR_SCRIPT_PANIC;
       break;
+    case SCRIPT_KILLED:
+      title = STR_SCRIPT_KILLED;
+      break;
     default:
       title = STR_SCRIPT_ERROR;
   }
@@ -932,7 +1202,9 @@ static void luaLoadScripts(bool init, const char * filename = nullptr)
     // 1. run chunk() 2. run init(), if available:
     do {
       // Resume running the coroutine
+      luaStatsStart(sid.stats);
       luaStatus = lua_resume(lsScripts, 0, 0);
+      luaStatsPause(sid.stats);
      
       if (luaStatus == LUA_YIELD) {
         // Coroutine yielded - wait for the next cycle
@@ -1018,6 +1290,20 @@ void luaExec(const char * filename)
   luaLoadScripts(true, filename);
 }
 
+// disables a script over its budget
+static void luaKillScript(uint8_t idx)
+{
+  ScriptInternalData & sid = scriptInternalData[idx];
+  snprintf(lua_warning_info, LUA_WARNING_INFO_LEN, "Script %.*s: %s budget exceeded\n",
+           LEN_SCRIPT_FILENAME, getScriptName(idx),
+           sid.stats.state == LUA_BUDGET_MEM_EXCEEDED ? "memory" : "CPU");
+  TRACE_ERROR("%s", lua_warning_info);
+  sid.state = SCRIPT_KILLED;
+  errorState = SCRIPT_KILLED;
+  displayLuaError(true);
+  luaFree(lsScripts, sid);
+}
+
 static bool resumeLua(bool init, bool allowLcdUsage)
 {
   static uint8_t idx;
@@ -1025,7 +1311,6 @@ static bool resumeLua(bool init, bool allowLcdUsage)
   if (init) idx = 0;
 
   bool scriptWasRun = false;
-  bool fullGC = !allowLcdUsage;
   static uint8_t luaDisplayStatistics = false;
  
   // Run in the right interactive mode
@@ -1069,6 +1354,14 @@ static bool resumeLua(bool init, bool allowLcdUsage)
     if (luaStatus == LUA_OK) {
       // Not preempted - setup another function call
       lua_settop(lsScripts, 0);
+
+      if (!luaStatsRun(sid.stats)) {
+        if (sid.stats.state >= LUA_BUDGET_CPU_EXCEEDED) {
+          luaKillScript(idx);
+          scriptWasRun = true;
+        }
+        continue;
+      }
      
       if (allowLcdUsage) {
 #if defined(PCBTARANIS)
@@ -1150,13 +1443,12 @@ static bool resumeLua(bool init, bool allowLcdUsage)
         else continue;
       }
     }
-    
-    // Full garbage collection at the start of every cycle
-    luaDoGc(lsScripts, fullGC);
-    fullGC = false;
 
-    // Resume running the coroutine
+    // Resume running the coroutine, each segment is charged on its own: a
+    // script over its budget when it yields is disabled at its next call
+    luaStatsStart(sid.stats);
     luaStatus = lua_resume(lsScripts, 0, inputsCount);
+    uint8_t budget = luaStatsStop(sid.stats);
 
     if (luaStatus == LUA_YIELD) {
       // Coroutine yielded - wait for the next cycle
@@ -1165,6 +1457,11 @@ static bool resumeLua(bool init, bool allowLcdUsage)
     else if (luaStatus == LUA_OK) {
       // Coroutine returned
       scriptWasRun = true;
+
+      if (budget >= LUA_BUDGET_CPU_EXCEEDED) {
+        luaKillScript(idx);
+        continue;
+      }
       
 #if defined(LUA_MODEL_SCRIPTS)
       if (ref <= SCRIPT_MIX_LAST) {
@@ -1257,8 +1554,47 @@ static bool resumeLua(bool init, bool allowLcdUsage)
 } //resumeLua(...)
 
 
+// GC slice of a state, sized on its heap growth since its last completed
+// cycle ('live', the memory it was using then)
+static void luaGcSlice(lua_State * L, uint32_t & live, uint32_t budget)
+{
+  if (!L) return;
+
+  uint32_t used = luaGetMemUsed(L);
+  if (used < live) live = used;  // collected meanwhile
+  uint32_t growth = used - live;
+  if (growth < live / 4 + LUA_GC_MIN_GROWTH) return;
+
+  if (growth < live)
+    budget = max<uint32_t>(LUA_GC_MIN_SLICE_US, (uint64_t)budget * growth / live);
+
+  uint32_t cycles = luaGcStats.cycles;
+  luaDoGc(L, false, budget);
+  if (luaGcStats.cycles != cycles) live = luaGetMemUsed(L);
+}
+
+// spend what the scripts left of the frame on garbage collection
+static void luaGcFrame(uint32_t start)
+{
+  static uint32_t scriptsLive = 0;
+
+  uint32_t used = timersGetUsTick() - start;
+  uint32_t budget = used < LUA_GC_FRAME_US ? LUA_GC_FRAME_US - used : 0;
+  budget = limit<uint32_t>(LUA_GC_MIN_SLICE_US, budget, LUA_GC_MAX_SLICE_US);
+
+#if defined(COLORLCD)
+  static uint32_t widgetsLive = 0;
+  // widgets garbage is made while drawing, share the slice
+  luaGcSlice(lsScripts, scriptsLive, budget / 2);
+  luaGcSlice(lsWidgets, widgetsLive, budget / 2);
+#else
+  luaGcSlice(lsScripts, scriptsLive, budget);
+#endif
+}
+
 bool luaTask(bool allowLcdUsage)
 {
+  uint32_t start = timersGetUsTick();
   bool init = false;
   bool scriptWasRun = false;
  
@@ -1300,18 +1636,97 @@ bool luaTask(bool allowLcdUsage)
       else luaDisable();
       UNPROTECT_LUA();
   }
+
+  luaGcFrame(start);
   return scriptWasRun;
 }
 
-void checkLuaMemoryUsage()
-{
 #if (LUA_MEM_MAX > 0)
+static uint32_t luaGetTotalMemUsed()
+{
   uint32_t totalMemUsed = luaGetMemUsed(lsScripts);
 #if defined(COLORLCD)
   totalMemUsed += luaGetMemUsed(lsWidgets);
   totalMemUsed += luaExtraMemoryUsage;
 #endif
+  return totalMemUsed;
+}
+#endif
+
+#if defined(LUA_SCRIPT_MEMORY)
+struct LuaMemCheck {
+  LuaScriptStats * offender;  // holding the most
+  uint32_t disabled;          // held by the disabled ones, until collected
+  bool overBudget;
+};
+
+static void luaCheckMemStats(const char * name, LuaScriptStats & stats,
+                             void * ctx)
+{
+  LuaMemCheck * check = (LuaMemCheck *)ctx;
+  if (stats.policy == LUA_POLICY_EXEMPT || stats.memory <= 0) return;
+  if (stats.state >= LUA_BUDGET_CPU_EXCEEDED) {
+    check->disabled += stats.memory;
+    return;
+  }
+  if (stats.memBudget && stats.memory > (int32_t)stats.memBudget)
+    check->overBudget = true;
+  if (!check->offender || stats.memory > check->offender->memory)
+    check->offender = &stats;
+}
+
+static void luaDisableOverMemBudget(const char * name, LuaScriptStats & stats,
+                                    void * ctx)
+{
+  if (stats.policy == LUA_POLICY_EXEMPT ||
+      stats.state >= LUA_BUDGET_CPU_EXCEEDED || !stats.memBudget ||
+      stats.memory <= (int32_t)stats.memBudget)
+    return;
+  TRACE_ERROR("checkLuaMemoryUsage(): %s over its memory budget (%d)\n",
+              name, stats.memory);
+  stats.state = LUA_BUDGET_MEM_EXCEEDED;
+}
+#endif
+
+void checkLuaMemoryUsage()
+{
+#if defined(LUA_SCRIPT_MEMORY)
+  // the scripts are charged with their garbage too, their memory is only
+  // compared with their budget after a full collection
+  LuaMemCheck check = {nullptr, 0, false};
+  luaForEachStats(luaCheckMemStats, &check);
+  if (check.overBudget) {
+    luaDoGc(lsScripts, true);
+#if defined(COLORLCD)
+    luaDoGc(lsWidgets, true);
+#endif
+    luaForEachStats(luaDisableOverMemBudget, nullptr);
+  }
+#endif
+
+#if (LUA_MEM_MAX > 0)
+  uint32_t totalMemUsed = luaGetTotalMemUsed();
+  if (totalMemUsed > LUA_MEM_GC_PRESSURE) {
+    // the slices could not keep up: full cycles before deciding
+    luaDoGc(lsScripts, true);
+#if defined(COLORLCD)
+    luaDoGc(lsWidgets, true);
+#endif
+    totalMemUsed = luaGetTotalMemUsed();
+  }
   if (totalMemUsed > LUA_MEM_MAX) {
+#if defined(LUA_SCRIPT_MEMORY)
+    // only disable the script or widget holding the most memory, unless
+    // the ones already disabled will give back enough once collected
+    check = {nullptr, 0, false};
+    luaForEachStats(luaCheckMemStats, &check);
+    if (totalMemUsed <= LUA_MEM_MAX + check.disabled) return;
+    if (check.offender) {
+      TRACE_ERROR("checkLuaMemoryUsage(): max limit reached (%u), disabling the biggest script\n", totalMemUsed);
+      check.offender->state = LUA_BUDGET_MEM_EXCEEDED;
+      return;
+    }
+#endif
     TRACE_ERROR("checkLuaMemoryUsage(): max limit reached (%u), killing Lua\n", totalMemUsed);
     // disable Lua scripts
     luaClose(&lsScripts);
@@ -1335,16 +1750,19 @@ void luaInit()
 
   luaClose(&lsScripts);
   L = nullptr;
+  // a panic may have left a script running
+  luaRunningStats = nullptr;
+  for (auto & sid : scriptInternalData) {
+    luaStatsRelease(sid.stats);
+  }
 
   if (luaState != INTERPRETER_PANIC) {
-#if defined(USE_BIN_ALLOCATOR)
-    L = lua_newstate(bin_l_alloc, nullptr);   //we use our own allocator!
-#elif defined(LUA_ALLOCATOR_TRACER)
+#if defined(LUA_ALLOCATOR_TRACER)
     memclear(&lsScriptsTrace, sizeof(lsScriptsTrace));
     lsScriptsTrace.script = "lua_newstate(scripts)";
-    L = lua_newstate(tracer_alloc, &lsScriptsTrace);   //we use tracer allocator
+    L = lua_newstate(luaAlloc, &lsScriptsTrace);   //we use tracer allocator
 #else
-    L = lua_newstate(l_alloc, nullptr);   //we use Lua default allocator
+    L = lua_newstate(luaAlloc, nullptr);   //we use our own allocator!
 #endif
     if (L) {
       // install our panic handler
@@ -138,7 +138,8 @@ enum ScriptState {
   SCRIPT_OK,
   SCRIPT_NOFILE,
   SCRIPT_SYNTAX_ERROR,
-  SCRIPT_PANIC
+  SCRIPT_PANIC,
+  SCRIPT_KILLED   // over its CPU or memory budget
 };
 
 enum ScriptReference {
@@ -157,12 +158,116 @@ enum ScriptReference {
   SCRIPT_STANDALONE                                              // Standalone script
 };
 
+// CPU time and memory used by each script and widget instance.
+//
+// The time is measured for each resume segment (a run, or its part up to a
+// yield), less the time the mixer task preempted it. A script over its time
+// budget for 'maxOverruns' segments in a row is throttled (run once every
+// 2, 4, 8 calls) and is run more often again after as many segments within
+// its budget. Over its budget at 'maxThrottle', a script is disabled while
+// a widget stays throttled.
+//
+// With LUA_SCRIPT_MEMORY, each block allocated while a script runs is
+// charged to it until it is freed, whoever frees it. After a full
+// collection this is the live memory the script holds: checkLuaMemoryUsage()
+// then disables the scripts over their memory budget, and the one holding
+// the most when Lua is over LUA_MEM_MAX.
+//
+// Standalone scripts are only accounted.
+#if !defined(USE_BIN_ALLOCATOR)
+// the block header does not fit the bin allocator slots
+#define LUA_SCRIPT_MEMORY
+#endif
+
+// defaults of luaBudgets
+#if !defined(LUA_SCRIPT_TIME_BUDGET_US)
+#define LUA_SCRIPT_TIME_BUDGET_US  25000
+#endif
+#if !defined(LUA_WIDGET_TIME_BUDGET_US)
+#define LUA_WIDGET_TIME_BUDGET_US  10000
+#endif
+#if !defined(LUA_SCRIPT_MEM_BUDGET)
+#define LUA_SCRIPT_MEM_BUDGET      (LUA_MEM_MAX / 4)
+#endif
+#if !defined(LUA_MAX_OVERRUNS)
+#define LUA_MAX_OVERRUNS           3
+#endif
+#if !defined(LUA_MAX_THROTTLE)
+#define LUA_MAX_THROTTLE           3
+#endif
+
+// budgets given to the scripts and widgets when loaded (0: no limit),
+// changed with the "lua limits" CLI command
+struct LuaBudgets {
+  uint32_t scriptTimeUs;
+  uint32_t widgetTimeUs;
+  uint32_t memory;        // bytes, for each script or widget
+  uint8_t maxOverruns;
+  uint8_t maxThrottle;
+};
+
+extern LuaBudgets luaBudgets;
+
+enum LuaBudgetPolicy {
+  LUA_POLICY_SCRIPT,      // disabled when over budget
+  LUA_POLICY_WIDGET,      // kept throttled when over its time budget
+  LUA_POLICY_EXEMPT       // accounted only
+};
+
+enum LuaBudgetState {
+  LUA_BUDGET_OK,
+  LUA_BUDGET_THROTTLED,
+  LUA_BUDGET_CPU_EXCEEDED,
+  LUA_BUDGET_MEM_EXCEEDED
+};
+
+struct LuaScriptStats {
+  uint32_t startUs;
+  uint32_t preemptUs;     // mixer time when started
+  uint32_t runUs;         // current segment, preemptions excluded
+  uint32_t lastUs;        // last segment
+  uint32_t maxUs;         // longest segment
+  uint32_t runs;
+  uint32_t allocated;     // bytes allocated while running
+  int32_t memory;         // bytes allocated and not freed (LUA_SCRIPT_MEMORY)
+  uint32_t timeBudgetUs;  // 0: no limit
+  uint32_t memBudget;     // 0: no limit
+  uint16_t memOwner;      // allocator slot, 0: not charged
+  uint8_t policy;         // LuaBudgetPolicy
+  uint8_t overruns;       // segments in a row over the time budget
+  uint8_t underruns;      // segments in a row within it, while throttled
+  uint8_t throttle;       // runs once every (1 << throttle) calls
+  uint8_t calls;
+  uint8_t state;          // LuaBudgetState
+};
+
+void luaStatsInit(LuaScriptStats & stats, uint8_t policy);
+// stops charging the memory of the blocks allocated with 'stats'
+void luaStatsRelease(LuaScriptStats & stats);
+// false if the script is throttled for this call, or disabled
+bool luaStatsRun(LuaScriptStats & stats);
+// a segment starts: the time and the allocations are charged to 'stats'
+// until luaStatsPause()
+void luaStatsStart(LuaScriptStats & stats);
+void luaStatsPause(LuaScriptStats & stats);
+// end of a segment: checks the time budget, returns the new LuaBudgetState
+uint8_t luaStatsStop(LuaScriptStats & stats);
+
+typedef void (*LuaStatsVisitor)(const char * name, LuaScriptStats & stats, void * ctx);
+void luaForEachStats(LuaStatsVisitor visitor, void * ctx);
+#if defined(COLORLCD)
+void luaForEachWidgetStats(LuaStatsVisitor visitor, void * ctx);
+#endif
+
+// allocator of the Lua states, charges the running script
+void * luaAlloc(void * ud, void * ptr, size_t osize, size_t nsize);
+
 struct ScriptInternalData {
   uint8_t reference;
   uint8_t state;
   int run;
   int background;
-  uint8_t instructions;
+  LuaScriptStats stats;
 };
 
 struct ScriptInputsOutputs {
@@ -192,12 +297,13 @@ void luaClose(lua_State ** L);
 bool luaTask(bool allowLcdUsage);
 void checkLuaMemoryUsage();
 void luaExec(const char * filename);
-void luaDoGc(lua_State * L, bool full);
+void luaDoGc(lua_State * L, bool full, uint32_t budgetUs = 0);
 uint32_t luaGetMemUsed(lua_State * L);
 void luaGetValueAndPush(lua_State * L, int src);
 bool isTelemetryScriptAvailable();
 
-#define luaGetCpuUsed(idx) scriptInternalData[idx].instructions
+// last run, in % of the Lua task period (50ms)
+#define luaGetCpuUsed(idx) (scriptInternalData[idx].stats.lastUs / 500)
 #define LUA_LOAD_MODEL_SCRIPTS()   luaState = INTERPRETER_RELOAD_PERMANENT_SCRIPTS
 #define LUA_LOAD_MODEL_SCRIPT(idx) luaState = INTERPRETER_RELOAD_PERMANENT_SCRIPTS
 
@@ -218,6 +324,23 @@ extern struct our_longjmp * global_lj;
                         if (setjmp(lj.b) == 0)
 #define UNPROTECT_LUA() global_lj = lj.previous; }   /* restore old error handler */
 
+// Garbage collection is done in time slices after the scripts (incremental
+// steps while the budget allows another one) once the heap grew since the
+// last cycle, a full collection is only done at load and under memory
+// pressure
+#define LUA_GC_PAUSES_BUCKETS  5
+
+struct LuaGcStats {
+  uint32_t steps;           // incremental steps
+  uint32_t cycles;          // incremental cycles completed
+  uint16_t fullCollections;
+  uint32_t stepTime;        // average step duration (1/16 us)
+  uint16_t maxPauseUs;      // longest GC pause
+  uint32_t pauses[LUA_GC_PAUSES_BUCKETS];  // < 0.5ms, < 1ms, < 2ms, < 5ms, more
+};
+
+extern LuaGcStats luaGcStats;
+
 extern uint16_t maxLuaInterval;
 extern uint16_t maxLuaDuration;
 extern uint8_t instructionsPercent;
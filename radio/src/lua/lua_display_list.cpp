@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include "lua_display_list.h"
+
+LuaDisplayList* luaDisplayList = nullptr;
+
+// Calls are stored as:
+//   lua_CFunction, uint8_t nargs, then for each argument its
+//   Lua type and value:
+//   - LUA_TNIL: -
+//   - LUA_TBOOLEAN: uint8_t
+//   - LUA_TNUMBER: lua_Number
+//   - LUA_TSTRING: uint16_t length, characters
+//   - LUA_TUSERDATA: int registry reference
+
+template <class T>
+void LuaDisplayList::write(const T& value)
+{
+  write(&value, sizeof(T));
+}
+
+void LuaDisplayList::write(const void* buf, size_t len)
+{
+  if (data.size() + len > LUA_DISPLAY_LIST_MAX_SIZE) {
+    full = true;
+    valid = false;
+    return;
+  }
+  const uint8_t* p = (const uint8_t*)buf;
+  data.insert(data.end(), p, p + len);
+}
+
+// Frees the buffers (clear() keeps them for the next recording)
+void LuaDisplayList::release()
+{
+  std::vector<uint8_t>().swap(data);
+  std::vector<int>().swap(refs);
+  updateCharge();
+}
+
+void LuaDisplayList::updateCharge()
+{
+  uint32_t size = data.capacity() + refs.capacity() * sizeof(int);
+  if (size >= charged) {
+    luaExtraMemoryUsage += size - charged;
+  } else if (luaExtraMemoryUsage >= charged - size) {
+    luaExtraMemoryUsage -= charged - size;
+  } else {
+    luaExtraMemoryUsage = 0;
+  }
+  charged = size;
+}
+
+template <class T>
+static const uint8_t* read(const uint8_t* p, T& value)
+{
+  memcpy(&value, p, sizeof(T));
+  return p + sizeof(T);
+}
+
+void LuaDisplayList::startRecording(lua_State* L)
+{
+  // too much to record: stay in immediate mode until cleared
+  if (full) return;
+  clear();
+  this->L = L;
+  valid = true;
+  luaDisplayList = this;
+}
+
+void LuaDisplayList::stopRecording()
+{
+  if (luaDisplayList == this) luaDisplayList = nullptr;
+  if (count == 0) valid = false;
+}
+
+void LuaDisplayList::clear()
+{
+  if (L) {
+    for (int ref : refs) luaL_unref(L, LUA_REGISTRYINDEX, ref);
+  }
+  refs.clear();
+  data.clear();
+  count = 0;
+  valid = false;
+  full = false;
+}
+
+void LuaDisplayList::record(lua_State* L, lua_CFunction f)
+{
+  if (!valid || L != this->L) return;
+
+  int nargs = lua_gettop(L);
+  if (nargs > UINT8_MAX) {
+    valid = false;
+    return;
+  }
+
+  write(f);
+  write((uint8_t)nargs);
+
+  for (int i = 1; valid && i <= nargs; i++) {
+    int type = lua_type(L, i);
+    write((uint8_t)type);
+    switch (type) {
+      case LUA_TNIL:
+        break;
+      case LUA_TBOOLEAN:
+        write((uint8_t)lua_toboolean(L, i));
+        break;
+      case LUA_TNUMBER:
+        write(lua_tonumber(L, i));
+        break;
+      case LUA_TSTRING: {
+        size_t len;
+        const char* s = lua_tolstring(L, i, &len);
+        if (len > UINT16_MAX) {
+          valid = false;
+          break;
+        }
+        write((uint16_t)len);
+        write(s, len);
+        break;
+      }
+      case LUA_TUSERDATA:
+        // keep the bitmap alive as long as it may be drawn
+        lua_pushvalue(L, i);
+        refs.push_back(luaL_ref(L, LUA_REGISTRYINDEX));
+        write(refs.back());
+        break;
+      default:
+        // tables, functions, ...: the script has to be run each time
+        valid = false;
+        break;
+    }
+  }
+
+  if (full) {
+    for (int ref : refs) luaL_unref(L, LUA_REGISTRYINDEX, ref);
+    refs.clear();
+    release();
+    return;
+  }
+
+  if (valid) count += 1;
+  updateCharge();
+}
+
+int LuaDisplayList::replayCalls(lua_State* L)
+{
+  auto list = (const LuaDisplayList*)lua_touserdata(L, 1);
+  const uint8_t* p = list->data.data();
+  const uint8_t* end = p + list->data.size();
+
+  while (p < end) {
+    lua_CFunction f;
+    uint8_t nargs;
+    p = read(p, f);
+    p = read(p, nargs);
+
+    lua_pushcfunction(L, f);
+    for (int i = 0; i < nargs; i++) {
+      uint8_t type = *p++;
+      switch (type) {
+        case LUA_TBOOLEAN:
+          lua_pushboolean(L, *p++);
+          break;
+        case LUA_TNUMBER: {
+          lua_Number n;
+          p = read(p, n);
+          lua_pushnumber(L, n);
+          break;
+        }
+        case LUA_TSTRING: {
+          uint16_t len;
+          p = read(p, len);
+          lua_pushlstring(L, (const char*)p, len);
+          p += len;
+          break;
+        }
+        case LUA_TUSERDATA: {
+          int ref;
+          p = read(p, ref);
+          lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+          break;
+        }
+        default:
+          lua_pushnil(L);
+          break;
+      }
+    }
+    lua_call(L, nargs, 0);
+  }
+
+  return 0;
+}
+
+bool LuaDisplayList::replay()
+{
+  if (!valid) return false;
+  lua_pushcfunction(L, replayCalls);
+  lua_pushlightuserdata(L, this);
+  return lua_pcall(L, 1, 0, 0) == 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "lua_api.h"
+
+//
+// Retained drawing of Lua widgets
+//
+// While recording, each lcd.* drawing call is stored along with its
+// arguments (numbers, booleans, strings and bitmaps). replay() calls
+// the same C functions again with the same arguments, without running
+// the script: the drawing is the same as long as the script would not
+// draw anything else.
+//
+// A list is limited to LUA_DISPLAY_LIST_MAX_SIZE bytes: a widget drawing
+// more is run each time (immediate mode) until the list is cleared. The
+// memory used is charged to luaExtraMemoryUsage.
+//
+
+#define LUA_DISPLAY_LIST_MAX_SIZE  (16 * 1024)
+
+class LuaDisplayList
+{
+ public:
+  ~LuaDisplayList()
+  {
+    stopRecording();
+    clear();
+    release();
+  }
+
+  // Records the lcd.* calls made until stopRecording()
+  void startRecording(lua_State* L);
+  void stopRecording();
+
+  // false if nothing was recorded or if a call could not be recorded
+  bool isValid() const { return valid; }
+  // true if the last recording exceeded LUA_DISPLAY_LIST_MAX_SIZE
+  bool isFull() const { return full; }
+  void clear();
+
+  // Draws the recorded calls into luaLcdBuffer, returns false on
+  // error (the error message is on top of the Lua stack)
+  bool replay();
+
+  uint16_t getCount() const { return count; }
+  uint32_t getSize() const { return data.size(); }
+
+  // Called by the lcd.* drawing functions with their arguments
+  void record(lua_State* L, lua_CFunction f);
+
+ protected:
+  lua_State* L = nullptr;
+  std::vector<uint8_t> data;
+  std::vector<int> refs;  // recorded userdata (bitmaps)
+  uint32_t charged = 0;  // bytes added to luaExtraMemoryUsage
+  uint16_t count = 0;
+  bool valid = false;
+  bool full = false;
+
+  template <class T>
+  void write(const T& value);
+  void write(const void* buf, size_t len);
+  void release();
+  void updateCharge();
+  static int replayCalls(lua_State* L);
+};
+
+// Display list being recorded, or nullptr
+extern LuaDisplayList* luaDisplayList;
+
+#define LUA_LCD_RECORD(L, f) \
+  if (luaDisplayList) luaDisplayList->record(L, f)
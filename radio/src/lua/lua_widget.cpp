@@ -23,12 +23,25 @@
 #include "lua_widget_factory.h"
 
 #include "lua_api.h"
+#include "lua_display_list.h"
 #include "lua_event.h"
 #include "draw_functions.h"
 #include "touch.h"
 
+#include <list>
+
 #define MAX_INSTRUCTIONS       (20000/100)
 
+// all the instances, for the statistics
+static std::list<LuaWidget*> luaWidgets;
+
+void luaForEachWidgetStats(LuaStatsVisitor visitor, void* ctx)
+{
+  for (auto widget : luaWidgets) {
+    visitor(widget->getFactory()->getName(), widget->stats, ctx);
+  }
+}
+
 #if defined(HARDWARE_TOUCH)
 uint32_t LuaEventHandler::downTime = 0;
 uint32_t LuaEventHandler::tapTime = 0;
@@ -203,15 +216,163 @@ LuaWidget::LuaWidget(const WidgetFactory* factory, Window* parent,
     zoneRectDataRef(zoneRectDataRef),
     errorMessage(nullptr)
 {
+  luaStatsInit(stats, LUA_POLICY_WIDGET);
+  luaWidgets.push_back(this);
+
+  // widget.watch{} (unless the script uses this name)
+  if (lsWidgets == 0) return;
+  lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, luaWidgetDataRef);
+  if (lua_istable(lsWidgets, -1)) {
+    lua_getfield(lsWidgets, -1, "watch");
+    bool used = !lua_isnil(lsWidgets, -1);
+    lua_pop(lsWidgets, 1);
+    if (!used) {
+      lua_pushlightuserdata(lsWidgets, this);
+      lua_pushcclosure(lsWidgets, luaWatch, 1);
+      lua_setfield(lsWidgets, -2, "watch");
+    }
+  }
+  lua_pop(lsWidgets, 1);
 }
 
 LuaWidget::~LuaWidget()
 {
+  luaWidgets.remove(this);
+  luaStatsRelease(stats);
+
+  if (lsWidgets) {
+    // the script may still hold its widget table
+    lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, luaWidgetDataRef);
+    if (lua_istable(lsWidgets, -1)) {
+      lua_getfield(lsWidgets, -1, "watch");
+      bool own = lua_tocfunction(lsWidgets, -1) == luaWatch;
+      lua_pop(lsWidgets, 1);
+      if (own) {
+        lua_pushnil(lsWidgets);
+        lua_setfield(lsWidgets, -2, "watch");
+      }
+    }
+    lua_pop(lsWidgets, 1);
+  }
+
+  delete displayList;
   luaL_unref(lsWidgets, LUA_REGISTRYINDEX, luaWidgetDataRef);
   luaL_unref(lsWidgets, LUA_REGISTRYINDEX, zoneRectDataRef);
   free(errorMessage);
 }
 
+/*luadoc
+@function widget.watch(sources)
+
+Switches a widget to retained mode: its refresh() function is then only
+called when one of the given sources changes value, when `period`
+expires, or when the widget options or size change. In between, the
+drawing made by the last refresh() call is repeated without running
+the script.
+
+Only the drawing made with lcd.* functions is repeated, using the same
+arguments: refresh() should not depend on anything else than the watched
+sources. Fullscreen widgets are always refreshed.
+
+@param sources (table) up to 8 sources, as names or indexes (see getValue()),
+and optionally `period` (number) in ms. Passing nil disables retained mode.
+
+@notice `widget` is the table returned by the create() function. Only
+available on radios with color display
+
+@status current Introduced in 2.10.0
+
+Example:
+
+```lua
+local function update(widget, options)
+  widget.watch{ "RSSI", "RxBt", period = 1000 }
+end
+```
+*/
+int LuaWidget::luaWatch(lua_State* L)
+{
+  auto widget = (LuaWidget*)lua_touserdata(L, lua_upvalueindex(1));
+  widget->setWatch(L);
+  return 0;
+}
+
+void LuaWidget::setWatch(lua_State* L)
+{
+  if (lua_isnoneornil(L, 1)) {
+    delete displayList;
+    displayList = nullptr;
+    budgetList = false;
+    watchCount = 0;
+    watchPeriod = 0;
+    return;
+  }
+
+  luaL_checktype(L, 1, LUA_TTABLE);
+
+  int16_t sources[LUA_WIDGET_MAX_WATCH];
+  uint8_t count = 0;
+
+  for (int i = 1;; i++) {
+    lua_rawgeti(L, 1, i);
+    if (lua_isnil(L, -1)) {
+      lua_pop(L, 1);
+      break;
+    }
+    if (count >= LUA_WIDGET_MAX_WATCH)
+      luaL_error(L, "too many sources (max %d)", LUA_WIDGET_MAX_WATCH);
+
+    int src = MIXSRC_NONE;
+    if (lua_type(L, -1) == LUA_TNUMBER) {
+      src = lua_tointeger(L, -1);
+    } else {
+      LuaField field;
+      if (luaFindFieldByName(luaL_checkstring(L, -1), field)) src = field.id;
+    }
+    if (src <= MIXSRC_NONE || src > MIXSRC_LAST_TELEM)
+      luaL_error(L, "invalid source '%s'", luaL_tolstring(L, -1, nullptr));
+    sources[count++] = src;
+    lua_pop(L, 1);
+  }
+
+  lua_getfield(L, 1, "period");
+  uint16_t period = luaL_optunsigned(L, -1, 0) / 10;
+  lua_pop(L, 1);
+
+  // scripts may call it on each refresh()
+  if (displayList && !budgetList && period == watchPeriod && count == watchCount &&
+      !memcmp(sources, watchSources, count * sizeof(int16_t)))
+    return;
+
+  memcpy(watchSources, sources, count * sizeof(int16_t));
+  watchCount = count;
+  watchPeriod = period;
+
+  if (!displayList) displayList = new LuaDisplayList();
+  displayList->clear();
+  budgetList = false;
+}
+
+bool LuaWidget::isWatchTriggered() const
+{
+  if (watchPeriod && (tmr10ms_t)(get_tmr10ms() - watchTime) >= watchPeriod)
+    return true;
+
+  for (uint8_t i = 0; i < watchCount; i++) {
+    if (getValue(watchSources[i]) != watchValues[i]) return true;
+  }
+
+  return false;
+}
+
+void LuaWidget::saveWatchedValues()
+{
+  watchTime = get_tmr10ms();
+  for (uint8_t i = 0; i < watchCount; i++) {
+    watchValues[i] = getValue(watchSources[i]);
+  }
+}
+
 void LuaWidget::onClicked()
 {
   if (!fullscreen) {
@@ -264,6 +425,9 @@ void LuaWidget::update()
   if (lsWidgets == 0 || errorMessage) return;
   LuaWidgetFactory * lua_factory = (LuaWidgetFactory *)factory;
 
+  // options or zone changed: refresh() has to be run again
+  if (displayList) displayList->clear();
+
   luaSetInstructionsLimit(lsWidgets, MAX_INSTRUCTIONS);
   lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, lua_factory->updateFunction);
   lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, luaWidgetDataRef);
@@ -286,9 +450,7 @@ void LuaWidget::update()
     }
   }
 
-  if (lua_pcall(lsWidgets, 2, 0, 0) != 0) {
-    setErrorMessage("update()");
-  }
+  callScript(2, "update()");
 }
 
 // Update table on top of Lua stack - set entry with name 'idx' to value 'val'
@@ -363,6 +525,35 @@ void LuaWidget::setErrorMessage(const char * funcName)
   }
 }
 
+void LuaWidget::setBudgetError(const char* funcName)
+{
+  lua_pushstring(lsWidgets, stats.state == LUA_BUDGET_MEM_EXCEEDED
+                                ? "memory budget exceeded"
+                                : "CPU budget exceeded");
+  setErrorMessage(funcName);
+  lua_pop(lsWidgets, 1);
+
+  // release the widget data
+  luaL_unref(lsWidgets, LUA_REGISTRYINDEX, luaWidgetDataRef);
+  luaWidgetDataRef = LUA_NOREF;
+}
+
+// Calls the function pushed with its 'nargs' arguments, accounted in 'stats'
+bool LuaWidget::callScript(int nargs, const char* funcName)
+{
+  luaStatsStart(stats);
+  bool ok = lua_pcall(lsWidgets, nargs, 0, 0) == 0;
+  uint8_t state = luaStatsStop(stats);
+
+  if (!ok) {
+    setErrorMessage(funcName);
+  } else if (state >= LUA_BUDGET_CPU_EXCEEDED) {
+    setBudgetError(funcName);
+    ok = false;
+  }
+  return ok;
+}
+
 const char * LuaWidget::getErrorMessage() const
 {
   return errorMessage;
@@ -379,6 +570,30 @@ void LuaWidget::refresh(BitmapBuffer* dc)
     return;
   }
 
+  bool run = luaStatsRun(stats);
+  if (stats.state >= LUA_BUDGET_CPU_EXCEEDED) {
+    // disabled by checkLuaMemoryUsage()
+    setBudgetError("refresh()");
+    return;
+  }
+
+  // Retained mode: replay the last drawing if nothing watched changed,
+  // or if throttled
+  bool retained = displayList && !fullscreen;
+  if (retained && displayList->isValid() &&
+      (!run || (!budgetList && !isWatchTriggered()))) {
+    luaLcdBuffer = dc;
+    bool lla = luaLcdAllowed;
+    luaLcdAllowed = true;
+    if (!displayList->replay()) {
+      setErrorMessage("refresh()");
+    }
+    luaLcdAllowed = lla;
+    luaLcdBuffer = nullptr;
+    refreshed = true;
+    return;
+  }
+
   luaSetInstructionsLimit(lsWidgets, MAX_INSTRUCTIONS);
   LuaWidgetFactory * factory = (LuaWidgetFactory *)this->factory;
   lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, factory->refreshFunction);
@@ -409,14 +624,33 @@ void LuaWidget::refresh(BitmapBuffer* dc)
   luaLcdAllowed = true;
   runningFS = this;
 
-  if (lua_pcall(lsWidgets, 3, 0, 0) != 0) {
-    setErrorMessage("refresh()");
+  if (retained) {
+    saveWatchedValues();
+    displayList->startRecording(lsWidgets);
   }
+
+  callScript(3, "refresh()");
   runningFS = nullptr;
+
+  // displayList is deleted if refresh() called widget.watch(nil)
+  if (luaDisplayList) {
+    luaDisplayList->stopRecording();
+  }
   // Remove LCD
   luaLcdAllowed = lla;
   luaLcdBuffer = nullptr;
 
+  // throttled: the next calls replay this drawing, until back within budget
+  if (stats.state == LUA_BUDGET_THROTTLED && !displayList && !fullscreen) {
+    displayList = new LuaDisplayList();
+    budgetList = true;
+  }
+  else if (stats.state == LUA_BUDGET_OK && budgetList) {
+    delete displayList;
+    displayList = nullptr;
+    budgetList = false;
+  }
+
   // mark as refreshed
   refreshed = true;
 }
@@ -426,15 +660,18 @@ void LuaWidget::background()
   if (lsWidgets == 0 || errorMessage) return;
 
   // TRACE("LuaWidget::background()");
+  if (!luaStatsRun(stats)) {
+    if (stats.state >= LUA_BUDGET_CPU_EXCEEDED) setBudgetError("background()");
+    return;
+  }
+
   luaSetInstructionsLimit(lsWidgets, MAX_INSTRUCTIONS);
   LuaWidgetFactory * factory = (LuaWidgetFactory *)this->factory;
   if (factory->backgroundFunction) {
     lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, factory->backgroundFunction);
     lua_rawgeti(lsWidgets, LUA_REGISTRYINDEX, luaWidgetDataRef);
     runningFS = this;
-    if (lua_pcall(lsWidgets, 1, 0, 0) != 0) {
-      setErrorMessage("background()");
-    }
+    callScript(1, "background()");
     runningFS = nullptr;
   }
 }
@@ -29,6 +29,11 @@
 
 #define LUA_TAP_TIME 250 // 250 ms
 
+// Max number of sources given to widget.watch{}
+#define LUA_WIDGET_MAX_WATCH 8
+
+class LuaDisplayList;
+
 class LuaEventHandler
 {
 #if defined(HARDWARE_TOUCH)
@@ -58,12 +63,33 @@ public:
 class LuaWidget : public Widget, public LuaEventHandler
 {
   friend class LuaWidgetFactory;
+  friend void luaForEachWidgetStats(LuaStatsVisitor visitor, void* ctx);
 
   int luaWidgetDataRef;
   int zoneRectDataRef;
   char* errorMessage;
   bool refreshed = false;
 
+  // Retained mode (widget.watch{}): refresh() is only run when a
+  // watched source changes or when the period expires, the recorded
+  // drawing is replayed otherwise
+  LuaDisplayList* displayList = nullptr;
+  uint8_t watchCount = 0;
+  uint16_t watchPeriod = 0; // 10ms
+  tmr10ms_t watchTime = 0;
+  int16_t watchSources[LUA_WIDGET_MAX_WATCH];
+  getvalue_t watchValues[LUA_WIDGET_MAX_WATCH];
+
+  // CPU time and memory of this instance; a throttled widget replays
+  // its last drawing, from 'displayList' created for that if needed
+  LuaScriptStats stats;
+  bool budgetList = false;
+
+  static int luaWatch(lua_State* L);
+  void setWatch(lua_State* L);
+  bool isWatchTriggered() const;
+  void saveWatchedValues();
+
   // Window interface
   void onClicked() override;
   void onCancel() override;
@@ -73,6 +99,8 @@ class LuaWidget : public Widget, public LuaEventHandler
   void onFullscreen(bool enable) override;
     
   void setErrorMessage(const char* funcName);
+  void setBudgetError(const char* funcName);
+  bool callScript(int nargs, const char* funcName);
 
   // Update 'zone' data
   void updateZoneRect(rect_t rect) override;
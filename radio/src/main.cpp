@@ -568,6 +568,7 @@ void perMain()
 
   checkTrainerSettings();
   periodicTick();
+  postModelLoadDeferred();
   DEBUG_TIMER_STOP(debugTimerPerMain1);
 
   if (mainRequestFlags & (1u << REQUEST_FLIGHT_RESET)) {
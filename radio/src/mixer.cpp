@@ -311,173 +311,301 @@ static const getvalue_t _switch_3pos_lookup[] = {
   +1024, // SWITCH_HW_DOWN 
 };
 
-// TODO same naming convention than the drawSource
-// *valid added to return status to Lua for invalid sources
-getvalue_t getValue(mixsrc_t i, bool* valid)
+//
+// Sources values
+//
+// getValue() finds the sources range in sourceAccessors[] (ordered as the
+// MixSources enum) with a lookup in a constant table and calls its
+// accessor with the index of the source in the range. *valid is set to
+// false for invalid sources (used by Lua). Inputs and channels, the usual
+// mixes sources, are read directly.
+//
+
+typedef getvalue_t (*SourceAccessor)(mixsrc_t idx, bool* valid);
+
+static inline getvalue_t invalidSource(bool* valid)
 {
-  if (i == MIXSRC_NONE) {
-    if (valid != nullptr) *valid = false;
-    return 0;
-  }
-  else if (i <= MIXSRC_LAST_INPUT) {
-    return anas[i - MIXSRC_FIRST_INPUT];
-  }
+  if (valid != nullptr) *valid = false;
+  return 0;
+}
+
+static getvalue_t getInvalidSource(mixsrc_t, bool* valid)
+{
+  return invalidSource(valid);
+}
+
+static getvalue_t getInputSource(mixsrc_t idx, bool*)
+{
+  return anas[idx];
+}
+
 #if defined(LUA_INPUTS)
-  else if (i <= MIXSRC_LAST_LUA) {
+static getvalue_t getLuaSource(mixsrc_t idx, bool* valid)
+{
 #if defined(LUA_MODEL_SCRIPTS)
-    div_t qr = div(i-MIXSRC_FIRST_LUA, MAX_SCRIPT_OUTPUTS);
-    return scriptInputsOutputs[qr.quot].outputs[qr.rem].value;
+  div_t qr = div(idx, MAX_SCRIPT_OUTPUTS);
+  return scriptInputsOutputs[qr.quot].outputs[qr.rem].value;
 #else
-    if (valid != nullptr) *valid = false;
-    return 0;
+  return invalidSource(valid);
 #endif
-  }
+}
 #endif
 
-  else if (i <= MIXSRC_LAST_STICK) {
-    i -= MIXSRC_FIRST_STICK;
-    if (i >= adcGetMaxInputs(ADC_INPUT_MAIN)) {
-      if (valid != nullptr) *valid = false;
-      return 0;
-    }
-    return calibratedAnalogs[inputMappingConvertMode(i)];
-  }
-  else if (i <= MIXSRC_LAST_POT) {
-    i -= MIXSRC_FIRST_POT;
-    if (i >= adcGetMaxInputs(ADC_INPUT_FLEX)) {
-      if (valid != nullptr) *valid = false;
-      return 0;
-    }
-    return calibratedAnalogs[i + adcGetInputOffset(ADC_INPUT_FLEX)];
-  }
+static getvalue_t getStickSource(mixsrc_t idx, bool* valid)
+{
+  if (idx >= adcGetMaxInputs(ADC_INPUT_MAIN)) return invalidSource(valid);
+  return calibratedAnalogs[inputMappingConvertMode(idx)];
+}
+
+static getvalue_t getPotSource(mixsrc_t idx, bool* valid)
+{
+  if (idx >= adcGetMaxInputs(ADC_INPUT_FLEX)) return invalidSource(valid);
+  return calibratedAnalogs[idx + adcGetInputOffset(ADC_INPUT_FLEX)];
+}
 
 #if defined(IMU)
-  else if (i == MIXSRC_TILT_X) {
-    return gyro.scaledX();
-  }
-  else if (i == MIXSRC_TILT_Y) {
-    return gyro.scaledY();
-  }
+static getvalue_t getTiltSource(mixsrc_t idx, bool*)
+{
+  return idx == 0 ? gyro.scaledX() : gyro.scaledY();
+}
 #endif
 
 #if defined(PCBHORUS)
-  else if (i >= MIXSRC_FIRST_SPACEMOUSE && i <= MIXSRC_LAST_SPACEMOUSE) {
+static getvalue_t getSpacemouseSource(mixsrc_t idx, bool*)
+{
 #if defined(SPACEMOUSE)
-    return get_spacemouse_value(i - MIXSRC_FIRST_SPACEMOUSE);
+  return get_spacemouse_value(idx);
 #else
-    return 0;
+  return 0;
 #endif
-  }
+}
 #endif
 
-  else if (i == MIXSRC_MIN) {
-    return -RESX;
-  }
-  else if (i == MIXSRC_MAX) {
-    return RESX;
-  }
+static getvalue_t getMinSource(mixsrc_t, bool*)
+{
+  return -RESX;
+}
+
+static getvalue_t getMaxSource(mixsrc_t, bool*)
+{
+  return RESX;
+}
 
-  else if (i <= MIXSRC_LAST_HELI) {
+static getvalue_t getHeliSource(mixsrc_t idx, bool* valid)
+{
 #if defined(HELI)
-    return cyc_anas[i - MIXSRC_FIRST_HELI];
+  return cyc_anas[idx];
 #else
-    if (valid != nullptr) *valid = false;
-    return 0;
+  return invalidSource(valid);
 #endif
-  }
+}
 
-  else if (i <= MIXSRC_LAST_TRIM) {
-    i -= MIXSRC_FIRST_TRIM;
-    if (getRawTrimValue(mixerCurrentFlightMode, i).mode == TRIM_MODE_3POS) {
-      // Trim set as 3POS toggle switch in FM
-      uint8_t tidx = inputMappingConvertMode(i) * 2;
-      if (trimDown(tidx)) return -RESX;
-      else if (trimDown(tidx + 1)) return RESX;
-      return 0;
-    }
-    auto trim_value = getTrimValue(mixerCurrentFlightMode, i);
-    return calc1000toRESX((int16_t)8 * trim_value);
+static getvalue_t getTrimSource(mixsrc_t idx, bool*)
+{
+  if (getRawTrimValue(mixerCurrentFlightMode, idx).mode == TRIM_MODE_3POS) {
+    // Trim set as 3POS toggle switch in FM
+    uint8_t tidx = inputMappingConvertMode(idx) * 2;
+    if (trimDown(tidx)) return -RESX;
+    else if (trimDown(tidx + 1)) return RESX;
+    return 0;
   }
-  else if (i >= MIXSRC_FIRST_SWITCH && i <= MIXSRC_LAST_SWITCH) {
-    auto sw_idx = (uint8_t)(i - MIXSRC_FIRST_SWITCH);
+  auto trim_value = getTrimValue(mixerCurrentFlightMode, idx);
+  return calc1000toRESX((int16_t)8 * trim_value);
+}
+
+static getvalue_t getSwitchSource(mixsrc_t idx, bool* valid)
+{
+  auto sw_idx = (uint8_t)idx;
 #if defined(FUNCTION_SWITCHES)
-    auto max_reg_switches = switchGetMaxSwitches();
-    if (sw_idx >= max_reg_switches) {
-      auto fct_idx = sw_idx - max_reg_switches;
-      auto max_fct_switches = switchGetMaxFctSwitches();
-      if (fct_idx < max_fct_switches) {
-	return _switch_2pos_lookup[getFSLogicalState(fct_idx)];
-      }
+  auto max_reg_switches = switchGetMaxSwitches();
+  if (sw_idx >= max_reg_switches) {
+    auto fct_idx = sw_idx - max_reg_switches;
+    auto max_fct_switches = switchGetMaxFctSwitches();
+    if (fct_idx < max_fct_switches) {
+      return _switch_2pos_lookup[getFSLogicalState(fct_idx)];
     }
+  }
 #endif
-    auto sw_cfg = (SwitchConfig)SWITCH_CONFIG(sw_idx);
-    switch(sw_cfg) {
-    case SWITCH_NONE:
-      if (valid != nullptr) *valid = false;
-      return 0;
-    case SWITCH_TOGGLE:
-    case SWITCH_2POS:
-      return _switch_2pos_lookup[switchGetPosition(sw_idx)];
-    case SWITCH_3POS:
-      return _switch_3pos_lookup[switchGetPosition(sw_idx)];
-    }
+  auto sw_cfg = (SwitchConfig)SWITCH_CONFIG(sw_idx);
+  switch(sw_cfg) {
+  case SWITCH_TOGGLE:
+  case SWITCH_2POS:
+    return _switch_2pos_lookup[switchGetPosition(sw_idx)];
+  case SWITCH_3POS:
+    return _switch_3pos_lookup[switchGetPosition(sw_idx)];
+  default:
+    return invalidSource(valid);
   }
+}
 
-  else if (i <= MIXSRC_LAST_LOGICAL_SWITCH) {
-    return getSwitch(SWSRC_FIRST_LOGICAL_SWITCH + i - MIXSRC_FIRST_LOGICAL_SWITCH) ? 1024 : -1024;
-  } else if (i <= MIXSRC_LAST_TRAINER) {
-    int16_t x = trainerInput[i - MIXSRC_FIRST_TRAINER];
-    if (i < MIXSRC_FIRST_TRAINER + NUM_CAL_PPM) {
-      x -= g_eeGeneral.trainer.calib[i - MIXSRC_FIRST_TRAINER];
-    }
-    return x * 2;
-  } else if (i <= MIXSRC_LAST_CH) {
-    return ex_chans[i - MIXSRC_FIRST_CH];
+static getvalue_t getLogicalSwitchSource(mixsrc_t idx, bool*)
+{
+  return getSwitch(SWSRC_FIRST_LOGICAL_SWITCH + idx) ? 1024 : -1024;
+}
+
+static getvalue_t getTrainerSource(mixsrc_t idx, bool*)
+{
+  int16_t x = trainerInput[idx];
+  if (idx < NUM_CAL_PPM) {
+    x -= g_eeGeneral.trainer.calib[idx];
   }
+  return x * 2;
+}
+
+static getvalue_t getChannelSource(mixsrc_t idx, bool*)
+{
+  return ex_chans[idx];
+}
 
-  else if (i <= MIXSRC_LAST_GVAR) {
+static getvalue_t getGVarSource(mixsrc_t idx, bool* valid)
+{
 #if defined(GVARS)
-    return GVAR_VALUE(i - MIXSRC_FIRST_GVAR, getGVarFlightMode(mixerCurrentFlightMode, i - MIXSRC_FIRST_GVAR));
+  return GVAR_VALUE(idx, getGVarFlightMode(mixerCurrentFlightMode, idx));
 #else
-    if (valid != nullptr) *valid = false;
-    return 0;
+  return invalidSource(valid);
 #endif
-  }
+}
 
-  else if (i == MIXSRC_TX_VOLTAGE) {
-    return g_vbat100mV;
-  } else if (i < MIXSRC_FIRST_TIMER) {
-    // TX_TIME + SPARES
+static getvalue_t getTxVoltageSource(mixsrc_t, bool*)
+{
+  return g_vbat100mV;
+}
+
+// TX_TIME + SPARES
+static getvalue_t getTxTimeSource(mixsrc_t, bool* valid)
+{
 #if defined(RTCLOCK)
-    return (g_rtcTime % SECS_PER_DAY) / 60; // number of minutes from midnight
+  return (g_rtcTime % SECS_PER_DAY) / 60; // number of minutes from midnight
 #else
-    if (valid != nullptr) *valid = false;
-    return 0;
+  return invalidSource(valid);
 #endif
-  } else if (i <= MIXSRC_LAST_TIMER) {
-    return timersStates[i - MIXSRC_FIRST_TIMER].val;
+}
+
+static getvalue_t getTimerSource(mixsrc_t idx, bool*)
+{
+  return timersStates[idx].val;
+}
+
+static getvalue_t getTelemetrySource(mixsrc_t idx, bool* valid)
+{
+  if (IS_FAI_FORBIDDEN(MIXSRC_FIRST_TELEM + idx)) return invalidSource(valid);
+  div_t qr = div(idx, 3);
+  TelemetryItem & telemetryItem = telemetryItems[qr.quot];
+  switch (qr.rem) {
+    case 1:
+      return telemetryItem.valueMin;
+    case 2:
+      return telemetryItem.valueMax;
+    default:
+      return telemetryItem.value;
   }
+}
 
-  else if (i <= MIXSRC_LAST_TELEM) {
-    if (IS_FAI_FORBIDDEN(i)) {
-      if (valid != nullptr) *valid = false;
-      return 0;
-    }
-    i -= MIXSRC_FIRST_TELEM;
-    div_t qr = div(i, 3);
-    TelemetryItem & telemetryItem = telemetryItems[qr.quot];
-    switch (qr.rem) {
-      case 1:
-        return telemetryItem.valueMin;
-      case 2:
-        return telemetryItem.valueMax;
-      default:
-        return telemetryItem.value;
+struct SourceRange {
+  mixsrc_t first;
+  SourceAccessor get;
+};
+
+static constexpr SourceRange sourceAccessors[] = {
+  {MIXSRC_NONE, getInvalidSource},
+  {MIXSRC_FIRST_INPUT, getInputSource},
+#if defined(LUA_INPUTS)
+  {MIXSRC_FIRST_LUA, getLuaSource},
+#endif
+  {MIXSRC_FIRST_STICK, getStickSource},
+  {MIXSRC_FIRST_POT, getPotSource},
+#if defined(IMU)
+  {MIXSRC_TILT_X, getTiltSource},
+#endif
+#if defined(PCBHORUS)
+  {MIXSRC_FIRST_SPACEMOUSE, getSpacemouseSource},
+#endif
+  {MIXSRC_MIN, getMinSource},
+  {MIXSRC_MAX, getMaxSource},
+  {MIXSRC_FIRST_HELI, getHeliSource},
+  {MIXSRC_FIRST_TRIM, getTrimSource},
+  {MIXSRC_FIRST_SWITCH, getSwitchSource},
+  {MIXSRC_FIRST_LOGICAL_SWITCH, getLogicalSwitchSource},
+  {MIXSRC_FIRST_TRAINER, getTrainerSource},
+  {MIXSRC_FIRST_CH, getChannelSource},
+  {MIXSRC_FIRST_GVAR, getGVarSource},
+  {MIXSRC_TX_VOLTAGE, getTxVoltageSource},
+  {MIXSRC_TX_TIME, getTxTimeSource},
+  {MIXSRC_FIRST_TIMER, getTimerSource},
+  {MIXSRC_FIRST_TELEM, getTelemetrySource},
+  {MIXSRC_LAST_TELEM + 1, getInvalidSource},
+};
+
+#define SOURCE_RANGES_COUNT  DIM(sourceAccessors)
+#define TELEM_SOURCE_RANGE   (SOURCE_RANGES_COUNT - 2)
+
+// Range of the source (before the telemetry ones), computed by the compiler
+static constexpr uint8_t sourceRangeOf(mixsrc_t src, uint8_t r = 0)
+{
+  return src >= sourceAccessors[r + 1].first ? sourceRangeOf(src, r + 1) : r;
+}
+
+// Compile time list of the sources 0..N-1 (split in halves to keep the
+// templates recursion shallow)
+template <mixsrc_t... I> struct SourceList {};
+
+template <class L, class H> struct SourceListJoin;
+template <mixsrc_t... L, mixsrc_t... H>
+struct SourceListJoin<SourceList<L...>, SourceList<H...>> {
+  typedef SourceList<L..., (sizeof...(L) + H)...> type;
+};
+
+template <mixsrc_t N> struct SourceListOf {
+  typedef typename SourceListJoin<typename SourceListOf<N / 2>::type,
+                                  typename SourceListOf<N - N / 2>::type>::type type;
+};
+template <> struct SourceListOf<0> { typedef SourceList<> type; };
+template <> struct SourceListOf<1> { typedef SourceList<0> type; };
+
+template <class L> struct SourceRangeTable;
+template <mixsrc_t... I> struct SourceRangeTable<SourceList<I...>> {
+  static constexpr uint8_t index[sizeof...(I)] = {sourceRangeOf(I)...};
+};
+template <mixsrc_t... I>
+constexpr uint8_t SourceRangeTable<SourceList<I...>>::index[sizeof...(I)];
+
+// Range of each source before the telemetry ones (in flash)
+typedef SourceRangeTable<SourceListOf<MIXSRC_FIRST_TELEM>::type> SourceRangeIndex;
+
+// Index of the range holding the source
+static inline uint8_t getSourceRange(mixsrc_t src)
+{
+  if (src < MIXSRC_FIRST_TELEM)
+    return SourceRangeIndex::index[src];
+  return src <= MIXSRC_LAST_TELEM ? TELEM_SOURCE_RANGE : SOURCE_RANGES_COUNT - 1;
+}
+
+getvalue_t getValue(mixsrc_t i, bool* valid)
+{
+  if (i >= MIXSRC_FIRST_INPUT && i <= MIXSRC_LAST_INPUT)
+    return anas[i - MIXSRC_FIRST_INPUT];
+  if (i >= MIXSRC_FIRST_CH && i <= MIXSRC_LAST_CH)
+    return ex_chans[i - MIXSRC_FIRST_CH];
+
+  const SourceRange & range = sourceAccessors[getSourceRange(i)];
+  return range.get(i - range.first, valid);
+}
+
+void getValues(const mixsrc_t* sources, getvalue_t* values, uint8_t count)
+{
+  uint8_t r = 0;
+  mixsrc_t first = 0, next = 0;  // current range: [first, next[
+
+  for (uint8_t n = 0; n < count; n++) {
+    mixsrc_t src = sources[n];
+    if (src < first || src >= next) {
+      r = getSourceRange(src);
+      first = sourceAccessors[r].first;
+      next = (r + 1 < SOURCE_RANGES_COUNT) ? sourceAccessors[r + 1].first
+                                           : (mixsrc_t)-1;
     }
+    values[n] = sourceAccessors[r].get(src - first, nullptr);
   }
-  
-  if (valid != nullptr) *valid = false;
-  return 0;
 }
 
 void evalTrims()
@@ -680,6 +808,230 @@ static inline bitfield_channels_t upper_channels_mask(uint16_t ch)
 
 uint8_t mixerCurrentFlightMode;
 
+// Flight modes fade
+//
+// While flight modes are fading, evalFlightModeMixes() runs once for each
+// fading flight mode. The mix lines which give the same result in all
+// these flight modes (no flight modes filter, delay, slow, GVAR, and
+// sources, switch and trims which do not depend on the flight mode) are
+// computed by the first flight mode and shared with the others. Only the
+// flight mode dependent lines and the lines multiplexing are evaluated for
+// each flight mode.
+
+enum MixFadeLineState {
+  MIX_FADE_NOT_SHARED = 0,
+  MIX_FADE_PENDING,  // shared, not computed yet
+  MIX_FADE_SKIP,     // shared, line disabled
+  MIX_FADE_VALUE,    // shared, 'dv' computed
+};
+
+struct MixFadeLine {
+  int32_t dv;
+  delayval_t mixEnabled;
+  uint8_t state;
+};
+
+bool mixerFadeSharing = true;
+static bool mixFadeActive = false;
+static MixFadeLine mixFadeLines[MAX_MIXERS];
+
+static_assert(MAX_INPUTS <= 32, "inputs mask is 32 bits");
+
+static inline bool isExpoGVar(int16_t value)
+{
+#if defined(GVARS)
+  return GV_IS_GV_VALUE(value, -100, 100);
+#else
+  return false;
+#endif
+}
+
+static inline bool isMixGVar(int16_t value)
+{
+#if defined(GVARS)
+  return GV_IS_GV_VALUE(value, GV_RANGELARGE_NEG, GV_RANGELARGE);
+#else
+  return false;
+#endif
+}
+
+static inline bool isCurveGVar(const CurveRef & curve)
+{
+  return curve.value &&
+         (curve.type == CURVE_REF_DIFF || curve.type == CURVE_REF_EXPO) &&
+         isExpoGVar(curve.value);
+}
+
+static bool isSwitchFlightModeIndependent(int swtch)
+{
+  swtch = abs(swtch);
+  return swtch == SWSRC_NONE || swtch == SWSRC_ON ||
+         (swtch >= SWSRC_FIRST_SWITCH &&
+          swtch <= SWSRC_LAST_MULTIPOS_SWITCH);
+}
+
+// 'inputs' is the mask of the flight mode independent inputs
+static bool isSourceFlightModeIndependent(mixsrc_t src, uint32_t inputs)
+{
+  if (src >= MIXSRC_FIRST_INPUT && src <= MIXSRC_LAST_INPUT)
+    return inputs & (1u << (src - MIXSRC_FIRST_INPUT));
+
+  // analogs, MIN / MAX, switches, trainer and telemetry
+  return (src >= MIXSRC_FIRST_STICK && src <= MIXSRC_MAX) ||
+         (src >= MIXSRC_FIRST_SWITCH && src <= MIXSRC_LAST_SWITCH) ||
+         (src >= MIXSRC_FIRST_TRAINER && src <= MIXSRC_LAST_TRAINER) ||
+         (src >= MIXSRC_FIRST_TELEM && src <= MIXSRC_LAST_TELEM);
+}
+
+static uint32_t getFlightModeIndependentInputs()
+{
+  uint32_t inputs = (uint32_t)-1;
+
+  for (uint8_t i = 0; i < MAX_EXPOS; i++) {
+    ExpoData * ed = expoAddress(i);
+    if (!EXPO_VALID(ed)) break; // end of list
+    if (ed->flightModes || !isSwitchFlightModeIndependent(ed->swtch) ||
+        !isSourceFlightModeIndependent(ed->srcRaw, 0) ||
+        isExpoGVar(ed->weight) || isExpoGVar(ed->offset) ||
+        isCurveGVar(ed->curve)) {
+      inputs &= ~(1u << ed->chn);
+    }
+  }
+
+  return inputs;
+}
+
+// Trims which have the same value in all the fading flight modes
+static uint32_t getFlightModesSharedTrims(uint16_t flightModes)
+{
+  uint32_t shared = 0;
+
+  for (uint8_t i = 0; i < keysGetMaxTrims(); i++) {
+    int value = 0;
+    bool first = true, same = true;
+    for (uint8_t p = 0; p < MAX_FLIGHT_MODES && same; p++) {
+      if (flightModes & (1 << p)) {
+        int trim = getTrimValue(p, i);
+        same = first || trim == value;
+        value = trim;
+        first = false;
+      }
+    }
+    if (same) shared |= 1u << i;
+  }
+
+  return shared;
+}
+
+static bool isMixLineFlightModeIndependent(uint8_t i, const MixData * md,
+                                           uint32_t inputs, uint32_t trims)
+{
+  if (md->flightModes || md->delayUp || md->delayDown || md->speedUp ||
+      md->speedDown || mixState[i].delay)
+    return false;
+
+  if (!isSwitchFlightModeIndependent(md->swtch) ||
+      !isSourceFlightModeIndependent(md->srcRaw, inputs))
+    return false;
+
+  if (isMixGVar(MD_WEIGHT(md)) || isMixGVar(MD_OFFSET(md)) ||
+      isCurveGVar(md->curve))
+    return false;
+
+  if (md->carryTrim == 0) {
+    if (md->srcRaw >= MIXSRC_FIRST_STICK && md->srcRaw <= MIXSRC_LAST_STICK)
+      return trims & (1u << (md->srcRaw - MIXSRC_FIRST_STICK));
+    // the input trim depends on its active line
+    if (md->srcRaw >= MIXSRC_FIRST_INPUT && md->srcRaw <= MIXSRC_LAST_INPUT)
+      return trims == (1u << keysGetMaxTrims()) - 1;
+  }
+
+  return true;
+}
+
+static void startMixFade(uint16_t flightModes)
+{
+  mixFadeActive = mixerFadeSharing;
+  if (!mixFadeActive)
+    return;
+
+  uint32_t inputs = getFlightModeIndependentInputs();
+  uint32_t trims = getFlightModesSharedTrims(flightModes);
+
+  for (uint8_t i = 0; i < MAX_MIXERS; i++) {
+    MixData * md = mixAddress(i);
+    bool shared = md->srcRaw && isMixLineFlightModeIndependent(i, md, inputs, trims);
+    mixFadeLines[i].state = shared ? MIX_FADE_PENDING : MIX_FADE_NOT_SHARED;
+  }
+}
+
+// Applies the output of the mix line 'i' to its channel
+static void applyMixLine(uint8_t i, const MixData * md, int32_t dv,
+                         uint8_t mode, bool * activeMixes)
+{
+  int32_t * ptr = &chans[md->destCh]; // Save calculating address several times
+
+  switch (md->mltpx) {
+    case MLTPX_REPL:
+      *ptr = dv;
+      if (mode == e_perout_mode_normal) {
+        for (int8_t m = i - 1; m >= 0 && mixAddress(m)->destCh == md->destCh; m--)
+          activeMixes[m] = false;
+      }
+      break;
+    case MLTPX_MUL:
+      // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
+      dv >>= 8;
+      dv *= *ptr;
+      dv >>= RESX_SHIFT;   // same as dv /= RESXl;
+      *ptr = dv;
+      break;
+    default: // MLTPX_ADD
+      *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
+      break;
+  } // endswitch md->mltpx
+#ifdef PREVENT_ARITHMETIC_OVERFLOW
+/*
+  // a lot of assumptions must be true, for this kind of check; not really worth for only 4 bytes flash savings
+  // this solution would save again 4 bytes flash
+  int8_t testVar=(*ptr<<1)>>24;
+  if ( (testVar!=-1) && (testVar!=0 ) ) {
+    // this devices by 64 which should give a good balance between still over 100% but lower then 32x100%; should be OK
+    *ptr >>= 6;  // this is quite tricky, reduces the value a lot but should be still over 100% and reduces flash need
+  } */
+
+
+  PACK( union u_int16int32_t {
+    struct {
+      int16_t lo;
+      int16_t hi;
+    } words_t;
+    int32_t dword;
+  });
+
+  u_int16int32_t tmp;
+  tmp.dword=*ptr;
+
+  if (tmp.dword<0) {
+    if ((tmp.words_t.hi&0xFF80)!=0xFF80) tmp.words_t.hi=0xFF86; // set to min nearly
+  }
+  else {
+    if ((tmp.words_t.hi|0x007F)!=0x007F) tmp.words_t.hi=0x0079; // set to max nearly
+  }
+  *ptr = tmp.dword;
+  // this implementation saves 18bytes flash
+
+/*      dv=*ptr>>8;
+  if (dv>(32767-RESXl)) {
+    *ptr=(32767-RESXl)<<8;
+  } else if (dv<(-32767+RESXl)) {
+    *ptr=(-32767+RESXl)<<8;
+  }*/
+  // *ptr=limit( int32_t(int32_t(-1)<<23), *ptr, int32_t(int32_t(1)<<23));  // limit code cost 72 bytes
+  // *ptr=limit( int32_t((-32767+RESXl)<<8), *ptr, int32_t((32767-RESXl)<<8));  // limit code cost 80 bytes
+#endif
+}
+
 void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
 {
   evalInputs(mode);
@@ -791,6 +1143,24 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
       if (i == 0 || md->destCh != (md - 1)->destCh)
         chans[md->destCh] = 0;
 
+      MixFadeLine * shared = nullptr;
+      if (mixFadeActive && mixFadeLines[i].state != MIX_FADE_NOT_SHARED)
+        shared = &mixFadeLines[i];
+
+      if (shared && shared->state != MIX_FADE_PENDING) {
+        // computed by another flight mode of this fade
+        if (mode == e_perout_mode_normal)
+          mixState[i].now = mixState[i].prev = shared->mixEnabled;
+        if (shared->state == MIX_FADE_VALUE) {
+          if (mode == e_perout_mode_normal) {
+            if (md->mixWarn) lv_mixWarning |= 1 << (md->mixWarn - 1);
+            activeMixes[i] = true;
+          }
+          applyMixLine(i, md, shared->dv, mode, activeMixes);
+        }
+        continue;
+      }
+
       //========== FLIGHT MODE && SWITCH =====
       bool mixCondition = (md->flightModes != 0 || md->swtch);
       bool fmEnabled = (md->flightModes & (1 << mixerCurrentFlightMode)) == 0;
@@ -889,6 +1259,10 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
               applyOffsetAndCurve = false;
             }
           } else if (mixCondition) {
+            if (shared) {
+              shared->state = MIX_FADE_SKIP;
+              shared->mixEnabled = mixEnabled;
+            }
             continue;
           }
         }
@@ -976,67 +1350,13 @@ void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms)
         dv = applyCurve(dv, md->curve);
       }
 
-      int32_t * ptr = &chans[md->destCh]; // Save calculating address several times
-
-      switch (md->mltpx) {
-        case MLTPX_REPL:
-          *ptr = dv;
-          if (mode == e_perout_mode_normal) {
-            for (int8_t m = i - 1; m >= 0 && mixAddress(m)->destCh == md->destCh; m--)
-              activeMixes[m] = false;
-          }
-          break;
-        case MLTPX_MUL:
-          // @@@2 we have to remove the weight factor of 256 in case of 100%; now we use the new base of 256
-          dv >>= 8;
-          dv *= *ptr;
-          dv >>= RESX_SHIFT;   // same as dv /= RESXl;
-          *ptr = dv;
-          break;
-        default: // MLTPX_ADD
-          *ptr += dv; //Mixer output add up to the line (dv + (dv>0 ? 100/2 : -100/2))/(100);
-          break;
-      } // endswitch md->mltpx
-#ifdef PREVENT_ARITHMETIC_OVERFLOW
-/*
-      // a lot of assumptions must be true, for this kind of check; not really worth for only 4 bytes flash savings
-      // this solution would save again 4 bytes flash
-      int8_t testVar=(*ptr<<1)>>24;
-      if ( (testVar!=-1) && (testVar!=0 ) ) {
-        // this devices by 64 which should give a good balance between still over 100% but lower then 32x100%; should be OK
-        *ptr >>= 6;  // this is quite tricky, reduces the value a lot but should be still over 100% and reduces flash need
-      } */
-
-
-      PACK( union u_int16int32_t {
-        struct {
-          int16_t lo;
-          int16_t hi;
-        } words_t;
-        int32_t dword;
-      });
-
-      u_int16int32_t tmp;
-      tmp.dword=*ptr;
-
-      if (tmp.dword<0) {
-        if ((tmp.words_t.hi&0xFF80)!=0xFF80) tmp.words_t.hi=0xFF86; // set to min nearly
-      }
-      else {
-        if ((tmp.words_t.hi|0x007F)!=0x007F) tmp.words_t.hi=0x0079; // set to max nearly
+      if (shared) {
+        shared->state = MIX_FADE_VALUE;
+        shared->mixEnabled = mixEnabled;
+        shared->dv = dv;
       }
-      *ptr = tmp.dword;
-      // this implementation saves 18bytes flash
 
-/*      dv=*ptr>>8;
-      if (dv>(32767-RESXl)) {
-        *ptr=(32767-RESXl)<<8;
-      } else if (dv<(-32767+RESXl)) {
-        *ptr=(-32767+RESXl)<<8;
-      }*/
-      // *ptr=limit( int32_t(int32_t(-1)<<23), *ptr, int32_t(int32_t(1)<<23));  // limit code cost 72 bytes
-      // *ptr=limit( int32_t((-32767+RESXl)<<8), *ptr, int32_t((32767-RESXl)<<8));  // limit code cost 80 bytes
-#endif
+      applyMixLine(i, md, dv, mode, activeMixes);
     } //endfor mixers
 
     tick10ms = 0;
@@ -1105,6 +1425,7 @@ void evalMixes(uint8_t tick10ms)
   int32_t weight = 0;
   if (flightModesFade) {
     memclear(sum_chans512, sizeof(sum_chans512));
+    startMixFade(flightModesFade);
     for (uint8_t p=0; p<MAX_FLIGHT_MODES; p++) {
       if (flightModesFade & (0x01 << p)) {
         mixerCurrentFlightMode = p;
@@ -1114,6 +1435,7 @@ void evalMixes(uint8_t tick10ms)
         weight += fp_act[p];
       }
     }
+    mixFadeActive = false;
     assert(weight);
     mixerCurrentFlightMode = fm;
   }
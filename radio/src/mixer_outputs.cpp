@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include <atomic>
+#include <stddef.h>
+#include <string.h>
+
+#include "mixer_outputs.h"
+#include "opentx.h"
+
+struct MixerOutputsBuffer {
+  std::atomic<uint32_t> sequence;  // odd while written
+  MixerOutputs outputs;
+};
+
+static MixerOutputsBuffer buffers[2];
+static std::atomic<uint8_t> current(0);  // last published buffer
+static uint32_t version = 0;             // mixer side
+
+void mixerOutputsPublish()
+{
+  uint8_t next = current.load(std::memory_order_relaxed) ^ 1;
+  MixerOutputsBuffer & buffer = buffers[next];
+  uint32_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+
+  buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  MixerOutputs & outputs = buffer.outputs;
+  outputs.version = ++version;
+  memcpy(outputs.channels, channelOutputs, sizeof(outputs.channels));
+  memcpy(outputs.mixes, ex_chans, sizeof(outputs.mixes));
+  outputs.flightMode = mixerCurrentFlightMode;
+
+  buffer.sequence.store(sequence + 2, std::memory_order_release);
+  current.store(next, std::memory_order_release);
+}
+
+// Copies 'size' bytes at 'offset' of the last snapshot. The buffer
+// being written is never the current one, so an interrupt preempting
+// the mixer always finds a complete snapshot
+static bool readSnapshot(void * data, size_t offset, size_t size)
+{
+  while (true) {
+    const MixerOutputsBuffer & buffer =
+        buffers[current.load(std::memory_order_acquire)];
+
+    uint32_t sequence = buffer.sequence.load(std::memory_order_acquire);
+    if (sequence & 1) continue;  // being written (reader too slow)
+
+    memcpy(data, (const uint8_t *)&buffer.outputs + offset, size);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (buffer.sequence.load(std::memory_order_relaxed) == sequence)
+      return sequence != 0;
+  }
+}
+
+bool mixerOutputsRead(MixerOutputs & outputs)
+{
+  return readSnapshot(&outputs, 0, sizeof(outputs));
+}
+
+bool mixerOutputsReadChannels(int16_t * channels)
+{
+  return readSnapshot(channels, offsetof(MixerOutputs, channels),
+                      sizeof(MixerOutputs::channels));
+}
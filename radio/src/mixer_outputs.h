@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include "dataconstants.h"
+
+//
+// Mixer outputs, published by the mixer task after each cycle
+//
+// The mixer writes a snapshot into the buffer readers are not using
+// (double buffer), each buffer being guarded by a sequence counter
+// (seqlock). Readers never block the mixer: they copy the last published
+// snapshot and retry if the mixer overwrote it meanwhile, which only
+// happens when a copy takes longer than a mixer cycle.
+//
+
+struct MixerOutputs {
+  uint32_t version;                       // mixer cycle of the snapshot
+  int16_t channels[MAX_OUTPUT_CHANNELS];  // channelOutputs
+  int16_t mixes[MAX_OUTPUT_CHANNELS];     // ex_chans
+  uint8_t flightMode;
+};
+
+// mixer task only
+void mixerOutputsPublish();
+
+// Copies the last snapshot, returns false if none has been published yet
+bool mixerOutputsRead(MixerOutputs & outputs);
+
+// Same for the channels only (channelOutputs), also usable from interrupts
+bool mixerOutputsReadChannels(int16_t * channels);
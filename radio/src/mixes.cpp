@@ -31,11 +31,40 @@ MixData* mixAddress(uint8_t idx) { return &g_model.mixData[idx]; }
 
 uint8_t getMixCount() { return _nb_mix_lines; }
 
+// Mix lines edit, prepared off the model and run by the mixer task
+struct MixEdit {
+  uint8_t idx;
+  uint8_t dst;
+  MixData line;
+};
+
+static void insertMixLine(void * ctx)
+{
+  auto edit = (const MixEdit *)ctx;
+  MixData * mix = mixAddress(edit->idx);
+  memmove(mix + 1, mix, (MAX_MIXERS - (edit->idx + 1)) * sizeof(MixData));
+  memcpy(mix, &edit->line, sizeof(MixData));
+}
+
+static void deleteMixLine(void * ctx)
+{
+  auto edit = (const MixEdit *)ctx;
+  MixData * mix = mixAddress(edit->idx);
+  memmove(mix, mix + 1, (MAX_MIXERS - (edit->idx + 1)) * sizeof(MixData));
+  memclear(&g_model.mixData[MAX_MIXERS - 1], sizeof(MixData));
+}
+
+static void swapMixLines(void * ctx)
+{
+  auto edit = (const MixEdit *)ctx;
+  memswap(mixAddress(edit->idx), mixAddress(edit->dst), sizeof(MixData));
+}
+
 void insertMix(uint8_t idx, uint8_t channel)
 {
-  mixerTaskStop();
-  MixData * mix = mixAddress(idx);
-  memmove(mix + 1, mix, (MAX_MIXERS - (idx + 1)) * sizeof(MixData));
+  MixEdit edit;
+  edit.idx = idx;
+  MixData * mix = &edit.line;
   memclear(mix, sizeof(MixData));
   mix->destCh = channel;
   mix->srcRaw = channel + 1;
@@ -50,7 +79,7 @@ void insertMix(uint8_t idx, uint8_t channel)
     }
   }
   mix->weight = 100;
-  mixerTaskStart();
+  mixerTaskCommitEdit(insertMixLine, &edit);
 
   _nb_mix_lines += 1;
   storageDirty(EE_MODEL);
@@ -58,11 +87,9 @@ void insertMix(uint8_t idx, uint8_t channel)
 
 void deleteMix(uint8_t idx)
 {
-  mixerTaskStop();
-  MixData * mix = mixAddress(idx);
-  memmove(mix, mix + 1, (MAX_MIXERS - (idx + 1)) * sizeof(MixData));
-  memclear(&g_model.mixData[MAX_MIXERS - 1], sizeof(MixData));
-  mixerTaskStart();
+  MixEdit edit;
+  edit.idx = idx;
+  mixerTaskCommitEdit(deleteMixLine, &edit);
 
   _nb_mix_lines -= 1;
   storageDirty(EE_MODEL);
@@ -70,15 +97,11 @@ void deleteMix(uint8_t idx)
 
 void copyMix(uint8_t src, uint8_t dst, uint8_t channel)
 {
-  mixerTaskStop();
-  MixData sourceMix;
-  memcpy(&sourceMix, mixAddress(src), sizeof(MixData));
-  MixData* mix = mixAddress(dst);
-  size_t trailingMixes = MAX_MIXERS - (dst + 1);
-  memmove(mix + 1, mix, trailingMixes * sizeof(MixData));
-  memcpy(mix, &sourceMix, sizeof(MixData));
-  mix->destCh = channel;
-  mixerTaskStart();
+  MixEdit edit;
+  edit.idx = dst;
+  memcpy(&edit.line, mixAddress(src), sizeof(MixData));
+  edit.line.destCh = channel;
+  mixerTaskCommitEdit(insertMixLine, &edit);
 
   _nb_mix_lines += 1;
   storageDirty(EE_MODEL);
@@ -134,9 +157,10 @@ uint8_t moveMix(uint8_t idx, bool up)
     return idx;
   }
 
-  mixerTaskStop();
-  memswap(x, y, sizeof(MixData));
-  mixerTaskStart();
+  MixEdit edit;
+  edit.idx = idx;
+  edit.dst = tgt_idx;
+  mixerTaskCommitEdit(swapMixLines, &edit);
 
   storageDirty(EE_MODEL);
   return tgt_idx;
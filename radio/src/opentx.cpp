@@ -78,6 +78,7 @@ Clipboard clipboard;
 GlobalData globalData;
 
 uint32_t maxMixerDuration; // microseconds
+uint32_t totalMixerDuration; // microseconds, wraps
 
 constexpr uint8_t HEART_TIMER_10MS = 0x01;
 uint8_t heartbeat;
@@ -1187,9 +1188,12 @@ void instantTrim()
   AUDIO_WARNING2();
 }
 
-void copySticksToOffset(uint8_t ch)
+// Offsets and limits edits computed by the mixer task between two cycles
+// (they use the mixer state), see mixerTaskCommitEdit()
+
+static void copySticksToOffsetEdit(void * ctx)
 {
-  mixerTaskStop();
+  uint8_t ch = *(const uint8_t *)ctx;
   int32_t zero = (int32_t)channelOutputs[ch];
 
   evalFlightModeMixes(e_perout_mode_nosticks+e_perout_mode_notrainer, 0);
@@ -1202,17 +1206,19 @@ void copySticksToOffset(uint8_t ch)
   }
   zero = (zero*256000 - val*lim) / (1024*256-val);
   ld->offset = (ld->revert ? -zero : zero);
+}
 
-  mixerTaskStart();
+void copySticksToOffset(uint8_t ch)
+{
+  mixerTaskCommitEdit(copySticksToOffsetEdit, &ch);
   storageDirty(EE_MODEL);
 }
 
-void copyTrimsToOffset(uint8_t ch)
+static void copyTrimsToOffsetEdit(void * ctx)
 {
+  uint8_t ch = *(const uint8_t *)ctx;
   int16_t zero;
 
-  mixerTaskStop();
-
   evalFlightModeMixes(e_perout_mode_noinput, 0); // do output loop - zero input sticks and trims
   zero = applyLimits(ch, chans[ch]);
 
@@ -1224,28 +1230,29 @@ void copyTrimsToOffset(uint8_t ch)
     output = -output;
   v += (output * 125) / 128;
   g_model.limitData[ch].offset = limit((int16_t)-1000, (int16_t)v, (int16_t)1000); // make sure the offset doesn't go haywire
+}
 
-  mixerTaskStart();
+void copyTrimsToOffset(uint8_t ch)
+{
+  mixerTaskCommitEdit(copyTrimsToOffsetEdit, &ch);
   storageDirty(EE_MODEL);
 }
 
-void copyMinMaxToOutputs(uint8_t ch)
+static void copyMinMaxToOutputsEdit(void * ctx)
 {
-  LimitData *ld = limitAddress(ch);
-  int16_t min = ld->min;
-  int16_t max = ld->max;
-  int16_t center = ld->ppmCenter;
-
-  mixerTaskStop();
-
+  const LimitData * src = (const LimitData *)ctx;
   for (uint8_t chan = 0; chan < MAX_OUTPUT_CHANNELS; chan++) {
-    ld = limitAddress(chan);
-    ld->min = min;
-    ld->max = max;
-    ld->ppmCenter = center;
+    LimitData * ld = limitAddress(chan);
+    ld->min = src->min;
+    ld->max = src->max;
+    ld->ppmCenter = src->ppmCenter;
   }
+}
 
-  mixerTaskStart();
+void copyMinMaxToOutputs(uint8_t ch)
+{
+  LimitData limits = *limitAddress(ch);
+  mixerTaskCommitEdit(copyMinMaxToOutputsEdit, &limits);
   storageDirty(EE_MODEL);
 }
 
@@ -1289,12 +1296,10 @@ void runStartupAnimation()
 }
 #endif
 
-void moveTrimsToOffsets() // copy state of 3 primary to subtrim
+static void moveTrimsToOffsetsEdit(void *)
 {
   int16_t zeros[MAX_OUTPUT_CHANNELS];
 
-  mixerTaskStop();
-
   evalFlightModeMixes(e_perout_mode_noinput, 0); // do output loop - zero input sticks and trims
 
   for (uint8_t i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
@@ -1325,8 +1330,11 @@ void moveTrimsToOffsets() // copy state of 3 primary to subtrim
       }
     }
   }
+}
 
-  mixerTaskStart();
+void moveTrimsToOffsets() // copy state of 3 primary to subtrim
+{
+  mixerTaskCommitEdit(moveTrimsToOffsetsEdit, nullptr);
 
   storageDirty(EE_MODEL);
   AUDIO_WARNING2();
@@ -1426,6 +1434,11 @@ void edgeTxInit()
 #endif // defined(AUTOUPDATE)
 
     logsInit();
+
+#if defined(COLORLCD) && defined(IMAGE_SIDECARS)
+    // decoded images are kept next to them to speed up later loads
+    BitmapBuffer::setSidecarsEnabled(true);
+#endif
   }
 #endif // defined(SDCARD)
 
@@ -157,10 +157,33 @@ void memswap(void * a, void * b, uint8_t size);
 #define MASK_CFN_TYPE  uint64_t  // current max = 64 customizable switches
 #define MASK_FUNC_TYPE uint32_t  // current max = 32 functions
 
+// Configured functions (with a switch), rebuilt by evalFunctions()
+// when the functions have been edited
+struct CustomFunctionsIndex {
+  bool valid;
+  uint16_t generation;                        // functions generation it was built from
+  uint8_t count;
+  uint8_t functions[MAX_SPECIAL_FUNCTIONS];   // in evaluation order
+  uint8_t switchIndex[MAX_SPECIAL_FUNCTIONS]; // function trigger in switches[]
+  uint8_t switchesCount;
+  swsrc_t switches[MAX_SPECIAL_FUNCTIONS];    // distinct triggers
+  uint8_t switchFlags[MAX_SPECIAL_FUNCTIONS]; // getSwitch() flags
+  MASK_CFN_TYPE edgeFunctions;                // run on switch changes only
+};
+
 struct CustomFunctionsContext {
   MASK_FUNC_TYPE activeFunctions;
   MASK_CFN_TYPE  activeSwitches;
   tmr10ms_t lastFunctionTime[MAX_SPECIAL_FUNCTIONS];
+  CustomFunctionsIndex index;
+  volatile uint16_t generation; // bumped after each edit of the functions
+
+  // Called by the functions editors (UI, Lua) once the functions data
+  // has been written; the index is rebuilt on the next evalFunctions() pass
+  inline void invalidateIndex()
+  {
+    generation = generation + 1;
+  }
 
   inline bool isFunctionActive(uint8_t func)
   {
@@ -169,7 +192,9 @@ struct CustomFunctionsContext {
 
   void reset()
   {
+    uint16_t previous = generation;
     memclear(this, sizeof(*this));
+    generation = previous + 1;
   }
 };
 
@@ -274,6 +299,7 @@ extern uint32_t availableMemory();
 
 void evalFlightModeMixes(uint8_t mode, uint8_t tick10ms);
 void evalMixes(uint8_t tick10ms);
+extern bool mixerFadeSharing;
 void doMixerCalculations();
 void doMixerPeriodicUpdates();
 
@@ -282,6 +308,9 @@ extern uint8_t currentBacklightBright;
 void perMain();
 
 getvalue_t getValue(mixsrc_t i, bool* valid = nullptr);
+// Values of 'count' sources (faster than getValue() for sources of the
+// same range)
+void getValues(const mixsrc_t* sources, getvalue_t* values, uint8_t count);
 
 int8_t getMovedSource(uint8_t min);
 #define GET_MOVED_SOURCE(min, max) getMovedSource(min)
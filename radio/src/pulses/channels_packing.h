@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <inttypes.h>
+
+//
+// Channels scaling & packing shared by the protocol encoders
+//
+// Channels are first converted from the mixer range [-1024:1024]
+// into the protocol range in one pass (scaleChannels()), then
+// bit-packed LSB first (packChannels()).
+//
+
+// value = limit(Min, ((channel + offset) * Num) / Den + Center, Max)
+//
+// With ScaledOffset, the offset is scaled on its own, as done by
+// CRSF: (channel * Num) / Den + (offset * Num) / Den + Center
+//
+template <int32_t Num, int32_t Den, int32_t Center, int32_t Min, int32_t Max,
+          bool ScaledOffset = false>
+struct ChannelScaling {
+  static inline uint16_t scale(int32_t value, int32_t offset)
+  {
+    int32_t v;
+    if (ScaledOffset)
+      v = (value * Num) / Den + (offset * Num) / Den + Center;
+    else
+      v = ((value + offset) * Num) / Den + Center;
+    return v < Min ? Min : (v > Max ? Max : v);
+  }
+};
+
+// PXX2: [-100%:100%] -> [1:2046] with 1024 as center
+typedef ChannelScaling<512, 682, 1024, 1, 2046> Pxx2ChannelScaling;
+
+// Multi: [-100%;100%] -> [204;1843] with 1024 as center
+typedef ChannelScaling<800, 1000, 1024, 0, 2047> MultiChannelScaling;
+
+// SBUS: [-100%;100%] -> [173;1811] with 992 as center
+typedef ChannelScaling<8, 10, 992, 0, 2047> SbusChannelScaling;
+
+// CRSF: [-100%;100%] -> [172;1811] with 992 as center
+typedef ChannelScaling<4, 5, 0x3E0, 0, 2 * 0x3E0, true> CrossfireChannelScaling;
+
+// Converts 'count' channels; 'offsets' holds the per channel
+// center offsets (see getChannelsCenterOffsets()) or nullptr
+template <class Scaling>
+inline void scaleChannels(uint16_t* values, const int16_t* channels,
+                          const int16_t* offsets, uint8_t count)
+{
+  if (offsets) {
+    for (uint8_t i = 0; i < count; i++)
+      values[i] = Scaling::scale(channels[i], offsets[i]);
+  } else {
+    for (uint8_t i = 0; i < count; i++)
+      values[i] = Scaling::scale(channels[i], 0);
+  }
+}
+
+// Packs 'count' values of BITS bits, LSB first, and returns the
+// end of the written buffer. A last incomplete byte is zero padded.
+template <uint8_t BITS>
+inline uint8_t* packChannels(uint8_t* buf, const uint16_t* values,
+                             uint8_t count)
+{
+  uint32_t bits = 0;
+  uint8_t bitsavailable = 0;
+
+  for (uint8_t i = 0; i < count; i++) {
+    bits |= (uint32_t)values[i] << bitsavailable;
+    bitsavailable += BITS;
+    while (bitsavailable >= 8) {
+      *buf++ = (uint8_t)bits;
+      bits >>= 8;
+      bitsavailable -= 8;
+    }
+  }
+
+  if (bitsavailable > 0) {
+    *buf++ = (uint8_t)bits;
+  }
+
+  return buf;
+}
+
+// 11 bits: 8 channels in 11 bytes (SBUS, CRSF, Multi)
+template <>
+inline uint8_t* packChannels<11>(uint8_t* buf, const uint16_t* values,
+                                 uint8_t count)
+{
+  uint8_t blocks = count / 8;
+
+  for (uint8_t i = 0; i < blocks; i++, values += 8) {
+    const uint16_t* v = values;
+    buf[0] = (uint8_t)v[0];
+    buf[1] = (uint8_t)((v[0] >> 8) | (v[1] << 3));
+    buf[2] = (uint8_t)((v[1] >> 5) | (v[2] << 6));
+    buf[3] = (uint8_t)(v[2] >> 2);
+    buf[4] = (uint8_t)((v[2] >> 10) | (v[3] << 1));
+    buf[5] = (uint8_t)((v[3] >> 7) | (v[4] << 4));
+    buf[6] = (uint8_t)((v[4] >> 4) | (v[5] << 7));
+    buf[7] = (uint8_t)(v[5] >> 1);
+    buf[8] = (uint8_t)((v[5] >> 9) | (v[6] << 2));
+    buf[9] = (uint8_t)((v[6] >> 6) | (v[7] << 5));
+    buf[10] = (uint8_t)(v[7] >> 3);
+    buf += 11;
+  }
+
+  uint32_t bits = 0;
+  uint8_t bitsavailable = 0;
+
+  for (uint8_t i = blocks * 8; i < count; i++) {
+    bits |= (uint32_t)*values++ << bitsavailable;
+    bitsavailable += 11;
+    while (bitsavailable >= 8) {
+      *buf++ = (uint8_t)bits;
+      bits >>= 8;
+      bitsavailable -= 8;
+    }
+  }
+
+  if (bitsavailable > 0) {
+    *buf++ = (uint8_t)bits;
+  }
+
+  return buf;
+}
+
+// 12 bits: 2 channels in 3 bytes (PXX2)
+template <>
+inline uint8_t* packChannels<12>(uint8_t* buf, const uint16_t* values,
+                                 uint8_t count)
+{
+  uint8_t pairs = count / 2;
+
+  for (uint8_t i = 0; i < pairs; i++, values += 2) {
+    buf[0] = (uint8_t)values[0];
+    buf[1] = (uint8_t)(((values[0] >> 8) & 0x0F) | (values[1] << 4));
+    buf[2] = (uint8_t)(values[1] >> 4);
+    buf += 3;
+  }
+
+  if (count & 1) {
+    *buf++ = (uint8_t)values[0];
+    *buf++ = (uint8_t)((values[0] >> 8) & 0x0F);
+  }
+
+  return buf;
+}
+
+// 16 bits: little endian
+template <>
+inline uint8_t* packChannels<16>(uint8_t* buf, const uint16_t* values,
+                                 uint8_t count)
+{
+  for (uint8_t i = 0; i < count; i++) {
+    buf[0] = (uint8_t)values[i];
+    buf[1] = (uint8_t)(values[i] >> 8);
+    buf += 2;
+  }
+
+  return buf;
+}
+
+// Reverse operation, used by receivers and for tests
+template <uint8_t BITS>
+inline const uint8_t* unpackChannels(const uint8_t* buf, uint16_t* values,
+                                     uint8_t count)
+{
+  uint32_t bits = 0;
+  uint8_t bitsavailable = 0;
+
+  for (uint8_t i = 0; i < count; i++) {
+    while (bitsavailable < BITS) {
+      bits |= (uint32_t)*buf++ << bitsavailable;
+      bitsavailable += 8;
+    }
+    values[i] = bits & ((1u << BITS) - 1);
+    bits >>= BITS;
+    bitsavailable -= BITS;
+  }
+
+  return buf;
+}
+
+// Fills 'offsets' with the PPM center offsets of channels
+// [start:start+count[ (2 * ppmCenter), returns nullptr
+// if the PPM center is not adjustable
+const int16_t* getChannelsCenterOffsets(int16_t* offsets, uint8_t start,
+                                        uint8_t count);
@@ -30,10 +30,10 @@
 #include "hal/module_port.h"
 
 #include "crossfire.h"
+#include "channels_packing.h"
 #include "telemetry/crossfire.h"
 
 #define CROSSFIRE_CH_BITS           11
-#define CROSSFIRE_CENTER            0x3E0
 #if defined(PPM_CENTER_ADJUSTABLE)
   #define CROSSFIRE_CENTER_CH_OFFSET(ch)            ((2 * limitAddress(ch)->ppmCenter) + 1)  // + 1 is for rouding
 #else
@@ -66,18 +66,16 @@ uint8_t createCrossfireChannelsFrame(uint8_t * frame, int16_t * pulses)
   *buf++ = 24; // 1(ID) + 22 + 1(CRC)
   uint8_t * crc_start = buf;
   *buf++ = CHANNELS_ID;
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
+
+  int16_t offsets[CROSSFIRE_CHANNELS_COUNT];
   for (int i=0; i<CROSSFIRE_CHANNELS_COUNT; i++) {
-    uint32_t val = limit(0, CROSSFIRE_CENTER + (CROSSFIRE_CENTER_CH_OFFSET(i) * 4) / 5 + (pulses[i] * 4) / 5, 2 * CROSSFIRE_CENTER);
-    bits |= val << bitsavailable;
-    bitsavailable += CROSSFIRE_CH_BITS;
-    while (bitsavailable >= 8) {
-      *buf++ = bits;
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
+    offsets[i] = CROSSFIRE_CENTER_CH_OFFSET(i);
   }
+
+  uint16_t values[CROSSFIRE_CHANNELS_COUNT];
+  scaleChannels<CrossfireChannelScaling>(values, pulses, offsets, CROSSFIRE_CHANNELS_COUNT);
+  buf = packChannels<CROSSFIRE_CH_BITS>(buf, values, CROSSFIRE_CHANNELS_COUNT);
+
   *buf++ = crc8(crc_start, 23);
   return buf - frame;
 }
@@ -20,6 +20,7 @@
  */
 
 #include "opentx.h"
+#include "channels_packing.h"
 
 #if defined(EXTERNAL_ANTENNA)
 bool isExternalAntennaEnabled()
@@ -89,6 +90,19 @@ int8_t sentModuleChannels(uint8_t idx)
     return sentModulePXXChannels(idx);
 }
 
+const int16_t* getChannelsCenterOffsets(int16_t* offsets, uint8_t start,
+                                        uint8_t count)
+{
+#if defined(PPM_CENTER_ADJUSTABLE)
+  for (uint8_t i = 0; i < count; i++) {
+    offsets[i] = 2 * PPM_CH_CENTER(start + i) - 2 * PPM_CENTER;
+  }
+  return offsets;
+#else
+  return nullptr;
+#endif
+}
+
 uint8_t getMaxRxNum(uint8_t idx)
 {
   if (isModuleDSM2(idx))
@@ -21,6 +21,7 @@
 
 #include "opentx.h"
 #include "multi.h"
+#include "channels_packing.h"
 
 #include "io/multi_protolist.h"
 #include "telemetry/multi.h"
@@ -43,7 +44,6 @@
 #define MULTI_DATA     0x02
 
 static void sendFrameProtocolHeader(uint8_t*& p_buf, uint8_t module, bool failsafe);
-static void sendChannels(uint8_t*& p_buf, uint8_t module);
 static void sendD16BindOption(uint8_t*& p_buf, uint8_t module);
 #if defined(LUA)
 static void sendSport(uint8_t*& p_buf, uint8_t module);
@@ -80,10 +80,9 @@ static void updateMultiSync(uint8_t module)
   }
 }
 
-static void sendFailsafeChannels(uint8_t*& p_buf, uint8_t module)
+void sendMultiFailsafeChannels(uint8_t*& p_buf, uint8_t module)
 {
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
+  uint16_t values[MULTI_CHANS];
 
   for (int i = 0; i < MULTI_CHANS; i++) {
     int16_t failsafeValue = g_model.failsafeChannels[i];
@@ -103,14 +102,10 @@ static void sendFailsafeChannels(uint8_t*& p_buf, uint8_t module)
       pulseValue = limit(1, (failsafeValue * 800 / 1000) + 1024, 2046);
     }
 
-    bits |= pulseValue << bitsavailable;
-    bitsavailable += MULTI_CHAN_BITS;
-    while (bitsavailable >= 8) {
-      sendMulti(p_buf, (uint8_t) (bits & 0xff));
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
+    values[i] = pulseValue;
   }
+
+  p_buf = packChannels<MULTI_CHAN_BITS>(p_buf, values, MULTI_CHANS);
 }
 
 static void setupPulsesMulti(uint8_t*& p_buf, uint8_t module)
@@ -151,9 +146,9 @@ static void setupPulsesMulti(uint8_t*& p_buf, uint8_t module)
 
   // Send channels
   if (type & MULTI_FAILSAFE)
-    sendFailsafeChannels(p_buf, module);
+    sendMultiFailsafeChannels(p_buf, module);
   else
-    sendChannels(p_buf, module);
+    sendMultiChannels(p_buf, module);
 
   // Multi V1.3.X.X -> Send byte 26, Protocol (bits 7 & 6), RX_Num (bits 5 & 4), invert, not used, disable telemetry, disable mapping
   if (moduleState[module].mode == MODULE_MODE_SPECTRUM_ANALYSER
@@ -290,30 +285,19 @@ const etx_proto_driver_t MultiDriver = {
   .onConfigChange = nullptr,
 };
 
-static void sendChannels(uint8_t*& p_buf, uint8_t module)
+void sendMultiChannels(uint8_t*& p_buf, uint8_t module)
 {
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
+  uint8_t start = g_model.moduleData[module].channelsStart;
+  int16_t offsets[MULTI_CHANS];
+  uint16_t values[MULTI_CHANS];
 
   // byte 4-25, channels 0..2047
   // Range for pulses (channelsOutputs) is [-1024:+1024] for [-100%;100%]
-  // Multi uses [204;1843] as [-100%;100%]
-  for (int i = 0; i < MULTI_CHANS; i++) {
-    int channel = g_model.moduleData[module].channelsStart + i;
-    int value = channelOutputs[channel] + 2 * PPM_CH_CENTER(channel) - 2 * PPM_CENTER;
-
-    // Scale to 80%
-    value = value * 800 / 1000 + 1024;
-    value = limit(0, value, 2047);
-
-    bits |= value << bitsavailable;
-    bitsavailable += MULTI_CHAN_BITS;
-    while (bitsavailable >= 8) {
-      sendMulti(p_buf, (uint8_t) (bits & 0xff));
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
-  }
+  // Multi uses [204;1843] as [-100%;100%] (scaled to 80%)
+  scaleChannels<MultiChannelScaling>(
+      values, &channelOutputs[start],
+      getChannelsCenterOffsets(offsets, start, MULTI_CHANS), MULTI_CHANS);
+  p_buf = packChannels<MULTI_CHAN_BITS>(p_buf, values, MULTI_CHANS);
 }
 
 void sendFrameProtocolHeader(uint8_t*& p_buf, uint8_t module, bool failsafe)
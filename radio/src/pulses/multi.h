@@ -24,3 +24,7 @@
 #include "hal/module_driver.h"
 
 extern const etx_proto_driver_t MultiDriver;
+
+// channels part of the frames sent to the module
+void sendMultiChannels(uint8_t*& p_buf, uint8_t module);
+void sendMultiFailsafeChannels(uint8_t*& p_buf, uint8_t module);
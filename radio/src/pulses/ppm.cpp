@@ -24,6 +24,7 @@
 #include "ppm.h"
 #include "hal/module_port.h"
 #include "mixer_scheduler.h"
+#include "mixer_outputs.h"
 
 #include "opentx.h"
 
@@ -33,7 +34,8 @@
 #define PPM_SAFE_MARGIN 3000 // 3ms
 
 template <class T>
-uint16_t setupPulsesPPM(T*& data, uint8_t channelsStart, int8_t channelsCount)
+uint16_t setupPulsesPPM(T*& data, const int16_t * channels,
+                        uint8_t channelsStart, int8_t channelsCount)
 {
   uint16_t total = 0;
   int16_t PPM_range = g_model.extendedLimits ?
@@ -49,7 +51,7 @@ uint16_t setupPulsesPPM(T*& data, uint8_t channelsStart, int8_t channelsCount)
 
   for (uint32_t i = firstCh; i < lastCh; i++) {
     int16_t v =
-        limit((int16_t)-PPM_range, channelOutputs[i], (int16_t)PPM_range) +
+        limit((int16_t)-PPM_range, channels[i], (int16_t)PPM_range) +
         2 * PPM_CH_CENTER(i);
     *data++ = v;
     total += v;
@@ -58,11 +60,16 @@ uint16_t setupPulsesPPM(T*& data, uint8_t channelsStart, int8_t channelsCount)
   return total;
 }
 
+// Called from the trainer timer interrupt: uses the last mixer outputs
+// snapshot, channelOutputs may be half written by the mixer
 void setupPulsesPPMTrainer()
 {
+  int16_t channels[MAX_OUTPUT_CHANNELS];
+  mixerOutputsReadChannels(channels);
+
   auto p_data = trainerPulsesData.ppm.pulses;
   uint16_t total = setupPulsesPPM<trainer_pulse_duration_t>(
-      p_data, g_model.trainerData.channelsStart,
+      p_data, channels, g_model.trainerData.channelsStart,
       g_model.trainerData.channelsCount);
 
   uint32_t rest = PPM_TRAINER_PERIOD_HALF_US();
@@ -87,7 +94,7 @@ void setupPulsesPPMTrainer()
 static uint32_t setupPulsesPPMModule(uint8_t module, pulse_duration_t*& data)
 {
   auto start = data;
-  setupPulsesPPM(data,
+  setupPulsesPPM(data, channelOutputs,
                  g_model.moduleData[module].channelsStart,
                  g_model.moduleData[module].channelsCount);
 
@@ -29,6 +29,7 @@
 
 #include "pxx2.h"
 #include "pxx2_transport.h"
+#include "channels_packing.h"
 
 static const etx_serial_init pxx2SerialInitParams = {
     .baudrate = PXX2_HIGHSPEED_BAUDRATE,
@@ -267,44 +268,47 @@ void Pxx2Pulses::addFlag1(uint8_t module)
   Pxx2Transport::addByte(flag1);
 }
 
-void Pxx2Pulses::addPulsesValues(uint16_t low, uint16_t high)
+void Pxx2Pulses::addPulsesValues(const uint16_t* values, uint8_t count)
 {
-  Pxx2Transport::addByte(low); // Low byte of channel
-  Pxx2Transport::addByte(((low >> 8u) & 0x0Fu) | (high << 4u));  // 4 bits each from 2 channels
-  Pxx2Transport::addByte(high >> 4u);  // High byte of channel
+  // 2 channels on 3 bytes: low byte, 4 bits each from 2 channels, high byte
+  uint8_t data[MAX_OUTPUT_CHANNELS * 3 / 2];
+  uint8_t* end = packChannels<12>(data, values, count);
+
+  for (uint8_t* p = data; p < end; p++) {
+    Pxx2Transport::addByte(*p);
+  }
 }
 
 void Pxx2Pulses::addChannels(uint8_t module, int16_t* channels, uint8_t nChannels)
 {
-  uint16_t pulseValue = 0;
-  uint16_t pulseValueLow = 0;
+  uint16_t values[MAX_OUTPUT_CHANNELS];
+  int16_t offsets[MAX_OUTPUT_CHANNELS];
 
   uint8_t channel = g_model.moduleData[module].channelsStart;
-  uint8_t count = sentModuleChannels(module);
+  // channels are sent by pairs
+  uint8_t count = sentModuleChannels(module) & ~1;
+
+  scaleChannels<Pxx2ChannelScaling>(
+      values, channels, getChannelsCenterOffsets(offsets, channel, count),
+      count);
 
-  for (int8_t i = 0; i < count; i++, channel++) {
-    int value = channels[i] + 2*PPM_CH_CENTER(channel) - 2*PPM_CENTER;
-    pulseValue = limit(1, (value * 512 / 682) + 1024, 2046);
 #if defined(DEBUG_LATENCY_RF_ONLY)
-    if (latencyToggleSwitch)
-      pulseValue = 1;
-    else
-      pulseValue = 2046;
-#endif
-    if (i & 1)
-      addPulsesValues(pulseValueLow, pulseValue);
-    else
-      pulseValueLow = pulseValue;
+  for (uint8_t i = 0; i < count; i++) {
+    values[i] = latencyToggleSwitch ? 1 : 2046;
   }
+#endif
+
+  addPulsesValues(values, count);
 }
 
 void Pxx2Pulses::addFailsafe(uint8_t module)
 {
+  uint16_t values[MAX_OUTPUT_CHANNELS];
   uint16_t pulseValue = 0;
-  uint16_t pulseValueLow = 0;
 
   uint8_t channel = g_model.moduleData[module].channelsStart;
-  uint8_t count = sentModuleChannels(module);
+  // channels are sent by pairs
+  uint8_t count = sentModuleChannels(module) & ~1;
 
   for (int8_t i = 0; i < count; i++, channel++) {
     if (g_model.moduleData[module].failsafeMode == FAILSAFE_HOLD) {
@@ -326,11 +330,10 @@ void Pxx2Pulses::addFailsafe(uint8_t module)
         pulseValue = limit(1, (failsafeValue * 512 / 682) + 1024, 2046);
       }
     }
-    if (i & 1)
-      addPulsesValues(pulseValueLow, pulseValue);
-    else
-      pulseValueLow = pulseValue;
+    values[i] = pulseValue;
   }
+
+  addPulsesValues(values, count);
 }
 
 void Pxx2Pulses::setupChannelsFrame(uint8_t module, int16_t* channels, uint8_t nChannels)
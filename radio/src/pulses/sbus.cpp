@@ -25,6 +25,7 @@
 #include "mixer_scheduler.h"
 
 #include "opentx.h"
+#include "channels_packing.h"
 
 #define SBUS_NORMAL_CHANS 16
 #define SBUS_CHAN_BITS    11
@@ -37,7 +38,6 @@
 #define SBUS_FLAG_FAILSAFE_ACTIVE   (1 << 3)
 #define SBUS_FRAME_BEGIN_BYTE       0x0F
 
-#define SBUS_CHAN_CENTER            992
 
 static inline void sendByte(uint8_t*& p_buf, uint8_t b)
 {
@@ -52,7 +52,7 @@ static inline int getChannelValue(uint8_t port, int channel)
   return channelOutputs[ch] + 2 * PPM_CH_CENTER(ch) - 2 * PPM_CENTER;
 }
 
-static void setupPulsesSbus(uint8_t module, uint8_t*& p_buf)
+void setupPulsesSbus(uint8_t module, uint8_t*& p_buf)
 {
   // extmodulePulsesData.dsm2.index = 0;
   // extmodulePulsesData.dsm2.ptr = extmodulePulsesData.dsm2.pulses;
@@ -60,23 +60,16 @@ static void setupPulsesSbus(uint8_t module, uint8_t*& p_buf)
   // Sync Byte
   sendByte(p_buf, SBUS_FRAME_BEGIN_BYTE);
 
-  uint32_t bits = 0;
-  uint8_t bitsavailable = 0;
-
   // byte 1-22, channels 0..2047, limits not really clear (B
+  int16_t channels[SBUS_NORMAL_CHANS];
+  uint16_t values[SBUS_NORMAL_CHANS];
   for (int i=0; i<SBUS_NORMAL_CHANS; i++) {
-    int value = getChannelValue(module, i);
-
-    value =  value*8/10 + SBUS_CHAN_CENTER;
-    bits |= limit(0, value, 2047) << bitsavailable;
-    bitsavailable += SBUS_CHAN_BITS;
-    while (bitsavailable >= 8) {
-      sendByte(p_buf, (uint8_t) (bits & 0xff));
-      bits >>= 8;
-      bitsavailable -= 8;
-    }
+    channels[i] = getChannelValue(module, i);
   }
 
+  scaleChannels<SbusChannelScaling>(values, channels, nullptr, SBUS_NORMAL_CHANS);
+  p_buf = packChannels<SBUS_CHAN_BITS>(p_buf, values, SBUS_NORMAL_CHANS);
+
   // flags
   uint8_t flags=0;
   if (getChannelValue(module, 16) > 0)
@@ -24,3 +24,6 @@
 #include "hal/module_driver.h"
 
 extern const etx_proto_driver_t SBusDriver;
+
+// builds the SBUS frame of the module channels
+void setupPulsesSbus(uint8_t module, uint8_t*& p_buf);
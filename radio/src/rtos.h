@@ -32,6 +32,7 @@ extern "C++" {
 #if defined(SIMU)
   #include <pthread.h>
   #include <semaphore.h>
+  #include <time.h>
 
   #define SIMU_SLEEP_OR_EXIT_MS(x)       simuSleep(x)
   #define RTOS_MS_PER_TICK  1
@@ -39,7 +40,11 @@ extern "C++" {
   typedef pthread_t RTOS_TASK_HANDLE;
   typedef pthread_mutex_t RTOS_MUTEX_HANDLE;
 
-  typedef uint32_t RTOS_FLAG_HANDLE;
+  typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool set;
+  } RTOS_FLAG_HANDLE;
 
   typedef sem_t * RTOS_EVENT_HANDLE;
 
@@ -81,6 +86,44 @@ extern "C++" {
       pthread_mutex_unlock(&mutex);
   }
 
+  static inline void RTOS_CREATE_FLAG(RTOS_FLAG_HANDLE &flag)
+  {
+    pthread_mutex_init(&flag.mutex, nullptr);
+    pthread_cond_init(&flag.cond, nullptr);
+    flag.set = false;
+  }
+
+  static inline void RTOS_SET_FLAG(RTOS_FLAG_HANDLE &flag)
+  {
+    pthread_mutex_lock(&flag.mutex);
+    flag.set = true;
+    pthread_cond_signal(&flag.cond);
+    pthread_mutex_unlock(&flag.mutex);
+  }
+
+  // returns true if timeout
+  static inline bool RTOS_WAIT_FLAG(RTOS_FLAG_HANDLE &flag, uint32_t timeout)
+  {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += (timeout % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000;
+    }
+
+    pthread_mutex_lock(&flag.mutex);
+    while (!flag.set) {
+      if (pthread_cond_timedwait(&flag.cond, &flag.mutex, &deadline) != 0)
+        break;
+    }
+    bool timedOut = !flag.set;
+    flag.set = false;
+    pthread_mutex_unlock(&flag.mutex);
+    return timedOut;
+  }
+
   template<int SIZE>
   class TaskStack
   {
@@ -107,12 +150,18 @@ extern "C++" {
 
   #define TASK_FUNCTION(task)           void* task(void *)
 
-  inline void RTOS_CREATE_TASK(pthread_t &taskId, void * (*task)(void *), const char * name)
+  // see tasks/task_placement.cpp
+  void rtosTaskCreated(pthread_t taskId, const char * name, unsigned priority);
+  void rtosTaskDeleted(pthread_t taskId);
+
+  inline void RTOS_CREATE_TASK(pthread_t &taskId, void * (*task)(void *),
+                               const char * name, unsigned priority = 0)
   {
     pthread_create(&taskId, nullptr, task, nullptr);
 #ifdef __linux__
     pthread_setname_np(taskId, name);
 #endif
+    rtosTaskCreated(taskId, name, priority);
   }
 
   template <int SIZE>
@@ -121,8 +170,13 @@ extern "C++" {
                                unsigned size = 0, unsigned priority = 0)
   {
     (void)size;
-    (void)priority;
-    RTOS_CREATE_TASK(taskId, task, name);
+    RTOS_CREATE_TASK(taskId, task, name, priority);
+  }
+
+  inline void RTOS_JOIN_TASK(pthread_t &taskId)
+  {
+    rtosTaskDeleted(taskId);
+    pthread_join(taskId, nullptr);
   }
 
 #define TASK_RETURN()                 return nullptr
@@ -204,13 +258,20 @@ extern "C++" {
     vTaskDelay(x);
   }
 
-  static inline void _RTOS_CREATE_TASK(RTOS_TASK_HANDLE *h,
+  // see tasks/task_placement.cpp
+  void rtosTaskPlacement(const char * name, BaseType_t * core,
+                         UBaseType_t * priority, uint32_t stackDepth);
+  void rtosTaskCreated(TaskHandle_t handle, const char * name,
+                       UBaseType_t priority, BaseType_t core);
+
+static inline void _RTOS_CREATE_TASK_EX(RTOS_TASK_HANDLE *h,
                                        TaskFunction_t pxTaskCode,
                                        const char *name,
                                        StackType_t *const puxStackBuffer,
                                        const uint32_t ulStackDepth,
-                                       UBaseType_t uxPriority)
+                                       UBaseType_t uxPriority, BaseType_t xCoreID)
   {
+    rtosTaskPlacement(name, &xCoreID, &uxPriority, ulStackDepth);
 #ifndef ESP_PLATFORM
     h->rtos_handle = xTaskCreateStatic(
         pxTaskCode, name, ulStackDepth, 0, uxPriority,
@@ -218,26 +279,21 @@ extern "C++" {
 #else
     h->rtos_handle = xTaskCreateStaticPinnedToCore(
         pxTaskCode, name, ulStackDepth, 0, uxPriority,
-        puxStackBuffer, &h->task_struct, 1);
+        puxStackBuffer, &h->task_struct, xCoreID);
 #endif
+    rtosTaskCreated(h->rtos_handle, name, uxPriority, xCoreID);
   }
 
-static inline void _RTOS_CREATE_TASK_EX(RTOS_TASK_HANDLE *h,
+  static inline void _RTOS_CREATE_TASK(RTOS_TASK_HANDLE *h,
                                        TaskFunction_t pxTaskCode,
                                        const char *name,
                                        StackType_t *const puxStackBuffer,
                                        const uint32_t ulStackDepth,
-                                       UBaseType_t uxPriority, const BaseType_t xCoreID)
+                                       UBaseType_t uxPriority)
   {
-#ifndef ESP_PLATFORM
-    h->rtos_handle = xTaskCreateStatic(
-        pxTaskCode, name, ulStackDepth, 0, uxPriority,
-        puxStackBuffer, &h->task_struct);
-#else
-    h->rtos_handle = xTaskCreateStaticPinnedToCore(
-        pxTaskCode, name, ulStackDepth, 0, uxPriority,
-        puxStackBuffer, &h->task_struct, xCoreID);
-#endif
+    // not listed in the placement table: core 1 on ESP32
+    _RTOS_CREATE_TASK_EX(h, pxTaskCode, name, puxStackBuffer, ulStackDepth,
+                         uxPriority, 1);
   }
 
   #define RTOS_CREATE_TASK(h,task,name,stackStruct,stackSize,prio) \
@@ -291,14 +347,24 @@ static inline void _RTOS_CREATE_TASK_EX(RTOS_TASK_HANDLE *h,
     return getStackAvailable(&_main_stack_start, stackSize());
   }
 
-  //#define RTOS_CREATE_FLAG(flag)        flag = CoCreateFlag(false, false)
-  //#define RTOS_SET_FLAG(flag)           (void)CoSetFlag(flag)
-  //#define RTOS_CLEAR_FLAG(flag)         (void)CoClearFlag(flag)
+  static inline void _RTOS_CREATE_FLAG(RTOS_FLAG_HANDLE* flag)
+  {
+    flag->rtos_handle = xSemaphoreCreateBinaryStatic(&flag->mutex_struct);
+  }
+
+  #define RTOS_CREATE_FLAG(flag) _RTOS_CREATE_FLAG(&flag)
+
+  static inline void _RTOS_SET_FLAG(RTOS_FLAG_HANDLE* flag)
+  {
+    xSemaphoreGive(flag->rtos_handle);
+  }
+
+  #define RTOS_SET_FLAG(flag) _RTOS_SET_FLAG(&flag)
 
   // returns true if timeout
   static inline bool _RTOS_WAIT_FLAG(RTOS_FLAG_HANDLE* flag, uint32_t timeout)
   {
-    return xSemaphoreTake(flag->rtos_handle, timeout * RTOS_MS_PER_TICK)
+    return xSemaphoreTake(flag->rtos_handle, pdMS_TO_TICKS(timeout))
       == pdFALSE;
   }
 
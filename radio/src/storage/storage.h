@@ -59,8 +59,16 @@ void storageFlushCurrentModel();
 void postRadioSettingsLoad();
 void preModelLoad();
 void postModelLoad(bool alarms);
+void postModelLoadDeferred();
+bool isModelLoadPending();
 void checkExternalAntenna();
 
+// Model load stages profiling
+uint8_t getModelLoadStagesCount();
+const char * getModelLoadStageName(uint8_t idx);
+bool isModelLoadStageDeferred(uint8_t idx);
+uint32_t getModelLoadStageDuration(uint8_t idx);
+
 #if !defined(STORAGE_MODELSLIST)
 extern ModelHeader modelHeaders[MAX_MODELS];
 
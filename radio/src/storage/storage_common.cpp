@@ -153,7 +153,7 @@ static void sanitizeMixerLines()
   if (dirty) storageDirty(EE_MODEL);
 }
 
-void postModelLoad(bool alarms)
+static void sanitizeModelData(bool)
 {
 #if defined(COLORLCD)
   // Load 'date time' widget if slot is empty
@@ -193,12 +193,11 @@ void postModelLoad(bool alarms)
     storageDirty(EE_MODEL);
   }
 
-// fix #2552: reset rssiSource to default none (= 0)
-if(g_model.rssiSource) {
-  g_model.rssiSource = 0;
-
-  storageDirty(EE_MODEL);  
-}
+  // fix #2552: reset rssiSource to default none (= 0)
+  if (g_model.rssiSource) {
+    g_model.rssiSource = 0;
+    storageDirty(EE_MODEL);
+  }
 
 #if defined(PXX2)
   if (is_memclear(g_model.modelRegistrationID, PXX2_LEN_REGISTRATION_ID)) {
@@ -230,14 +229,20 @@ if(g_model.rssiSource) {
 #if defined(MULTIMODULE) && defined(MULTI_PROTOLIST)
   MultiRfProtocols::removeInstance(EXTERNAL_MODULE);
 #endif
+}
 
+static void resetModelState(bool)
+{
   AUDIO_FLUSH();
   flightReset(false);
 
   customFunctionsReset();
 
   restoreTimers();
+}
 
+static void resetTelemetrySensors(bool)
+{
   for (int i=0; i<MAX_TELEMETRY_SENSORS; i++) {
     TelemetrySensor & sensor = g_model.telemetrySensors[i];
     if (sensor.type == TELEM_TYPE_CALCULATED && sensor.persistent) {
@@ -248,38 +253,170 @@ if(g_model.rssiSource) {
       telemetryItems[i].timeout = TELEMETRY_SENSOR_TIMEOUT_UNAVAILABLE;
     }
   }
+}
 
+static void loadModelCurves(bool)
+{
   loadCurves();
+}
+
+static void loadModelMixerLines(bool)
+{
   sanitizeMixerLines();
+}
 
 #if defined(GUI)
+static void checkModelAlarms(bool alarms)
+{
   if (alarms) {
     checkAll();
     PLAY_MODEL_NAME();
   }
+}
 #endif
 
+static void restartPulses(bool)
+{
   // Mixer should only be restarted
   // if we are switching between models,
   // not on first boot (started later on)
   if (mixerTaskStarted()) {
     pulsesStart();
   }
+}
 
 #if defined(SDCARD)
+static void loadModelAudioFiles(bool)
+{
   referenceModelAudioFiles();
+}
 #endif
 
 #if defined(COLORLCD)
+static void loadModelScreens(bool)
+{
   loadCustomScreens();
+}
 #endif
 
+static void loadModelBitmap(bool)
+{
   LOAD_MODEL_BITMAP();
+}
+
+static void loadModelScripts(bool)
+{
   LUA_LOAD_MODEL_SCRIPTS();
+}
 
+static void sendModelFailsafe(bool)
+{
   SEND_FAILSAFE_1S();
 }
 
+struct ModelLoadStage {
+  const char * name;
+  void (*run)(bool alarms);
+  // deferred stages are not needed by the mixer: on a model switch
+  // they are run from perMain() once the model is live
+  bool deferred;
+};
+
+static const ModelLoadStage modelLoadStages[] = {
+  { "sanitize", sanitizeModelData, false },
+  { "reset", resetModelState, false },
+  { "telemetry", resetTelemetrySensors, false },
+  { "curves", loadModelCurves, false },
+  { "mixes", loadModelMixerLines, false },
+#if defined(GUI)
+  { "checks", checkModelAlarms, false },
+#endif
+  { "pulses", restartPulses, false },
+#if defined(SDCARD)
+  { "audio", loadModelAudioFiles, true },
+#endif
+#if defined(COLORLCD)
+  { "screens", loadModelScreens, true },
+#endif
+  { "bitmap", loadModelBitmap, true },
+  { "scripts", loadModelScripts, false },
+  { "failsafe", sendModelFailsafe, false },
+};
+
+static_assert(DIM(modelLoadStages) <= 32, "too many model load stages");
+
+static uint32_t modelLoadStageDurations[DIM(modelLoadStages)];
+static uint32_t modelLoadPendingStages = 0;
+
+static void runModelLoadStage(uint8_t idx, bool alarms)
+{
+  const ModelLoadStage & stage = modelLoadStages[idx];
+  uint32_t t0 = timersGetUsTick();
+  stage.run(alarms);
+  modelLoadStageDurations[idx] = timersGetUsTick() - t0;
+  TRACE("postModelLoad: %s %uus", stage.name,
+        (unsigned)modelLoadStageDurations[idx]);
+}
+
+void postModelLoad(bool alarms)
+{
+  modelLoadPendingStages = 0;
+
+  // on boot the mixer is started later on, after the whole
+  // model is loaded: the main view shows the model screens right away
+  bool defer = mixerTaskStarted();
+
+  for (uint8_t i = 0; i < DIM(modelLoadStages); i++) {
+    if (defer && modelLoadStages[i].deferred) {
+      modelLoadStageDurations[i] = 0;
+      modelLoadPendingStages |= (1u << i);
+    }
+    else {
+      runModelLoadStage(i, alarms);
+    }
+  }
+}
+
+void postModelLoadDeferred()
+{
+  if (!modelLoadPendingStages)
+    return;
+
+  // one stage per call, so that the UI keeps running in between
+  for (uint8_t i = 0; i < DIM(modelLoadStages); i++) {
+    if (modelLoadPendingStages & (1u << i)) {
+      modelLoadPendingStages &= ~(1u << i);
+      runModelLoadStage(i, false);
+      return;
+    }
+  }
+}
+
+bool isModelLoadPending()
+{
+  return modelLoadPendingStages != 0;
+}
+
+uint8_t getModelLoadStagesCount()
+{
+  return DIM(modelLoadStages);
+}
+
+const char * getModelLoadStageName(uint8_t idx)
+{
+  return modelLoadStages[idx].name;
+}
+
+bool isModelLoadStageDeferred(uint8_t idx)
+{
+  return modelLoadStages[idx].deferred;
+}
+
+uint32_t getModelLoadStageDuration(uint8_t idx)
+{
+  return modelLoadStageDurations[idx];
+}
+
 void storageFlushCurrentModel()
 {
   saveTimers();
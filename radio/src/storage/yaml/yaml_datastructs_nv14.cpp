@@ -385,6 +385,7 @@ static const struct YamlNode struct_RadioData[] = {
   YAML_UNSIGNED( "labelSingleSelect", 1 ),
   YAML_UNSIGNED( "labelMultiMode", 1 ),
   YAML_UNSIGNED( "favMultiMode", 1 ),
+  YAML_UNSIGNED( "adcFilter", 2 ),
   YAML_END
 };
 static const struct YamlNode struct_unsigned_8[] = {
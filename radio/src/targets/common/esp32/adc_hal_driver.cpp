@@ -189,5 +189,5 @@ void adruino_adc_init(void) {
   adcInit(&arduino_hal_adc_driver);
 
   // The stuff on ADC are not that critical, so start a task and read it in the background
-  RTOS_CREATE_TASK_EX(taskIdADC,task_adc,"ADC task",taskADC_stack,TASKADC_STACK_SIZE,TASKADC_PRIO,MIXER_TASK_CORE);
+  RTOS_CREATE_TASK(taskIdADC,task_adc,"ADC task",taskADC_stack,TASKADC_STACK_SIZE,TASKADC_PRIO);
 }
\ No newline at end of file
@@ -80,8 +80,11 @@ void esp32_rmt_rx_start(rmt_ctx_t *ctx, void *decoder_ctx, size_t rx_task_stack_
     ctx->rx_cfg.signal_range_min_ns = min_pulse_in_ns;
     ctx->rx_cfg.signal_range_max_ns = idle_threshold_in_ns;
     ctx->decoder_ctx = decoder_ctx;
+    BaseType_t core = tskNO_AFFINITY; // see boardTaskPlacements[]
+    UBaseType_t prio = 5; // TODO-MUFFIN priority
+    rtosTaskPlacement("esp32_rmt_rx_task", &core, &prio, ctx->stack_size);
     ctx->task_id = xTaskCreateStaticPinnedToCore(esp32_rmt_rx_task, "esp32_rmt_rx_task", ctx->stack_size,
-            ctx, 5, ctx->rmt_task_stack, &rx_task_buf, TRAINER_PPM_OUT_TASK_CORE); // TODO-MUFFIN priority
+            ctx, prio, ctx->rmt_task_stack, &rx_task_buf, core);
     rmt_rx_event_callbacks_t cbs = {
         .on_recv_done = rmt_rx_done_callback,
     };
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <string.h>
+
+#include "crc.h"
+#include "esprc_packet.h"
+#include "pulses/channels_packing.h"
+
+//
+// ESP-NOW RC link codec (TX and RX sides)
+//
+// The TX sends a full frame every ESPRC_FULL_FRAME_PERIOD frames and
+// until one of them is acked. In between, delta frames only carry the
+// channels which moved beyond ESPRC_DEADBAND from the last acked state,
+// plus the channels changed by the frames sent since the last ack (the
+// RX may or may not have received them).
+//
+// No platform dependency: also built by the host tests.
+//
+
+#define ESPRC_HEADER_LEN         (sizeof(EspRcHeader_t) + 1)
+#define ESPRC_CH_PACKED_LEN(n)   (((n) * ESPRC_CH_BITS + 7) / 8)
+
+inline uint16_t espRcChannelValue(int16_t channel)
+{
+  int32_t value = ESPRC_CH_CENTER + channel / 2;
+  return value < 0 ? 0 : (value > ESPRC_CH_MAX ? ESPRC_CH_MAX : value);
+}
+
+inline int16_t espRcChannelOutput(uint16_t value)
+{
+  return ((int16_t)value - ESPRC_CH_CENTER) * 2;
+}
+
+// CRC of a packet, computed with its header crc = 0
+inline uint16_t espRcCrc(uint8_t* data, uint8_t len)
+{
+  EspRcHeader_t* hdr = (EspRcHeader_t*)data;
+  uint16_t saved = hdr->crc;
+  hdr->crc = 0;
+  uint16_t crc = crc16(CRC_1021, data, len);
+  hdr->crc = saved;
+  return crc;
+}
+
+inline bool espRcCheckPacket(uint8_t* data, uint8_t len)
+{
+  if (len < sizeof(EspRcHeader_t)) return false;
+  EspRcHeader_t* hdr = (EspRcHeader_t*)data;
+  return hdr->version == ESPRC_VERSION && hdr->crc == espRcCrc(data, len);
+}
+
+inline void espRcSetHeader(uint8_t* data, uint8_t len, uint8_t type,
+                           uint8_t idx)
+{
+  EspRcHeader_t* hdr = (EspRcHeader_t*)data;
+  hdr->type = type;
+  hdr->version = ESPRC_VERSION;
+  hdr->idx = idx;
+  hdr->crc = 0;
+  hdr->crc = espRcCrc(data, len);
+}
+
+class EspRcEncoder
+{
+ public:
+  void reset()
+  {
+    synced = false;
+    framesSinceFull = 0;
+    dirtyMask = 0;
+  }
+
+  // Builds the next channels frame, returns its length
+  uint8_t encode(TXPacket_t* packet, const int16_t* channels, uint8_t count)
+  {
+    if (count > MAX_OUTPUT_CHANNELS) count = MAX_OUTPUT_CHANNELS;
+
+    uint16_t values[MAX_OUTPUT_CHANNELS];
+    for (uint8_t i = 0; i < count; i++) {
+      values[i] = espRcChannelValue(channels[i]);
+    }
+
+    if (count != this->count) {
+      this->count = count;
+      synced = false;
+    }
+
+    uint8_t* end;
+    uint8_t type;
+
+    if (!synced || framesSinceFull + 1 >= ESPRC_FULL_FRAME_PERIOD) {
+      type = ESPRC_DATA;
+      framesSinceFull = 0;
+      for (uint8_t i = 0; i < count; i++) {
+        if (values[i] != acked[i]) dirtyMask |= 1u << i;
+      }
+      memcpy(pending, values, count * sizeof(uint16_t));
+      end = packChannels<ESPRC_CH_BITS>(packet->data, values, count);
+    } else {
+      type = ESPRC_DELTA;
+      framesSinceFull++;
+      uint32_t mask = dirtyMask;
+      uint8_t changed = 0;
+      for (uint8_t i = 0; i < count; i++) {
+        int16_t diff = values[i] - acked[i];
+        if (diff > ESPRC_DEADBAND || diff < -ESPRC_DEADBAND ||
+            (mask & (1u << i))) {
+          mask |= 1u << i;
+          pending[i] = values[i];
+          values[changed++] = values[i];
+        } else {
+          pending[i] = acked[i];
+        }
+      }
+      dirtyMask = mask;
+      packet->data[0] = mask;
+      packet->data[1] = mask >> 8;
+      packet->data[2] = mask >> 16;
+      packet->data[3] = mask >> 24;
+      end = packChannels<ESPRC_CH_BITS>(&packet->data[4], values, changed);
+    }
+
+    packet->count = count;
+    uint8_t len = end - (uint8_t*)packet;
+    espRcSetHeader((uint8_t*)packet, len, type, ++idx);
+    lastType = type;
+    lastCrc = packet->hdr.crc;
+    return len;
+  }
+
+  // Bind frames carry the WiFi channel instead of the frame index
+  uint8_t encodeBind(TXPacket_t* packet, const int16_t* channels,
+                     uint8_t count, uint8_t wifiChannel)
+  {
+    reset();
+    uint8_t len = encode(packet, channels, count);
+    espRcSetHeader((uint8_t*)packet, len, ESPRC_BIND, wifiChannel);
+    return len;
+  }
+
+  // Returns true if the ack matches the last sent frame
+  bool ack(uint8_t idx, uint16_t crc)
+  {
+    if (idx != this->idx || crc != lastCrc) return false;
+    memcpy(acked, pending, count * sizeof(uint16_t));
+    dirtyMask = 0;
+    if (lastType == ESPRC_DATA) synced = true;
+    return true;
+  }
+
+  bool isSynced() const { return synced; }
+
+ protected:
+  uint16_t acked[MAX_OUTPUT_CHANNELS] = {0};
+  uint16_t pending[MAX_OUTPUT_CHANNELS] = {0};
+  uint32_t dirtyMask = 0;
+  uint16_t lastCrc = 0;
+  uint8_t lastType = ESPRC_DATA;
+  uint8_t count = 0;
+  uint8_t idx = 0;
+  uint8_t framesSinceFull = 0;
+  bool synced = false;
+};
+
+class EspRcDecoder
+{
+ public:
+  void reset() { synced = false; }
+
+  // Checks and applies a channels frame (ESPRC_DATA, ESPRC_DELTA or
+  // ESPRC_BIND), returns false if the frame has to be dropped
+  bool decode(uint8_t* data, uint8_t len)
+  {
+    if (len < ESPRC_HEADER_LEN || !espRcCheckPacket(data, len)) return false;
+
+    TXPacket_t* packet = (TXPacket_t*)data;
+    uint8_t count = packet->count;
+    if (count > MAX_OUTPUT_CHANNELS) return false;
+
+    switch (packet->hdr.type) {
+      case ESPRC_DATA:
+      case ESPRC_BIND:
+        if (len != ESPRC_HEADER_LEN + ESPRC_CH_PACKED_LEN(count)) return false;
+        unpackChannels<ESPRC_CH_BITS>(packet->data, values, count);
+        this->count = count;
+        synced = true;
+        break;
+
+      case ESPRC_DELTA:
+      {
+        if (!synced || count != this->count) return false;
+        uint32_t mask = packet->data[0] | (packet->data[1] << 8) |
+                        (packet->data[2] << 16) |
+                        ((uint32_t)packet->data[3] << 24);
+        if (count < 32 && (mask >> count)) return false;
+        uint8_t changed = __builtin_popcount(mask);
+        if (len != ESPRC_HEADER_LEN + 4 + ESPRC_CH_PACKED_LEN(changed))
+          return false;
+        uint16_t delta[MAX_OUTPUT_CHANNELS];
+        unpackChannels<ESPRC_CH_BITS>(&packet->data[4], delta, changed);
+        for (uint8_t i = 0, j = 0; i < count; i++) {
+          if (mask & (1u << i)) values[i] = delta[j++];
+        }
+        break;
+      }
+
+      default:
+        return false;
+    }
+
+    lastIdx = packet->hdr.idx;
+    lastCrc = packet->hdr.crc;
+    return true;
+  }
+
+  // Builds the ack of the last decoded frame, with telemetry items
+  uint8_t encodeAck(RXPacket_t* packet, const EspRcTelemetryItem_t* items,
+                    uint8_t count, uint8_t type = ESPRC_ACK)
+  {
+    if (count > ESPRC_MAX_TELEMETRY_ITEMS) count = ESPRC_MAX_TELEMETRY_ITEMS;
+    packet->ackCrc = lastCrc;
+    packet->count = count;
+    memcpy(packet->items, items, count * sizeof(EspRcTelemetryItem_t));
+    uint8_t len = ESPRC_RX_PACKET_LEN(count);
+    espRcSetHeader((uint8_t*)packet, len, type, lastIdx);
+    return len;
+  }
+
+  bool isSynced() const { return synced; }
+  uint8_t getCount() const { return count; }
+  uint16_t getValue(uint8_t index) const { return values[index]; }
+  int16_t getChannel(uint8_t index) const
+  {
+    return espRcChannelOutput(values[index]);
+  }
+
+ protected:
+  uint16_t values[MAX_OUTPUT_CHANNELS] = {0};
+  uint16_t lastCrc = 0;
+  uint8_t lastIdx = 0;
+  uint8_t count = 0;
+  bool synced = false;
+};
+
+// TX side: checks a packet from the RX (ESPRC_ACK or ESPRC_BIND),
+// returns the number of telemetry items or -1 if it has to be dropped
+inline int espRcCheckRxPacket(uint8_t* data, uint8_t len)
+{
+  if (len < ESPRC_RX_PACKET_LEN(0) || !espRcCheckPacket(data, len)) return -1;
+  RXPacket_t* packet = (RXPacket_t*)data;
+  if (packet->count > ESPRC_MAX_TELEMETRY_ITEMS ||
+      len != ESPRC_RX_PACKET_LEN(packet->count))
+    return -1;
+  return packet->count;
+}
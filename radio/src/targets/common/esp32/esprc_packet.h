@@ -1,31 +1,77 @@
 #ifndef ESPRC_PACKET_H
 #define ESPRC_PACKET_H
 
+#include <inttypes.h>
+
 #define ESPNOW_CHANNEL 1
 #if !defined(MAX_OUTPUT_CHANNELS)
 #define MAX_OUTPUT_CHANNELS  32
 #endif
 #define BIND_CH 1
 
+// Packet format version, receivers drop any other version
+#define ESPRC_VERSION 2
+
+// Channels are sent as 11 bits values: 1024 + channel / 2 (1us resolution)
+#define ESPRC_CH_BITS 11
+#define ESPRC_CH_CENTER 1024
+#define ESPRC_CH_MAX ((1 << ESPRC_CH_BITS) - 1)
+
+// A full frame is sent at least every ESPRC_FULL_FRAME_PERIOD frames,
+// in between only channels moving beyond ESPRC_DEADBAND are sent
+#define ESPRC_FULL_FRAME_PERIOD 10
+#define ESPRC_DEADBAND 1
+
+#define ESPRC_MAX_TELEMETRY_ITEMS 4
+
 enum PacketType_t {
-    DATA,
-    TELE,
-    BIND,
-    FSAFE,
-    ACK
+    ESPRC_DATA,   // full frame: all channels
+    ESPRC_TELE,
+    ESPRC_BIND,
+    ESPRC_FSAFE,
+    ESPRC_ACK,    // ack + telemetry from the receiver
+    ESPRC_DELTA,  // changed channels only
 };
 
 typedef struct {
-    PacketType_t type:4;
-    uint8_t idx:4;
-    uint16_t crc;
-    uint16_t ch[MAX_OUTPUT_CHANNELS];
+    uint8_t type:4;
+    uint8_t version:4;
+    uint8_t idx;
+    uint16_t crc;  // CRC of the whole packet, computed with crc = 0
+} __attribute__((packed)) EspRcHeader_t;
+
+// ESPRC_DATA / ESPRC_BIND:
+//   header, count, packed channels [0:count[
+// ESPRC_DELTA:
+//   header, count, channels mask (LE), packed channels in mask
+typedef struct {
+    EspRcHeader_t hdr;
+    uint8_t count;
+    uint8_t data[sizeof(uint32_t) + (MAX_OUTPUT_CHANNELS * ESPRC_CH_BITS + 7) / 8];
 } __attribute__((packed)) TXPacket_t;
 
+enum EspRcTelemetryId_t {
+    ESPRC_TELEM_RSSI = 1,  // RX side RSSI (dBm)
+    ESPRC_TELEM_RX_BATT,   // RX voltage (10mV)
+    ESPRC_TELEM_LOST,      // frames lost, as seen by the RX
+    ESPRC_TELEM_CUSTOM = 0x10,  // raw values from the RX sensors
+};
+
+typedef struct {
+    uint8_t id;
+    int32_t value;
+} __attribute__((packed)) EspRcTelemetryItem_t;
+
+// ESPRC_ACK / ESPRC_BIND:
+//   header (idx = acked frame), CRC of the acked frame, telemetry items
 typedef struct {
-    PacketType_t type:4;
-    uint8_t idx:4;
-    uint16_t crc;
+    EspRcHeader_t hdr;
+    uint16_t ackCrc;
+    uint8_t count;
+    EspRcTelemetryItem_t items[ESPRC_MAX_TELEMETRY_ITEMS];
 } __attribute__((packed)) RXPacket_t;
 
-#endif
\ No newline at end of file
+#define ESPRC_RX_PACKET_LEN(count) \
+    (sizeof(RXPacket_t) - sizeof(EspRcTelemetryItem_t) * (ESPRC_MAX_TELEMETRY_ITEMS - (count)))
+
+#endif
@@ -39,7 +39,7 @@ EXT_RAM_BSS_ATTR RTOS_DEFINE_STACK(taskIdPWRUP, taskPWRUP_stack, TASKPWRUP_STACK
 static void* BtPowerUPInit(uint8_t module)
 {
     if (NULL == pwrup_task_handle) {
-        RTOS_CREATE_TASK_EX(taskIdPWRUP,task_pwrup,"PowerUP task",taskPWRUP_stack,TASKPWRUP_STACK_SIZE,TASKPWRUP_PRIO,MENU_TASK_CORE);
+        RTOS_CREATE_TASK(taskIdPWRUP,task_pwrup,"PowerUP task",taskPWRUP_stack,TASKPWRUP_STACK_SIZE,TASKPWRUP_PRIO);
         pwrup_task_handle = taskIdPWRUP.rtos_handle;
     }
 
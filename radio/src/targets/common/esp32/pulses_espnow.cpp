@@ -29,18 +29,27 @@
 #include "esp_task.h"
 #include "esp_timer.h"
 #include "rom/ets_sys.h"
-#include "rom/crc.h"
 #include "esprc.h"
-#include "esprc_packet.h"
+#include "esprc_codec.h"
+#include "telemetry/espnow.h"
 
 #include "pulses_esp32.h"
 
 static const char *TAG = "tx.cpp";
 static xQueueHandle evtQueue;
 static esp_now_peer_info_t rxPeer;
-static DRAM_ATTR int16_t locChannelOutputs[MAX_OUTPUT_CHANNELS] = {0};
+typedef struct {
+    int16_t channels[MAX_OUTPUT_CHANNELS];
+    uint8_t count;
+} EspNowPulses_t;
+
+static DRAM_ATTR EspNowPulses_t locPulses = {{0}, 0};
 static QueueHandle_t xPulsesQueue;
-static volatile TXPacket_t packet;
+static QueueHandle_t xTelemetryQueue;
+static TXPacket_t packet;
+static uint8_t packetLen;
+static EspRcEncoder encoder;
+static bool volatile resync = true;
 static volatile LinkState_t linkState = IDLE;
 uint32_t volatile packSent = 0;
 uint32_t volatile packAckn = 0;
@@ -55,40 +64,45 @@ StaticTask_t espnowTaskBuffer;
 
 void packet_prepare()
 {
-    packet.type = DATA;
-    packet.idx++;
-    packet.crc = 0;
-    xQueueReceive( xPulsesQueue, locChannelOutputs,0);
-    memcpy((void *)packet.ch,locChannelOutputs,sizeof(packet.ch));
-    packet.crc = crc16_le(0, (uint8_t const *) &packet, sizeof(packet));
+    xQueueReceive( xPulsesQueue, &locPulses, 0);
+    if (resync) {
+        resync = false;
+        encoder.reset();
+    }
+    packetLen = encoder.encode(&packet, locPulses.channels, locPulses.count);
 }
 
 void bind_packet_prepare()
 {
-    packet.type = BIND;
-    packet.idx = g_model.moduleData[INTERNAL_MODULE].espnow.ch;
-    xQueueReceive( xPulsesQueue, locChannelOutputs,0);
-    memcpy((void *)packet.ch,locChannelOutputs,sizeof(packet.ch));
-    packet.crc = 0;
-    packet.crc = crc16_le(0, (uint8_t const *) &packet, sizeof(packet));
+    xQueueReceive( xPulsesQueue, &locPulses, 0);
+    packetLen = encoder.encodeBind(&packet, locPulses.channels, locPulses.count,
+                                   g_model.moduleData[INTERNAL_MODULE].espnow.ch);
+    resync = true;
 }
 
 inline void process_data(Event_t &evt) {
     if (!memcmp(evt.mac_addr,rxPeer.peer_addr, sizeof(ESPNOW_ETH_ALEN))) {
+        int items = espRcCheckRxPacket(evt.data, evt.data_len);
+        if (items < 0) {
+            ESP_LOGE(TAG, "Wrong RX packet: len %d", evt.data_len);
+            return;
+        }
         RXPacket_t *rp = (RXPacket_t *) evt.data;
-        switch (rp->type){
-        case ACK:
-            if (rp->idx == packet.idx && rp->crc == packet.crc){
+        switch (rp->hdr.type){
+        case ESPRC_ACK:
+            if (encoder.ack(rp->hdr.idx, rp->ackCrc)){
                 linkState = GOTACKN;
                 packAckn++;
             } else {
-                ESP_LOGE(TAG, "Ack failed: idx: %d vs %d, crc: %d vs %d, ", rp->idx , packet.idx, rp->crc , packet.crc);
+                ESP_LOGD(TAG, "Ack failed: idx: %d, crc: %d", rp->hdr.idx, rp->ackCrc);
+            }
+            // telemetry is drained by the mixer task (espNowSendPulses)
+            for (int i = 0; i < items; i++) {
+                xQueueSend(xTelemetryQueue, &rp->items[i], 0);
             }
-            break;
-        case TELE:
             break;
         default:
-            ESP_LOGE(TAG,"Incorrect RX packet type: %d",rp->type);
+            ESP_LOGE(TAG,"Incorrect RX packet type: %d",rp->hdr.type);
             break;
         }
     } else {
@@ -98,31 +112,26 @@ inline void process_data(Event_t &evt) {
 
 inline void process_bind(Event_t &evt) {
     RXPacket_t *rp = (RXPacket_t *) evt.data;
-    if (BIND == rp->type) {
-        uint16_t crc = rp->crc;
-        rp->crc = 0;
-        rp->crc = crc16_le(0, (uint8_t const *) rp, sizeof(RXPacket_t));
-        if(crc == rp->crc){
-            ESP_LOGW(TAG, "Got bind MAC: " MACSTR, MAC2STR(evt.mac_addr));
-            memcpy(rxPeer.peer_addr, evt.mac_addr, ESPNOW_ETH_ALEN);
-            memcpy(g_model.moduleData[INTERNAL_MODULE].espnow.rx_mac_addr, rxPeer.peer_addr,  ESPNOW_ETH_ALEN);
-            storageDirty(EE_MODEL);
-
-            rxPeer.channel = g_model.moduleData[INTERNAL_MODULE].espnow.ch;
-            rxPeer.ifidx = (wifi_interface_t)ESP_IF_WIFI_STA;
-            rxPeer.encrypt = false;
-            if (esp_now_is_peer_exist(rxPeer.peer_addr) == false) {
-                esp_now_add_peer(&rxPeer);
-            } else {
-                esp_now_mod_peer(&rxPeer);
-            }
-            esp_wifi_set_channel(g_model.moduleData[INTERNAL_MODULE].espnow.ch, (wifi_second_chan_t)0);
-            txState = PULSES;
+    if (espRcCheckRxPacket(evt.data, evt.data_len) < 0) {
+        ESP_LOGE(TAG,"RX packet CRC error");
+    } else if (ESPRC_BIND == rp->hdr.type) {
+        ESP_LOGW(TAG, "Got bind MAC: " MACSTR, MAC2STR(evt.mac_addr));
+        memcpy(rxPeer.peer_addr, evt.mac_addr, ESPNOW_ETH_ALEN);
+        memcpy(g_model.moduleData[INTERNAL_MODULE].espnow.rx_mac_addr, rxPeer.peer_addr,  ESPNOW_ETH_ALEN);
+        storageDirty(EE_MODEL);
+
+        rxPeer.channel = g_model.moduleData[INTERNAL_MODULE].espnow.ch;
+        rxPeer.ifidx = (wifi_interface_t)ESP_IF_WIFI_STA;
+        rxPeer.encrypt = false;
+        if (esp_now_is_peer_exist(rxPeer.peer_addr) == false) {
+            esp_now_add_peer(&rxPeer);
         } else {
-            ESP_LOGE(TAG,"RX packet CRC error: %d vs %d", crc, rp->crc);
+            esp_now_mod_peer(&rxPeer);
         }
+        esp_wifi_set_channel(g_model.moduleData[INTERNAL_MODULE].espnow.ch, (wifi_second_chan_t)0);
+        txState = PULSES;
     } else {
-        ESP_LOGE(TAG,"Incorrect RX packet type: %d", rp->type);
+        ESP_LOGE(TAG,"Incorrect RX packet type: %d", rp->hdr.type);
     }
 }
 
@@ -143,19 +152,15 @@ static void tx_task(void *pvParameter)
                 }
                 break;
             case RX:
-                if ( sizeof(RXPacket_t) == evt.data_len ){
-                    switch (txState) {
-                    case PULSES:
-                        process_data(evt);
-                        break;
-                    case BIND:
-                        process_bind(evt);
-                        break;
-                    default:
-                        break;
-                    }
-                } else {
-                    ESP_LOGE(TAG,"Wrong RX packet size.");
+                switch (txState) {
+                case PULSES:
+                    process_data(evt);
+                    break;
+                case BINDING:
+                    process_bind(evt);
+                    break;
+                default:
+                    break;
                 }
                 free(evt.data);
                 break;
@@ -172,7 +177,7 @@ static void tx_task(void *pvParameter)
                 last_send_time = curr_time;
                 if( linkState != QUEUED){
                     packet_prepare();
-                    esp_err_t ret = esp_now_send(rxPeer.peer_addr, (const uint8_t *) &packet, sizeof(packet));
+                    esp_err_t ret = esp_now_send(rxPeer.peer_addr, (const uint8_t *) &packet, packetLen);
                     if ( ret != ESP_OK) {
                         ESP_LOGE(TAG, "Send txPacket error: %s", esp_err_to_name(ret));
                     } else {
@@ -185,7 +190,7 @@ static void tx_task(void *pvParameter)
                 if( linkState != QUEUED){
                     ESP_LOGD(TAG, "Sending bind packet: linkState: %d", linkState);
                     bind_packet_prepare();
-                    esp_err_t ret = esp_now_send(broadcast_mac, (const uint8_t *) &packet, sizeof(packet));
+                    esp_err_t ret = esp_now_send(broadcast_mac, (const uint8_t *) &packet, packetLen);
                     if ( ret != ESP_OK) {
                         ESP_LOGE(TAG, "Send txPacket error: %s", esp_err_to_name(ret));
                     } else {
@@ -253,11 +258,18 @@ esp_err_t initTX(){
     }
   
     if(xPulsesQueue == NULL) {
-        xPulsesQueue=xQueueCreate( 1, sizeof( locChannelOutputs ) );
+        xPulsesQueue=xQueueCreate( 1, sizeof( locPulses ) );
         if(NULL == xPulsesQueue){
             ESP_LOGE(TAG, "Failed to create queue: xPulsesQueue!");
         }
     }
+
+    if(xTelemetryQueue == NULL) {
+        xTelemetryQueue=xQueueCreate( 2 * ESPRC_MAX_TELEMETRY_ITEMS, sizeof( EspRcTelemetryItem_t ) );
+        if(NULL == xTelemetryQueue){
+            ESP_LOGE(TAG, "Failed to create queue: xTelemetryQueue!");
+        }
+    }
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_now_init());
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_now_register_send_cb(send_cb));
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_now_register_recv_cb(recv_cb));
@@ -272,11 +284,17 @@ esp_err_t initTX(){
     ESP_ERROR_CHECK_WITHOUT_ABORT(esp_now_add_peer(&rxPeer));
 
     linkState = IDLE;
+    resync = true;
     pulsesON = true;
     txState = PULSES;
-    if (NULL == xTaskCreateStaticPinnedToCore(tx_task, "tx_task", ESPNOW_STACK_SIZE, NULL, ESP_TASK_PRIO_MAX-6, espnow_stack, &espnowTaskBuffer, PULSES_TASK_CORE)) {
+    BaseType_t core = tskNO_AFFINITY; // see boardTaskPlacements[]
+    UBaseType_t prio = ESP_TASK_PRIO_MAX-6;
+    rtosTaskPlacement("tx_task", &core, &prio, ESPNOW_STACK_SIZE);
+    TaskHandle_t handle = xTaskCreateStaticPinnedToCore(tx_task, "tx_task", ESPNOW_STACK_SIZE, NULL, prio, espnow_stack, &espnowTaskBuffer, core);
+    if (NULL == handle) {
         ESP_LOGE(TAG, "Failed to create tx_task");
     }
+    rtosTaskCreated(handle, "tx_task", prio, core);
     return ESP_OK;
 }
 
@@ -303,6 +321,7 @@ bool is_binding_espnow(){
 
 void resume_espnow(){
     ESP_LOGI(TAG, "Resume ESP-NOW");
+    resync = true;
     txState = PULSES;
 }
 
@@ -333,7 +352,15 @@ static void espNowSetupPulses(void* context, int16_t* channels, uint8_t nChannel
 static void espNowSendPulses(void* context, uint8_t* buffer, int16_t* channels, uint8_t nChannels)
 {
     if (xPulsesQueue){
-        xQueueOverwrite( xPulsesQueue, channelOutputs );
+        static EspNowPulses_t pulses;
+        pulses.count = min<uint8_t>(nChannels, MAX_OUTPUT_CHANNELS);
+        memcpy(pulses.channels, channels, pulses.count * sizeof(int16_t));
+        xQueueOverwrite( xPulsesQueue, &pulses );
+    }
+
+    EspRcTelemetryItem_t item;
+    while (xTelemetryQueue && xQueueReceive(xTelemetryQueue, &item, 0) == pdTRUE) {
+        processEspNowTelemetry(item.id, item.value);
     }
 }
 
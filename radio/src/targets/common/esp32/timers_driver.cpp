@@ -62,14 +62,13 @@ static void task5ms(void * pdata) {
 #define TIM5MS_STACK_SIZE (1024 * 3)
 RTOS_TASK_HANDLE taskId5ms;
 RTOS_DEFINE_STACK(taskId5ms, task5ms_stack, TIM5MS_STACK_SIZE);
-#define TMR_5MS_CORE 1 // TODO
 
 // Start TIMER at 2000000Hz
 void init2MhzTimer()
 {
     sem5ms = xSemaphoreCreateBinary();
 
-    RTOS_CREATE_TASK_EX(taskId5ms,task5ms,"5ms timer",task5ms_stack,TIM5MS_STACK_SIZE,5,TMR_5MS_CORE);  // TODO-feather priority
+    RTOS_CREATE_TASK(taskId5ms,task5ms,"5ms timer",task5ms_stack,TIM5MS_STACK_SIZE,5);  // TODO-feather priority
 
     gptimer_config_t timer_config = {
         .clk_src = GPTIMER_CLK_SRC_DEFAULT,
@@ -152,5 +152,5 @@ void ads1015_adc_init(void) {
     adcInit(&ads1015_hal_adc_driver);
 
     // The stuff (POTs, VBATT) on ADS1015 are not that critical, so start a task and read it in the background
-    RTOS_CREATE_TASK_EX(taskIdADC,task_adc,"ADC task",taskADC_stack,TASKADC_STACK_SIZE,TASKADC_PRIO,MIXER_TASK_CORE);
+    RTOS_CREATE_TASK(taskIdADC,task_adc,"ADC task",taskADC_stack,TASKADC_STACK_SIZE,TASKADC_PRIO);
 }
\ No newline at end of file
@@ -19,6 +19,9 @@
  */
 
 #include "opentx.h"
+#include "tasks.h"
+#include "tasks/task_placement.h"
+#include "esp_task.h"
 
 /* Littlevgl specific */
 #ifdef LV_LVGL_H_INCLUDE_SIMPLE
@@ -41,6 +44,21 @@
 
 extern void ads1015_adc_init(void);
 
+// Tasks not listed keep the core / priority given at creation
+const TaskPlacement boardTaskPlacements[] = {
+  // name                core           priority                stack
+  { "mixer",             0,             MIXER_TASK_PRIO,        MIXER_STACK_SIZE },
+  { "tx_task",           0,             ESP_TASK_PRIO_MAX - 6,  0 },
+  { "ADC task",          0,             5,                      0 },
+  { "esp32_rmt_rx_task", 0,             0,                      0 },
+  { "menus",             1,             MENUS_TASK_PRIO,        MENUS_STACK_SIZE },
+  { "audio",             1,             AUDIO_TASK_PRIO,        AUDIO_STACK_SIZE },
+  { "5ms timer",         1,             5,                      0 },
+  { "PowerUP task",      1,             0,                      0 },
+  { "CLI",               1,             CLI_TASK_PRIO,          CLI_STACK_SIZE },
+  { nullptr,             TASK_ANY_CORE, 0,                      0 }
+};
+
 i2c_master_bus_handle_t i2c_0_bus_handle;
 i2c_master_bus_handle_t lvgl_i2c_bus_handle;
 i2c_master_bus_handle_t rtc_i2c_bus_handle;
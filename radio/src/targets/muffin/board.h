@@ -41,12 +41,9 @@
 void boardInit();
 void boardOff();
 
-// TODO-Muffin cleanup
-#define TRAINER_PPM_OUT_TASK_CORE 0
-#define MIXER_TASK_CORE 0
-#define PULSES_TASK_CORE 0
-#define MENU_TASK_CORE 1
-#define AUDIO_TASK_CORE 1
+// Tasks placement (cores are only given by boardTaskPlacements[] in board.cpp):
+// mixer, pulses and their inputs on core 0, UI / Lua / audio / SD on core 1
+#define BOARD_TASK_PLACEMENT
 
 /*
 From Kconfig
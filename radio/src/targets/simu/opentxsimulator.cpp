@@ -22,6 +22,7 @@
 #include "opentxsimulator.h"
 #include "opentx.h"
 #include "simulcd.h"
+#include "simuoutputs.h"
 #include "switches.h"
 
 #include "hal/adc_driver.h"
@@ -34,7 +35,8 @@
   #define MAX_LOGICAL_SWITCHES    NUM_CSW
 #endif
 
-#define GET_SWITCH_BOOL(sw__)    getSwitch((sw__), 0);
+// outputs are reported when the mixer publishes changes, at most every
+#define OUTPUTS_REFRESH_PERIOD   50  // ms
 
 #define ETXS_DBG    qDebug() << "(" << simuTimerMicros() << "us)"
 
@@ -78,7 +80,9 @@ OpenTxSimulator::OpenTxSimulator() :
   SimulatorInterface(),
   m_timer10ms(nullptr),
   m_resetOutputsData(true),
-  m_stopRequested(false)
+  m_stopRequested(false),
+  m_lcdChangePending(false),
+  m_lcdBacklight(false)
 {
   tracebackDevices.clear();
   traceCallback = firmwareTraceCb;
@@ -152,6 +156,7 @@ void OpenTxSimulator::start(const char * filename, bool tests)
   QMutexLocker slckr(&m_mtxSettings);
   startEepromThread(filename);
   startAudioThread(volumeGain);
+  simuOutputsSetListener(&OpenTxSimulator::outputsPublished, this);
   simuStart(tests, simuSdDirectory.toLatin1().constData(), simuSettingsDirectory.toLatin1().constData());
 
   emit started();
@@ -168,6 +173,7 @@ void OpenTxSimulator::stop()
 
   QMutexLocker lckr(&m_mtxSimuMain);
   simuStop();
+  simuOutputsSetListener(nullptr, nullptr);
   stopAudioThread();
   stopEepromThread();
 
@@ -210,6 +216,17 @@ uint8_t * OpenTxSimulator::getLcd()
   return (uint8_t *)simuLcdBuf;
 }
 
+// Areas changed since the previous call, the next lcdChange() signal
+// is only emitted once they have been read
+QVector<QRect> OpenTxSimulator::getLcdDirtyRects()
+{
+  QMutexLocker lckr(&m_mtxLcd);
+  QVector<QRect> rects;
+  rects.swap(m_lcdDirtyRects);
+  m_lcdChangePending = false;
+  return rects;
+}
+
 void OpenTxSimulator::setAnalogValue(uint8_t index, int16_t value)
 {
   static int dim = DIM(g_anas);
@@ -520,7 +537,7 @@ void OpenTxSimulator::run()
 
   checkLcdChanged();
 
-  if (!(loops % 5)) {
+  if (m_resetOutputsData) {
     checkOutputsChanged();
   }
 
@@ -543,79 +560,117 @@ void OpenTxSimulator::setStopRequested(bool stop)
 
 bool OpenTxSimulator::checkLcdChanged()
 {
-  if (simuLcdRefresh) {
-    simuLcdRefresh = false;
-    emit lcdChange(isBacklightEnabled());
-    return true;
+  bool backlight = isBacklightEnabled();
+  bool backlightChanged = (backlight != m_lcdBacklight);
+  if (!simuLcdRefresh && !backlightChanged)
+    return false;
+
+  simuLcdRefresh = false;
+  m_lcdBacklight = backlight;
+
+  SimuLcdRect rects[SIMU_LCD_MAX_DIRTY_RECTS];
+  uint8_t count = simuLcdGetDirtyRects(rects);
+
+  {
+    QMutexLocker lckr(&m_mtxLcd);
+    for (uint8_t i = 0; i < count; i++) {
+      QRect rect(rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+      if (m_lcdDirtyRects.size() < SIMU_LCD_MAX_DIRTY_RECTS)
+        m_lcdDirtyRects.append(rect);
+      else
+        m_lcdDirtyRects.last() = m_lcdDirtyRects.last().united(rect);
+    }
+    // the UI has not read the previous changes yet: it will get these
+    // ones as well
+    if (m_lcdChangePending && !backlightChanged)
+      return false;
+    m_lcdChangePending = true;
   }
-  return false;
+
+  emit lcdChange(backlight);
+  return true;
 }
 
+// Mixer task side: hands the changes over to the simulator thread
+void OpenTxSimulator::outputsPublished(void * ctx)
+{
+  QMetaObject::invokeMethod(static_cast<OpenTxSimulator *>(ctx),
+                            "onOutputsPublished", Qt::QueuedConnection);
+}
+
+void OpenTxSimulator::onOutputsPublished()
+{
+  qint64 wait = OUTPUTS_REFRESH_PERIOD - m_outputsRefresh.elapsed();
+  if (m_outputsRefresh.isValid() && wait > 0)
+    QTimer::singleShot(wait, this, &OpenTxSimulator::checkOutputsChanged);
+  else
+    checkOutputsChanged();
+}
+
+// Only the outputs flagged by the mixer task since the last call are
+// emitted (all of them after a reset)
 void OpenTxSimulator::checkOutputsChanged()
 {
-  static TxOutputs lastOutputs;
-  static size_t chansDim = DIM(channelOutputs);
   const static int16_t limit = 512 * 2;
+  SimuOutputs outputs;
+  uint32_t changed[SIMU_OUTPUT_WORDS];
   qint32 tmpVal;
-  uint8_t i, idx;
-  const uint8_t phase = getFlightMode();  // opentx.cpp
-
-  for (i=0; i < chansDim; i++) {
-    if (lastOutputs.chans[i] != channelOutputs[i] || m_resetOutputsData) {
-      emit channelOutValueChange(i, channelOutputs[i], (g_model.extendedLimits ? limit * LIMIT_EXT_PERCENT / 100 : limit));
-      emit outputValueChange(OUTPUT_SRC_CHAN_OUT, i, channelOutputs[i]);
-      lastOutputs.chans[i] = channelOutputs[i];
+  unsigned i;
+
+  m_outputsRefresh.start();
+  if (!simuOutputsConsume(outputs, changed) && !m_resetOutputsData)
+    return;
+
+  if (m_resetOutputsData)
+    memset(changed, 0xFF, sizeof(changed));
+
+  for (i=0; i < MAX_OUTPUT_CHANNELS; i++) {
+    if (simuOutputChanged(changed, SIMU_OUTPUT_CHAN + i)) {
+      emit channelOutValueChange(i, outputs.chans[i], (g_model.extendedLimits ? limit * LIMIT_EXT_PERCENT / 100 : limit));
+      emit outputValueChange(OUTPUT_SRC_CHAN_OUT, i, outputs.chans[i]);
     }
-    if (lastOutputs.ex_chans[i] != ex_chans[i] || m_resetOutputsData) {
-      emit channelMixValueChange(i, ex_chans[i], limit * 2);
-      emit outputValueChange(OUTPUT_SRC_CHAN_MIX, i, ex_chans[i]);
-      lastOutputs.ex_chans[i] = ex_chans[i];
+    if (simuOutputChanged(changed, SIMU_OUTPUT_MIX + i)) {
+      emit channelMixValueChange(i, outputs.mixes[i], limit * 2);
+      emit outputValueChange(OUTPUT_SRC_CHAN_MIX, i, outputs.mixes[i]);
     }
   }
 
   for (i=0; i < MAX_LOGICAL_SWITCHES; i++) {
-    tmpVal = (qint32)GET_SWITCH_BOOL(SWSRC_FIRST_LOGICAL_SWITCH+i);
-    if (lastOutputs.vsw[i] != (bool)tmpVal || m_resetOutputsData) {
+    if (simuOutputChanged(changed, SIMU_OUTPUT_LOGICAL_SWITCH + i)) {
+      tmpVal = simuLogicalSwitchState(outputs, i);
       emit virtualSwValueChange(i, tmpVal);
       emit outputValueChange(OUTPUT_SRC_VIRTUAL_SW, i, tmpVal);
-      lastOutputs.vsw[i] = tmpVal;
     }
   }
 
-  for (i=0; i < Board::TRIM_AXIS_COUNT; i++) {
-    idx = inputMappingConvertMode(i);
-    tmpVal = getTrimValue(getTrimFlightMode(phase, idx), idx);
-    if (lastOutputs.trims[i] != tmpVal || m_resetOutputsData) {
-      emit trimValueChange(i, tmpVal);
-      emit outputValueChange(OUTPUT_SRC_TRIM_VALUE, i, tmpVal);
-      lastOutputs.trims[i] = tmpVal;
+  for (i=0; i < Board::TRIM_AXIS_COUNT && i < MAX_TRIMS; i++) {
+    if (simuOutputChanged(changed, SIMU_OUTPUT_TRIM + i)) {
+      emit trimValueChange(i, outputs.trims[i]);
+      emit outputValueChange(OUTPUT_SRC_TRIM_VALUE, i, outputs.trims[i]);
     }
   }
 
-  tmpVal = g_model.extendedTrims ? TRIM_EXTENDED_MAX : TRIM_MAX;
-  if (lastOutputs.trimRange != tmpVal || m_resetOutputsData) {
+  if (simuOutputChanged(changed, SIMU_OUTPUT_TRIM_RANGE)) {
+    tmpVal = outputs.trimRange;
     emit trimRangeChange(Board::TRIM_AXIS_COUNT, -tmpVal, tmpVal);
     emit outputValueChange(OUTPUT_SRC_TRIM_RANGE, Board::TRIM_AXIS_COUNT, tmpVal);
-    lastOutputs.trimRange = tmpVal;
   }
 
-  if (lastOutputs.phase != phase || m_resetOutputsData) {
-    emit phaseChanged(phase, getCurrentPhaseName());
-    emit outputValueChange(OUTPUT_SRC_PHASE, 0, qint16(phase));
-    lastOutputs.phase = phase;
+  if (simuOutputChanged(changed, SIMU_OUTPUT_PHASE)) {
+    emit phaseChanged(outputs.phase, getPhaseDisplayName(outputs.phase));
+    emit outputValueChange(OUTPUT_SRC_PHASE, 0, qint16(outputs.phase));
   }
 
 #if defined(GVAR_VALUE) && defined(GVARS)
   gVarMode_t gvar;
   for (uint8_t gv=0; gv < MAX_GVARS; gv++) {
-    gvar.prec = g_model.gvars[gv].prec;
-    gvar.unit = g_model.gvars[gv].unit;
+    gvar.prec = outputs.gvarsPrec[gv];
+    gvar.unit = outputs.gvarsUnit[gv];
     for (uint8_t fm=0; fm < MAX_FLIGHT_MODES; fm++) {
-      gvar.mode = fm;
-      gvar.value = (int16_t)GVAR_VALUE(gv, getGVarFlightMode(fm, gv));
-      tmpVal = gvar;
-      if (lastOutputs.gvars[fm][gv] != tmpVal || m_resetOutputsData) {
-        lastOutputs.gvars[fm][gv] = tmpVal;
+      if (simuOutputChanged(changed, SIMU_OUTPUT_GVAR + fm * MAX_GVARS + gv)) {
+        gvar.mode = fm;
+        gvar.value = outputs.gvars[fm][gv];
+        tmpVal = gvar;
         emit gVarValueChange(gv, tmpVal);
         emit outputValueChange(OUTPUT_SRC_GVAR, gv, tmpVal);
       }
@@ -638,9 +693,8 @@ const char * OpenTxSimulator::getPhaseName(unsigned int phase)
   return buff;
 }
 
-const QString OpenTxSimulator::getCurrentPhaseName()
+const QString OpenTxSimulator::getPhaseDisplayName(unsigned int phase)
 {
-  unsigned phase = getFlightMode();
   QString name(getPhaseName(phase));
   if (name.isEmpty())
     name = QString::number(phase);
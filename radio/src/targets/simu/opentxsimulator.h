@@ -24,8 +24,10 @@
 
 #include "simulatorinterface.h"
 
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QObject>
+#include <QRect>
 #include <QTimer>
 
 #if defined __GNUC__
@@ -53,6 +55,7 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
     virtual bool isRunning();
     virtual void readRadioData(QByteArray & dest);
     virtual uint8_t * getLcd();
+    virtual QVector<QRect> getLcdDirtyRects();
     virtual uint8_t getSensorInstance(uint16_t id, uint8_t defaultValue = 0);
     virtual uint16_t getSensorRatio(uint16_t id);
     virtual const int getCapability(Capability cap);
@@ -85,6 +88,7 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
 
   protected slots:
     void run();
+    void onOutputsPublished();
 
   protected:
 
@@ -92,9 +96,10 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
     void setStopRequested(bool stop);
     bool checkLcdChanged();
     void checkOutputsChanged();
+    static void outputsPublished(void * ctx);
     uint8_t getStickMode();
     const char * getPhaseName(unsigned int phase);
-    const QString getCurrentPhaseName();
+    const QString getPhaseDisplayName(unsigned int phase);
     const char * getError();
     const int voltageToAdc(const int volts);
 
@@ -106,9 +111,14 @@ class DLLEXPORT OpenTxSimulator : public SimulatorInterface
     QMutex m_mtxRadioData;
     QMutex m_mtxSettings;
     QMutex m_mtxTbDevices;
+    QMutex m_mtxLcd;
+    QVector<QRect> m_lcdDirtyRects;
+    QElapsedTimer m_outputsRefresh;
     int volumeGain;
     bool m_resetOutputsData;
     bool m_stopRequested;
+    bool m_lcdChangePending;
+    bool m_lcdBacklight;
 
 };
 
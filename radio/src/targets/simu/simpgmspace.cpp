@@ -28,6 +28,7 @@
 
 #include "opentx.h"
 #include "simulcd.h"
+#include "tasks.h"
 
 #include "hal/adc_driver.h"
 #include "hal/rotary_encoder.h"
@@ -242,8 +243,8 @@ void simuStop()
 
   simu_shutdown = true;
 
-  pthread_join(mixerTaskId, nullptr);
-  pthread_join(menusTaskId, nullptr);
+  RTOS_JOIN_TASK(mixerTaskId);
+  RTOS_JOIN_TASK(menusTaskId);
 
   simu_running = false;
 }
@@ -407,12 +408,13 @@ void startAudioThread(int volumeGain)
 #ifdef __linux__
   pthread_setname_np(simuAudio.threadPid, "audio");
 #endif
+  rtosTaskCreated(simuAudio.threadPid, "audio", AUDIO_TASK_PRIO);
 }
 
 void stopAudioThread()
 {
   simuAudio.threadRunning = false;
-  pthread_join(simuAudio.threadPid, nullptr);
+  RTOS_JOIN_TASK(simuAudio.threadPid);
 }
 #endif // #if defined(SIMU_AUDIO)
 
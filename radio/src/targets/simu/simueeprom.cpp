@@ -164,7 +164,7 @@ void stopEepromThread()
 {
   eeprom_thread_running = false;
   sem_post(eeprom_write_sem);
-  pthread_join(eeprom_thread_pid, nullptr);
+  RTOS_JOIN_TASK(eeprom_thread_pid);
 
 #ifdef __APPLE__
   sem_close(eeprom_write_sem);
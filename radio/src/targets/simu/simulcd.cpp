@@ -23,10 +23,46 @@
 #include "simulcd.h"
 #include "rtos.h"
 #include <string.h>
+#include <algorithm>
+#include <mutex>
 #include <utility>
 
 bool simuLcdRefresh = false;
 
+static std::mutex dirtyRectsMutex;
+static SimuLcdRect dirtyRects[SIMU_LCD_MAX_DIRTY_RECTS];
+static uint8_t dirtyRectsCount = 0;
+
+void simuLcdAddDirtyRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  std::lock_guard<std::mutex> lock(dirtyRectsMutex);
+
+  if (dirtyRectsCount < SIMU_LCD_MAX_DIRTY_RECTS) {
+    dirtyRects[dirtyRectsCount++] = {x, y, w, h};
+    return;
+  }
+
+  int16_t x1 = x, y1 = y, x2 = x + w, y2 = y + h;
+  for (uint8_t i = 0; i < dirtyRectsCount; i++) {
+    const SimuLcdRect& rect = dirtyRects[i];
+    x1 = std::min(x1, rect.x);
+    y1 = std::min(y1, rect.y);
+    x2 = std::max<int16_t>(x2, rect.x + rect.w);
+    y2 = std::max<int16_t>(y2, rect.y + rect.h);
+  }
+  dirtyRects[0] = {x1, y1, (int16_t)(x2 - x1), (int16_t)(y2 - y1)};
+  dirtyRectsCount = 1;
+}
+
+uint8_t simuLcdGetDirtyRects(SimuLcdRect * rects)
+{
+  std::lock_guard<std::mutex> lock(dirtyRectsMutex);
+  uint8_t count = dirtyRectsCount;
+  memcpy(rects, dirtyRects, count * sizeof(SimuLcdRect));
+  dirtyRectsCount = 0;
+  return count;
+}
+
 void toplcdOff() {}
 
 #if !defined(lcdOff)
@@ -41,10 +77,15 @@ void lcdInit() {}
 
 void lcdRefresh()
 {
-  // Mark screen dirty for async refresh
-  simuLcdRefresh = true;
+  // most refreshes draw the same screen again
+  if (!memcmp(simuLcdBuf, displayBuf, DISPLAY_BUFFER_SIZE * sizeof(pixel_t)))
+    return;
 
   memcpy(simuLcdBuf, displayBuf, DISPLAY_BUFFER_SIZE * sizeof(pixel_t));
+  simuLcdAddDirtyRect(0, 0, LCD_W, LCD_H);
+
+  // Mark screen dirty for async refresh
+  simuLcdRefresh = true;
 }
 
 #else
@@ -138,6 +179,24 @@ static void _copy_area(uint16_t* dst, uint16_t* src, const rect_t& copy_area)
 pixel_t* simuLcdBuf = nullptr;
 #endif
 
+// Areas redrawn by LVGL, the whole screen when drawing outside of a
+// LVGL refresh (lcdRefresh())
+static void simuLcdAddInvalidatedAreas()
+{
+  lv_disp_t* disp = _lv_refr_get_disp_refreshing();
+  if (!disp || disp->inv_p == 0) {
+    simuLcdAddDirtyRect(0, 0, LCD_W, LCD_H);
+    return;
+  }
+
+  for (int i = 0; i < disp->inv_p; i++) {
+    if (disp->inv_area_joined[i]) continue;
+    const lv_area_t& area = disp->inv_areas[i];
+    simuLcdAddDirtyRect(area.x1, area.y1, lv_area_get_width(&area),
+                        lv_area_get_height(&area));
+  }
+}
+
 static void simuRefreshLcd(lv_disp_drv_t * disp_drv, uint16_t *buffer, const rect_t& copy_area)
 {
 #if !defined(LCD_VERTICAL_INVERT) // rename into "Use direct mode" ???
@@ -145,6 +204,7 @@ static void simuRefreshLcd(lv_disp_drv_t * disp_drv, uint16_t *buffer, const rec
 
   // simply set LVGL's buffer as our current frame buffer
   simuLcdBuf = buffer;
+  simuLcdAddInvalidatedAreas();
 
   // Trigger async refresh
   simuLcdRefresh = true;
@@ -163,6 +223,7 @@ static void simuRefreshLcd(lv_disp_drv_t * disp_drv, uint16_t *buffer, const rec
       simuLcdBuf = _LCD_BUF1;
       simuLcdBackBuf = _LCD_BUF2;
     }
+    simuLcdAddInvalidatedAreas();
 
     // Trigger async refresh
     simuLcdRefresh = true;
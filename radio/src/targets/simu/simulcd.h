@@ -28,6 +28,20 @@
 extern int g_snapshot_idx;
 extern bool simuLcdRefresh;
 
+// Areas of simuLcdBuf changed since they were last read: more areas
+// than SIMU_LCD_MAX_DIRTY_RECTS are merged into their bounding box
+#define SIMU_LCD_MAX_DIRTY_RECTS 16
+
+struct SimuLcdRect {
+  int16_t x, y, w, h;
+};
+
+void simuLcdAddDirtyRect(int16_t x, int16_t y, int16_t w, int16_t h);
+
+// Returns the number of areas copied into 'rects' (up to
+// SIMU_LCD_MAX_DIRTY_RECTS) and clears them
+uint8_t simuLcdGetDirtyRects(SimuLcdRect * rects);
+
 #if defined(COLORLCD)
 extern pixel_t* simuLcdBuf;
 #else
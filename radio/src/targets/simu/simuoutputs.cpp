@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "opentx.h"
+#include "switches.h"
+#include "input_mapping.h"
+#include "hal/key_driver.h"
+#include "simuoutputs.h"
+
+#include <atomic>
+
+#define SIMU_OUTPUTS_FRESH 0x80  // set in 'middle' when it holds a new snapshot
+
+static SimuOutputs buffers[3];
+static SimuOutputs lastOutputs;   // last published snapshot (mixer side)
+static bool published = false;
+static uint8_t back = 0;          // written by the mixer
+static uint8_t front = 2;         // read by the simulator
+static std::atomic<uint8_t> middle(1);
+static std::atomic<uint32_t> changes[SIMU_OUTPUT_WORDS];
+static std::atomic<bool> notified(false);
+static SimuOutputsListener listener = nullptr;
+static void * listenerCtx = nullptr;
+
+static void readOutputs(SimuOutputs & outputs)
+{
+  memset(&outputs, 0, sizeof(outputs));
+
+  memcpy(outputs.chans, channelOutputs, sizeof(outputs.chans));
+  memcpy(outputs.mixes, ex_chans, sizeof(outputs.mixes));
+
+  for (uint8_t i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+    if (getSwitch(SWSRC_FIRST_LOGICAL_SWITCH + i, 0))
+      outputs.logicalSwitches[i / 8] |= 1 << (i % 8);
+  }
+
+  uint8_t phase = getFlightMode();
+  outputs.phase = phase;
+  for (uint8_t i = 0; i < keysGetMaxTrims() && i < MAX_TRIMS; i++) {
+    uint8_t idx = inputMappingConvertMode(i);
+    outputs.trims[i] = getTrimValue(getTrimFlightMode(phase, idx), idx);
+  }
+  outputs.trimRange = g_model.extendedTrims ? TRIM_EXTENDED_MAX : TRIM_MAX;
+
+#if defined(GVARS)
+  for (uint8_t gv = 0; gv < MAX_GVARS; gv++) {
+    outputs.gvarsPrec[gv] = g_model.gvars[gv].prec;
+    outputs.gvarsUnit[gv] = g_model.gvars[gv].unit;
+    for (uint8_t fm = 0; fm < MAX_FLIGHT_MODES; fm++) {
+      outputs.gvars[fm][gv] = GVAR_VALUE(gv, getGVarFlightMode(fm, gv));
+    }
+  }
+#endif
+}
+
+static inline void setChanged(uint32_t * changed, unsigned index)
+{
+  changed[index / 32] |= 1u << (index % 32);
+}
+
+void simuOutputsPublish()
+{
+  SimuOutputs & outputs = buffers[back];
+  readOutputs(outputs);
+
+  uint32_t changed[SIMU_OUTPUT_WORDS] = {0};
+  bool any = false;
+
+  if (!published) {
+    memset(changed, 0xFF, sizeof(changed));
+    published = true;
+    any = true;
+  }
+  else if (memcmp(&outputs, &lastOutputs, sizeof(outputs))) {
+    for (unsigned i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+      if (outputs.chans[i] != lastOutputs.chans[i])
+        setChanged(changed, SIMU_OUTPUT_CHAN + i);
+      if (outputs.mixes[i] != lastOutputs.mixes[i])
+        setChanged(changed, SIMU_OUTPUT_MIX + i);
+    }
+    for (unsigned i = 0; i < MAX_LOGICAL_SWITCHES; i++) {
+      if (simuLogicalSwitchState(outputs, i) != simuLogicalSwitchState(lastOutputs, i))
+        setChanged(changed, SIMU_OUTPUT_LOGICAL_SWITCH + i);
+    }
+    for (unsigned i = 0; i < MAX_TRIMS; i++) {
+      if (outputs.trims[i] != lastOutputs.trims[i])
+        setChanged(changed, SIMU_OUTPUT_TRIM + i);
+    }
+    if (outputs.trimRange != lastOutputs.trimRange)
+      setChanged(changed, SIMU_OUTPUT_TRIM_RANGE);
+    if (outputs.phase != lastOutputs.phase)
+      setChanged(changed, SIMU_OUTPUT_PHASE);
+    for (unsigned gv = 0; gv < MAX_GVARS; gv++) {
+      bool format = outputs.gvarsPrec[gv] != lastOutputs.gvarsPrec[gv] ||
+                    outputs.gvarsUnit[gv] != lastOutputs.gvarsUnit[gv];
+      for (unsigned fm = 0; fm < MAX_FLIGHT_MODES; fm++) {
+        if (format || outputs.gvars[fm][gv] != lastOutputs.gvars[fm][gv])
+          setChanged(changed, SIMU_OUTPUT_GVAR + fm * MAX_GVARS + gv);
+      }
+    }
+    any = true;
+  }
+
+  if (!any)
+    return;
+
+  memcpy(&lastOutputs, &outputs, sizeof(outputs));
+
+  // the snapshot is published before its changes: the simulator takes
+  // the changes first, then the latest snapshot, which holds them
+  back = middle.exchange(back | SIMU_OUTPUTS_FRESH) & ~SIMU_OUTPUTS_FRESH;
+  for (unsigned i = 0; i < SIMU_OUTPUT_WORDS; i++) {
+    if (changed[i])
+      changes[i].fetch_or(changed[i]);
+  }
+
+  if (listener && !notified.exchange(true))
+    listener(listenerCtx);
+}
+
+bool simuOutputsConsume(SimuOutputs & outputs, uint32_t * changed)
+{
+  bool any = false;
+  notified.store(false);
+  for (unsigned i = 0; i < SIMU_OUTPUT_WORDS; i++) {
+    changed[i] = changes[i].exchange(0);
+    any = any || changed[i];
+  }
+
+  if (middle.load() & SIMU_OUTPUTS_FRESH) {
+    front = middle.exchange(front) & ~SIMU_OUTPUTS_FRESH;
+  }
+
+  memcpy(&outputs, &buffers[front], sizeof(outputs));
+  return any;
+}
+
+void simuOutputsSetListener(SimuOutputsListener cb, void * ctx)
+{
+  // only called while the mixer task is stopped
+  listener = cb;
+  listenerCtx = ctx;
+  notified.store(false);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include "dataconstants.h"
+
+//
+// Simulator outputs, published by the mixer task after each cycle
+//
+// The mixer publishes a snapshot of the outputs into a triple buffer
+// and sets the bits of the outputs which changed in a bitmap. The
+// simulator consumes both at its own rate, without locking the mixer:
+// outputs changed several times in between are only reported once.
+//
+
+enum SimuOutputIndex {
+  SIMU_OUTPUT_CHAN = 0,
+  SIMU_OUTPUT_MIX = SIMU_OUTPUT_CHAN + MAX_OUTPUT_CHANNELS,
+  SIMU_OUTPUT_LOGICAL_SWITCH = SIMU_OUTPUT_MIX + MAX_OUTPUT_CHANNELS,
+  SIMU_OUTPUT_TRIM = SIMU_OUTPUT_LOGICAL_SWITCH + MAX_LOGICAL_SWITCHES,
+  SIMU_OUTPUT_TRIM_RANGE = SIMU_OUTPUT_TRIM + MAX_TRIMS,
+  SIMU_OUTPUT_PHASE,
+  SIMU_OUTPUT_GVAR,  // [flight mode][gvar]
+  SIMU_OUTPUT_COUNT = SIMU_OUTPUT_GVAR + MAX_FLIGHT_MODES * MAX_GVARS
+};
+
+#define SIMU_OUTPUT_WORDS ((SIMU_OUTPUT_COUNT + 31) / 32)
+
+struct SimuOutputs {
+  int16_t chans[MAX_OUTPUT_CHANNELS];
+  int16_t mixes[MAX_OUTPUT_CHANNELS];
+  uint8_t logicalSwitches[(MAX_LOGICAL_SWITCHES + 7) / 8];
+  int16_t trims[MAX_TRIMS];
+  int16_t trimRange;
+  uint8_t phase;
+  int16_t gvars[MAX_FLIGHT_MODES][MAX_GVARS];
+  uint8_t gvarsPrec[MAX_GVARS];
+  uint8_t gvarsUnit[MAX_GVARS];
+};
+
+inline bool simuOutputChanged(const uint32_t * changed, unsigned index)
+{
+  return changed[index / 32] & (1u << (index % 32));
+}
+
+inline bool simuLogicalSwitchState(const SimuOutputs & outputs, unsigned index)
+{
+  return outputs.logicalSwitches[index / 8] & (1 << (index % 8));
+}
+
+// Mixer task side
+void simuOutputsPublish();
+
+// Simulator side: latest snapshot and outputs changed since the
+// previous call (SIMU_OUTPUT_WORDS words), returns false if none
+bool simuOutputsConsume(SimuOutputs & outputs, uint32_t * changed);
+
+// Called from the mixer task when outputs changed, at most once between
+// two simuOutputsConsume() calls (nullptr: no listener)
+typedef void (*SimuOutputsListener)(void * ctx);
+void simuOutputsSetListener(SimuOutputsListener listener, void * ctx);
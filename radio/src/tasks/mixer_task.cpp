@@ -22,6 +22,7 @@
 #include "tasks.h"
 #include "mixer_task.h"
 #include "mixer_scheduler.h"
+#include "mixer_outputs.h"
 
 #include "opentx.h"
 #include "switches.h"
@@ -29,6 +30,12 @@
 
 #include "hal/watchdog_driver.h"
 
+#include <atomic>
+
+#if defined(SIMU)
+  #include "targets/simu/simuoutputs.h"
+#endif
+
 RTOS_TASK_HANDLE mixerTaskId;
 RTOS_DEFINE_STACK(mixerTaskId, mixerStack, MIXER_STACK_SIZE);
 
@@ -59,10 +66,54 @@ void mixerTaskUnlock()
   RTOS_UNLOCK_MUTEX(mixerMutex);
 }
 
+// Longest wait for an edit before checking the mixer is still running
+#define MIXER_EDIT_WAIT_MS  20
+
+struct MixerTaskEditRecord {
+  MixerTaskEdit edit;
+  void * ctx;
+};
+
+// edit waiting for the mixer: one committer at a time, signaled once applied
+static RTOS_MUTEX_HANDLE editMutex;
+static RTOS_FLAG_HANDLE editApplied;
+static std::atomic<const MixerTaskEditRecord *> _pending_edit(nullptr);
+
+void mixerTaskApplyEdit()
+{
+  const MixerTaskEditRecord * record =
+      _pending_edit.exchange(nullptr, std::memory_order_acq_rel);
+  if (record) {
+    record->edit(record->ctx);
+    RTOS_SET_FLAG(editApplied);
+  }
+}
+
+void mixerTaskCommitEdit(MixerTaskEdit edit, void * ctx)
+{
+  const MixerTaskEditRecord record = {edit, ctx};
+
+  RTOS_LOCK_MUTEX(editMutex);
+  _pending_edit.store(&record, std::memory_order_release);
+
+  do {
+    if (!mixerTaskRunning()) {
+      // nobody else will run it
+      mixerTaskLock();
+      mixerTaskApplyEdit();
+      mixerTaskUnlock();
+    }
+  } while (RTOS_WAIT_FLAG(editApplied, MIXER_EDIT_WAIT_MS));
+
+  RTOS_UNLOCK_MUTEX(editMutex);
+}
+
 void mixerTaskInit()
 {
   mixerSchedulerInit();
   RTOS_CREATE_MUTEX(mixerMutex);
+  RTOS_CREATE_MUTEX(editMutex);
+  RTOS_CREATE_FLAG(editApplied);
   RTOS_CREATE_TASK(mixerTaskId, mixerTask, "mixer", mixerStack,
                    MIXER_STACK_SIZE, MIXER_TASK_PRIO);
   mixerSchedulerStart();
@@ -191,10 +242,17 @@ TASK_FUNCTION(mixerTask)
       DEBUG_TIMER_START(debugTimerMixer);
       mixerTaskLock();
 
+      // model edits are applied between two cycles
+      mixerTaskApplyEdit();
+
       doMixerCalculations();
       pulsesSendChannels();
       doMixerPeriodicUpdates();
 
+#if defined(SIMU)
+      simuOutputsPublish();
+#endif
+
       // TODO: what are these for???
       DEBUG_TIMER_START(debugTimerMixerCalcToUsage);
       DEBUG_TIMER_SAMPLE(debugTimerMixerIterval);
@@ -213,6 +271,7 @@ TASK_FUNCTION(mixerTask)
       WDG_RESET();
 
       t0 = timersGetUsTick() - t0;
+      totalMixerDuration += t0;
       if (t0 > maxMixerDuration)
         maxMixerDuration = t0;
     }
@@ -252,4 +311,6 @@ void doMixerCalculations()
   DEBUG_TIMER_START(debugTimerEvalMixes);
   evalMixes(tick10ms);
   DEBUG_TIMER_STOP(debugTimerEvalMixes);
+
+  mixerOutputsPublish();
 }
@@ -78,3 +78,21 @@ void mixerTaskUnlock();
 // returns true if the lock could be acquired
 bool mixerTaskTryLock();
 
+//
+// Model edits
+//
+// Structural model edits (mix and input lines, curves, outputs offsets and
+// limits) are prepared by the caller, then 'edit' only moves the data, or
+// computes what needs the mixer state. It is run by the mixer
+// task between two cycles, so that the mixer never computes a half edited
+// model nor waits for the caller. Returns once 'edit' has run; concurrent
+// callers are committed one after the other.
+//
+// When the mixer is not running, 'edit' is run by the caller.
+//
+typedef void (*MixerTaskEdit)(void * ctx);
+void mixerTaskCommitEdit(MixerTaskEdit edit, void * ctx);
+
+// runs the edit waiting for the mixer, if any (mixer lock held)
+void mixerTaskApplyEdit();
+
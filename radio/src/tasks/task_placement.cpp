@@ -0,0 +1,298 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include <string.h>
+#include <atomic>
+
+#include "rtos.h"
+#include "task_placement.h"
+#include "debug.h"
+
+#if defined(SIMU)
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+#if defined(ESP_PLATFORM)
+  #include "esp_timer.h"
+#endif
+
+#if defined(BOARD_TASK_PLACEMENT)
+static const TaskPlacement * placementTable = boardTaskPlacements;
+#else
+static const TaskPlacement * placementTable = nullptr;
+#endif
+
+void setTaskPlacementTable(const TaskPlacement * table)
+{
+#if defined(BOARD_TASK_PLACEMENT)
+  placementTable = table ? table : boardTaskPlacements;
+#else
+  placementTable = table;
+#endif
+}
+
+const TaskPlacement * getTaskPlacement(const char * name)
+{
+  if (!placementTable || !name) return nullptr;
+
+  for (const TaskPlacement * placement = placementTable; placement->name;
+       placement++) {
+    if (!strcmp(placement->name, name)) return placement;
+  }
+
+  return nullptr;
+}
+
+//
+// Tasks registry & CPU usage accounting
+//
+
+#if defined(SIMU)
+typedef pthread_t TaskId;
+typedef uint64_t RunTime;
+#else
+typedef TaskHandle_t TaskId;
+#if configGENERATE_RUN_TIME_STATS == 1
+typedef configRUN_TIME_COUNTER_TYPE RunTime;  // wraps around
+#else
+typedef uint32_t RunTime;
+#endif
+#endif
+
+enum TaskEntryState {
+  TASK_ENTRY_FREE,
+  TASK_ENTRY_CLAIMED,
+  TASK_ENTRY_VALID,
+};
+
+struct TaskEntry {
+  std::atomic<uint8_t> state;
+  const char * name;
+  TaskId id;
+  int8_t core;
+  uint8_t priority;
+  RunTime lastRunTime;
+  RunTime lastTime;
+};
+
+static TaskEntry tasksEntries[MAX_TASKS_STATS];
+
+#if defined(SIMU)
+static RunTime getTime()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// thread CPU time in us, 0 if not available
+static RunTime getRunTime(TaskId id)
+{
+#if defined(__linux__)
+  clockid_t clock;
+  struct timespec ts;
+  if (pthread_getcpuclockid(id, &clock) == 0 &&
+      clock_gettime(clock, &ts) == 0) {
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+  }
+#endif
+  return 0;
+}
+
+static uint32_t getStackFree(TaskId)
+{
+  return 0;
+}
+#else
+static RunTime getTime()
+{
+#if configGENERATE_RUN_TIME_STATS == 1
+  return portGET_RUN_TIME_COUNTER_VALUE();
+#else
+  return 0;
+#endif
+}
+
+static RunTime getRunTime(TaskId id)
+{
+#if configGENERATE_RUN_TIME_STATS == 1
+  return ulTaskGetRunTimeCounter(id);
+#else
+  (void)id;
+  return 0;
+#endif
+}
+
+static uint32_t getStackFree(TaskId id)
+{
+  return uxTaskGetStackHighWaterMark(id) * sizeof(StackType_t);
+}
+#endif
+
+static bool isSameTask(TaskId a, TaskId b)
+{
+#if defined(SIMU)
+  return pthread_equal(a, b);
+#else
+  return a == b;
+#endif
+}
+
+static void registerTask(TaskId id, const char * name, int8_t core,
+                         uint8_t priority)
+{
+  // tasks re-created with the same static buffers keep their entry
+  for (TaskEntry & entry : tasksEntries) {
+    if (entry.state.load(std::memory_order_acquire) == TASK_ENTRY_VALID &&
+        isSameTask(entry.id, id)) {
+      entry.name = name;
+      entry.core = core;
+      entry.priority = priority;
+      return;
+    }
+  }
+
+  for (TaskEntry & entry : tasksEntries) {
+    uint8_t state = TASK_ENTRY_FREE;
+    if (entry.state.compare_exchange_strong(state, TASK_ENTRY_CLAIMED)) {
+      entry.name = name;
+      entry.id = id;
+      entry.core = core;
+      entry.priority = priority;
+      entry.lastRunTime = getRunTime(id);
+      entry.lastTime = getTime();
+      entry.state.store(TASK_ENTRY_VALID, std::memory_order_release);
+      return;
+    }
+  }
+
+  TRACE("Task %s not registered: registry full", name);
+}
+
+#if defined(SIMU)
+void rtosTaskCreated(pthread_t taskId, const char * name, unsigned priority)
+{
+  int8_t core = TASK_ANY_CORE;
+
+  const TaskPlacement * placement = getTaskPlacement(name);
+  if (placement) {
+    if (placement->priority) priority = placement->priority;
+    if (placement->core != TASK_ANY_CORE) {
+      core = placement->core;
+#if defined(__linux__)
+      // pin the thread when the host has enough cores
+      if (core < sysconf(_SC_NPROCESSORS_ONLN)) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        pthread_setaffinity_np(taskId, sizeof(cpus), &cpus);
+      }
+#endif
+    }
+  }
+
+  registerTask(taskId, name, core, priority);
+}
+
+void rtosTaskDeleted(pthread_t taskId)
+{
+  for (TaskEntry & entry : tasksEntries) {
+    if (entry.state.load(std::memory_order_acquire) == TASK_ENTRY_VALID &&
+        isSameTask(entry.id, taskId)) {
+      entry.state.store(TASK_ENTRY_FREE, std::memory_order_release);
+    }
+  }
+}
+#else
+void rtosTaskPlacement(const char * name, BaseType_t * core,
+                       UBaseType_t * priority, uint32_t stackDepth)
+{
+  const TaskPlacement * placement = getTaskPlacement(name);
+  if (!placement) return;
+
+  if (placement->core != TASK_ANY_CORE) *core = placement->core;
+  if (placement->priority) *priority = placement->priority;
+  if (placement->stackSize && placement->stackSize != stackDepth) {
+    TRACE("Task %s: stack %u instead of %u", name, (unsigned)stackDepth,
+          (unsigned)placement->stackSize);
+  }
+}
+
+void rtosTaskCreated(TaskHandle_t handle, const char * name,
+                     UBaseType_t priority, BaseType_t core)
+{
+  if (!handle) return;
+
+#if defined(ESP_PLATFORM)
+  registerTask(handle, name, core == tskNO_AFFINITY ? TASK_ANY_CORE : core,
+               priority);
+#else
+  (void)core;
+  registerTask(handle, name, 0, priority);
+#endif
+}
+#endif
+
+uint8_t getTasksStats(TaskStats * stats, uint8_t max)
+{
+#if defined(ESP_PLATFORM)
+  // the idle tasks give the load of each core
+  static bool idleRegistered = false;
+  if (!idleRegistered) {
+    idleRegistered = true;
+    for (BaseType_t core = 0; core < portNUM_PROCESSORS; core++) {
+      TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+      registerTask(idle, pcTaskGetName(idle), core, tskIDLE_PRIORITY);
+    }
+  }
+#endif
+
+  uint8_t result = 0;
+  RunTime now = getTime();
+
+  for (uint8_t i = 0; i < MAX_TASKS_STATS && result < max; i++) {
+    TaskEntry & entry = tasksEntries[i];
+    if (entry.state.load(std::memory_order_acquire) != TASK_ENTRY_VALID)
+      continue;
+
+    TaskStats & task = stats[result++];
+    task.name = entry.name;
+    task.core = entry.core;
+    task.priority = entry.priority;
+    task.stackFree = getStackFree(entry.id);
+
+    RunTime runTime = getRunTime(entry.id);
+    RunTime elapsed = now - entry.lastTime;
+    if (runTime == 0 || elapsed == 0) {
+      task.load = TASK_LOAD_UNKNOWN;
+    } else {
+      RunTime busy = runTime - entry.lastRunTime;
+      uint64_t load = ((uint64_t)busy * 1000) / elapsed;
+      task.load = load > 1000 ? 1000 : load;
+    }
+    entry.lastRunTime = runTime;
+    entry.lastTime = now;
+  }
+
+  return result;
+}
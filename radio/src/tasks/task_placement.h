@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#pragma once
+
+#include <inttypes.h>
+
+#define TASK_ANY_CORE  -1
+
+// Where a task runs and with which priority. Boards defining
+// BOARD_TASK_PLACEMENT provide boardTaskPlacements[] (terminated by a
+// nullptr name), applied by RTOS_CREATE_TASK() / RTOS_CREATE_TASK_EX()
+// to the tasks it lists.
+struct TaskPlacement {
+  const char * name;
+  int8_t core;        // TASK_ANY_CORE: keep the core given at creation
+  uint8_t priority;   // 0: keep the priority given at creation
+  uint32_t stackSize; // as given at creation, 0: not checked
+};
+
+#if defined(BOARD_TASK_PLACEMENT)
+extern const TaskPlacement boardTaskPlacements[];
+#endif
+
+// returns the placement of the task 'name', nullptr if not listed
+const TaskPlacement * getTaskPlacement(const char * name);
+
+// replaces the placement table (nullptr: board table), for tests
+void setTaskPlacementTable(const TaskPlacement * table);
+
+#define MAX_TASKS_STATS  24
+#define TASK_LOAD_UNKNOWN 0xFFFF
+
+struct TaskStats {
+  const char * name;
+  int8_t core;        // TASK_ANY_CORE if not pinned
+  uint8_t priority;
+  uint32_t stackFree; // bytes, 0 if unknown
+  uint16_t load;      // CPU usage since the previous call, in 0.1% of a core
+};
+
+// fills 'stats' with the tasks created through RTOS_CREATE_TASK(),
+// returns the number of tasks
+uint8_t getTasksStats(TaskStats * stats, uint8_t max);
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "opentx.h"
+#include "espnow.h"
+#include "targets/common/esp32/esprc_packet.h"
+
+struct EspNowSensor {
+  const uint16_t id;
+  const char * name;
+  const TelemetryUnit unit;
+  const uint8_t precision;
+};
+
+const EspNowSensor espnowSensors[] = {
+  {ESPRC_TELEM_RSSI,    STR_SENSOR_RSSI, UNIT_DBM,   0},
+  {ESPRC_TELEM_RX_BATT, STR_SENSOR_BATT, UNIT_VOLTS, 2},
+  {ESPRC_TELEM_LOST,    STR_SENSOR_LOSS, UNIT_RAW,   0},
+  {0,                   NULL,            UNIT_RAW,   0}  // sentinel
+};
+
+static const EspNowSensor * getEspNowSensor(uint16_t id)
+{
+  for (const EspNowSensor * sensor = espnowSensors; sensor->id; sensor++) {
+    if (id == sensor->id)
+      return sensor;
+  }
+  return nullptr;
+}
+
+void processEspNowTelemetry(uint8_t id, int32_t value)
+{
+  const EspNowSensor * sensor = getEspNowSensor(id);
+
+  if (id == ESPRC_TELEM_RSSI) {
+    // -100dBm..-50dBm -> 0..100
+    telemetryData.rssi.set(limit<int32_t>(0, 2 * (value + 100), 100));
+  }
+  telemetryStreaming = TELEMETRY_TIMEOUT10ms;
+
+  if (sensor) {
+    setTelemetryValue(PROTOCOL_TELEMETRY_ESPNOW, id, 0, 0, value, sensor->unit,
+                      sensor->precision);
+  } else {
+    setTelemetryValue(PROTOCOL_TELEMETRY_ESPNOW, id, 0, 0, value, UNIT_RAW, 0);
+  }
+}
+
+void espnowSetDefault(int index, uint16_t id, uint8_t subId, uint8_t instance)
+{
+  TelemetrySensor &telemetrySensor = g_model.telemetrySensors[index];
+  telemetrySensor.id = id;
+  telemetrySensor.subId = subId;
+  telemetrySensor.instance = instance;
+
+  const EspNowSensor * sensor = getEspNowSensor(id);
+  if (sensor) {
+    telemetrySensor.init(sensor->name, sensor->unit, sensor->precision);
+  } else {
+    telemetrySensor.init(id);
+  }
+
+  storageDirty(EE_MODEL);
+}
@@ -55,6 +55,10 @@
   #include "flysky_ibus.h"
 #endif
 
+#if defined(ESPNOW)
+  #include "espnow.h"
+#endif
+
 TelemetryItem telemetryItems[MAX_TELEMETRY_SENSORS];
 uint8_t allowNewSensors;
 
@@ -583,6 +587,12 @@ int setTelemetryValue(TelemetryProtocol protocol, uint16_t id, uint8_t subId,
         break;
 #endif
 
+#if defined(ESPNOW)
+      case PROTOCOL_TELEMETRY_ESPNOW:
+        espnowSetDefault(index, id, subId, instance);
+        break;
+#endif
+
 #if defined(LUA)
      case PROTOCOL_TELEMETRY_LUA:
         // Sensor will be initialized by calling function
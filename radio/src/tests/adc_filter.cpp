@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <math.h>
+
+#include "gtests.h"
+#include "hal/adc_filter.h"
+
+#define FILTER_PERIOD_US  4000
+#define FILTER_TICKS      1000
+
+static const char* filterName(uint8_t type)
+{
+  static const char* names[ADC_FILTER_COUNT] = {"jitter", "1euro",
+                                                "decimate"};
+  return names[type];
+}
+
+// Ticks for one input to reach 90% of a step from 'from' to 'to'
+static int stepResponse(uint8_t type, uint16_t from, uint16_t to)
+{
+  AdcFilters filters;
+  adcFilterReset(filters);
+  filters.type[0] = type;
+
+  uint32_t filtered = from * JITTER_ALPHA;
+  adcFilterInputs(filters, &from, &filtered, 1, 0, FILTER_PERIOD_US);
+
+  int32_t target = from + (to - from) * 9 / 10;
+  for (int tick = 1; tick <= FILTER_TICKS; tick++) {
+    adcFilterInputs(filters, &to, &filtered, 1, 0, FILTER_PERIOD_US);
+    int32_t out = filtered / JITTER_ALPHA;
+    if (to > from ? out >= target : out <= target) return tick;
+  }
+  return FILTER_TICKS + 1;
+}
+
+TEST(AdcFilter, stepResponse)
+{
+  for (uint8_t type = 0; type < ADC_FILTER_COUNT; type++) {
+    uint32_t latency = adcFilterLatency(type, FILTER_PERIOD_US);
+    EXPECT_GT(latency, 0u) << filterName(type);
+
+    // small step: the filter is fully active
+    int ticks = stepResponse(type, 2048, 2048 + 8);
+    EXPECT_GT(ticks, 1) << filterName(type);
+    EXPECT_LE(ticks * FILTER_PERIOD_US, 3 * latency) << filterName(type);
+
+    ticks = stepResponse(type, 2048 + 8, 2048);
+    EXPECT_GT(ticks, 1) << filterName(type);
+    EXPECT_LE(ticks * FILTER_PERIOD_US, 3 * latency) << filterName(type);
+  }
+
+  // big changes are not delayed by the jitter filter
+  EXPECT_EQ(1, stepResponse(ADC_FILTER_JITTER, 1024, 3072));
+
+  // 1€ filter cutoff follows the speed
+  int fast = stepResponse(ADC_FILTER_ONE_EURO, 1024, 3072);
+  EXPECT_LT(fast * FILTER_PERIOD_US,
+            adcFilterLatency(ADC_FILTER_ONE_EURO, FILTER_PERIOD_US));
+  EXPECT_LT(fast, stepResponse(ADC_FILTER_ONE_EURO, 2048, 2048 + 8));
+}
+
+TEST(AdcFilter, noiseReduction)
+{
+  for (uint8_t type = 0; type < ADC_FILTER_COUNT; type++) {
+    AdcFilters filters;
+    adcFilterReset(filters);
+    filters.type[0] = type;
+
+    srand(42);
+    uint32_t filtered = 2048 * JITTER_ALPHA;
+    double inputNoise = 0, outputNoise = 0;
+    for (int tick = 0; tick < FILTER_TICKS; tick++) {
+      uint16_t v = 2048 - 4 + rand() % 9;
+      adcFilterInputs(filters, &v, &filtered, 1, 0, FILTER_PERIOD_US);
+      double out = (double)filtered / JITTER_ALPHA - 2048;
+      inputNoise += (v - 2048) * (v - 2048);
+      outputNoise += out * out;
+    }
+
+    EXPECT_LT(sqrt(outputNoise), sqrt(inputNoise) * 2 / 3) << filterName(type);
+  }
+}
+
+// Jitter filter as computed before the filters were batched
+static uint32_t referenceJitterFilter(uint32_t v, uint32_t v_prev,
+                                      bool enabled)
+{
+  uint32_t previous = v_prev / JITTER_ALPHA;
+  uint32_t diff = (v > previous) ? (v - previous) : (previous - v);
+  if (enabled && diff < (10 * ANALOG_MULTIPLIER)) {
+    return (v_prev - previous) + v;
+  }
+  return v * JITTER_ALPHA;
+}
+
+TEST(AdcFilter, jitterUnchanged)
+{
+  AdcFilters filters;
+  adcFilterReset(filters);
+
+  uint16_t values[MAX_ANALOG_INPUTS];
+  uint32_t filtered[MAX_ANALOG_INPUTS] = {0};
+  uint32_t reference[MAX_ANALOG_INPUTS] = {0};
+  uint32_t bypass = 0x3;
+
+  srand(7);
+  for (int tick = 0; tick < FILTER_TICKS; tick++) {
+    for (uint8_t x = 0; x < MAX_ANALOG_INPUTS; x++) {
+      // mostly noise, sometimes a big move
+      values[x] = (tick % 100 == x) ? rand() % (4 * RESX)
+                                    : 2048 + (x * 16) - 12 + rand() % 25;
+      reference[x] = referenceJitterFilter(values[x], reference[x],
+                                           !(bypass & (1u << x)));
+    }
+    adcFilterInputs(filters, values, filtered, MAX_ANALOG_INPUTS, bypass,
+                    FILTER_PERIOD_US);
+    for (uint8_t x = 0; x < MAX_ANALOG_INPUTS; x++) {
+      ASSERT_EQ(reference[x], filtered[x]) << "input " << (int)x;
+    }
+  }
+}
+
+TEST(AdcFilter, radioSetting)
+{
+  auto max_mains = adcGetMaxInputs(ADC_INPUT_MAIN);
+  auto max_analogs = adcGetMaxInputs(ADC_INPUT_ALL);
+
+  for (uint8_t type = 0; type < ADC_FILTER_COUNT; type++) {
+    g_eeGeneral.adcFilter = type;
+    getADC();
+    for (uint8_t x = 0; x < max_analogs; x++) {
+      EXPECT_EQ(x < max_mains ? type : ADC_FILTER_JITTER, adcGetInputFilter(x))
+          << filterName(type) << " input " << (int)x;
+    }
+  }
+
+  g_eeGeneral.adcFilter = ADC_FILTER_JITTER;
+  getADC();
+  anaResetFiltered();
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <list>
+#include <string>
+#include <unistd.h>
+
+#include "gtests.h"
+#include "location.h"
+#include "dir_listing.h"
+
+#if defined(SDCARD)
+
+#define LISTING_DIR    "/dir_listing"
+#define LISTING_FILES  1000
+#define LISTING_PAGE   32
+
+TEST(DirListing, naturalCompare)
+{
+  EXPECT_LT(strnatcasecmp("file2", "file10"), 0);
+  EXPECT_GT(strnatcasecmp("file10", "file2"), 0);
+  EXPECT_EQ(0, strnatcasecmp("File1.wav", "file1.WAV"));
+  EXPECT_LT(strnatcasecmp("a", "B"), 0);
+}
+
+TEST(DirListing, largeDirectory)
+{
+  char cwd[1024];
+  ASSERT_NE(nullptr, getcwd(cwd, sizeof(cwd)));
+
+  simuFatfsSetPaths(TESTS_BUILD_PATH "/", TESTS_BUILD_PATH "/");
+  f_mkdir(LISTING_DIR);
+  f_mkdir(LISTING_DIR "/sounds10");
+  f_mkdir(LISTING_DIR "/sounds9");
+  f_mkdir(LISTING_DIR "/-sounds");  // '-' sorts before '.'
+
+  char name[64];
+  for (int i = LISTING_FILES; i > 0; i--) {
+    FIL file;
+    snprintf(name, sizeof(name), LISTING_DIR "/track%d.wav", i);
+    ASSERT_EQ(FR_OK, f_open(&file, name, FA_CREATE_ALWAYS | FA_WRITE));
+    f_close(&file);
+  }
+  ASSERT_EQ(FR_OK, f_chdir(LISTING_DIR));
+
+  DirListing listing;
+  ASSERT_TRUE(listing.open());
+  listing.readPage(LISTING_PAGE);
+  EXPECT_GT(listing.size(), 0);
+  while (!listing.readPage(LISTING_PAGE));
+
+  // "..", directories, then files in natural order
+  ASSERT_EQ(LISTING_FILES + 4, listing.size());
+  EXPECT_STREQ("..", listing.getName(0));
+  EXPECT_STREQ("-sounds", listing.getName(1));
+  EXPECT_STREQ("sounds9", listing.getName(2));
+  EXPECT_STREQ("sounds10", listing.getName(3));
+  EXPECT_TRUE(listing.isDirectory(3));
+  for (int i = 1; i <= LISTING_FILES; i++) {
+    snprintf(name, sizeof(name), "track%d.wav", i);
+    ASSERT_STREQ(name, listing.getName(i + 3));
+    ASSERT_FALSE(listing.isDirectory(i + 3));
+  }
+  EXPECT_EQ(0, listing.find("..", true));
+  EXPECT_EQ(1, listing.find("-sounds", true));
+  EXPECT_EQ(LISTING_FILES / 2 + 3, listing.find("track500.wav", false));
+  EXPECT_EQ(-1, listing.find("track500.wav", true));
+
+  // one std::string per name in a std::list, as the browser did
+  size_t listSize = 0;
+  for (int i = 0; i < listing.size(); i++) {
+    size_t len = strlen(listing.getName(i)) + 1;
+    listSize += sizeof(std::string) + 2 * sizeof(void*);
+    if (len > 16) listSize += len;
+  }
+
+  EXPECT_LT(listing.getAllocatedSize(), listSize);
+
+  listing.close();
+  for (int i = 1; i <= LISTING_FILES; i++) {
+    snprintf(name, sizeof(name), LISTING_DIR "/track%d.wav", i);
+    f_unlink(name);
+  }
+
+  simuFatfsSetPaths("", "");
+  ASSERT_EQ(0, chdir(cwd));
+
+  // the simu f_unlink() does not remove directories
+  EXPECT_EQ(0, rmdir(TESTS_BUILD_PATH LISTING_DIR "/sounds10"));
+  EXPECT_EQ(0, rmdir(TESTS_BUILD_PATH LISTING_DIR "/sounds9"));
+  EXPECT_EQ(0, rmdir(TESTS_BUILD_PATH LISTING_DIR "/-sounds"));
+  EXPECT_EQ(0, rmdir(TESTS_BUILD_PATH LISTING_DIR));
+}
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "gtests.h"
+#include "targets/common/esp32/esprc_codec.h"
+
+static void moveChannels(int16_t* channels, uint8_t count, int moving)
+{
+  for (int i = 0; i < moving; i++) {
+    int16_t& ch = channels[rand() % count];
+    ch = limit<int16_t>(-1024, ch + (rand() % 201) - 100, 1024);
+  }
+}
+
+static void expectChannels(const EspRcDecoder& decoder,
+                           const int16_t* channels, uint8_t count,
+                           int deadband)
+{
+  ASSERT_EQ(count, decoder.getCount());
+  for (uint8_t i = 0; i < count; i++) {
+    int diff = decoder.getValue(i) - espRcChannelValue(channels[i]);
+    ASSERT_LE(abs(diff), deadband) << "channel " << (int)i;
+  }
+}
+
+static bool ackFrame(EspRcEncoder& encoder, EspRcDecoder& decoder)
+{
+  RXPacket_t ack;
+  uint8_t len = decoder.encodeAck(&ack, nullptr, 0);
+  if (espRcCheckRxPacket((uint8_t*)&ack, len) != 0) return false;
+  return encoder.ack(ack.hdr.idx, ack.ackCrc);
+}
+
+TEST(EspRc, channelValues)
+{
+  EXPECT_EQ(ESPRC_CH_CENTER, espRcChannelValue(0));
+  EXPECT_EQ(ESPRC_CH_CENTER - 512, espRcChannelValue(-1024));
+  EXPECT_EQ(ESPRC_CH_CENTER + 512, espRcChannelValue(1024));
+  EXPECT_EQ(0, espRcChannelValue(-2048));
+  EXPECT_EQ(ESPRC_CH_MAX, espRcChannelValue(2047));
+  for (int ch = -2048; ch < 2048; ch += 2) {
+    EXPECT_EQ(ch, espRcChannelOutput(espRcChannelValue(ch)));
+  }
+}
+
+TEST(EspRc, roundTrip)
+{
+  EspRcEncoder encoder;
+  EspRcDecoder decoder;
+  TXPacket_t packet;
+  int16_t channels[MAX_OUTPUT_CHANNELS];
+
+  for (uint8_t count = 1; count <= MAX_OUTPUT_CHANNELS; count++) {
+    for (int i = 0; i < count; i++) {
+      channels[i] = -1024 + rand() % 2049;
+    }
+
+    // count changed: full frame
+    uint8_t len = encoder.encode(&packet, channels, count);
+    EXPECT_EQ(ESPRC_DATA, packet.hdr.type);
+    EXPECT_EQ(ESPRC_HEADER_LEN + ESPRC_CH_PACKED_LEN(count), len);
+    ASSERT_TRUE(decoder.decode((uint8_t*)&packet, len));
+    expectChannels(decoder, channels, count, 0);
+    EXPECT_TRUE(ackFrame(encoder, decoder));
+    EXPECT_TRUE(encoder.isSynced());
+
+    // one channel moved: delta frame with one channel
+    channels[count - 1] = channels[count - 1] > 0 ? -1000 : 1000;
+    len = encoder.encode(&packet, channels, count);
+    EXPECT_EQ(ESPRC_DELTA, packet.hdr.type);
+    EXPECT_EQ(ESPRC_HEADER_LEN + 4 + ESPRC_CH_PACKED_LEN(1), len);
+    ASSERT_TRUE(decoder.decode((uint8_t*)&packet, len));
+    expectChannels(decoder, channels, count, 0);
+    EXPECT_TRUE(ackFrame(encoder, decoder));
+  }
+}
+
+TEST(EspRc, badFrames)
+{
+  EspRcEncoder encoder;
+  EspRcDecoder decoder;
+  TXPacket_t packet;
+  int16_t channels[16] = {0};
+
+  // delta frames are dropped until a full frame is received
+  uint8_t len = encoder.encode(&packet, channels, 16);
+  encoder.ack(packet.hdr.idx, packet.hdr.crc);
+  channels[3] = 500;
+  len = encoder.encode(&packet, channels, 16);
+  EXPECT_EQ(ESPRC_DELTA, packet.hdr.type);
+  EXPECT_FALSE(decoder.decode((uint8_t*)&packet, len));
+
+  encoder.reset();
+  len = encoder.encode(&packet, channels, 16);
+  EXPECT_TRUE(decoder.decode((uint8_t*)&packet, len));
+
+  // corrupted frames
+  for (int i = 0; i < len; i++) {
+    packet.data[0] ^= 1 << (i & 7);
+    EXPECT_FALSE(decoder.decode((uint8_t*)&packet, len));
+    packet.data[0] ^= 1 << (i & 7);
+  }
+  EXPECT_FALSE(decoder.decode((uint8_t*)&packet, len - 1));
+
+  // wrong version
+  packet.hdr.version = ESPRC_VERSION - 1;
+  packet.hdr.crc = 0;
+  packet.hdr.crc = crc16(CRC_1021, (uint8_t*)&packet, len);
+  EXPECT_FALSE(decoder.decode((uint8_t*)&packet, len));
+
+  // ack of another frame
+  EXPECT_FALSE(encoder.ack(packet.hdr.idx + 1, packet.hdr.crc));
+}
+
+TEST(EspRc, telemetry)
+{
+  EspRcDecoder decoder;
+  RXPacket_t packet;
+  EspRcTelemetryItem_t items[ESPRC_MAX_TELEMETRY_ITEMS + 1];
+
+  for (int i = 0; i <= ESPRC_MAX_TELEMETRY_ITEMS; i++) {
+    items[i].id = ESPRC_TELEM_CUSTOM + i;
+    items[i].value = -1000 * i;
+  }
+
+  for (int count = 0; count <= ESPRC_MAX_TELEMETRY_ITEMS + 1; count++) {
+    uint8_t len = decoder.encodeAck(&packet, items, count);
+    int expected = min(count, ESPRC_MAX_TELEMETRY_ITEMS);
+    EXPECT_EQ(ESPRC_RX_PACKET_LEN(expected), len);
+    EXPECT_EQ(expected, espRcCheckRxPacket((uint8_t*)&packet, len));
+    for (int i = 0; i < expected; i++) {
+      EXPECT_EQ(items[i].id, packet.items[i].id);
+      EXPECT_EQ(items[i].value, packet.items[i].value);
+    }
+    EXPECT_EQ(-1, espRcCheckRxPacket((uint8_t*)&packet, len + 1));
+  }
+}
+
+// Random frames and acks losses: each received frame must give channels
+// within the deadband, and a lossless link must converge to the exact
+// channels within ESPRC_FULL_FRAME_PERIOD frames
+TEST(EspRc, lossSimulation)
+{
+  EspRcEncoder encoder;
+  EspRcDecoder decoder;
+  TXPacket_t packet;
+  int16_t channels[MAX_OUTPUT_CHANNELS] = {0};
+  const uint8_t count = 16;
+  int received = 0;
+  int fullBytes = 0, sentBytes = 0;
+
+  srand(0x5A5A);
+
+  for (int loss = 0; loss <= 80; loss += 20) {
+    for (int n = 0; n < 2000; n++) {
+      moveChannels(channels, count, rand() % 3);
+      uint8_t len = encoder.encode(&packet, channels, count);
+      sentBytes += len;
+      fullBytes += ESPRC_HEADER_LEN + ESPRC_CH_PACKED_LEN(count);
+
+      if (rand() % 100 < loss) continue;  // frame lost
+      ASSERT_TRUE(decoder.decode((uint8_t*)&packet, len) ||
+                  !decoder.isSynced());
+      if (!decoder.isSynced()) continue;
+      received++;
+      expectChannels(decoder, channels, count, ESPRC_DEADBAND);
+
+      if (rand() % 100 < loss) continue;  // ack lost
+      ackFrame(encoder, decoder);
+    }
+
+    // lossless link, channels not moving
+    for (int n = 0; n < ESPRC_FULL_FRAME_PERIOD; n++) {
+      uint8_t len = encoder.encode(&packet, channels, count);
+      ASSERT_TRUE(decoder.decode((uint8_t*)&packet, len));
+      ackFrame(encoder, decoder);
+    }
+    expectChannels(decoder, channels, count, 0);
+  }
+
+  EXPECT_GT(received, 0);
+  EXPECT_LT(sentBytes, fullBytes);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <thread>
+
+#include "gtests.h"
+#include "fifo.h"
+
+TEST(Fifo, pushPop)
+{
+  Fifo<uint8_t, 8> fifo;
+  uint8_t value;
+
+  EXPECT_TRUE(fifo.isEmpty());
+  for (int i = 0; i < 7; i++) {
+    EXPECT_TRUE(fifo.push(i));
+  }
+  EXPECT_TRUE(fifo.isFull());
+  EXPECT_FALSE(fifo.push(7));
+  EXPECT_EQ(7u, fifo.size());
+  EXPECT_EQ(7u, fifo.getHighWaterMark());
+  EXPECT_EQ(1u, fifo.getOverflows());
+
+  for (int i = 0; i < 7; i++) {
+    EXPECT_TRUE(fifo.probe(value));
+    EXPECT_EQ(i, value);
+    EXPECT_TRUE(fifo.pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(fifo.pop(value));
+  EXPECT_TRUE(fifo.isEmpty());
+
+  fifo.resetStats();
+  EXPECT_EQ(0u, fifo.getHighWaterMark());
+  EXPECT_EQ(0u, fifo.getOverflows());
+}
+
+TEST(Fifo, spans)
+{
+  Fifo<uint8_t, 8> fifo;
+  uint32_t len;
+
+  // empty fifo at index 0: the last slot can't be used
+  uint8_t * span = fifo.pushSpan(len);
+  EXPECT_EQ(7u, len);
+  span[0] = 10; span[1] = 11; span[2] = 12; span[3] = 13; span[4] = 14;
+  fifo.pushCommit(5);
+
+  const uint8_t * data = fifo.popSpan(len);
+  EXPECT_EQ(5u, len);
+  EXPECT_EQ(10, data[0]);
+  fifo.popCommit(3);
+
+  // writes wrap around: first span ends at the buffer end
+  span = fifo.pushSpan(len);
+  EXPECT_EQ(3u, len);
+  span[0] = 15; span[1] = 16; span[2] = 17;
+  fifo.pushCommit(3);
+  span = fifo.pushSpan(len);
+  EXPECT_EQ(2u, len);
+  EXPECT_EQ(fifo.buffer(), span);
+  span[0] = 18;
+  fifo.pushCommit(1);
+
+  data = fifo.popSpan(len);
+  EXPECT_EQ(5u, len);
+  EXPECT_EQ(13, data[0]);
+  EXPECT_EQ(17, data[4]);
+  fifo.popCommit(len);
+  data = fifo.popSpan(len);
+  EXPECT_EQ(1u, len);
+  EXPECT_EQ(18, data[0]);
+  fifo.popCommit(len);
+  EXPECT_TRUE(fifo.isEmpty());
+  EXPECT_EQ(6u, fifo.getHighWaterMark());
+}
+
+TEST(Fifo, bulk)
+{
+  Fifo<uint16_t, 16> fifo;
+  uint16_t values[32], result[32];
+
+  for (int i = 0; i < 32; i++) values[i] = 1000 + i;
+
+  for (int n = 0; n < 100; n++) {
+    uint32_t count = 1 + n % 11;
+    EXPECT_EQ(count, fifo.push(values, count));
+    EXPECT_EQ(count, fifo.pop(result, 32));
+    EXPECT_EQ(0, memcmp(values, result, count * sizeof(uint16_t)));
+  }
+
+  EXPECT_EQ(15u, fifo.push(values, 32));
+  EXPECT_EQ(1u, fifo.getOverflows());
+  EXPECT_EQ(15u, fifo.pop(result, 32));
+  EXPECT_EQ(0, memcmp(values, result, 15 * sizeof(uint16_t)));
+}
+
+// One producer and one consumer thread, mixing single element and
+// bulk operations: every element must come out once and in order
+TEST(Fifo, stress)
+{
+  static Fifo<uint32_t, 256> fifo;
+  const uint32_t total = 200000;
+  uint32_t errors = 0;
+
+  std::thread producer([&]() {
+    uint32_t next = 0;
+    uint32_t chunk[37];
+    while (next < total) {
+      uint32_t pushed;
+      if (next & 0x100) {
+        pushed = fifo.push(next) ? 1 : 0;
+      } else {
+        uint32_t count = std::min<uint32_t>(1 + next % 37, total - next);
+        for (uint32_t i = 0; i < count; i++) chunk[i] = next + i;
+        pushed = fifo.push(chunk, count);
+      }
+      next += pushed;
+      if (!pushed) std::this_thread::yield();
+    }
+  });
+
+  std::thread consumer([&]() {
+    uint32_t expected = 0;
+    uint32_t chunk[29];
+    while (expected < total) {
+      if (expected & 0x80) {
+        uint32_t value;
+        if (fifo.pop(value)) {
+          if (value != expected) errors++;
+          expected++;
+        } else {
+          std::this_thread::yield();
+        }
+      } else {
+        uint32_t len;
+        const uint32_t * span = fifo.popSpan(len);
+        if (len == 0) std::this_thread::yield();
+        if (len > 29) len = 29;
+        for (uint32_t i = 0; i < len; i++) chunk[i] = span[i];
+        fifo.popCommit(len);
+        for (uint32_t i = 0; i < len; i++) {
+          if (chunk[i] != expected) errors++;
+          expected++;
+        }
+      }
+    }
+  });
+
+  producer.join();
+  consumer.join();
+
+  EXPECT_EQ(0u, errors);
+  EXPECT_TRUE(fifo.isEmpty());
+  EXPECT_LE(fifo.getHighWaterMark(), 255u);
+}
@@ -66,6 +66,39 @@ TEST_F(SpecialFunctionsTest, FlightReset)
   EXPECT_EQ((bool)(mainRequestFlags & (1 << REQUEST_FLIGHT_RESET)), false);
 }
 
+TEST_F(SpecialFunctionsTest, EdgeFunctions)
+{
+  g_model.customFn[0].swtch = SWSRC_FIRST_SWITCH;
+  g_model.customFn[0].func = FUNC_SCREENSHOT;
+  g_model.customFn[0].active = true;
+  g_model.customFn[1].swtch = SWSRC_FIRST_SWITCH;
+  g_model.customFn[1].func = FUNC_RESET;
+  g_model.customFn[1].all.val = FUNC_RESET_TIMER1;
+  g_model.customFn[1].active = true;
+
+  simuSetSwitch(0, -1);
+  mainRequestFlags = 0;
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ((MASK_CFN_TYPE)1, modelFunctionsContext.index.edgeFunctions);
+  EXPECT_TRUE(mainRequestFlags & (1 << REQUEST_SCREENSHOT));
+
+  // held: the screenshot is skipped, the timer is still reset
+  mainRequestFlags = 0;
+  timersStates[0].val = 10;
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_FALSE(mainRequestFlags & (1 << REQUEST_SCREENSHOT));
+  EXPECT_EQ((MASK_CFN_TYPE)3, modelFunctionsContext.activeSwitches);
+  EXPECT_EQ(0, timersStates[0].val);
+
+  simuSetSwitch(0, 0);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ((MASK_CFN_TYPE)0, modelFunctionsContext.activeSwitches);
+
+  simuSetSwitch(0, -1);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_TRUE(mainRequestFlags & (1 << REQUEST_SCREENSHOT));
+}
+
 #if defined(GVARS)
 TEST_F(SpecialFunctionsTest, GvarsInc)
 {
@@ -123,5 +156,58 @@ TEST_F(SpecialFunctionsTest, GvarsInc)
 }
 #endif // #if defined(GVARS)
 
+#if defined(OVERRIDE_CHANNEL_FUNCTION)
+TEST_F(SpecialFunctionsTest, SwitchesIndex)
+{
+  // two functions on SA up, one on SA down
+  for (uint8_t i = 0; i < 3; i++) {
+    g_model.customFn[i * 20].swtch = (i < 2 ? SWSRC_FIRST_SWITCH : SWSRC_FIRST_SWITCH + 2);
+    g_model.customFn[i * 20].func = FUNC_OVERRIDE_CHANNEL;
+    g_model.customFn[i * 20].all.param = i;
+    g_model.customFn[i * 20].all.val = 10 * (i + 1);
+    g_model.customFn[i * 20].active = true;
+  }
+
+  simuSetSwitch(0, -1);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(3, modelFunctionsContext.index.count);
+  EXPECT_EQ(2, modelFunctionsContext.index.switchesCount);
+  EXPECT_EQ(10, safetyCh[0]);
+  EXPECT_EQ(20, safetyCh[1]);
+  EXPECT_EQ(OVERRIDE_CHANNEL_UNDEFINED, safetyCh[2]);
+  EXPECT_EQ((MASK_CFN_TYPE)1 | ((MASK_CFN_TYPE)1 << 20),
+            modelFunctionsContext.activeSwitches);
+
+  simuSetSwitch(0, 1);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(OVERRIDE_CHANNEL_UNDEFINED, safetyCh[0]);
+  EXPECT_EQ(OVERRIDE_CHANNEL_UNDEFINED, safetyCh[1]);
+  EXPECT_EQ(30, safetyCh[2]);
+  EXPECT_EQ((MASK_CFN_TYPE)1 << 40, modelFunctionsContext.activeSwitches);
+
+  // storageDirty() alone (GVAR or trim change) keeps the index
+  g_model.customFn[63].swtch = SWSRC_ON;
+  g_model.customFn[63].func = FUNC_OVERRIDE_CHANNEL;
+  g_model.customFn[63].all.param = 3;
+  g_model.customFn[63].active = true;
+  storageDirty(EE_MODEL);
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(3, modelFunctionsContext.index.count);
+  EXPECT_EQ(OVERRIDE_CHANNEL_UNDEFINED, safetyCh[3]);
+
+  // an edited function is seen once the editor bumped the generation
+  modelFunctionsContext.invalidateIndex();
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(4, modelFunctionsContext.index.count);
+  EXPECT_EQ(0, safetyCh[3]);
+
+  // a model load resets the context and rebuilds the index
+  g_model.customFn[63].swtch = SWSRC_NONE;
+  customFunctionsReset();
+  evalFunctions(g_model.customFn, modelFunctionsContext);
+  EXPECT_EQ(3, modelFunctionsContext.index.count);
+}
+#endif
+
 #endif // #if defined(PCBFRSKY)
 
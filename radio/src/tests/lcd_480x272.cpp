@@ -28,6 +28,9 @@
 
 #if defined(COLORLCD)
 
+#include "bitmap_cache.h"
+#include "text_cache.h"
+
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
@@ -195,6 +198,56 @@ TEST(Lcd_colorlcd, transparency)
   EXPECT_TRUE(checkScreenshot_colorlcd(&dc, "transparency_" TRANSLATIONS));
 }
 
+static void drawTextFrame(BitmapBuffer* dc)
+{
+  static const char* const labels[] = {"RSSI", "-67dB", "RxBt", "7.4V",
+                                       "Alt",  "123m",  "Curr", "12.5A"};
+  dc->clear(COLOR_THEME_SECONDARY3);
+  for (unsigned i = 0; i < DIM(labels); i++) {
+    coord_t y = (i / 2) * 30;
+    dc->drawText(0, y, labels[i], COLOR_THEME_SECONDARY1);
+    dc->drawText(LCD_W / 2, y, labels[i], COLOR_THEME_PRIMARY1 | CENTERED);
+    dc->drawText(LCD_W, y, labels[i], COLOR_THEME_SECONDARY1 | RIGHT);
+  }
+  dc->drawText(0, 130, "The quick brown fox jumps over the lazy dog",
+               COLOR_THEME_SECONDARY1 | FONT(L));
+  dc->drawText(-20, 200, "Clipped", COLOR_THEME_SECONDARY1 | FONT(XL));
+  dc->drawText(0, 240, "Two\nlines", COLOR_THEME_SECONDARY1);
+}
+
+TEST(Lcd_colorlcd, textCache)
+{
+  BitmapBuffer lvgl(BMP_RGB565, LCD_W, LCD_H);
+  BitmapBuffer cached(BMP_RGB565, LCD_W, LCD_H);
+
+  textCache.flush();
+  textCache.resetStats();
+
+  textCache.setEnabled(false);
+  drawTextFrame(&lvgl);
+  textCache.setEnabled(true);
+
+  // first frame fills the cache, the next ones only hit
+  drawTextFrame(&cached);
+  EXPECT_EQ(0, memcmp(lvgl.getData(), cached.getData(), lvgl.getDataSize()));
+  EXPECT_GT(textCache.getStats().entries, 0);
+  textCache.resetStats();
+  drawTextFrame(&cached);
+  EXPECT_EQ(0, memcmp(lvgl.getData(), cached.getData(), lvgl.getDataSize()));
+  EXPECT_EQ(0u, textCache.getStats().misses);
+  EXPECT_GT(textCache.getStats().hits, 0u);
+
+  // texts with a new line are not cached
+  EXPECT_EQ(nullptr, textCache.get(getFont(0), "Two\nlines", 9));
+
+  // budget exceeded: least recently used texts are dropped
+  textCache.setBudget(1024);
+  EXPECT_LE(textCache.getStats().bytesUsed, 1024u);
+  drawTextFrame(&cached);
+  EXPECT_EQ(0, memcmp(lvgl.getData(), cached.getData(), lvgl.getDataSize()));
+  textCache.setBudget(TEXT_CACHE_SIZE);
+}
+
 //
 // Fonts test are disabled, as they cause
 // too much trouble (font are generated and never
@@ -268,6 +321,116 @@ TEST(Lcd_colorlcd, bitmap)
   EXPECT_TRUE(checkScreenshot_colorlcd(&dc, "bitmap"));
 }
 
+TEST(Lcd_colorlcd, bitmapCache)
+{
+  BitmapCache cache;
+  const char* path = TESTS_PATH "/images/color/edgetx.png";
+
+  // same image: one decode, shared
+  const BitmapBuffer* bmp1 = cache.acquire(path);
+  ASSERT_NE(nullptr, bmp1);
+  const BitmapBuffer* bmp2 = cache.acquire(path);
+  EXPECT_EQ(bmp1, bmp2);
+  EXPECT_EQ(2, cache.getRefCount(bmp1));
+
+  BitmapCacheStats stats = cache.getStats();
+  EXPECT_EQ(1U, stats.misses);
+  EXPECT_EQ(1U, stats.hits);
+  EXPECT_EQ(bmp1->getDataSize(), stats.bytesSaved);
+
+  // same size: shared, other size: scaled copy, itself shared
+  EXPECT_EQ(bmp1, cache.acquireScaled(bmp1, bmp1->width(), bmp1->height()));
+  const BitmapBuffer* small = cache.acquireScaled(bmp1, 20, 10);
+  ASSERT_NE(nullptr, small);
+  EXPECT_NE(bmp1, small);
+  EXPECT_EQ(20, small->width());
+  EXPECT_EQ(small, cache.acquire(path, BMP_INVALID, 20, 10));
+  EXPECT_EQ(2, cache.getRefCount(small));
+
+  // charged once, whoever opened it first, until the last charged release
+  EXPECT_EQ(bmp1->getDataSize(), cache.charge(bmp1));
+  EXPECT_EQ(0U, cache.charge(bmp1));
+  EXPECT_EQ(0U, cache.uncharge(bmp1));
+  EXPECT_EQ(bmp1->getDataSize(), cache.uncharge(bmp1));
+  EXPECT_EQ(0U, cache.uncharge(bmp1));
+
+  cache.release(bmp1);
+  cache.release(bmp1);
+  cache.release(bmp1);
+  EXPECT_EQ(0, cache.getRefCount(bmp1));
+
+  // unreferenced bitmaps are kept until the budget is exceeded
+  EXPECT_EQ(2, cache.getStats().entries);
+  cache.setBudget(small->getDataSize());
+  EXPECT_EQ(0, cache.getRefCount(bmp1));
+  EXPECT_EQ(1, cache.getStats().entries);
+  EXPECT_EQ(small->getDataSize(), cache.getStats().bytesUsed);
+
+  cache.release(small);
+  cache.release(small);
+  cache.flush();
+  EXPECT_EQ(0, cache.getStats().entries);
+  EXPECT_EQ(0U, cache.getStats().bytesUsed);
+
+  EXPECT_EQ(nullptr, cache.acquire(TESTS_PATH "/images/color/none.png"));
+}
+
+static void copyFile(const char* from, const char* to)
+{
+  FILE* src = fopen(from, "rb");
+  FILE* dst = fopen(to, "wb");
+  ASSERT_TRUE(src && dst);
+  char buf[1024];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), src)) > 0) fwrite(buf, 1, len, dst);
+  fclose(src);
+  fclose(dst);
+}
+
+TEST(Lcd_colorlcd, bitmapSidecar)
+{
+  const char* path = TESTS_BUILD_PATH "/sidecar.png";
+  const char* sidecar = TESTS_BUILD_PATH "/sidecar.png" BITMAP_SIDECAR_EXT;
+
+  copyFile(TESTS_PATH "/images/color/edgetx.png", path);
+  remove(sidecar);
+
+  std::unique_ptr<BitmapBuffer> ref(BitmapBuffer::loadBitmap(path));
+  ASSERT_NE(nullptr, ref.get());
+
+  // first load writes the sidecar, then it is used instead of the PNG
+  BitmapBuffer::setSidecarsEnabled(true);
+  delete BitmapBuffer::loadBitmap(path);
+  FILE* f = fopen(sidecar, "rb");
+  ASSERT_NE(nullptr, f);
+  fclose(f);
+
+  std::unique_ptr<BitmapBuffer> bmp(BitmapBuffer::loadBitmap(path));
+  ASSERT_NE(nullptr, bmp.get());
+  EXPECT_EQ(ref->getFormat(), bmp->getFormat());
+  EXPECT_EQ(ref->width(), bmp->width());
+  EXPECT_EQ(ref->height(), bmp->height());
+  EXPECT_EQ(0, memcmp(ref->getData(), bmp->getData(), ref->getDataSize()));
+
+  // another requested format is not taken from the sidecar
+  std::unique_ptr<BitmapBuffer> rgb(BitmapBuffer::loadBitmap(path, BMP_RGB565));
+  ASSERT_NE(nullptr, rgb.get());
+  EXPECT_EQ(BMP_RGB565, rgb->getFormat());
+
+  // corrupted sidecar: the PNG is decoded again
+  f = fopen(sidecar, "r+b");
+  fseek(f, 0, SEEK_END);
+  fputc(0, f);
+  fclose(f);
+  bmp.reset(BitmapBuffer::loadBitmap(path));
+  ASSERT_NE(nullptr, bmp.get());
+  EXPECT_EQ(0, memcmp(ref->getData(), bmp->getData(), ref->getDataSize()));
+
+  BitmapBuffer::setSidecarsEnabled(false);
+  remove(sidecar);
+  remove(path);
+}
+
 TEST(Lcd_colorlcd, masks)
 {
   BitmapBuffer dc(BMP_RGB565, LCD_W, LCD_H);
@@ -188,4 +188,278 @@ TEST(Lua, Switches)
   luaExecStr("if MIXSRC_SB == nil then error('failed') end");
 }
 
+// big live heap (widgets like), plus garbage
+static void makeGarbage(lua_State* L)
+{
+  lua_gc(L, LUA_GCSTOP, 0);
+  luaExecStr("keep = {} for i = 1, 20000 do keep[i] = {i} end");
+  luaExecStr("for i = 1, 20000 do local t = {i, tostring(i)} end");
+}
+
+TEST(Lua, gcSlices)
+{
+  extern lua_State * lsScripts;
+  luaExecStr("keep = nil");
+  lua_State* L = lsScripts;
+
+  // before: a full collection at once
+  makeGarbage(L);
+  memclear(&luaGcStats, sizeof(luaGcStats));
+  luaDoGc(L, true);
+  uint32_t fullMem = luaGetMemUsed(L);
+
+  // after: 1ms slices until a cycle is done
+  makeGarbage(L);
+  uint32_t garbageMem = luaGetMemUsed(L);
+  memclear(&luaGcStats, sizeof(luaGcStats));
+  int slices = 0;
+  while (luaGcStats.cycles < 2 && slices < 10000) {
+    luaDoGc(L, false, 1000);
+    slices++;
+  }
+  EXPECT_EQ(2u, luaGcStats.cycles);
+  EXPECT_LT(luaGetMemUsed(L), garbageMem);
+  EXPECT_LE(luaGetMemUsed(L), fullMem + fullMem / 8);
+  EXPECT_GT(slices, 2);
+  EXPECT_GT(luaGcStats.stepTime, 0u);
+
+  lua_gc(L, LUA_GCRESTART, 0);
+  luaExecStr("keep = nil");
+  luaDoGc(L, true);
+}
+
+TEST(Lua, scriptStats)
+{
+  extern lua_State * lsScripts;
+  LuaScriptStats stats;
+  luaStatsInit(stats, LUA_POLICY_SCRIPT);
+  stats.timeBudgetUs = 1000;
+
+  // allocations are charged while the script runs
+  luaStatsStart(stats);
+  luaExecStr("keep = {} for i = 1, 1000 do keep[i] = {i} end");
+  luaStatsPause(stats);
+  EXPECT_GT(stats.allocated, 16000u);
+  uint32_t allocated = stats.allocated;
+#if defined(LUA_SCRIPT_MEMORY)
+  // and stay charged until collected, by whoever frees them
+  EXPECT_GT(stats.memory, 16000);
+  luaDoGc(lsScripts, true);
+  EXPECT_GT(stats.memory, 16000);
+  luaExecStr("keep = nil");
+  luaDoGc(lsScripts, true);
+  EXPECT_LT(stats.memory, 1000);
+#else
+  luaExecStr("keep = nil");
+  luaDoGc(lsScripts, true);
+#endif
+  EXPECT_EQ(allocated, stats.allocated);
+
+  // over the time budget: throttled, then disabled
+  auto run = [&](uint32_t us) {
+    stats.runUs = us;
+    return luaStatsStop(stats);
+  };
+  for (int i = 1; i < LUA_MAX_OVERRUNS; i++) {
+    EXPECT_EQ(LUA_BUDGET_OK, run(2000));
+  }
+  EXPECT_EQ(LUA_BUDGET_OK, run(500));
+  for (int i = 1; i < LUA_MAX_OVERRUNS; i++) {
+    EXPECT_EQ(LUA_BUDGET_OK, run(2000));
+  }
+  EXPECT_EQ(LUA_BUDGET_THROTTLED, run(2000));
+  EXPECT_EQ(1, stats.throttle);
+  EXPECT_EQ(2000u, stats.maxUs);
+
+  int runs = 0;
+  for (int i = 0; i < 8; i++) {
+    if (luaStatsRun(stats)) runs++;
+  }
+  EXPECT_EQ(4, runs);
+
+  // back within the budget: runs as often again
+  for (int i = 1; i < LUA_MAX_OVERRUNS; i++) {
+    EXPECT_EQ(LUA_BUDGET_THROTTLED, run(500));
+  }
+  EXPECT_EQ(LUA_BUDGET_OK, run(500));
+  EXPECT_EQ(0, stats.throttle);
+
+  for (int i = 1; i < (LUA_MAX_THROTTLE + 1) * LUA_MAX_OVERRUNS; i++) {
+    EXPECT_NE(LUA_BUDGET_CPU_EXCEEDED, run(2000));
+  }
+  EXPECT_EQ(LUA_MAX_THROTTLE, stats.throttle);
+  EXPECT_EQ(LUA_BUDGET_CPU_EXCEEDED, run(2000));
+  EXPECT_FALSE(luaStatsRun(stats));
+  luaStatsRelease(stats);
+
+  // a widget stays throttled
+  LuaScriptStats widget;
+  luaStatsInit(widget, LUA_POLICY_WIDGET);
+  widget.timeBudgetUs = 1000;
+  for (int i = 0; i < (LUA_MAX_THROTTLE + 2) * LUA_MAX_OVERRUNS; i++) {
+    widget.runUs = 2000;
+    EXPECT_NE(LUA_BUDGET_CPU_EXCEEDED, luaStatsStop(widget));
+  }
+  EXPECT_EQ(LUA_BUDGET_THROTTLED, widget.state);
+  EXPECT_EQ(LUA_MAX_THROTTLE, widget.throttle);
+  luaStatsRelease(widget);
+
+  // standalone scripts are only accounted
+  LuaScriptStats tool;
+  luaStatsInit(tool, LUA_POLICY_EXEMPT);
+  EXPECT_EQ(0u, tool.timeBudgetUs);
+  EXPECT_EQ(0u, tool.memBudget);
+  luaStatsRelease(tool);
+}
+
+#if defined(LUA_SCRIPT_MEMORY)
+TEST(Lua, scriptMemoryBudget)
+{
+  extern lua_State * lsScripts;
+  extern ScriptInternalData scriptInternalData[];
+  extern uint8_t luaScriptsCount;
+
+  // two function scripts, one keeping its tables, one making garbage
+  ScriptInternalData & keeper = scriptInternalData[0];
+  ScriptInternalData & churner = scriptInternalData[1];
+  keeper.reference = SCRIPT_GFUNC_FIRST;
+  churner.reference = SCRIPT_GFUNC_FIRST + 1;
+  luaStatsInit(keeper.stats, LUA_POLICY_SCRIPT);
+  luaStatsInit(churner.stats, LUA_POLICY_SCRIPT);
+  keeper.stats.memBudget = 32 * 1024;
+  churner.stats.memBudget = 32 * 1024;
+  luaScriptsCount = 2;
+
+  lua_gc(lsScripts, LUA_GCSTOP, 0);
+  luaStatsStart(churner.stats);
+  luaExecStr("for i = 1, 2000 do local t = {i, tostring(i)} end");
+  luaStatsPause(churner.stats);
+  lua_gc(lsScripts, LUA_GCRESTART, 0);
+  EXPECT_GT(churner.stats.memory, 32 * 1024);
+
+  luaStatsStart(keeper.stats);
+  luaExecStr("kept = {} for i = 1, 2000 do kept[i] = {i} end");
+  luaStatsPause(keeper.stats);
+
+  // the budgets are checked after a full collection: garbage is not an
+  // offence
+  checkLuaMemoryUsage();
+  EXPECT_LT(churner.stats.memory, 32 * 1024);
+  EXPECT_EQ(LUA_BUDGET_OK, churner.stats.state);
+  EXPECT_GT(keeper.stats.memory, 32 * 1024);
+  EXPECT_EQ(LUA_BUDGET_MEM_EXCEEDED, keeper.stats.state);
+  EXPECT_FALSE(luaStatsRun(keeper.stats));
+
+  luaStatsRelease(keeper.stats);
+  luaStatsRelease(churner.stats);
+  memclear(scriptInternalData, 2 * sizeof(ScriptInternalData));
+  luaScriptsCount = 0;
+  luaExecStr("kept = nil");
+  luaDoGc(lsScripts, true);
+}
+#endif
+
+#if defined(COLORLCD)
+#include <chrono>
+#include "lua/lua_display_list.h"
+
+// 6 widgets showing a channel value, with its name and a gauge
+static const char widgetsRefresh[] =
+    "function refreshWidgets()\n"
+    "  for i = 1, 6 do\n"
+    "    local v = getValue('ch' .. i)\n"
+    "    local y = (i - 1) * 40\n"
+    "    lcd.drawFilledRectangle(0, y, 160, 38, COLOR_THEME_SECONDARY3)\n"
+    "    lcd.drawText(2, y, 'CH' .. i, SMLSIZE)\n"
+    "    lcd.drawText(158, y + 10, string.format('%d%%', v / 10.24), RIGHT)\n"
+    "    lcd.drawGauge(2, y + 30, 156, 6, v + 1024, 2048, COLOR_THEME_PRIMARY1)\n"
+    "  end\n"
+    "end\n";
+
+static bool refreshWidgets(lua_State* L)
+{
+  lua_getglobal(L, "refreshWidgets");
+  return lua_pcall(L, 0, 0, 0) == 0;
+}
+
+TEST(Lua, displayList)
+{
+  extern lua_State * lsScripts;
+  luaExecStr(widgetsRefresh);
+  lua_State* L = lsScripts;
+
+  BitmapBuffer dc(BMP_RGB565, LCD_W, LCD_H);
+  BitmapBuffer replayed(BMP_RGB565, LCD_W, LCD_H);
+  luaLcdAllowed = true;
+
+  LuaDisplayList list;
+  dc.clear();
+  luaLcdBuffer = &dc;
+  list.startRecording(L);
+  EXPECT_TRUE(refreshWidgets(L));
+  list.stopRecording();
+  EXPECT_TRUE(list.isValid());
+  EXPECT_EQ(6 * 4, list.getCount());
+
+  // same drawing without running the script
+  replayed.clear();
+  luaLcdBuffer = &replayed;
+  EXPECT_TRUE(list.replay());
+  EXPECT_EQ(0, memcmp(dc.getData(), replayed.getData(), dc.getDataSize()));
+
+  // calls with tables can't be recorded
+  list.startRecording(L);
+  luaExecStr("lcd.drawText(0, 0, 'x', 0, {})");
+  list.stopRecording();
+  EXPECT_FALSE(list.isValid());
+
+  // recorded calls are charged to luaExtraMemoryUsage
+  uint32_t extra = luaExtraMemoryUsage;
+  {
+    LuaDisplayList other;
+    other.startRecording(L);
+    EXPECT_TRUE(refreshWidgets(L));
+    other.stopRecording();
+    EXPECT_GE(luaExtraMemoryUsage, extra + other.getSize());
+  }
+  EXPECT_EQ(extra, luaExtraMemoryUsage);
+
+  // too many calls: the list is dropped and not recorded again until cleared
+  list.startRecording(L);
+  luaExecStr("for i = 1, 2000 do lcd.drawText(0, 0, 'x') end");
+  list.stopRecording();
+  EXPECT_FALSE(list.isValid());
+  EXPECT_TRUE(list.isFull());
+  EXPECT_EQ(0u, list.getSize());
+  list.startRecording(L);
+  EXPECT_TRUE(refreshWidgets(L));
+  list.stopRecording();
+  EXPECT_FALSE(list.isValid());
+  list.clear();
+  EXPECT_FALSE(list.isFull());
+
+  // benchmark: script refresh vs replay
+  const int frames = 200;
+  list.startRecording(L);
+  refreshWidgets(L);
+  list.stopRecording();
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) refreshWidgets(L);
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < frames; i++) list.replay();
+  auto t2 = std::chrono::steady_clock::now();
+
+  luaLcdBuffer = nullptr;
+  luaLcdAllowed = false;
+
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  printf("6 widgets frame: refresh() %lldus, replay %lldus (%u bytes)\n",
+         (long long)duration_cast<microseconds>(t1 - t0).count() / frames,
+         (long long)duration_cast<microseconds>(t2 - t1).count() / frames,
+         list.getSize());
+}
+#endif
+
 #endif   // #if defined(LUA)
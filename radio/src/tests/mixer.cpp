@@ -19,8 +19,14 @@
  * GNU General Public License for more details.
  */
 
+#include <unistd.h>
+#include <atomic>
+
 #include "gtests.h"
 #include "hal/adc_driver.h"
+#include "mixes.h"
+#include "rtos.h"
+#include "tasks/mixer_task.h"
 
 class TrimsTest : public OpenTxTest {};
 class MixerTest : public OpenTxTest {};
@@ -1056,6 +1062,102 @@ TEST_F(MixerTest, flightModeOverflow)
   CHECK_FLIGHT_MODE_TRANSITION(0, 1000, 1024, 1024);
 }
 
+#define FADE_TICKS  400
+
+// Flips through the nine flight modes, one per tick, and records the
+// outputs while they fade
+static void runFlightModesFade(std::vector<int16_t> & outputs)
+{
+  for (uint8_t sw = 0; sw < 4; sw++)
+    simuSetSwitch(sw, -1);
+  for (int i = 0; i < FADE_TICKS; i++)
+    evalMixes(1);
+  EXPECT_EQ(0, getFlightMode());
+
+  outputs.clear();
+  for (int tick = 0; tick < FADE_TICKS; tick++) {
+    if (tick < MAX_FLIGHT_MODES) {
+      // FM1..FM8 are the middle and down positions of SA..SD
+      for (uint8_t sw = 0; sw < 4; sw++)
+        simuSetSwitch(sw, -1);
+      if (tick > 0)
+        simuSetSwitch((tick - 1) / 2, (tick - 1) % 2);
+      EXPECT_EQ(tick, getFlightMode());
+    }
+    anaSetFiltered(0, (tick * 37) % 2048 - 1024);
+    anaSetFiltered(2, (tick * 13) % 2048 - 1024);
+
+    evalMixes(1);
+    outputs.insert(outputs.end(), channelOutputs, channelOutputs + MAX_OUTPUT_CHANNELS);
+    outputs.insert(outputs.end(), anas, anas + MAX_INPUTS);
+  }
+}
+
+TEST_F(MixerTest, flightModesFadeSharedLines)
+{
+  if (switchGetMaxSwitches() < 4) return;
+  for (uint8_t sw = 0; sw < 4; sw++)
+    g_eeGeneral.switchConfig |= (swconfig_t)SWITCH_3POS << (sw * SW_CFG_BITS);
+
+  for (uint8_t p = 0; p < MAX_FLIGHT_MODES; p++) {
+    FlightModeData * fm = flightModeAddress(p);
+    if (p > 0)
+      fm->swtch = SWSRC_FIRST_SWITCH + 3 * ((p - 1) / 2) + 1 + (p - 1) % 2;
+    fm->fadeIn = fm->fadeOut = 20;
+    // own trim on the first stick only, the other ones are FM0 trims
+    fm->trim[0].mode = 2 * p;
+    fm->trim[0].value = 8 * p;
+#if defined(GVARS)
+    fm->gvars[0] = 10 * p;
+#endif
+  }
+
+  // setModelDefaults() gives inputs and mixes on CH1..CH4
+  MixData * md = mixAddress(4);
+  md->destCh = 4;  // flight mode filtered line
+  md->srcRaw = MIXSRC_FIRST_STICK + 1;
+  md->weight = 100;
+  md->flightModes = 0b10;
+
+  md++;
+  md->destCh = 5;  // stick without trim, shared
+  md->srcRaw = MIXSRC_FIRST_STICK + 2;
+  md->carryTrim = 1;
+  md->weight = 80;
+  md->offset = 10;
+  md->curve.type = CURVE_REF_EXPO;
+  md->curve.value = 30;
+
+  md++;
+  md->destCh = 6;  // shared lines multiplexed
+  md->srcRaw = MIXSRC_MAX;
+  md->weight = 50;
+  md++;
+  md->destCh = 6;
+  md->srcRaw = MIXSRC_FIRST_STICK + 2;
+  md->carryTrim = 1;
+  md->mltpx = MLTPX_MUL;
+  md->weight = 100;
+
+#if defined(GVARS)
+  md++;
+  md->destCh = 7;  // GVAR weight
+  md->srcRaw = MIXSRC_MAX;
+  md->weight = GV_CALC_VALUE_IDX_POS(0, GV1_LARGE);  // GV1
+#endif
+
+  std::vector<int16_t> reference, shared;
+  mixerFadeSharing = false;
+  runFlightModesFade(reference);
+  mixerFadeSharing = true;
+  runFlightModesFade(shared);
+
+  ASSERT_EQ(reference.size(), shared.size());
+  for (size_t i = 0; i < reference.size(); i++) {
+    ASSERT_EQ(reference[i], shared[i]) << "index " << i;
+  }
+}
+
 TEST_F(TrimsTest, throttleTrimWithCrossTrims)
 {
   g_model.thrTrim = 1;
@@ -1224,3 +1326,118 @@ TEST_F(TrimsTest, invertedThrottlePlusThrottleTrimWithCrossTrims)
   EXPECT_EQ(channelOutputs[THR_CHAN], +1024);
   EXPECT_EQ(channelOutputs[ELE_CHAN], 0);
 }
+
+static std::atomic<bool> mixerRunning;
+static std::atomic<uint32_t> mixerCycles;
+static std::atomic<uint32_t> incompleteModels;
+static uint8_t mixesCount;
+
+// lines sorted by channel, 'count' or 'count + 1' of them
+static bool isMixesEditComplete(uint8_t count)
+{
+  uint8_t lines = 0;
+  while (lines < MAX_MIXERS && !is_memclear(mixAddress(lines), sizeof(MixData))) {
+    if (lines > 0 && mixAddress(lines)->destCh < mixAddress(lines - 1)->destCh)
+      return false;
+    lines++;
+  }
+  return lines == count || lines == count + 1;
+}
+
+static void * mixerLoop(void *)
+{
+  while (mixerRunning) {
+    mixerTaskLock();
+    mixerTaskApplyEdit();
+    if (!isMixesEditComplete(mixesCount))
+      incompleteModels++;
+    evalMixes(1);
+    mixerTaskUnlock();
+    mixerCycles++;
+    usleep(500);
+  }
+  return nullptr;
+}
+
+TEST_F(MixerTest, structuralEditsDuringMixing)
+{
+  updateMixCount();
+  uint8_t count = getMixCount();
+  ASSERT_GT(count, 0);
+  mixesCount = count;
+
+  mixerCycles = 0;
+  incompleteModels = 0;
+  mixerRunning = true;
+  mixerTaskStart();
+
+  pthread_t mixer;
+  RTOS_CREATE_TASK(mixer, mixerLoop, "mixer");
+
+  for (int i = 0; i < 200; i++) {
+    insertMix(1, mixAddress(0)->destCh);
+    EXPECT_EQ(count + 1, getMixCount());
+    deleteMix(1);
+  }
+
+  mixerRunning = false;
+  RTOS_JOIN_TASK(mixer);
+  mixerTaskStop();
+
+  EXPECT_GE(mixerCycles, 400u);
+  EXPECT_EQ(0u, incompleteModels);
+  EXPECT_EQ(count, getMixCount());
+}
+
+static std::atomic<uint32_t> editsTotal;
+
+static void addToEditsTotal(void * ctx)
+{
+  editsTotal += *(const uint32_t *)ctx;
+}
+
+static void commitEdits(uint32_t value)
+{
+  for (int i = 0; i < 200; i++) {
+    uint32_t ctx = value;
+    mixerTaskCommitEdit(addToEditsTotal, &ctx);
+  }
+}
+
+static void * committerOnes(void *)
+{
+  commitEdits(1);
+  return nullptr;
+}
+
+static void * committerThousands(void *)
+{
+  commitEdits(1000);
+  return nullptr;
+}
+
+TEST_F(MixerTest, concurrentEditCommitters)
+{
+  updateMixCount();
+  mixesCount = getMixCount();
+
+  editsTotal = 0;
+  mixerRunning = true;
+  mixerTaskStart();
+
+  pthread_t mixer;
+  RTOS_CREATE_TASK(mixer, mixerLoop, "mixer");
+
+  // each edit must run once, with the context of its own committer
+  pthread_t ones, thousands;
+  RTOS_CREATE_TASK(ones, committerOnes, "committer");
+  RTOS_CREATE_TASK(thousands, committerThousands, "committer");
+  RTOS_JOIN_TASK(ones);
+  RTOS_JOIN_TASK(thousands);
+
+  mixerRunning = false;
+  RTOS_JOIN_TASK(mixer);
+  mixerTaskStop();
+
+  EXPECT_EQ(200u * (1 + 1000), editsTotal);
+}
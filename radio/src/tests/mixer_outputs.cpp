@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include <atomic>
+
+#include "gtests.h"
+#include "rtos.h"
+#include "mixer_outputs.h"
+
+#define PUBLISHED_FRAMES  200000
+#define READERS           3
+
+static std::atomic<bool> readersRunning;
+static std::atomic<uint32_t> tornFrames;
+static std::atomic<uint32_t> readFrames;
+
+// each frame holds (frame + channel) in the channels, minus that in the mixes
+static void writeFrame(int16_t frame)
+{
+  for (uint8_t i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+    channelOutputs[i] = frame + i;
+    ex_chans[i] = -(frame + i);
+  }
+  mixerCurrentFlightMode = (uint16_t)frame % MAX_FLIGHT_MODES;
+}
+
+static bool isFrameConsistent(const MixerOutputs & outputs)
+{
+  int16_t frame = outputs.channels[0];
+  for (uint8_t i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+    if (outputs.channels[i] != (int16_t)(frame + i) ||
+        outputs.mixes[i] != (int16_t)-(frame + i))
+      return false;
+  }
+  return outputs.flightMode == (uint16_t)frame % MAX_FLIGHT_MODES;
+}
+
+static void * readerTask(void *)
+{
+  uint32_t lastVersion = 0;
+  while (readersRunning) {
+    MixerOutputs outputs;
+    if (!mixerOutputsRead(outputs))
+      continue;
+    if (!isFrameConsistent(outputs) || outputs.version < lastVersion)
+      tornFrames++;
+    lastVersion = outputs.version;
+    readFrames++;
+  }
+  return nullptr;
+}
+
+static void publishFrames(int count)
+{
+  for (int frame = 0; frame < count; frame++) {
+    writeFrame(frame);
+    mixerOutputsPublish();
+  }
+}
+
+class MixerOutputsTest : public OpenTxTest {};
+
+TEST_F(MixerOutputsTest, publishedSnapshot)
+{
+  writeFrame(100);
+  mixerOutputsPublish();
+
+  MixerOutputs outputs;
+  EXPECT_TRUE(mixerOutputsRead(outputs));
+  EXPECT_TRUE(isFrameConsistent(outputs));
+  EXPECT_EQ(100, outputs.channels[0]);
+
+  uint32_t version = outputs.version;
+  writeFrame(200);
+  mixerOutputsPublish();
+  EXPECT_TRUE(mixerOutputsRead(outputs));
+  EXPECT_EQ(200, outputs.channels[0]);
+  EXPECT_EQ(version + 1, outputs.version);
+
+  int16_t channels[MAX_OUTPUT_CHANNELS];
+  EXPECT_TRUE(mixerOutputsReadChannels(channels));
+  EXPECT_EQ(0, memcmp(channels, outputs.channels, sizeof(channels)));
+}
+
+TEST_F(MixerOutputsTest, concurrentReaders)
+{
+  pthread_t readers[READERS];
+  tornFrames = 0;
+  readFrames = 0;
+  readersRunning = true;
+  for (uint8_t i = 0; i < READERS; i++) {
+    RTOS_CREATE_TASK(readers[i], readerTask, "reader");
+  }
+
+  publishFrames(PUBLISHED_FRAMES);
+
+  readersRunning = false;
+  for (uint8_t i = 0; i < READERS; i++) {
+    RTOS_JOIN_TASK(readers[i]);
+  }
+
+  EXPECT_GT(readFrames, 0u);
+  EXPECT_EQ(0u, tornFrames);
+}
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include "gtests.h"
+#include "pulses/channels_packing.h"
+#include "pulses/sbus.h"
+#include "pulses/multi.h"
+
+// Per channel encoders, as they were before channels_packing.h
+static uint8_t* legacyPack(uint8_t* buf, const uint16_t* values, int count,
+                           int chBits)
+{
+  uint32_t bits = 0;
+  uint8_t bitsavailable = 0;
+  for (int i = 0; i < count; i++) {
+    bits |= values[i] << bitsavailable;
+    bitsavailable += chBits;
+    while (bitsavailable >= 8) {
+      *buf++ = bits;
+      bits >>= 8;
+      bitsavailable -= 8;
+    }
+  }
+  return buf;
+}
+
+static uint8_t* legacyPxx2Pack(uint8_t* buf, const uint16_t* values, int count)
+{
+  uint16_t low = 0;
+  for (int i = 0; i < count; i++) {
+    if (i & 1) {
+      uint16_t high = values[i];
+      *buf++ = low;
+      *buf++ = ((low >> 8u) & 0x0Fu) | (high << 4u);
+      *buf++ = high >> 4u;
+    } else {
+      low = values[i];
+    }
+  }
+  return buf;
+}
+
+static uint16_t legacyPxx2Scale(int channel, int offset)
+{
+  int value = channel + offset;
+  return limit(1, (value * 512 / 682) + 1024, 2046);
+}
+
+static uint16_t legacyMultiScale(int channel, int offset)
+{
+  int value = channel + offset;
+  value = value * 800 / 1000 + 1024;
+  return limit(0, value, 2047);
+}
+
+static uint16_t legacySbusScale(int channel, int offset)
+{
+  int value = channel + offset;
+  value = value * 8 / 10 + 992;
+  return limit(0, value, 2047);
+}
+
+static uint16_t legacyCrossfireScale(int channel, int offset)
+{
+  return limit(0, 0x3E0 + (offset * 4) / 5 + (channel * 4) / 5, 2 * 0x3E0);
+}
+
+static void randomValues(uint16_t* values, int count, uint16_t max)
+{
+  for (int i = 0; i < count; i++) {
+    values[i] = rand() % (max + 1);
+  }
+}
+
+TEST(ChannelsPacking, pack11)
+{
+  uint16_t values[MAX_OUTPUT_CHANNELS];
+  uint8_t expected[64];
+  uint8_t packed[64];
+
+  for (int n = 0; n < 1000; n++) {
+    int count = 1 + (rand() % MAX_OUTPUT_CHANNELS);
+    randomValues(values, count, 2047);
+    memset(expected, 0, sizeof(expected));
+    memset(packed, 0, sizeof(packed));
+
+    uint8_t* end = legacyPack(expected, values, count, 11);
+    // the legacy encoders dropped the last incomplete byte, packChannels()
+    // writes it with the high bits of the last channel, zero padded
+    int remainingBits = (count * 11) % 8;
+    if (remainingBits) {
+      *end++ = values[count - 1] >> (11 - remainingBits);
+    }
+    EXPECT_EQ(end - expected, packChannels<11>(packed, values, count) - packed);
+    EXPECT_EQ(0, memcmp(expected, packed, sizeof(packed)));
+  }
+}
+
+TEST(ChannelsPacking, pack12)
+{
+  uint16_t values[MAX_OUTPUT_CHANNELS];
+  uint8_t expected[64];
+  uint8_t packed[64];
+
+  for (int n = 0; n < 1000; n++) {
+    int count = 2 * (1 + (rand() % (MAX_OUTPUT_CHANNELS / 2)));
+    randomValues(values, count, 2047);
+    memset(expected, 0, sizeof(expected));
+    memset(packed, 0, sizeof(packed));
+
+    uint8_t* end = legacyPxx2Pack(expected, values, count);
+    EXPECT_EQ(end - expected, packChannels<12>(packed, values, count) - packed);
+    EXPECT_EQ(0, memcmp(expected, packed, sizeof(packed)));
+  }
+}
+
+TEST(ChannelsPacking, roundTrip)
+{
+  uint16_t values[MAX_OUTPUT_CHANNELS];
+  uint16_t unpacked[MAX_OUTPUT_CHANNELS];
+  uint8_t packed[64];
+
+  for (int count = 1; count <= MAX_OUTPUT_CHANNELS; count++) {
+    randomValues(values, count, 2047);
+    memset(packed, 0xFF, sizeof(packed));
+    uint8_t* end = packChannels<11>(packed, values, count);
+    EXPECT_EQ((count * 11 + 7) / 8, end - packed);
+    EXPECT_EQ(end, unpackChannels<11>(packed, unpacked, count));
+    EXPECT_EQ(0, memcmp(values, unpacked, count * sizeof(uint16_t)));
+  }
+
+  randomValues(values, MAX_OUTPUT_CHANNELS, 2047);
+  packChannels<11>(packed, values, MAX_OUTPUT_CHANNELS);
+  unpackChannels<11>(packed, unpacked, MAX_OUTPUT_CHANNELS);
+  EXPECT_EQ(0, memcmp(values, unpacked, sizeof(values)));
+
+  randomValues(values, MAX_OUTPUT_CHANNELS, 4095);
+  packChannels<12>(packed, values, MAX_OUTPUT_CHANNELS);
+  unpackChannels<12>(packed, unpacked, MAX_OUTPUT_CHANNELS);
+  EXPECT_EQ(0, memcmp(values, unpacked, sizeof(values)));
+
+  randomValues(values, MAX_OUTPUT_CHANNELS, 65535);
+  packChannels<16>(packed, values, MAX_OUTPUT_CHANNELS);
+  unpackChannels<16>(packed, unpacked, MAX_OUTPUT_CHANNELS);
+  EXPECT_EQ(0, memcmp(values, unpacked, sizeof(values)));
+}
+
+TEST(ChannelsPacking, scaling)
+{
+  for (int offset = -1000; offset <= 1000; offset += 125) {
+    for (int channel = -1536; channel <= 1536; channel++) {
+      ASSERT_EQ(legacyPxx2Scale(channel, offset),
+                Pxx2ChannelScaling::scale(channel, offset));
+      ASSERT_EQ(legacyMultiScale(channel, offset),
+                MultiChannelScaling::scale(channel, offset));
+      ASSERT_EQ(legacySbusScale(channel, offset),
+                SbusChannelScaling::scale(channel, offset));
+      ASSERT_EQ(legacyCrossfireScale(channel, offset + 1),
+                CrossfireChannelScaling::scale(channel, offset + 1));
+    }
+  }
+}
+
+#if defined(CROSSFIRE)
+#include "telemetry/crossfire.h"
+
+uint8_t createCrossfireChannelsFrame(uint8_t * frame, int16_t * pulses);
+
+TEST_F(OpenTxTest, crossfireChannelsFrame)
+{
+  int16_t pulses[CROSSFIRE_CHANNELS_COUNT];
+  uint16_t values[CROSSFIRE_CHANNELS_COUNT];
+  uint8_t expected[CROSSFIRE_FRAME_MAXLEN];
+  uint8_t frame[CROSSFIRE_FRAME_MAXLEN];
+
+  for (int n = 0; n < 100; n++) {
+    for (int i = 0; i < CROSSFIRE_CHANNELS_COUNT; i++) {
+      pulses[i] = -1536 + rand() % 3073;
+#if defined(PPM_CENTER_ADJUSTABLE)
+      g_model.limitData[i].ppmCenter = -500 + rand() % 1001;
+      int offset = 2 * g_model.limitData[i].ppmCenter + 1;
+#else
+      int offset = 0;
+#endif
+      values[i] = legacyCrossfireScale(pulses[i], offset);
+    }
+
+    memset(expected, 0, sizeof(expected));
+    memset(frame, 0, sizeof(frame));
+    expected[0] = MODULE_ADDRESS;
+    expected[1] = 24;
+    expected[2] = CHANNELS_ID;
+    legacyPack(&expected[3], values, CROSSFIRE_CHANNELS_COUNT, 11);
+    expected[25] = crc8(&expected[2], 23);
+
+    EXPECT_EQ(26, createCrossfireChannelsFrame(frame, pulses));
+    EXPECT_EQ(0, memcmp(expected, frame, sizeof(frame)));
+  }
+}
+#endif
+
+// Random outputs, PPM centers and failsafe values on all the channels
+static void randomOutputs()
+{
+  for (int i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+    channelOutputs[i] = -1536 + rand() % 3073;
+#if defined(PPM_CENTER_ADJUSTABLE)
+    g_model.limitData[i].ppmCenter = -500 + rand() % 1001;
+#endif
+    switch (rand() % 8) {
+      case 0:
+        g_model.failsafeChannels[i] = FAILSAFE_CHANNEL_HOLD;
+        break;
+      case 1:
+        g_model.failsafeChannels[i] = FAILSAFE_CHANNEL_NOPULSE;
+        break;
+      default:
+        g_model.failsafeChannels[i] = -1024 + rand() % 2049;
+        break;
+    }
+  }
+}
+
+static int ppmCenterOffset(int channel)
+{
+  return 2 * PPM_CH_CENTER(channel) - 2 * PPM_CENTER;
+}
+
+TEST_F(OpenTxTest, sbusFrame)
+{
+  uint16_t values[16];
+  uint8_t expected[25];
+  uint8_t frame[25];
+
+  g_model.moduleData[EXTERNAL_MODULE].type = MODULE_TYPE_SBUS;
+  for (int n = 0; n < 100; n++) {
+    randomOutputs();
+    // channels 17 and 18 are sent as flags
+    uint8_t start = rand() % (MAX_OUTPUT_CHANNELS - 17);
+    g_model.moduleData[EXTERNAL_MODULE].channelsStart = start;
+
+    // frame as built before channels_packing.h
+    for (int i = 0; i < 16; i++) {
+      values[i] = legacySbusScale(channelOutputs[start + i],
+                                  ppmCenterOffset(start + i));
+    }
+    expected[0] = 0x0F;
+    legacyPack(&expected[1], values, 16, 11);
+    expected[23] = 0;
+    if (channelOutputs[start + 16] + ppmCenterOffset(start + 16) > 0)
+      expected[23] |= 1 << 0;
+    if (channelOutputs[start + 17] + ppmCenterOffset(start + 17) > 0)
+      expected[23] |= 1 << 1;
+    expected[24] = 0;
+
+    memset(frame, 0xFF, sizeof(frame));
+    uint8_t* p = frame;
+    setupPulsesSbus(EXTERNAL_MODULE, p);
+    EXPECT_EQ(25, p - frame);
+    EXPECT_EQ(0, memcmp(expected, frame, sizeof(frame)));
+  }
+}
+
+#if defined(MULTIMODULE)
+
+static uint16_t legacyMultiFailsafe(uint8_t module, int i)
+{
+  int16_t failsafeValue = g_model.failsafeChannels[i];
+  if (g_model.moduleData[module].failsafeMode == FAILSAFE_HOLD ||
+      failsafeValue == FAILSAFE_CHANNEL_HOLD)
+    return 2047;
+  if (g_model.moduleData[module].failsafeMode == FAILSAFE_NOPULSES ||
+      failsafeValue == FAILSAFE_CHANNEL_NOPULSE)
+    return 0;
+  failsafeValue +=
+      ppmCenterOffset(g_model.moduleData[module].channelsStart + i);
+  return limit(1, (failsafeValue * 800 / 1000) + 1024, 2046);
+}
+
+TEST_F(OpenTxTest, multiChannelsFrame)
+{
+  static const uint8_t failsafeModes[] = {FAILSAFE_CUSTOM, FAILSAFE_HOLD,
+                                          FAILSAFE_NOPULSES};
+  uint16_t values[16];
+  uint8_t expected[22];
+  uint8_t frame[22];
+
+  g_model.moduleData[EXTERNAL_MODULE].type = MODULE_TYPE_MULTIMODULE;
+  for (int n = 0; n < 100; n++) {
+    randomOutputs();
+    uint8_t start = rand() % 16;
+    g_model.moduleData[EXTERNAL_MODULE].channelsStart = start;
+    g_model.moduleData[EXTERNAL_MODULE].failsafeMode = failsafeModes[n % 3];
+
+    for (int i = 0; i < 16; i++) {
+      values[i] = legacyMultiScale(channelOutputs[start + i],
+                                   ppmCenterOffset(start + i));
+    }
+    legacyPack(expected, values, 16, 11);
+    memset(frame, 0xFF, sizeof(frame));
+    uint8_t* p = frame;
+    sendMultiChannels(p, EXTERNAL_MODULE);
+    EXPECT_EQ(22, p - frame);
+    EXPECT_EQ(0, memcmp(expected, frame, sizeof(frame)));
+
+    // failsafe values are read from the first channels
+    for (int i = 0; i < 16; i++) {
+      values[i] = legacyMultiFailsafe(EXTERNAL_MODULE, i);
+    }
+    legacyPack(expected, values, 16, 11);
+    memset(frame, 0xFF, sizeof(frame));
+    p = frame;
+    sendMultiFailsafeChannels(p, EXTERNAL_MODULE);
+    EXPECT_EQ(22, p - frame);
+    EXPECT_EQ(0, memcmp(expected, frame, sizeof(frame)));
+  }
+}
+#endif
+
+#if defined(PXX2)
+#include "pulses/pxx2.h"
+
+// frame CRC, as computed by the transport
+struct Pxx2LegacyCrc : public Pxx2CrcMixin {
+  uint16_t compute(const uint8_t* data, int len)
+  {
+    crc = 0xFFFF;
+    for (int i = 0; i < len; i++) addToCrc(data[i]);
+    return crc;
+  }
+};
+
+static uint16_t legacyPxx2Failsafe(uint8_t module, int channel)
+{
+  if (g_model.moduleData[module].failsafeMode == FAILSAFE_HOLD) return 2047;
+  if (g_model.moduleData[module].failsafeMode == FAILSAFE_NOPULSES) return 0;
+  int16_t failsafeValue = g_model.failsafeChannels[channel];
+  if (failsafeValue == FAILSAFE_CHANNEL_HOLD) return 2047;
+  if (failsafeValue == FAILSAFE_CHANNEL_NOPULSE) return 0;
+  failsafeValue += ppmCenterOffset(channel);
+  return limit(1, (failsafeValue * 512 / 682) + 1024, 2046);
+}
+
+TEST_F(OpenTxTest, pxx2ChannelsFrame)
+{
+  static const uint8_t failsafeModes[] = {FAILSAFE_CUSTOM, FAILSAFE_HOLD,
+                                          FAILSAFE_NOPULSES};
+  uint16_t values[MAX_OUTPUT_CHANNELS];
+  uint8_t expected[64];
+  uint8_t frame[64];
+
+  ModuleData& md = g_model.moduleData[EXTERNAL_MODULE];
+  md.type = MODULE_TYPE_R9M_PXX2;
+  moduleState[EXTERNAL_MODULE].mode = MODULE_MODE_NORMAL;
+
+  for (int n = 0; n < 200; n++) {
+    randomOutputs();
+    md.channelsCount = rand() % 9;
+    md.channelsStart = rand() % (MAX_OUTPUT_CHANNELS - 8 - md.channelsCount + 1);
+    md.failsafeMode = failsafeModes[n % 3];
+
+    // every other frame is a failsafe frame
+    bool failsafe = n & 1;
+    moduleState[EXTERNAL_MODULE].counter = failsafe ? 0 : 100;
+
+    uint8_t start = md.channelsStart;
+    int count = sentModuleChannels(EXTERNAL_MODULE);
+    for (int i = 0; i < count; i++) {
+      values[i] = failsafe ? legacyPxx2Failsafe(EXTERNAL_MODULE, start + i)
+                           : legacyPxx2Scale(channelOutputs[start + i],
+                                             ppmCenterOffset(start + i));
+    }
+
+    memset(frame, 0, sizeof(frame));
+    Pxx2Pulses pulses(frame);
+    pulses.setupFrame(EXTERNAL_MODULE, &channelOutputs[start], count);
+    int size = pulses.getSize();
+
+    // head, type and flags are not concerned by the change
+    memset(expected, 0, sizeof(expected));
+    memcpy(expected, frame, 6);
+    EXPECT_EQ(failsafe, (frame[4] & PXX2_CHANNELS_FLAG0_FAILSAFE) != 0);
+    uint8_t* end = legacyPxx2Pack(&expected[6], values, count);
+    expected[1] = end - expected - 2;
+    uint16_t crc = Pxx2LegacyCrc().compute(&expected[2], end - expected - 2);
+    *end++ = crc >> 8;
+    *end++ = crc;
+
+    EXPECT_EQ(end - expected, size);
+    EXPECT_EQ(0, memcmp(expected, frame, sizeof(frame)));
+  }
+}
+#endif
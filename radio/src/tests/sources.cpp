@@ -20,6 +20,7 @@
  */
 
 #include "gtests.h"
+#include "hal/adc_driver.h"
 
 #include "storage/yaml/yaml_tree_walker.h"
 #include "storage/yaml/yaml_parser.h"
@@ -120,3 +121,94 @@ TEST(Sources, getSourceString)
   EXPECT_STREQ(getSourceString(MIXSRC_FIRST_TRIM + 2), STR_CHAR_TRIM "Thr");
 #endif
 }
+
+TEST_F(OpenTxTest, getValueRanges)
+{
+  bool valid = true;
+  EXPECT_EQ(0, getValue(MIXSRC_NONE, &valid));
+  EXPECT_FALSE(valid);
+
+  valid = true;
+  EXPECT_EQ(-RESX, getValue(MIXSRC_MIN, &valid));
+  EXPECT_EQ(RESX, getValue(MIXSRC_MAX, &valid));
+  EXPECT_TRUE(valid);
+
+  valid = true;
+  EXPECT_EQ(0, getValue(MIXSRC_LAST_TELEM + 1, &valid));
+  EXPECT_FALSE(valid);
+
+  ex_chans[0] = 123;
+  ex_chans[MAX_OUTPUT_CHANNELS - 1] = -456;
+  EXPECT_EQ(123, getValue(MIXSRC_FIRST_CH));
+  EXPECT_EQ(-456, getValue(MIXSRC_LAST_CH));
+}
+
+TEST_F(OpenTxTest, getValueFixedValues)
+{
+  for (unsigned i = 0; i < MAX_INPUTS; i++) {
+    anas[i] = 50 - i * 3;
+  }
+  for (unsigned i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+    ex_chans[i] = i * 10 - 100;
+  }
+  calibratedAnalogs[inputMappingConvertMode(0)] = -300;
+  calibratedAnalogs[adcGetInputOffset(ADC_INPUT_FLEX)] = 400;
+  trainerInput[0] = 100;
+  trainerInput[MAX_TRAINER_CHANNELS - 1] = -200;
+  g_vbat100mV = 82;
+  timersStates[0].val = 75;
+  telemetryItems[1].value = 1234;
+  telemetryItems[1].valueMin = -10;
+  telemetryItems[1].valueMax = 2000;
+
+  bool valid = true;
+  EXPECT_EQ(50, getValue(MIXSRC_FIRST_INPUT, &valid));
+  EXPECT_EQ(50 - (MAX_INPUTS - 1) * 3, getValue(MIXSRC_LAST_INPUT, &valid));
+  EXPECT_EQ(-300, getValue(MIXSRC_FIRST_STICK, &valid));
+  EXPECT_EQ(400, getValue(MIXSRC_FIRST_POT, &valid));
+  EXPECT_EQ(0, getValue(MIXSRC_FIRST_TRIM, &valid));
+  EXPECT_EQ(-1024, getValue(MIXSRC_FIRST_LOGICAL_SWITCH, &valid));
+  EXPECT_EQ(200, getValue(MIXSRC_FIRST_TRAINER, &valid));
+  EXPECT_EQ(-400, getValue(MIXSRC_LAST_TRAINER, &valid));
+  EXPECT_EQ(-100, getValue(MIXSRC_FIRST_CH, &valid));
+  EXPECT_EQ(82, getValue(MIXSRC_TX_VOLTAGE, &valid));
+  EXPECT_EQ(75, getValue(MIXSRC_FIRST_TIMER, &valid));
+  EXPECT_EQ(1234, getValue(MIXSRC_FIRST_TELEM + 3, &valid));
+  EXPECT_EQ(-10, getValue(MIXSRC_FIRST_TELEM + 4, &valid));
+  EXPECT_EQ(2000, getValue(MIXSRC_FIRST_TELEM + 5, &valid));
+  EXPECT_TRUE(valid);
+
+#if defined(GVARS)
+  g_model.flightModeData[0].gvars[1] = -33;
+  EXPECT_EQ(-33, getValue(MIXSRC_FIRST_GVAR + 1));
+#endif
+}
+
+TEST_F(OpenTxTest, getValuesSameAsGetValue)
+{
+  for (unsigned i = 0; i < MAX_OUTPUT_CHANNELS; i++) {
+    ex_chans[i] = i * 10 - 100;
+  }
+
+  // all the sources, then the same in reverse order (range changes)
+  mixsrc_t sources[MIXSRC_LAST_TELEM + 2];
+  getvalue_t values[MIXSRC_LAST_TELEM + 2];
+  for (mixsrc_t src = 0; src <= MIXSRC_LAST_TELEM + 1; src += 255) {
+    uint8_t count = 0;
+    for (mixsrc_t i = src; i <= MIXSRC_LAST_TELEM + 1 && count < 255; i++) {
+      sources[count++] = i;
+    }
+    getValues(sources, values, count);
+    for (uint8_t n = 0; n < count; n++) {
+      ASSERT_EQ(getValue(sources[n]), values[n]) << "source " << sources[n];
+    }
+
+    for (uint8_t n = 0; n < count / 2; n++) {
+      std::swap(sources[n], sources[count - 1 - n]);
+    }
+    getValues(sources, values, count);
+    for (uint8_t n = 0; n < count; n++) {
+      ASSERT_EQ(getValue(sources[n]), values[n]) << "source " << sources[n];
+    }
+  }
+}
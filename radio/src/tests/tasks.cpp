@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   opentx - https://github.com/opentx/opentx
+ *   th9x - http://code.google.com/p/th9x
+ *   er9x - http://code.google.com/p/er9x
+ *   gruvin9x - http://code.google.com/p/gruvin9x
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+
+#include <unistd.h>
+#include <atomic>
+
+#include "gtests.h"
+#include "rtos.h"
+#include "tasks/task_placement.h"
+
+static std::atomic<bool> tasksRunning;
+
+static void * busyTask(void *)
+{
+  while (tasksRunning) {
+  }
+  return nullptr;
+}
+
+static void * sleepingTask(void *)
+{
+  while (tasksRunning) {
+    usleep(5000);
+  }
+  return nullptr;
+}
+
+static const TaskStats * findTask(const TaskStats * stats, uint8_t count,
+                                  const char * name)
+{
+  for (uint8_t i = 0; i < count; i++) {
+    if (!strcmp(stats[i].name, name)) return &stats[i];
+  }
+  return nullptr;
+}
+
+TEST(Tasks, placementAndLoad)
+{
+  static const TaskPlacement placements[] = {
+    { "busy",     0,             4, 0 },
+    { "sleeping", TASK_ANY_CORE, 2, 0 },
+    { nullptr,    TASK_ANY_CORE, 0, 0 }
+  };
+
+  setTaskPlacementTable(placements);
+  EXPECT_EQ(&placements[0], getTaskPlacement("busy"));
+  EXPECT_EQ(&placements[1], getTaskPlacement("sleeping"));
+  EXPECT_EQ(nullptr, getTaskPlacement("other"));
+
+  pthread_t busy, sleeping;
+  tasksRunning = true;
+  RTOS_CREATE_TASK(busy, busyTask, "busy", 1);
+  RTOS_CREATE_TASK(sleeping, sleepingTask, "sleeping");
+
+#if defined(__linux__)
+  cpu_set_t cpus;
+  ASSERT_EQ(0, pthread_getaffinity_np(busy, sizeof(cpus), &cpus));
+  EXPECT_TRUE(CPU_ISSET(0, &cpus));
+  EXPECT_EQ(1, CPU_COUNT(&cpus));
+#endif
+
+  TaskStats stats[MAX_TASKS_STATS];
+  getTasksStats(stats, MAX_TASKS_STATS);
+  usleep(200000);
+  uint8_t count = getTasksStats(stats, MAX_TASKS_STATS);
+
+  tasksRunning = false;
+  RTOS_JOIN_TASK(busy);
+  RTOS_JOIN_TASK(sleeping);
+  setTaskPlacementTable(nullptr);
+
+  const TaskStats * busyTaskStats = findTask(stats, count, "busy");
+  ASSERT_NE(nullptr, busyTaskStats);
+  EXPECT_EQ(0, busyTaskStats->core);
+  EXPECT_EQ(4, busyTaskStats->priority);
+
+  const TaskStats * sleepingTaskStats = findTask(stats, count, "sleeping");
+  ASSERT_NE(nullptr, sleepingTaskStats);
+  EXPECT_EQ(TASK_ANY_CORE, sleepingTaskStats->core);
+  EXPECT_EQ(2, sleepingTaskStats->priority);
+
+#if defined(__linux__)
+  // absolute loads depend on the host scheduling
+  EXPECT_GT(busyTaskStats->load, sleepingTaskStats->load);
+#endif
+
+  // joined tasks leave the registry
+  count = getTasksStats(stats, MAX_TASKS_STATS);
+  EXPECT_EQ(nullptr, findTask(stats, count, "busy"));
+  EXPECT_EQ(nullptr, findTask(stats, count, "sleeping"));
+}
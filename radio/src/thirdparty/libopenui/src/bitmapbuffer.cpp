@@ -25,6 +25,7 @@
 #include "font.h"
 #include "dma2d.h"
 #include "strhelpers.h"
+#include "text_cache.h"
 
 #include "lvgl/src/draw/sw/lv_draw_sw.h"
 
@@ -1039,6 +1040,43 @@ void BitmapBuffer::drawBitmapPattern(coord_t x, coord_t y, const uint8_t * bmp,
                    srcx, srcy, srcw, srch, COLOR_VAL(flags));
 }
 
+#if !defined(BOOT)
+// Same blending as LVGL (lv_draw_sw_blend()) for the alpha mask of
+// a cached text, clipped the same way as lv_draw_label()
+void BitmapBuffer::drawTextRun(coord_t x, coord_t y, const TextRun* run,
+                               uint16_t fullColor)
+{
+  lv_color_t color;
+  color.full = fullColor;
+
+  coord_t xmin = 0, xmax = _width, ymin = 0, ymax = _height;
+  if (draw_ctx) {
+    xmin = draw_ctx->clip_area->x1 - draw_ctx->buf_area->x1;
+    xmax = draw_ctx->clip_area->x2 + 1 - draw_ctx->buf_area->x1;
+    ymin = draw_ctx->clip_area->y1 - draw_ctx->buf_area->y1;
+    ymax = draw_ctx->clip_area->y2 + 1 - draw_ctx->buf_area->y1;
+  }
+
+  coord_t w = run->size.x;
+  coord_t h = run->size.y;
+  coord_t x1 = max<coord_t>(x, xmin), x2 = min<coord_t>(x + w, xmax);
+  coord_t y1 = max<coord_t>(y, ymin), y2 = min<coord_t>(y + h, ymax);
+  if (x1 >= x2 || y1 >= y2) return;
+
+  DMAWait();
+  for (coord_t row = y1; row < y2; row++) {
+    const uint8_t* q = run->mask + 4 + (row - y) * w + (x1 - x);
+    lv_color_t* p = (lv_color_t*)getPixelPtrAbs(x1, row);
+    for (coord_t col = x1; col < x2; col++, p++, q++) {
+      if (*q == LV_OPA_COVER)
+        *p = color;
+      else if (*q)
+        *p = lv_color_mix(color, *p, *q);
+    }
+  }
+}
+#endif
+
 // TODO: find a better place to define this
 extern lv_color_t makeLvColor(uint32_t colorFlags);
 
@@ -1072,8 +1110,29 @@ coord_t BitmapBuffer::drawSizedText(coord_t x, coord_t y, const char *s,
   }
   
   lv_point_t p;
-  lv_txt_get_size(&p, buffer, font, label_draw_dsc.letter_space,
-                  label_draw_dsc.line_space, LV_COORD_MAX, 0);
+#if !defined(BOOT)
+  // cached text: already measured, and drawn without LVGL if possible
+  const TextRun* run = textCache.get(font, buffer, len);
+  if (run && run->mask &&
+      (canvas || (draw_ctx && draw_ctx->buf == data))) {
+    coord_t textX = x - (draw_ctx ? draw_ctx->buf_area->x1 : 0);
+    coord_t textY = y - (draw_ctx ? draw_ctx->buf_area->y1 : 0);
+    if (flags & RIGHT)
+      textX -= run->size.x;
+    else if (flags & CENTERED)
+      textX -= run->size.x / 2;
+    drawTextRun(textX, textY, run, label_draw_dsc.color.full);
+    RESTORE_OFFSET();
+    pos += run->size.x;
+    return ((flags & RIGHT) ? orig_pos : pos) - offsetX;
+  }
+
+  if (run)
+    p = run->size;
+  else
+#endif
+    lv_txt_get_size(&p, buffer, font, label_draw_dsc.letter_space,
+                    label_draw_dsc.line_space, LV_COORD_MAX, 0);
 
   lv_coord_t lv_x = (lv_coord_t)x;
   lv_coord_t lv_y = (lv_coord_t)y;
@@ -1130,13 +1189,182 @@ void drawSolidRect(BitmapBuffer * dc, coord_t x, coord_t y, coord_t w, coord_t h
 BitmapBuffer * BitmapBuffer::loadBitmap(const char * filename, BitmapFormats fmt)
 {
   //TRACE("  BitmapBuffer::loadBitmap(%s)", filename);
+#if !defined(BOOT)
+  FILINFO info;
+  uint32_t sourceDate = 0;
+  bool sidecar = sidecarsEnabled && f_stat(filename, &info) == FR_OK;
+  if (sidecar) {
+    sourceDate = ((uint32_t)info.fdate << 16) | info.ftime;
+    BitmapBuffer * bmp = load_sidecar(filename, fmt, info.fsize, sourceDate);
+    if (bmp) return bmp;
+  }
+#endif
+
+  BitmapBuffer * bmp;
   const char * ext = getFileExtension(filename);
   if (ext && !strcmp(ext, ".bmp"))
-    return load_bmp(filename);
+    bmp = load_bmp(filename);
   else
-    return load_stb(filename, fmt);
+    bmp = load_stb(filename, fmt);
+
+#if !defined(BOOT)
+  if (bmp && sidecar && sidecarsWritable) {
+    save_sidecar(filename, fmt, info.fsize, sourceDate, bmp);
+  }
+#endif
+
+  return bmp;
+}
+
+#if !defined(BOOT)
+
+#include "../thirdparty/lz4/lz4.h"
+
+bool BitmapBuffer::sidecarsEnabled = false;
+bool BitmapBuffer::sidecarsWritable = false;
+
+#define BITMAP_SIDECAR_MAGIC    0x42585445 // "ETXB"
+#define BITMAP_SIDECAR_VERSION  1
+
+// Sidecar file: header followed by the LZ4 compressed pixels
+struct BitmapSidecarHeader {
+  uint32_t magic;
+  uint8_t version;
+  int8_t requestedFormat;  // 'fmt' given to loadBitmap()
+  uint8_t format;
+  uint8_t reserved;
+  uint16_t width;
+  uint16_t height;
+  uint32_t sourceSize;
+  uint32_t sourceDate;     // fdate << 16 | ftime
+  uint32_t compressedSize;
+};
+
+static bool getSidecarPath(const char * filename, char * path)
+{
+  size_t len = strlen(filename);
+  if (len + sizeof(BITMAP_SIDECAR_EXT) > FF_MAX_LFN + 1) return false;
+  const char * ext = getFileExtension(filename);
+  if (ext && !strcasecmp(ext, BITMAP_SIDECAR_EXT)) return false;
+  memcpy(path, filename, len);
+  memcpy(path + len, BITMAP_SIDECAR_EXT, sizeof(BITMAP_SIDECAR_EXT));
+  return true;
 }
 
+BitmapBuffer * BitmapBuffer::load_sidecar(const char * filename,
+                                          BitmapFormats fmt,
+                                          uint32_t sourceSize,
+                                          uint32_t sourceDate)
+{
+  char path[FF_MAX_LFN + 1];
+  if (!getSidecarPath(filename, path)) return nullptr;
+
+  if (f_open(&imgFile, path, FA_OPEN_EXISTING | FA_READ) != FR_OK) {
+    return nullptr;
+  }
+
+  UINT read;
+  BitmapSidecarHeader hdr;
+  if (f_read(&imgFile, &hdr, sizeof(hdr), &read) != FR_OK ||
+      read != sizeof(hdr) || hdr.magic != BITMAP_SIDECAR_MAGIC ||
+      hdr.version != BITMAP_SIDECAR_VERSION || hdr.requestedFormat != fmt ||
+      hdr.sourceSize != sourceSize || hdr.sourceDate != sourceDate ||
+      f_size(&imgFile) != sizeof(hdr) + hdr.compressedSize) {
+    // stale or invalid: it will be written again
+    f_close(&imgFile);
+    return nullptr;
+  }
+
+  uint8_t * compressed = (uint8_t *)malloc(hdr.compressedSize);
+  if (!compressed) {
+    f_close(&imgFile);
+    return nullptr;
+  }
+
+  FRESULT result = f_read(&imgFile, compressed, hdr.compressedSize, &read);
+  f_close(&imgFile);
+
+  BitmapBuffer * bmp = nullptr;
+  if (result == FR_OK && read == hdr.compressedSize) {
+    bmp = new BitmapBuffer(hdr.format, hdr.width, hdr.height);
+    uint32_t size = bmp->getDataSize();
+    if (!bmp->getData() ||
+        LZ4_decompress_safe((const char *)compressed, (char *)bmp->getData(),
+                            hdr.compressedSize, size) != (int)size) {
+      TRACE("load_sidecar(%s) failed", path);
+      delete bmp;
+      bmp = nullptr;
+    }
+  }
+
+  free(compressed);
+  return bmp;
+}
+
+void BitmapBuffer::save_sidecar(const char * filename, BitmapFormats fmt,
+                                uint32_t sourceSize, uint32_t sourceDate,
+                                const BitmapBuffer * bmp)
+{
+  char path[FF_MAX_LFN + 1];
+  if (!getSidecarPath(filename, path)) return;
+
+  int size = bmp->getDataSize();
+  int bound = LZ4_compressBound(size);
+  // the LZ4 state is too big for the tasks stacks
+  void * state = malloc(LZ4_sizeofState());
+  char * compressed = (char *)malloc(bound);
+
+  int len = 0;
+  if (state && compressed) {
+    len = LZ4_compress_fast_extState(state, (const char *)bmp->getData(),
+                                     compressed, size, bound, 1);
+  }
+  free(state);
+
+  FRESULT result = FR_OK;
+  if (len > 0) {
+    result = f_open(&imgFile, path, FA_CREATE_ALWAYS | FA_WRITE);
+  }
+  if (len > 0 && result == FR_OK) {
+    BitmapSidecarHeader hdr = {
+        BITMAP_SIDECAR_MAGIC,
+        BITMAP_SIDECAR_VERSION,
+        (int8_t)fmt,
+        bmp->getFormat(),
+        0,
+        bmp->width(),
+        bmp->height(),
+        sourceSize,
+        sourceDate,
+        (uint32_t)len,
+    };
+    UINT written;
+    result = f_write(&imgFile, &hdr, sizeof(hdr), &written);
+    if (result == FR_OK && written == sizeof(hdr))
+      result = f_write(&imgFile, compressed, len, &written);
+    f_close(&imgFile);
+    if (result == FR_OK && written != (UINT)len) {
+      // short write: the card is full
+      result = FR_DENIED;
+    }
+    if (result != FR_OK) {
+      // never leave a truncated sidecar behind
+      f_unlink(path);
+    }
+  }
+
+  if (result != FR_OK) {
+    // read-only or full card: do not try again on each load
+    TRACE("save_sidecar(%s) failed (%d), sidecars not saved anymore", path,
+          result);
+    sidecarsWritable = false;
+  }
+
+  free(compressed);
+}
+
+#endif
+
 BitmapBuffer * BitmapBuffer::loadMask(const char * filename)
 {
   BitmapBuffer * bitmap = BitmapBuffer::loadBitmap(filename);
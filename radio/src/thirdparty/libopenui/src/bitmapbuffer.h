@@ -41,6 +41,8 @@ constexpr uint8_t STASHED = 0x33;
 
 #define USE_STB
 
+#define BITMAP_SIDECAR_EXT ".etxb"
+
 enum BitmapFormats
 {
   BMP_INVALID = -1,
@@ -55,6 +57,8 @@ typedef _lv_draw_ctx_t lv_draw_ctx_t;
 struct _lv_obj_t;
 typedef _lv_obj_t lv_obj_t;
 
+struct TextRun;
+
 template<class T>
 class BitmapBufferBase
 {
@@ -306,6 +310,17 @@ class BitmapBuffer: public BitmapBufferBase<pixel_t>
 
     static BitmapBuffer * loadBitmap(const char * filename, BitmapFormats fmt = BMP_INVALID);
 
+    // When enabled, loadBitmap() saves the decoded pixels next to the
+    // image file (BITMAP_SIDECAR_EXT, LZ4 compressed) and loads them
+    // from there as long as the image file size and date do not change.
+    // Saving stops at the first write error (read-only or full SD card)
+    // until enabled again.
+    static void setSidecarsEnabled(bool enabled)
+    {
+      sidecarsEnabled = enabled;
+      sidecarsWritable = enabled;
+    }
+
     static BitmapBuffer * loadMask(const char * filename);
     static BitmapBuffer * load8bitMask(const uint8_t * lbm);
     static BitmapBuffer * load8bitMaskLZ4(const uint8_t * compressed_data);
@@ -333,12 +348,22 @@ class BitmapBuffer: public BitmapBufferBase<pixel_t>
     void drawScaledBitmap(const T * bitmap, coord_t x, coord_t y, coord_t w, coord_t h);
 
   protected:
+    static bool sidecarsEnabled;
+    static bool sidecarsWritable;
+
+    static BitmapBuffer * load_sidecar(const char * filename, BitmapFormats fmt,
+                                       uint32_t sourceSize, uint32_t sourceDate);
+    static void save_sidecar(const char * filename, BitmapFormats fmt,
+                             uint32_t sourceSize, uint32_t sourceDate,
+                             const BitmapBuffer * bmp);
     static BitmapBuffer * load_bmp(const char * filename);
     static BitmapBuffer * load_stb(const char * filename, BitmapFormats fmt = BMP_INVALID);
     static BitmapBuffer * load_stb_buffer(const uint8_t * buffer, int len);
     static BitmapBuffer * convert_stb_bitmap(uint8_t * img, int w, int h, int n,
                                              BitmapFormats fmt = BMP_INVALID);
 
+    void drawTextRun(coord_t x, coord_t y, const TextRun * run, uint16_t color);
+
     inline bool applyClippingRect(coord_t & x, coord_t & y, coord_t & w, coord_t & h) const
     {
       if (h < 0) {
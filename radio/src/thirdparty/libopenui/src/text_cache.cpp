@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   libopenui - https://github.com/opentx/libopenui
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_cache.h"
+
+TextCache textCache;
+
+// FNV-1a
+static uint32_t textHash(const char* s, uint8_t len)
+{
+  uint32_t hash = 2166136261u;
+  for (uint8_t i = 0; i < len; i++) {
+    hash = (hash ^ (uint8_t)s[i]) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t TextCache::entrySize(const Entry& entry)
+{
+  uint32_t size = sizeof(Entry) + entry.text.size();
+  if (entry.run.mask)
+    size += 4 + entry.run.size.x * entry.run.size.y;
+  return size;
+}
+
+// Glyphs are placed and converted to alpha values the same way as
+// lv_draw_label() / lv_draw_letter() do
+uint8_t* TextCache::render(const lv_font_t* font, const char* text,
+                           const lv_point_t& size)
+{
+  static const uint8_t bpp1[] = {0, 255};
+  static const uint8_t bpp2[] = {0, 85, 170, 255};
+  static const uint8_t bpp4[] = {0,   17,  34,  51,  68,  85,  102, 119,
+                                 136, 153, 170, 187, 204, 221, 238, 255};
+
+  if (size.x <= 0 || size.y <= 0) return nullptr;
+
+  uint32_t pixels = size.x * size.y;
+  uint8_t* mask = (uint8_t*)malloc(4 + pixels);
+  if (!mask) return nullptr;
+
+  *((uint16_t*)mask) = size.x;
+  *(((uint16_t*)mask) + 1) = size.y;
+  uint8_t* dest = mask + 4;
+  memset(dest, 0, pixels);
+
+  lv_coord_t x = 0;
+  uint32_t i = 0;
+  uint32_t letter = _lv_txt_encoded_next(text, &i);
+
+  while (letter) {
+    uint32_t next = i;
+    uint32_t letterNext = _lv_txt_encoded_next(text, &next);
+
+    lv_font_glyph_dsc_t g;
+    if (!lv_font_get_glyph_dsc(font, &g, letter, letterNext) ||
+        g.resolved_font != font || font->subpx) {
+      free(mask);
+      return nullptr;
+    }
+
+    if (g.box_w > 0 && g.box_h > 0) {
+      const uint8_t* bitmap = lv_font_get_glyph_bitmap(font, letter);
+      if (!bitmap) {
+        free(mask);
+        return nullptr;
+      }
+
+      uint8_t bpp = g.bpp == 3 ? 4 : g.bpp;
+      const uint8_t* table;
+      switch (bpp) {
+        case 1: table = bpp1; break;
+        case 2: table = bpp2; break;
+        case 4: table = bpp4; break;
+        case 8: table = nullptr; break;
+        default:
+          free(mask);
+          return nullptr;
+      }
+
+      lv_coord_t gx = x + g.ofs_x;
+      lv_coord_t gy =
+          (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+
+      uint32_t bit = 0;
+      for (lv_coord_t row = 0; row < g.box_h; row++) {
+        for (lv_coord_t col = 0; col < g.box_w; col++, bit += bpp) {
+          uint8_t px = bitmap[bit >> 3];
+          px = (px >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1);
+          if (!px) continue;
+
+          // LVGL clips the glyphs to the text area
+          lv_coord_t dx = gx + col, dy = gy + row;
+          if (dx < 0 || dx >= size.x || dy < 0 || dy >= size.y) continue;
+
+          uint8_t& a = dest[dy * size.x + dx];
+          if (a) {
+            // LVGL would blend both glyphs one after the other
+            free(mask);
+            return nullptr;
+          }
+          a = table ? table[px] : px;
+        }
+      }
+    }
+
+    // same advance as lv_txt_get_width() (kerning included)
+    x += g.adv_w;
+    letter = letterNext;
+    i = next;
+  }
+
+  return mask;
+}
+
+const TextRun* TextCache::get(const lv_font_t* font, const char* s,
+                              uint8_t len)
+{
+  if (!enabled || !font || !s) return nullptr;
+
+  len = strnlen(s, len);
+  if (len == 0 || len > TEXT_CACHE_MAX_LEN) return nullptr;
+  for (uint8_t i = 0; i < len; i++) {
+    if (s[i] == '\n' || s[i] == '\r') return nullptr;
+  }
+
+  uint32_t hash = textHash(s, len);
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->hash == hash && it->font == font &&
+        it->text.compare(0, std::string::npos, s, len) == 0) {
+      hits += 1;
+      entries.splice(entries.begin(), entries, it);
+      return &entries.front().run;
+    }
+  }
+
+  misses += 1;
+
+  Entry entry{font, hash, std::string(s, len), {{0, 0}, nullptr}};
+  const char* text = entry.text.c_str();
+  lv_txt_get_size(&entry.run.size, text, font, 0, 0, LV_COORD_MAX, 0);
+
+  // too large masks would flush the whole cache
+  if (entry.run.size.x * entry.run.size.y <= (int32_t)budget / 4)
+    entry.run.mask = render(font, text, entry.run.size);
+
+  entries.push_front(std::move(entry));
+  bytesUsed += entrySize(entries.front());
+  evict(budget);
+
+  return entries.empty() ? nullptr : &entries.front().run;
+}
+
+void TextCache::evict(uint32_t size)
+{
+  while (bytesUsed > size && !entries.empty()) {
+    Entry& entry = entries.back();
+    bytesUsed -= entrySize(entry);
+    free(entry.run.mask);
+    entries.pop_back();
+  }
+}
+
+TextCacheStats TextCache::getStats() const
+{
+  return {hits, misses, bytesUsed, (uint16_t)entries.size()};
+}
+
+void TextCache::resetStats()
+{
+  hits = 0;
+  misses = 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) EdgeTX
+ *
+ * Based on code named
+ *   libopenui - https://github.com/opentx/libopenui
+ *
+ * License GPLv2: http://www.gnu.org/licenses/gpl-2.0.html
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#pragma once
+
+#include <list>
+#include <string>
+
+#include <lvgl/lvgl.h>
+
+//
+// Cache of single line texts layouts
+//
+// Most texts drawn by BitmapBuffer::drawSizedText() (labels, units,
+// sensors names) are the same from one frame to the next. For each
+// (font, string), the cache keeps the text size as measured by LVGL
+// and the glyphs rendered into an 8 bits alpha mask (same layout as
+// the lcd masks: uint16_t width, uint16_t height, pixels).
+//
+// The mask holds the same alpha values as LVGL would use when drawing
+// each glyph. It is left empty (the text is then drawn by LVGL) when
+// the text can't be rendered the same way: glyphs overlapping each
+// other, missing glyphs, fallback fonts or sub-pixel rendering.
+//
+// Only used from the UI task (no locking).
+//
+
+#if !defined(TEXT_CACHE_SIZE)
+  #define TEXT_CACHE_SIZE (32 * 1024)
+#endif
+
+// Longer texts are not cached
+#define TEXT_CACHE_MAX_LEN 64
+
+struct TextCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t bytesUsed;
+  uint16_t entries;
+};
+
+struct TextRun {
+  lv_point_t size;  // as returned by lv_txt_get_size()
+  uint8_t* mask;    // nullptr if the text has to be drawn by LVGL
+};
+
+class TextCache
+{
+ public:
+  explicit TextCache(uint32_t budget = TEXT_CACHE_SIZE) : budget(budget) {}
+  ~TextCache() { flush(); }
+
+  // Returns the layout of 'len' characters of 's', or nullptr if
+  // the text can't be cached (multiple lines, too long)
+  const TextRun* get(const lv_font_t* font, const char* s, uint8_t len);
+
+  void flush() { evict(0); }
+
+  void setBudget(uint32_t size)
+  {
+    budget = size;
+    evict(budget);
+  }
+
+  void setEnabled(bool value) { enabled = value; }
+  bool isEnabled() const { return enabled; }
+
+  TextCacheStats getStats() const;
+  void resetStats();
+
+ protected:
+  struct Entry {
+    const lv_font_t* font;
+    uint32_t hash;
+    std::string text;
+    TextRun run;
+  };
+
+  // most recently used first
+  std::list<Entry> entries;
+  uint32_t budget;
+  uint32_t bytesUsed = 0;
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  bool enabled = true;
+
+  static uint32_t entrySize(const Entry& entry);
+  static uint8_t* render(const lv_font_t* font, const char* text,
+                         const lv_point_t& size);
+  void evict(uint32_t size);
+};
+
+extern TextCache textCache;
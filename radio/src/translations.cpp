@@ -95,6 +95,7 @@ ISTR(ANTENNA_MODES);
 ISTR(SAMPLE_MODES);
 ISTR(SPORT_UPDATE_POWER_MODES);
 ISTR(CRSF_BAUDRATE);
+ISTR(ADC_FILTER_TYPES);
 ISTR(PPM_POL);
 ISTR(SBUS_INVERSION_VALUES);
 ISTR(SPORT_MODES);
@@ -214,6 +214,7 @@ extern const char* const STR_R9M_PXX2_RF_PROTOCOLS[];
 extern const char* const STR_PPM_PROTOCOLS[];
 extern const char* const STR_DSM_PROTOCOLS[];
 extern const char* const STR_CRSF_BAUDRATE[];
+extern const char* const STR_ADC_FILTER_TYPES[];
 extern const char* const STR_PPM_POL[];
 extern const char* const STR_SBUS_INVERSION_VALUES[];
 
@@ -47,6 +47,8 @@
 
 #define TR_CRSF_BAUDRATE               "115k","400k","921k","1.87M","3.75M","5.25M"
 
+#define TR_ADC_FILTER_TYPES            "Jitter","1Euro","Avg4"
+
 #define TR_MODULE_R9M_LITE             "R9MLite"
 
 #define TR_MODULE_PROTOCOLS          \
@@ -109,6 +111,11 @@
 #define TR_SPLASHSCREEN_DELAYS         "1s","2s","3s","4s","6s","8s","10s","15s"
 #endif
 
+// Debug statistics
+#define STR_BITMAP_CACHE_LABEL         "Bitmaps"
+#define STR_CACHE_HITS                 "Hits(%): "
+#define STR_CACHE_SAVED                "Saved(B): "
+
 // Telemetry sensor name definitions
 #define STR_SENSOR_RSSI                      "RSSI"
 #define STR_SENSOR_R9PW                      "R9PW"